@@ -0,0 +1,13 @@
+-- Sequence for player item IDs.  ItemFactory reserves IDs from here in blocks and inserts entity rows in batches
+-- +migrate Up
+create table if not exists srvItemIDSeq
+(
+    AI tinyint(3) unsigned not null primary key,
+    nextItemID int(10) unsigned not null
+);
+
+insert into srvItemIDSeq (AI, nextItemID)
+    select 1, greatest(140000001, coalesce(max(itemID) + 1, 0)) from entity where itemID < 300000000;
+
+-- +migrate Down
+drop table srvItemIDSeq;
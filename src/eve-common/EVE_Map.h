@@ -27,6 +27,12 @@ namespace Map {
             System          = 2     // blue
         };
     }
+    namespace Jumps {
+        enum {
+            Max             = 254,  // longest route in k-space is well under this
+            Unreachable     = 255   // no gate route (w-space, jove, or blocked by sec filter)
+        };
+    }
 }
 
 
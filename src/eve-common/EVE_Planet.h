@@ -107,11 +107,6 @@ struct PlanetResourceData {
     float dist_3;
     float dist_4;
     float dist_5;
-    std::string buffer_1;
-    std::string buffer_2;
-    std::string buffer_3;
-    std::string buffer_4;
-    std::string buffer_5;
 };
 
 struct PI_Link {
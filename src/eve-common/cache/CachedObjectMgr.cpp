@@ -113,7 +113,8 @@ PyObject *CachedObjectMgr::CacheRecord::EncodeHint() const
 {
     objectCaching_CachedObject_spec spec;
 
-    spec.objectID = objectID->Clone();
+    spec.objectID = objectID;
+    PyIncRef( objectID );
     spec.nodeID = HackCacheNodeID;
     spec.timestamp = timestamp;
     spec.version = version;
@@ -294,7 +295,8 @@ PyObject *CachedObjectMgr::GetCachedObject(const PyRep *objectID)
     co.version = res->second->version;
     co.nodeID = HackCacheNodeID;    //hack, doesn't matter until we have multi-node networks.
     co.shared = true;
-    co.objectID = res->second->objectID->Clone();
+    co.objectID = res->second->objectID;
+    PyIncRef( co.objectID );
     co.cache = res->second->cache;
 
     if (res->second->cache->content().size() == 0 || res->second->cache->content()[0] == MarshalHeaderByte)
@@ -305,22 +307,22 @@ PyObject *CachedObjectMgr::GetCachedObject(const PyRep *objectID)
     sLog.Debug("CachedObjMgr","Returning cached object '%s' with checksum 0x%x", str.c_str(), co.version);
 
     PyObject* result = co.Encode();
-    co.cache = nullptr;    //avoid a copy
+    co.cache = nullptr;    //not ours; Encode() took its own reference
 
     return result;
 }
 
-bool CachedObjectMgr::IsCacheUpToDate(const PyRep *objectID, uint32 version, int64 timestamp)
+bool CachedObjectMgr::IsCacheUpToDate(const PyRep *objectID, uint32 version) const
 {
     const std::string str = OIDToString(objectID);
 
-    CachedObjMapItr res = m_cachedObjects.find(str);
+    CachedObjMapConstItr res = m_cachedObjects.find(str);
     if (res == m_cachedObjects.end())
         return false;
 
-    //for now, only support exact matches...
-    return (   res->second->version == version
-            && res->second->timestamp == timestamp);
+    // only the version is compared; the timestamp is renewed every time the object is rebuilt
+    // (server restart, cache invalidation), even when the contents come out the same.
+    return (res->second->version == version);
 }
 
 bool CachedObjectMgr::LoadCachedFromFile(const std::string &cacheDir, const std::string &objectID)
@@ -611,9 +613,12 @@ PyCachedObject *PyCachedObject::Clone() const
     res->version  = version;
     res->nodeID  = nodeID;
     res->shared = shared;
-    res->cache = (PyBuffer *) cache->Clone();
+    // both are immutable once cached; share them
+    res->cache = cache;
+    PyIncRef( cache );
     res->compressed = compressed;
-    res->objectID = objectID->Clone();
+    res->objectID = objectID;
+    PyIncRef( objectID );
     return res;
 }
 
@@ -801,12 +806,12 @@ PyObject *PyCachedObject::Encode()
         //or if we can change this encode method to consume the PyCachedObject (which will almost always be the case)
         arg_tuple->items[4] = cache->Clone();
     }*/
-    //TODO: we don't really need to clone this if we can figure out a way to say "this is read only"
-    //or if we can change this encode method to consume the PyCachedObject (which will almost always be the case)
-    arg_tuple->items[4] = cache->Clone();
+    // cached data and objectID are never changed once cached, so share them instead of cloning
+    arg_tuple->items[4] = cache;
+    PyIncRef( cache );
     arg_tuple->items[5] = new PyInt(compressed?1:0);
-    //same cloning statement as above.
-    arg_tuple->items[6] = objectID->Clone();
+    arg_tuple->items[6] = objectID;
+    PyIncRef( objectID );
 
     return new PyObject( "objectCaching.CachedObject", arg_tuple );
 }
@@ -816,8 +821,9 @@ PyObject *PyCachedObjectDecoder::EncodeHint() {
         versiont->items[0] = new PyLong(timestamp);
         versiont->items[1] = new PyInt(version);
     PyTuple *arg_tuple = new PyTuple(3);
-        arg_tuple->items[0] = objectID->Clone();
+        arg_tuple->items[0] = objectID;
         arg_tuple->items[1] = new PyInt(nodeID);
+    PyIncRef( objectID );
         arg_tuple->items[2] = versiont;
 
     return new PyObject( "util.CachedObject", arg_tuple );
@@ -832,7 +838,8 @@ PyCachedCall::~PyCachedCall()
 
 PyCachedCall *PyCachedCall::Clone() const {
     PyCachedCall *res = new PyCachedCall();
-    res->result = result->Clone();
+    res->result = result;
+    PyIncRef( result );
     return res;
 }
 
@@ -65,7 +65,8 @@ public:
     bool HaveCached(const std::string &objectID) const;
     bool HaveCached(const PyRep *objectID) const;
 
-    bool IsCacheUpToDate(const PyRep *objectID, uint32 version, int64 timestamp);
+    //true if the client's copy of objectID (version as sent in GetCachableObject) is the one we have.
+    bool IsCacheUpToDate(const PyRep *objectID, uint32 version) const;
 
     void InvalidateCache(const PyRep *objectID);
 
@@ -110,8 +111,8 @@ protected:
         PyObject *EncodeHint() const;
 
         PyRep *objectID;    //we own this
-        int64 timestamp;
-        uint32 version;
+        int64 timestamp;    //when this copy was built; changes on every rebuild
+        uint32 version;     //crc32 of cache, so it only changes with the contents
         PyBuffer *cache; //we own this.
     };
     typedef std::map<std::string, CacheRecord *>    CachedObjMap;
@@ -91,7 +91,7 @@ PyObject *DBResultToRowset(DBQueryResult &result)
     //list off the column names:
     PyList *header = new PyList(cc);
     for(uint32 r(0); r < cc; ++r)
-        header->SetItemString(r, result.ColumnName(r));
+        header->SetItem(r, PyString::Intern(result.ColumnName(r)));
     args->SetItemString("header", header);
 
     //RowClass:
@@ -123,7 +123,7 @@ PyTuple *DBResultToTupleSet(DBQueryResult &result) {
     //list off the column names:
     PyList *cols = new PyList(cc);
     for(uint32 r(0); r < cc; ++r)
-        cols->SetItemString(r, result.ColumnName(r));
+        cols->SetItem(r, PyString::Intern(result.ColumnName(r)));
     res->items[0] = cols;
 
     //add a line entry for each result row:
@@ -193,12 +193,12 @@ PyObject *DBResultToIndexRowset(DBQueryResult &result, uint32 key_index) {
     PyList *header = new PyList(cc);
     args->SetItemString("header", header);
     for (uint32 i(0); i < cc; ++i)
-        header->SetItemString(i, result.ColumnName(i));
+        header->SetItem(i, PyString::Intern(result.ColumnName(i)));
 
     //RowClass:
     args->SetItemString("RowClass", new PyToken("util.Row"));
     //idName:
-    args->SetItemString("idName", new PyString(result.ColumnName(key_index)));
+    args->SetItemString("idName", PyString::Intern(result.ColumnName(key_index)));
 
     //items:
     PyDict *items = new PyDict();
@@ -222,7 +222,7 @@ PyObject *DBRowToKeyVal(DBResultRow &row) {
     PyDict *args = new PyDict();
     uint32 cc(row.ColumnCount());
     for (uint32 r(0); r < cc; ++r)
-        args->SetItemString(row.ColumnName(r), DBColumnToPyRep(row, r));
+        args->SetItem(PyString::Intern(row.ColumnName(r)), DBColumnToPyRep(row, r));
 
     return new PyObject("util.KeyVal", args);
 }
@@ -235,7 +235,7 @@ PyObject *DBRowToRow(DBResultRow &row, const char *type)
     uint32 cc(row.ColumnCount());
     PyList *header = new PyList(cc);
     for (uint32 r(0); r < cc; ++r)
-        header->SetItemString(r, row.ColumnName(r));
+        header->SetItem(r, PyString::Intern(row.ColumnName(r)));
 
     args->SetItemString("header", header);
 
@@ -258,7 +258,7 @@ PyTuple *DBResultToRowList(DBQueryResult &result, const char *type) {
     PyList *cols = new PyList(cc);
     //list off the column names:
     for(uint32 r(0); r < cc; ++r)
-        cols->SetItemString(r, result.ColumnName(r));
+        cols->SetItem(r, PyString::Intern(result.ColumnName(r)));
 
     PyTuple *res = new PyTuple(2);
     res->SetItem(0, cols);
@@ -423,14 +423,15 @@ PyDict *DBResultToPackedRowDict(DBQueryResult &result, uint32 key_index)
 
 /* this is a very monstrous implementation of a Python Class/Function call
  */
-PyObjectEx *DBResultToCRowset(DBQueryResult &result)
+PyObjectEx *DBResultToCRowset(DBQueryResult &result, uint32 maxRows/*0*/)
 {
     /** @todo Mem leak.  `header` never freed */
     DBRowDescriptor *header = new DBRowDescriptor(result);
     CRowSet *rowset = new CRowSet(&header);
 
     DBResultRow row;
-    while(result.GetRow(row))
+    uint32 count(0);
+    while (((maxRows == 0) or (count++ < maxRows)) and result.GetRow(row))
     {
         PyPackedRow* into = rowset->NewRow();
         FillPackedRow(row, into);
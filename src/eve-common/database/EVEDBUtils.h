@@ -65,7 +65,8 @@ PyDict *DBResultToPackedRowDict(DBQueryResult &result, uint32 key_index);
 PyList *DBResultToPackedRowList(DBQueryResult &result);
 
 // this fills PyObjectEx2(util.KeyVal)'s 'list" with PacketRow objects
-PyObjectEx *DBResultToCRowset(DBQueryResult &result);
+// maxRows limits it to the next maxRows rows of result (0 = all that are left), so big results can be split in several rowsets
+PyObjectEx *DBResultToCRowset(DBQueryResult &result, uint32 maxRows = 0);
 // this fills PyObjectEx2(util.KeyVal)'s 'list" with Indexed PacketRow objects
 PyObjectEx *DBResultToCIndexedRowset(DBQueryResult &result, const char *key);
 PyObjectEx *DBResultToCIndexedRowset(DBQueryResult &result, uint32 key_index);
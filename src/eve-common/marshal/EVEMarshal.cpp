@@ -32,17 +32,28 @@
 #include "python/PyRep.h"
 #include "python/PyVisitor.h"
 #include "utils/EVEUtils.h"
+#include "utils/Metrics.h"
+#include "utils/Trace.h"
+
+#if defined( __SSE2__ )
+#   include <emmintrin.h>
+#endif
 
 bool Marshal( const PyRep* rep, Buffer& into )
 {
+    static MetricCounter& bytes = sMetrics.GetCounter( "evemu_marshal_bytes_total", "Bytes written by Marshal(), nested substreams included." );
+
+    const size_t start(into.size());
     MarshalStream* pMS(new MarshalStream());
     bool ret(pMS->Save(rep, into));
     SafeDelete(pMS);
+    bytes.Inc( into.size() - start );
     return ret;
 }
 
 bool MarshalDeflate( const PyRep* rep, Buffer& into, const uint32 deflationLimit )
 {
+    TRACE_SPAN( "MarshalDeflate" );
     Buffer* data(new Buffer());
     bool ret(false);
     if (Marshal(rep, *data)) {
@@ -71,6 +82,8 @@ bool MarshalStream::Save( const PyRep* rep, Buffer& into )
     mBuffer = &into;
     bool res(SaveStream(rep));
     mBuffer = nullptr;
+    // the descriptors may be gone once the rep is
+    mPackedLayouts.clear();
 
     return res;
 }
@@ -171,7 +184,10 @@ bool MarshalStream::VisitString( const PyString* rep )
         Put<uint8>( rep->content()[0] );
     } else {
         //string is long enough for a string table entry, check it.
-        const uint8 index = sMarshalStringTable.LookupIndex( rep->content() );
+        // interned strings already know their index (or that they have none)
+        uint8 index = rep->GetTableIndex();
+        if ((index == STRING_TABLE_ERROR) and !rep->IsInterned())
+            index = sMarshalStringTable.LookupIndex( rep->content() );
         if ( index > STRING_TABLE_ERROR ) {
             Put<uint8>( Op_PyStringTableItem );
             Put<uint8>( index );
@@ -310,103 +326,54 @@ bool MarshalStream::VisitPackedRow( const PyPackedRow* pyPackedRow )
     DBRowDescriptor* header(pyPackedRow->header());
     header->visit( *this );
 
-    // create the sizemap and sort it by bitsize, the value of the map indicates the index of the column
-    // this can be used to identify things easily
-    std::multimap< uint8, uint32, std::greater< uint8 > > sizeMap;
-    std::map<uint8,uint8> booleanColumns;
-
-    uint32 columnCount = header->ColumnCount();
-    size_t byteDataBitLength = 0;
-    size_t booleansBitLength = 0;
-    size_t nullsBitLength = 0;
-
-    // go through all the columns to gather the required information
-    for (uint32_t i = 0; i < columnCount; i ++)
-    {
-        DBTYPE columnType = header->GetColumnType (i);
-        uint8_t size = DBTYPE_GetSizeBits (columnType);
-
-        // count booleans
-        if (columnType == DBTYPE_BOOL)
-        {
-            // register the boolean in the list and increase the length
-            booleanColumns.insert (std::make_pair (i, booleansBitLength));
-            booleansBitLength ++;
-        }
-
-        // also count all columns as possible nulls
-        nullsBitLength ++;
-
-        // increase the bytedata length only if a column is longer than 7 bits
-        // this is used as an indicator of what is written in the first second, or third part
-        if (size >= 8)
-            byteDataBitLength += size;
+    // rowsets share one descriptor between all of their rows, so the column layout is only worked out once
+    const PackedRowLayout& layout = GetPackedRowLayout( header );
 
-        // add the column to the list
-        sizeMap.insert (std::make_pair (size, i));
-    }
+    // the packed data is the fixed-size columns followed by the bool and null bits, all zero unless set
+    mRowData.assign( layout.byteSize + layout.bitSize, 0 );
+    uint8* rowData = mRowData.data();
+    uint8* bitData = rowData + layout.byteSize;
 
-    // reserve the space for the buffers
-    Buffer rowData;
-    rowData.Reserve<uint8> ((byteDataBitLength >> 3) + ((booleansBitLength + nullsBitLength) >> 3) + 1);
-    // to ease working with the bit data, reserve a fixed-size buffer
-    // and fill it with 0s
-    Buffer bitData(((booleansBitLength + nullsBitLength) >> 3) + 1, 0);
-
-    std::multimap< uint8, uint32, std::greater< uint8 > >::iterator cur, end;
-    cur = sizeMap.begin();
-    // limit the search to booleans, the rest of the values are encoded differently
-    end = sizeMap.lower_bound( 1 );
     PyRep* value(nullptr);
-    for (; cur != end; ++cur)
-    {
-        value = pyPackedRow->GetField(cur->second);
-
-        // handle the column being none
-        if (value->IsNone() == true)
-        {
-            // get the bit this column should be written at
-            unsigned long nullBit = cur->second + booleansBitLength;
-            unsigned long nullByte = nullBit >> 3;
-            // setup the iterator to the proper byte
-            Buffer::iterator<uint8> bitIterator = bitData.begin<uint8>() + nullByte;
-            // update the proper bit
-            *bitIterator |= (1 << (nullBit & 0x7));
-        }
+    for (auto& col : layout.fixed) {
+        value = pyPackedRow->GetField( col.index );
+
+        // the value is still written for None fields, the client ignores it once the null bit is set
+        const bool none = value->IsNone();
+        if (none)
+            bitData[ col.nullBit >> 3 ] |= ( 1 << ( col.nullBit & 0x7 ) );
 
-        // ensure that the proper value is written
-        // the values will be ignored if a none flag is set, but they must be present
-        switch (header->GetColumnType (cur->second))
-        {
+        uint8* out = rowData + col.offset;
+        switch (col.type) {
             case DBTYPE_CY:
             case DBTYPE_I8:
             case DBTYPE_UI8:
             case DBTYPE_FILETIME:
-                rowData.Append<int64>(value->IsNone() ? 0 : value->AsLong()->value() );
+                PutPacked<int64>( out, none ? 0 : value->AsLong()->value() );
                 break;
             case DBTYPE_I4:
-                rowData.Append<int32>(value->IsNone() ? 0 : value->AsInt()->value() );
+                PutPacked<int32>( out, none ? 0 : value->AsInt()->value() );
                 break;
             case DBTYPE_UI4:
-                rowData.Append<uint32>(value->IsNone() ? 0 : value->AsInt()->value() );
+                PutPacked<uint32>( out, none ? 0 : value->AsInt()->value() );
                 break;
             case DBTYPE_I2:
-                rowData.Append<int16>(value->IsNone() ? 0 : value->AsInt()->value() );
+                PutPacked<int16>( out, none ? 0 : value->AsInt()->value() );
                 break;
             case DBTYPE_UI2:
-                rowData.Append<uint16>(value->IsNone() ? 0 : value->AsInt()->value() );
+                PutPacked<uint16>( out, none ? 0 : value->AsInt()->value() );
                 break;
             case DBTYPE_I1:
-                rowData.Append<int8>(value->IsNone() ? 0 : value->AsInt()->value() );
+                PutPacked<int8>( out, none ? 0 : value->AsInt()->value() );
                 break;
             case DBTYPE_UI1:
-                rowData.Append<uint8>(value->IsNone() ? 0 : value->AsInt()->value() );
+                PutPacked<uint8>( out, none ? 0 : value->AsInt()->value() );
                 break;
             case DBTYPE_R8:
-                rowData.Append<double>(value->IsNone() ? 0.0 : value->AsFloat()->value() );
+                PutPacked<double>( out, none ? 0.0 : value->AsFloat()->value() );
                 break;
             case DBTYPE_R4:
-                rowData.Append<float>(static_cast<float>(value->IsNone() ? 0.0f : value->AsFloat()->value()));
+                PutPacked<float>( out, static_cast<float>(none ? 0.0f : value->AsFloat()->value()) );
                 break;
             // FIXME nothing should hit here ever but better implement some error-handling just in case
             default:
@@ -416,45 +383,83 @@ bool MarshalStream::VisitPackedRow( const PyPackedRow* pyPackedRow )
         }
     }
 
-    cur = sizeMap.lower_bound( 1 );
-    end = sizeMap.lower_bound( 0 );
-    PyBool* b(nullptr);
-    for (; cur != end; ++cur)
-    {
-        b = pyPackedRow->GetField(cur->second)->AsBool();
-
-        // false values do not need anything to be done
-        if (b->value() == false)
+    for (auto& col : layout.bools) {
+        value = pyPackedRow->GetField( col.index );
+        if (value->IsNone()) {
+            bitData[ col.nullBit >> 3 ] |= ( 1 << ( col.nullBit & 0x7 ) );
             continue;
+        }
 
-        // get the bit this boolean should be written at
-        unsigned long boolBit = booleanColumns.find (cur->second)->second;
-        unsigned long boolByte = boolBit >> 3;
-        // setup the iterator to the proper byte
-        Buffer::iterator<uint8> bitIterator = bitData.begin<uint8>() + boolByte;
-        // update the proper bit
-        *bitIterator |= (1 << (boolBit & 0x7));
+        // false values do not need anything to be done
+        if (value->AsBool()->value())
+            bitData[ col.offset >> 3 ] |= ( 1 << ( col.offset & 0x7 ) );
     }
 
-    // concatenate the bit data to the rowData
-    rowData.AppendSeq(bitData.begin<uint8>(), bitData.end<uint8>());
-
     // run the data through the zero compression algorithm
-    if (!SaveRLE(rowData))
+    if (!SaveRLE( rowData, mRowData.size() ))
         return false;
 
     // finally append items that are not packed like strings or byte buffers
-    cur = sizeMap.lower_bound( 0 );
-    end = sizeMap.end();
-    for (; cur != end; ++cur) {
-        value = pyPackedRow->GetField(cur->second );
-        if (!value->visit(*this))
+    for (auto& index : layout.objects)
+        if (!pyPackedRow->GetField( index )->visit( *this ))
             return false;
-    }
 
     return true;
 }
 
+const MarshalStream::PackedRowLayout& MarshalStream::GetPackedRowLayout( const DBRowDescriptor* header )
+{
+    // the descriptors are kept alive by the rep being saved, so their address is a safe key for this stream
+    std::unordered_map<const DBRowDescriptor*, PackedRowLayout>::iterator itr = mPackedLayouts.find( header );
+    if (itr != mPackedLayouts.end())
+        return itr->second;
+
+    PackedRowLayout& layout = mPackedLayouts[ header ];
+    layout.byteSize = 0;
+
+    // columns are packed widest first, keeping column order between columns of the same size
+    const uint32 columnCount = header->ColumnCount();
+    std::vector<std::pair<uint8, PackedRowLayout::Column>> columns;
+    columns.reserve( columnCount );
+
+    uint32 booleans(0);
+    for (uint32 i = 0; i < columnCount; ++i) {
+        PackedRowLayout::Column col;
+        col.index = i;
+        col.type = header->GetColumnType( i );
+        col.offset = 0;
+        col.nullBit = 0;
+        if (col.type == DBTYPE_BOOL)
+            col.offset = booleans++;    // bit of the value, within the bit data
+
+        columns.push_back( std::make_pair( DBTYPE_GetSizeBits( col.type ), col ) );
+    }
+
+    std::stable_sort( columns.begin(), columns.end(),
+        []( const std::pair<uint8, PackedRowLayout::Column>& a, const std::pair<uint8, PackedRowLayout::Column>& b ) { return a.first > b.first; } );
+
+    for (auto& cur : columns) {
+        PackedRowLayout::Column& col = cur.second;
+        // every column has a null bit, after the bool bits
+        col.nullBit = booleans + col.index;
+
+        if (cur.first >= 8) {
+            col.offset = layout.byteSize;
+            layout.byteSize += cur.first >> 3;
+            layout.fixed.push_back( col );
+        } else if (cur.first == 1) {
+            layout.bools.push_back( col );
+        } else {
+            layout.objects.push_back( col.index );
+        }
+    }
+
+    // sized the same way the unmarshaler works it out, spare byte included
+    layout.bitSize = ( ( booleans + columnCount ) >> 3 ) + 1;
+
+    return layout;
+}
+
 bool MarshalStream::VisitSubStruct( const PySubStruct* rep )
 {
     Put<uint8>(Op_PySubStruct);
@@ -521,79 +526,126 @@ void MarshalStream::SaveVarInteger( const PyLong* v )
     }
 }
 
-bool MarshalStream::SaveRLE(const Buffer& in )
+namespace {
+
+/** @return number of trailing zero bits of given (non-zero) value. */
+inline uint32 CountTrailingZeros( uint32 bits )
+{
+#if defined( __GNUC__ )
+    return __builtin_ctz( bits );
+#else
+    uint32 count(0);
+    for (; ( bits & 1 ) == 0; bits >>= 1)
+        ++count;
+    return count;
+#endif
+}
+
+/**
+ * Builds a bitmask of the zero bytes in given data; bit n of the mask is set
+ * when data[n] is zero. The mask must have room for (size + 63) / 64 words.
+ */
+void BuildZeroMask( const uint8* data, size_t size, uint64_t* mask )
+{
+    size_t i(0);
+#if defined( __SSE2__ )
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16) {
+        const uint64_t bits = (uint16)_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i*)( data + i ) ), zero ) );
+        if (( i & 63 ) == 0)
+            mask[ i >> 6 ] = bits;
+        else
+            mask[ i >> 6 ] |= bits << ( i & 63 );
+    }
+#endif
+    for (; i < size; ++i) {
+        if (( i & 63 ) == 0)
+            mask[ i >> 6 ] = 0;
+        if (data[ i ] == 0)
+            mask[ i >> 6 ] |= (uint64_t)1 << ( i & 63 );
+    }
+}
+
+/** @return the 8 mask bits starting at bit index. */
+inline uint32 GetMaskByte( const uint64_t* mask, size_t index, size_t words )
+{
+    const size_t word = index >> 6, shift = index & 63;
+    uint64_t bits = mask[ word ] >> shift;
+    if (( shift > 56 ) and ( word + 1 < words ))
+        bits |= mask[ word + 1 ] << ( 64 - shift );
+    return (uint32)( bits & 0xFF );
+}
+
+}
+
+bool MarshalStream::SaveRLE( const uint8* in, size_t in_size )
 {
-    // TODO: REWRITE THIS, AS IT IS RIGHT NOW IS INEFFICIENT, I'VE CONVERTED THE BUFFER CLASS TO A BASTARDIZED VERSION OF A NORMAL BYTE ARRAY
     // ALMAMU - 2021/04/22 - After many years the buggy "SaveZeroCompressed" function has been laid to rest
     //                       may this todo be a way to remind us how unstable and fragile the EVEmu core is
     //                       this code has been validated against the disassembly of Apocrypha's blue.dll
     //                       for those interested, the function lives in .text:10082D10 of that DLL
     //                       "hopefully" this brings our marshaller closer to fully featured
 
-    // reserve double the buffer size just in case, we do not want to run out of space or else the iterators will start to complain
-    Buffer out(in.size() * 2, 0);
-
-    // this code has been used and ported through different projects
-    // both ntt's reverence and Captnoord's re-implementation of evemu core have the exact same code
-    // after validation against the disassembly (and unless I've missed anything) it seems to be 100% accurate
-    // so no real modification to it was done
-    int nibble = 0;
-    int nibble_ix = 0;
-    int in_ix = 0;
-    int out_ix = 0;
-    int start, end, count;
-    int zerochains = 0;
-    int in_size = in.size();
-
-    while(in_ix < in_size)
-    {
-        if(!nibble)
-        {
+    // the data is read in chunks of up to 8 bytes, each one a run of either zero or non-zero bytes
+    // every chunk gets a nibble with its length, and non-zero runs are copied after it.
+    // the runs are taken from a bitmask of the zero bytes instead of testing byte by byte.
+    const size_t words = ( in_size + 63 ) >> 6;
+    mZeroMask.resize( words );
+    BuildZeroMask( in, in_size, mZeroMask.data() );
+
+    // worst case is every byte copied plus a nibble byte for every two chunks
+    mRLEData.resize( in_size + ( in_size >> 4 ) + 2 );
+    uint8* out = mRLEData.data();
+
+    size_t nibble_ix(0), out_ix(0), in_ix(0);
+    uint32 count(0), zerochains(0);
+    bool nibble(false);
+
+    while (in_ix < in_size) {
+        if (!nibble) {
             nibble_ix = out_ix++;
-            out[nibble_ix] = 0;
+            out[ nibble_ix ] = 0;
         }
 
-        start = in_ix;
-        end = in_ix+8;
-        if(end > in_size)
-            end = in_size;
+        const uint32 len = (uint32)std::min<size_t>( 8, in_size - in_ix );
+        // zero bits of this chunk, with a stop bit right after it
+        const uint32 zeros = ( GetMaskByte( mZeroMask.data(), in_ix, words ) & ( ( 1 << len ) - 1 ) ) | ( 1 << len );
 
-        if(in[in_ix])
-        {
+        if (( zeros & 1 ) == 0) {
+            // non-zero run; goes up to the first zero byte
+            const uint32 run = CountTrailingZeros( zeros );
             zerochains = 0;
-            do {
-                out[out_ix++] = in[in_ix++];
-            } while(in_ix<end && in[in_ix]);
-            count = (start - in_ix) + 8;
-        }
-        else
-        {
-            zerochains++;
-            while(in_ix<end && !in[in_ix])
-                in_ix++;
-            count = (in_ix - start) + 7;
+            ::memcpy( out + out_ix, in + in_ix, run );
+            out_ix += run;
+            in_ix += run;
+            count = 8 - run;
+        } else {
+            // zero run; goes up to the first non-zero byte
+            const uint32 run = CountTrailingZeros( ~zeros | ( 1 << len ) );
+            ++zerochains;
+            in_ix += run;
+            count = run + 7;
         }
 
-        if(nibble)
-            out[nibble_ix] |= (count << 4);
+        if (nibble)
+            out[ nibble_ix ] |= ( count << 4 );
         else
-            out[nibble_ix] = count;
+            out[ nibble_ix ] = count;
         nibble = !nibble;
     }
 
-    if(nibble && zerochains)
-        zerochains++;
+    if (nibble and zerochains)
+        ++zerochains;
 
-    while(zerochains>1)
-    {
+    // trailing zero chains are implied, drop their nibble bytes
+    while (zerochains > 1) {
         zerochains -= 2;
         out_ix -= 1;
     }
 
     // Write the packed in
-    PutSizeEx( (uint32) out_ix);
-    if ( 0 < out.size() )
-        Put( out.begin<uint8>(), out.begin<uint8>() + out_ix );
+    PutSizeEx( (uint32)out_ix );
+    Put( out, out + out_ix );
 
     return true;
 }
@@ -26,9 +26,12 @@
 #ifndef EVE_MARSHAL_H
 #define EVE_MARSHAL_H
 
+#include "database/dbtype.h"
 #include "marshal/EVEMarshalOpcodes.h"
 #include "python/PyVisitor.h"
 
+class DBRowDescriptor;
+
 /*
  * @brief Marshal Stream builder.
  *
@@ -138,12 +141,47 @@ protected:
     bool VisitChecksumedStream( const PyChecksumedStream* rep );
 
 private:
+    /** where each column of a DBRowDescriptor goes in a packed row */
+    struct PackedRowLayout {
+        struct Column {
+            uint32 index;
+            DBTYPE type;
+            /// byte offset in the row data; for bools, bit of the value in the bit data
+            uint32 offset;
+            /// bit in the bit data set when the field is None
+            uint32 nullBit;
+        };
+
+        /// columns of 8 bits or more, widest first
+        std::vector<Column> fixed;
+        std::vector<Column> bools;
+        /// indexes of the columns marshaled as objects after the packed data (strings, buffers)
+        std::vector<uint32> objects;
+        /// bytes used by the fixed columns
+        size_t byteSize;
+        /// bytes used by the bool and null bits
+        size_t bitSize;
+    };
+
     // utility to handle Op_PyVarInteger (a bit hacky......)
     void SaveVarInteger( const PyLong* v );
-    // zero-compresses given buffer and adds it to the stream
-    bool SaveRLE(const Buffer& in );
+    // zero-compresses given data and adds it to the stream
+    bool SaveRLE( const uint8* in, size_t in_size );
+
+    /** @return layout of the rows of given descriptor; built on first use. */
+    const PackedRowLayout& GetPackedRowLayout( const DBRowDescriptor* header );
+    /** writes value unaligned into the packed row data */
+    template<typename T>
+    static void PutPacked( uint8* out, T value ) { ::memcpy( out, &value, sizeof( T ) ); }
 
     Buffer* mBuffer;
+
+    // packed row layouts, by descriptor
+    std::unordered_map<const DBRowDescriptor*, PackedRowLayout> mPackedLayouts;
+    // scratch space reused by every packed row
+    std::vector<uint8> mRowData;
+    std::vector<uint8> mRLEData;
+    std::vector<uint64_t> mZeroMask;
 };
 
 #endif
@@ -305,6 +305,9 @@ uint8 MarshalStringTable::LookupIndex( const char* str )
     StringTableMapConstItr res = mStringTableMap.find( hash( str ) );
     if( mStringTableMap.end() == res )
         return STRING_TABLE_ERROR;
+    // a djb2 hit alone may be a collision
+    if( strcmp( str, LookupString( res->second ) ) != 0 )
+        return STRING_TABLE_ERROR;
 
     return res->second;
 }
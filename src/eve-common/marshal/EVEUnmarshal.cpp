@@ -34,9 +34,16 @@
 #include "marshal/EVEMarshalStringTable.h"
 
 #include "utils/EVEUtils.h"
+#include "utils/Metrics.h"
+
+/** longest string we look for in the PyString intern pool before allocating it */
+static const uint32 MAX_INTERNED_LOOKUP_LENGTH = 64;
 
 PyRep* Unmarshal( const Buffer& data )
 {
+    static MetricCounter& bytes = sMetrics.GetCounter( "evemu_unmarshal_bytes_total", "Bytes read by Unmarshal(), nested substreams included." );
+    bytes.Inc( data.size() );
+
     UnmarshalStream* pUMS = new UnmarshalStream();
     PyRep* res = pUMS->Load( data );
     SafeDelete(pUMS);
@@ -265,6 +272,14 @@ PyRep* UnmarshalStream::LoadStringLong()
     const uint32 len = ReadSizeEx();
     const Buffer::const_iterator<char> str = Read<char>( len );
 
+    // identifiers (method, column and type names) are likely interned already
+    if( ( len > 1 ) and ( len <= MAX_INTERNED_LOOKUP_LENGTH ) )
+    {
+        PyString* interned = PyString::Lookup( &*str, len );
+        if( NULL != interned )
+            return interned;
+    }
+
     return new PyString( str, str + len );
 }
 
@@ -272,7 +287,7 @@ PyRep* UnmarshalStream::LoadStringTable()
 {
     const uint8 index = Read<uint8>();
 
-    const char* str = sMarshalStringTable.LookupString( index );
+    PyString* str = PyString::FromStringTable( index );
     if( NULL == str )
     {
         assert( false );
@@ -283,7 +298,7 @@ PyRep* UnmarshalStream::LoadStringTable()
         return new PyString( ebuf );
     }
     else
-        return new PyString( str );
+        return str;
 }
 
 PyRep* UnmarshalStream::LoadWStringUCS2Char()
@@ -49,6 +49,7 @@ EVEClientSession::~EVEClientSession() {
 
 void EVEClientSession::Reset() {
     mPacketHandler = nullptr;
+    mNet->SetDecodePackets(false);
 
     if (GetState() != TCPConnection::STATE_CONNECTED)
         // Connection has been lost, there's no point in reset
@@ -63,7 +64,7 @@ void EVEClientSession::Reset() {
     mPacketHandler = &EVEClientSession::_HandleVersion;
 }
 
-void EVEClientSession::QueuePacket(PyPacket* packet) {
+void EVEClientSession::QueuePacket(PyPacket* packet, uint8 sendClass/*EVETCPConnection::SEND_CALL*/, uint8 sendFlags/*0*/) {
     if (packet == nullptr)
         return;
 
@@ -74,11 +75,14 @@ void EVEClientSession::QueuePacket(PyPacket* packet) {
         return;
     }
 
-    mNet->QueueRep(res);
+    mNet->QueueRep(res, true, sendClass, sendFlags);
 }
 
 PyPacket* EVEClientSession::PopPacket() {
-    PyRep* rep(mNet->PopRep());
+    PyRep* rep(nullptr);
+    PyPacket* packet(mNet->PopPacket(rep));
+    if (packet != nullptr)
+        return packet;
     if (rep == nullptr)
         return nullptr;
 
@@ -173,12 +177,19 @@ PyPacket* EVEClientSession::_HandleAuthentication(PyRep* rep) {
     return PopPacket();
 }
 
+void EVEClientSession::_LoginVerified() {
+    if (mPacketHandler == &EVEClientSession::_HandleAuthentication)
+        mPacketHandler = &EVEClientSession::_HandleFuncResult;
+}
+
 PyPacket* EVEClientSession::_HandleFuncResult(PyRep* rep) {
     CryptoHandshakeResult hr;
     if (!hr.Decode(&rep)) {
         sLog.Error("_HandleFuncResult", "%s: Received invalid crypto handshake result!", GetAddress().c_str());
     } else if (_VerifyFuncResult(hr)) {
         mPacketHandler = &EVEClientSession::_HandlePacket;
+        // handshake is done; everything from here on is a PyPacket, so let the connection thread decode them
+        mNet->SetDecodePackets(true);
     }
 
     //PySafeDecRef(rep);
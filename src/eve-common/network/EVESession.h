@@ -76,9 +76,11 @@ public:
     /**
      * @brief Queues new packet, retaking ownership.
      *
-     * @param[in] p Packed to be queued.
+     * @param[in] p         Packed to be queued.
+     * @param[in] sendClass EVETCPConnection::SendClass to send it in.
+     * @param[in] sendFlags EVETCPConnection::SendFlags for it.
      */
-    void QueuePacket( PyPacket* packet );
+    void QueuePacket( PyPacket* packet, uint8 sendClass = EVETCPConnection::SEND_CALL, uint8 sendFlags = 0 );
 
     /**
      * @brief Pops new packet from queue.
@@ -138,9 +140,17 @@ protected:
      * @param[in] ccp Login data sent by client.
      *
      * @retval true  Verification succeeded; proceeds to next state.
-     * @retval false Verification failed; stays in current state.
+     * @retval false Verification failed or still pending; stays in current state.
+     *
+     * @note Verification may finish later (off the calling thread); call _LoginVerified() when it succeeds.
      */
     virtual bool _VerifyLogin( CryptoChallengePacket& ccp ) = 0;
+    /**
+     * @brief Completes a login verification that _VerifyLogin left pending.
+     *
+     * Proceeds to next state, same as _VerifyLogin returning true.
+     */
+    void _LoginVerified();
     /**
      * @brief Verifies function result.
      *
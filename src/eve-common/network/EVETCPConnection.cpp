@@ -28,26 +28,74 @@
 #include "marshal/EVEMarshal.h"
 #include "marshal/EVEUnmarshal.h"
 #include "network/EVETCPConnection.h"
+#include "network/PacketLog.h"
+#include "python/PyPacket.h"
+#include "python/PyRep.h"
+#include "threading/WakeEvent.h"
 
 /*************************************************************************/
 /* EVETCPConnection                                                      */
 /*************************************************************************/
 const uint32 EVETCPConnection::TIMEOUT_MS = 10 * 60 * 1000; // 10 minutes
 const uint32 EVETCPConnection::PACKET_SIZE_LIMIT = 1024 * 1024; // 1 megabyte
+const uint32 EVETCPConnection::INQUEUE_SIZE = 256;
+const uint32 EVETCPConnection::SEND_WINDOW = 256 * 1024;
+const uint32 EVETCPConnection::SEND_BUDGET[ SEND_CLASS_COUNT ] = {
+    2 * 1024 * 1024,    // SEND_CALL
+    512 * 1024,         // SEND_DESTINY
+    1024 * 1024,        // SEND_NOTIFY
+    8 * 1024 * 1024     // SEND_BULK
+};
+const uint32 EVETCPConnection::SEND_BULK_SIZE = 64 * 1024;
+const uint32 EVETCPConnection::SEND_HARD_LIMIT = 16 * 1024 * 1024;
 
 EVETCPConnection::EVETCPConnection()
 : TCPConnection(),
-  mTimeoutTimer( TIMEOUT_MS )
+  mTimeoutTimer( TIMEOUT_MS ),
+  mInQueue( INQUEUE_SIZE ),
+  mDecodePackets( false ),
+  mPacketLog( nullptr ),
+  mOrderStaged( 0 ),
+  mOrderSent( 0 ),
+  mDroppedBytes( 0 )
 {
+    for (uint8 i = 0; i < SEND_CLASS_COUNT; ++i)
+        mStagedBytes[ i ] = 0;
 }
 
 EVETCPConnection::EVETCPConnection( Socket* sock, uint32 rIP, uint16 rPort )
 : TCPConnection( sock, rIP, rPort ),
-  mTimeoutTimer( TIMEOUT_MS )
+  mTimeoutTimer( TIMEOUT_MS ),
+  mInQueue( INQUEUE_SIZE ),
+  mDecodePackets( false ),
+  mPacketLog( nullptr ),
+  mOrderStaged( 0 ),
+  mOrderSent( 0 ),
+  mDroppedBytes( 0 )
 {
+    for (uint8 i = 0; i < SEND_CLASS_COUNT; ++i)
+        mStagedBytes[ i ] = 0;
 }
 
-void EVETCPConnection::QueueRep( const PyRep* rep, bool compress/*true*/ )
+EVETCPConnection::~EVETCPConnection()
+{
+    // stop the connection thread here, while it still sees our overrides and members
+    Disconnect();
+    WaitLoop();
+
+    InPacket packet;
+    while (mInQueue.Pop( packet )) {
+        PySafeDecRef( packet.rep );
+        SafeDelete( packet.packet );
+    }
+
+    ClearStaged();
+
+    PacketLogWriter* log = mPacketLog.exchange( nullptr );
+    SafeDelete( log );
+}
+
+void EVETCPConnection::QueueRep( const PyRep* rep, bool compress/*true*/, uint8 sendClass/*SEND_CALL*/, uint8 sendFlags/*0*/ )
 {
     Buffer* pBuffer = new Buffer();
 
@@ -73,7 +121,14 @@ void EVETCPConnection::QueueRep( const PyRep* rep, bool compress/*true*/ )
        //     DumpBuffer( pBuffer, PACKET_OUTBOUND );
         // write length
         *bufLen = ( pBuffer->size() - sizeof( uint32 ) );
-        Send( &pBuffer );
+        PacketLogWriter* log = mPacketLog.load( std::memory_order_acquire );
+        if (log != nullptr)
+            log->Write( PacketLog::OUTBOUND, &( *pBuffer )[ sizeof( uint32 ) ], pBuffer->size() - sizeof( uint32 ) );
+        if ((sendClass == SEND_CALL) and (pBuffer->size() > SEND_BULK_SIZE))
+            sendClass = SEND_BULK;
+        StageBuffer( pBuffer, sendClass, sendFlags );
+        pBuffer = nullptr;
+        FlushSendQueue();
     } else {
         sLog.Error( "Network", "Failed to marshal new packet." );
     }
@@ -82,25 +137,122 @@ void EVETCPConnection::QueueRep( const PyRep* rep, bool compress/*true*/ )
     SafeDelete( pBuffer );
 }
 
-PyRep* EVETCPConnection::PopRep()
+void EVETCPConnection::StageBuffer( Buffer* buf, uint8 sendClass, uint8 sendFlags )
 {
-    PyRep* res(nullptr);
+    if (GetState() != STATE_CONNECTED) {
+        SafeDelete( buf );
+        return;
+    }
 
-    MutexLock lock( mMInQueue );
-    Buffer* packet = mInQueue.PopPacket();
+    // everything droppable still staged in this class is stale, as is an older superseding packet
+    if (sendFlags & SEND_FLAG_SUPERSEDE)
+        DropStaged( sendClass, 0, SEND_FLAG_DROPPABLE | SEND_FLAG_SUPERSEDE );
+
+    StagedBuffer staged;
+        staged.buf = buf;
+        staged.flags = sendFlags;
+        staged.order = 0;
+    if (sendFlags & SEND_FLAG_ORDERED)
+        staged.order = ++mOrderStaged;
+    mStaged[ sendClass ].push_back( staged );
+    mStagedBytes[ sendClass ] += buf->size();
+
+    // only droppable packets give way to the budget; ordered and other packets wait for the hard limit
+    if (mStagedBytes[ sendClass ] > SEND_BUDGET[ sendClass ])
+        DropStaged( sendClass, SEND_BUDGET[ sendClass ], SEND_FLAG_DROPPABLE );
+
+    // client isnt reading.  drop it rather than let its backlog grow
+    int64 backlog = GetStagedBytes() + GetSendQueueBytes();
+    if (backlog > SEND_HARD_LIMIT) {
+        sLog.Warning( "Network", "%s: Send backlog of %li bytes is over the %u byte limit.  Disconnecting.", GetAddress().c_str(), backlog, SEND_HARD_LIMIT );
+        ClearStaged();
+        Disconnect();
+    }
+}
 
-    if (packet != nullptr) {
-        if ( PACKET_SIZE_LIMIT < packet->size() ) {
-            sLog.Error( "Network", "Packet length %lu exceeds hardcoded packet length limit %u.", packet->size(), PACKET_SIZE_LIMIT );
-        } else {
-           // if (is_log_enabled(DEBUG__DEBUG))
-           //     DumpBuffer( packet, PACKET_INBOUND );
-            res = InflateUnmarshal( *packet );
+void EVETCPConnection::DropStaged( uint8 sendClass, uint32 budget, uint8 flags )
+{
+    std::deque<StagedBuffer>& queue = mStaged[ sendClass ];
+    std::deque<StagedBuffer>::iterator itr = queue.begin();
+    while ((itr != queue.end()) and (mStagedBytes[ sendClass ] > budget)) {
+        // an ordered packet may carry a sequence number the client counts on; never drop one
+        if (((itr->flags & flags) == 0) or (itr->flags & SEND_FLAG_ORDERED)) {
+            ++itr;
+            continue;
+        }
+        mStagedBytes[ sendClass ] -= itr->buf->size();
+        mDroppedBytes += itr->buf->size();
+        SafeDelete( itr->buf );
+        itr = queue.erase( itr );
+    }
+}
+
+void EVETCPConnection::FlushSendQueue()
+{
+    if (GetState() != STATE_CONNECTED) {
+        ClearStaged();
+        return;
+    }
+
+    int64 window = SEND_WINDOW - GetSendQueueBytes();
+    uint8 i = 0;
+    while ((i < SEND_CLASS_COUNT) and (window > 0)) {
+        std::deque<StagedBuffer>& queue = mStaged[ i ];
+        if (queue.empty()) {
+            ++i;
+            continue;
         }
+
+        StagedBuffer staged = queue.front();
+        if (staged.flags & SEND_FLAG_ORDERED) {
+            // an older ordered packet is still staged in a lower class; this class waits for it
+            if (staged.order != mOrderSent + 1) {
+                ++i;
+                continue;
+            }
+            ++mOrderSent;
+        }
+
+        queue.pop_front();
+        mStagedBytes[ i ] -= staged.buf->size();
+        window -= staged.buf->size();
+        Send( &staged.buf );
+
+        // a higher class may have been waiting on this one
+        if (staged.flags & SEND_FLAG_ORDERED)
+            i = 0;
+    }
+}
+
+uint32 EVETCPConnection::GetStagedBytes() const
+{
+    uint32 bytes(0);
+    for (uint8 i = 0; i < SEND_CLASS_COUNT; ++i)
+        bytes += mStagedBytes[ i ];
+    return bytes;
+}
+
+void EVETCPConnection::ClearStaged()
+{
+    for (uint8 i = 0; i < SEND_CLASS_COUNT; ++i) {
+        for (auto cur : mStaged[ i ])
+            SafeDelete( cur.buf );
+        mStaged[ i ].clear();
+        mStagedBytes[ i ] = 0;
+    }
+    mOrderStaged = mOrderSent = 0;
+}
+
+PyPacket* EVETCPConnection::PopPacket( PyRep*& rep )
+{
+    InPacket packet;
+    if (!mInQueue.Pop( packet )) {
+        rep = nullptr;
+        return nullptr;
     }
 
-    SafeDelete( packet );
-    return res;
+    rep = packet.rep;
+    return packet.packet;
 }
 
 bool EVETCPConnection::ProcessReceivedData( char* errbuf )
@@ -108,22 +260,73 @@ bool EVETCPConnection::ProcessReceivedData( char* errbuf )
     if (errbuf != nullptr)
         errbuf[0] = 0;
 
-    MutexLock lock( mMInQueue );
-
     // put bytes into packetizer
-    mInQueue.InputData( *mRecvBuf );
+    mPacketizer.InputData( *mRecvBuf );
     // process packetizer
-    mInQueue.Process();
+    mPacketizer.Process();
+    QueuePackets();
     mTimeoutTimer.Start();
 
     return true;
 }
 
+void EVETCPConnection::QueuePackets()
+{
+    // packets that dont fit stay in the packetizer until PopPacket() makes room
+    bool queued(false);
+    Buffer* buf(nullptr);
+    while (!mInQueue.Full() and ((buf = mPacketizer.PopPacket()) != nullptr)) {
+        InPacket packet;
+        packet.rep = nullptr;
+        packet.packet = nullptr;
+
+        if (PACKET_SIZE_LIMIT < buf->size()) {
+            sLog.Error( "Network", "Packet length %lu exceeds hardcoded packet length limit %u.", buf->size(), PACKET_SIZE_LIMIT );
+        } else {
+           // if (is_log_enabled(DEBUG__DEBUG))
+           //     DumpBuffer( buf, PACKET_INBOUND );
+            PacketLogWriter* log = mPacketLog.load( std::memory_order_acquire );
+            if ((log != nullptr) and (buf->size() > 0))
+                log->Write( PacketLog::INBOUND, &( *buf )[ 0 ], buf->size() );
+            packet.rep = InflateUnmarshal( *buf );
+        }
+        SafeDelete( buf );
+
+        if (packet.rep == nullptr)
+            continue;
+
+        if (mDecodePackets.load( std::memory_order_acquire )) {
+            if (is_log_enabled(NET__PRES_REP)) {
+                _log(NET__PRES_REP, "%s: Raw Rep Dump:", GetAddress().c_str());
+                packet.rep->Dump(NET__PRES_REP, "    ");
+            }
+
+            packet.packet = new PyPacket();
+            if (!packet.packet->Decode( &packet.rep )) { //rep is consumed here
+                sLog.Error( "Network", "%s: Failed to decode packet rep", GetAddress().c_str() );
+                SafeDelete( packet.packet );
+                continue;
+            }
+            packet.rep = nullptr;
+        }
+
+        mInQueue.Push( packet );
+        queued = true;
+    }
+
+    // one wakeup per read, not per packet
+    if (queued)
+        sMainLoopWake.Notify();
+}
+
 bool EVETCPConnection::RecvData( char* errbuf )
 {
     if( !TCPConnection::RecvData( errbuf ) )
         return false;
 
+    // retry anything held back by a full queue
+    QueuePackets();
+
     if( mTimeoutTimer.Check() ) {
         if (errbuf != nullptr)
             snprintf( errbuf, TCPCONN_ERRBUF_SIZE, "Connection timeout" );
@@ -137,8 +340,8 @@ void EVETCPConnection::ClearBuffers()
 {
     TCPConnection::ClearBuffers();
     mTimeoutTimer.Start();
-    MutexLock lock( mMInQueue );
-    mInQueue.ClearBuffers();
+    // mInQueue belongs to the reader; packets already in it are freed by PopPacket() or our destructor
+    mPacketizer.ClearBuffers();
 }
 
 void EVETCPConnection::DumpBuffer( Buffer* buf, packet_direction packet_direction)
@@ -27,7 +27,9 @@
 #define __NETWORK__EVE_TCP_CONNECTION_H__INCL__
 
 class PyRep;
+class PyPacket;
 class EVETCPServer;
+class PacketLogWriter;
 
 /**
  * @brief EVE derivation of TCP connection.
@@ -44,27 +46,109 @@ public:
     static const uint32 TIMEOUT_MS;
     /// Hardcoded limit of packet size (NetClient.dll).
     static const uint32 PACKET_SIZE_LIMIT;
+    /// Number of received packets waiting for PopRep() before the connection thread holds off.
+    static const uint32 INQUEUE_SIZE;
+
+    /**
+     * @brief Outgoing packet classes, highest priority first.
+     *
+     * Each class is staged in its own queue with its own byte budget.
+     * FlushSendQueue() hands staged packets to the socket queue in class
+     * order, only while less than SEND_WINDOW bytes are waiting there, so
+     * a slow client backs up here, where stale packets can still be dropped.
+     * Packets marked SEND_FLAG_ORDERED keep the order they were staged in,
+     * across classes.
+     */
+    enum SendClass
+    {
+        SEND_CALL,      ///< call replies, exceptions, session changes, handshake.
+        SEND_DESTINY,   ///< destiny updates and events.
+        SEND_NOTIFY,    ///< chat and other notifications.
+        SEND_BULK,      ///< cached objects and other large call replies.
+        SEND_CLASS_COUNT
+    };
+    /// Flags for QueueRep()
+    enum SendFlags
+    {
+        SEND_FLAG_DROPPABLE = 0x01, ///< may be dropped while staged, when over budget or superseded.
+        SEND_FLAG_SUPERSEDE = 0x02, ///< drops droppable and older superseding packets still staged in the same class (ie. SetState).
+        SEND_FLAG_ORDERED   = 0x04  ///< sent after every ordered packet staged before it, whatever its class, and never dropped (ie. sequenced notifications, session changes).
+    };
+    /// Bytes allowed in the socket queue before packets are held in the class queues.
+    static const uint32 SEND_WINDOW;
+    /// Per-class staging budget, in bytes.  droppable packets are dropped oldest first past this.
+    static const uint32 SEND_BUDGET[ SEND_CLASS_COUNT ];
+    /// Call replies bigger than this go in SEND_BULK.
+    static const uint32 SEND_BULK_SIZE;
+    /// Staged plus socket-queued bytes past which the connection is dropped.
+    static const uint32 SEND_HARD_LIMIT;
 
     /**
      * @brief Creates empty EVE connection.
      */
     EVETCPConnection();
-    virtual ~EVETCPConnection()                         { /* do nothing here */ }
+    /**
+     * @brief Stops connection thread and frees unread packets.
+     */
+    virtual ~EVETCPConnection();
 
     /**
      * @brief Queues given PyRep into send queue.
      *
-     * @param[in] rep PyRep to be queued.
+     * Must only be called from one thread (the main loop).
+     *
+     * @param[in] rep       PyRep to be queued.
+     * @param[in] compress  Deflate large packets.
+     * @param[in] sendClass SendClass to stage the packet in.
+     * @param[in] sendFlags SendFlags for the packet.
      */
     // consumes PyRep
-    void QueueRep( const PyRep* rep, bool compress=true );
+    void QueueRep( const PyRep* rep, bool compress=true, uint8 sendClass=SEND_CALL, uint8 sendFlags=0 );
+    /**
+     * @brief Moves staged packets to the socket queue as the send window allows.
+     *
+     * Called from QueueRep(), and should be called every tick so staged
+     * packets keep going out while nothing new is queued.  Main loop only.
+     */
+    void FlushSendQueue();
+
+    /** @return Bytes staged in the class queues. */
+    uint32 GetStagedBytes() const;
+    /** @return Bytes staged in one class queue. */
+    uint32 GetStagedBytes( uint8 sendClass ) const { return mStagedBytes[ sendClass ]; }
+    /** @return Bytes of droppable packets dropped so far. */
+    int64 GetDroppedBytes() const { return mDroppedBytes; }
 
     /**
-     * @brief Pops PyRep from receive queue.
+     * @brief Pops next received packet.
+     *
+     * Packets are inflated and unmarshaled on the connection thread, and
+     * decoded into PyPacket there too once SetDecodePackets(true) is called.
+     * Must only be called from one thread (the main loop).
      *
-     * @return Popped PyRep; NULL if nothing was received.
+     * @param[out] rep Unmarshaled PyRep, when the packet wasnt decoded; NULL otherwise.
+     *
+     * @return Decoded packet; NULL if not decoded (see rep) or nothing was received.
+     */
+    PyPacket* PopPacket( PyRep*& rep );
+
+    /**
+     * @brief Sets whether the connection thread decodes received reps into PyPacket.
+     *
+     * Set once the session is past its handshake; before that reps are
+     * handed over as they are.
      */
-    PyRep* PopRep();
+    void SetDecodePackets( bool decode ) { mDecodePackets.store( decode, std::memory_order_release ); }
+
+    /**
+     * @brief Starts recording packets in both directions to log.
+     *
+     * Inbound packets are written by the connection thread as they are
+     * received, outbound ones by QueueRep().  Set once, by the main loop.
+     *
+     * @param[in] log Opened log; the connection takes ownership.
+     */
+    void SetPacketLog( PacketLogWriter* log ) { mPacketLog.store( log, std::memory_order_release ); }
 
     /**
      * @brief Dumps buffer to file
@@ -91,16 +175,52 @@ protected:
 
     bool RecvData( char* errbuf = 0 );
     bool ProcessReceivedData( char* errbuf = 0 );
+    /// Unmarshals (and decodes) complete packets from the packetizer into mInQueue, as room allows.
+    void QueuePackets();
+
+    /// Adds buf to its class queue, applying SendFlags, the class budget and the hard limit.
+    void StageBuffer( Buffer* buf, uint8 sendClass, uint8 sendFlags );
+    /// Drops unordered packets in a class with any of 'flags' set, oldest first, until the class is at or under 'budget' bytes.
+    void DropStaged( uint8 sendClass, uint32 budget, uint8 flags );
+    /// Frees everything staged.
+    void ClearStaged();
 
     void ClearBuffers();
 
     /// Timer used to implement timeout.
     Timer mTimeoutTimer;
 
-    /// Mutex to protect received data queue.
-    Mutex mMInQueue;
-    /// Received data queue.
-    StreamPacketizer mInQueue;
+    /// Splits received data into packets; connection thread only.
+    StreamPacketizer mPacketizer;
+    /**
+     * received packet, as handed to the main loop.
+     *  the reps (and packet) are built and only touched by the connection thread until pushed,
+     *  and only by the main loop after it pops them.  the queue's acquire/release is the handover,
+     *  so PyRep refcounts dont need to be atomic.
+     */
+    struct InPacket {
+        PyRep* rep;
+        PyPacket* packet;
+    };
+    /// Received packets; connection thread pushes, PopPacket() pops.
+    SPSCQueue<InPacket> mInQueue;
+    /// Decode packets on the connection thread.
+    std::atomic<bool> mDecodePackets;
+    /// Session recording, if any; see SetPacketLog().
+    std::atomic<PacketLogWriter*> mPacketLog;
+
+    struct StagedBuffer {
+        Buffer* buf;
+        uint8 flags;
+        uint32 order;   ///< place among ordered packets; 0 if not SEND_FLAG_ORDERED.
+    };
+    /// Outgoing packets waiting for the send window, per SendClass; main loop only.
+    std::deque<StagedBuffer> mStaged[ SEND_CLASS_COUNT ];
+    uint32 mStagedBytes[ SEND_CLASS_COUNT ];
+    /// Last order given to an ordered packet, and last one sent.
+    uint32 mOrderStaged;
+    uint32 mOrderSent;
+    int64 mDroppedBytes;
 };
 
 #endif /* !__NETWORK__EVE_TCP_CONNECTION_H__INCL__ */
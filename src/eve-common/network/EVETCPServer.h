@@ -27,6 +27,7 @@
 #define EVETCPSERVER_H_
 
 #include "network/EVETCPConnection.h"
+#include "threading/WakeEvent.h"
 
 /**
  * @brief EVE derivation of TCP server.
@@ -39,6 +40,7 @@ protected:
     virtual void CreateNewConnection( Socket* sock, uint32 rIP, uint16 rPort )
     {
         AddConnection( new EVETCPConnection( sock, rIP, rPort ) );
+        sMainLoopWake.Notify();
     }
 };
 #endif /*EVETCPSERVER_H_*/
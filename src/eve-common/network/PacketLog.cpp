@@ -0,0 +1,159 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-common.h"
+
+#include "network/PacketLog.h"
+
+/*************************************************************************/
+/* PacketLogWriter                                                       */
+/*************************************************************************/
+PacketLogWriter::PacketLogWriter()
+: mFile( nullptr )
+{
+}
+
+PacketLogWriter::~PacketLogWriter()
+{
+    Close();
+}
+
+bool PacketLogWriter::Open( const char* filename )
+{
+    MutexLock lock( mMutex );
+    if (mFile != nullptr)
+        return false;
+
+    mFile = fopen( filename, "wb" );
+    if (mFile == nullptr) {
+        sLog.Error( "PacketLog", "Unable to open '%s' for writing.", filename );
+        return false;
+    }
+
+    const uint32 magic = PacketLog::MAGIC;
+    const uint16 version = PacketLog::VERSION;
+    const int64 startTime = Win32TimeNow();
+    fwrite( &magic, sizeof( magic ), 1, mFile );
+    fwrite( &version, sizeof( version ), 1, mFile );
+    fwrite( &startTime, sizeof( startTime ), 1, mFile );
+
+    mStart = std::chrono::steady_clock::now();
+    return true;
+}
+
+void PacketLogWriter::Close()
+{
+    MutexLock lock( mMutex );
+    if (mFile == nullptr)
+        return;
+
+    fclose( mFile );
+    mFile = nullptr;
+}
+
+void PacketLogWriter::Write( uint8 direction, const uint8* data, uint32 length )
+{
+    const int64 time = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - mStart ).count();
+
+    MutexLock lock( mMutex );
+    if (mFile == nullptr)
+        return;
+
+    fwrite( &time, sizeof( time ), 1, mFile );
+    fwrite( &direction, sizeof( direction ), 1, mFile );
+    fwrite( &length, sizeof( length ), 1, mFile );
+    if (fwrite( data, 1, length, mFile ) != length) {
+        // disk full or the like; dont leave a half-written log growing
+        sLog.Error( "PacketLog", "Write failed; closing log." );
+        fclose( mFile );
+        mFile = nullptr;
+    }
+}
+
+/*************************************************************************/
+/* PacketLogReader                                                       */
+/*************************************************************************/
+PacketLogReader::PacketLogReader()
+: mFile( nullptr ),
+  mStartTime( 0 )
+{
+}
+
+PacketLogReader::~PacketLogReader()
+{
+    Close();
+}
+
+bool PacketLogReader::Open( const char* filename )
+{
+    Close();
+
+    mFile = fopen( filename, "rb" );
+    if (mFile == nullptr) {
+        sLog.Error( "PacketLog", "Unable to open '%s'.", filename );
+        return false;
+    }
+
+    uint32 magic(0);
+    uint16 version(0);
+    if ((fread( &magic, sizeof( magic ), 1, mFile ) != 1)
+    or  (fread( &version, sizeof( version ), 1, mFile ) != 1)
+    or  (fread( &mStartTime, sizeof( mStartTime ), 1, mFile ) != 1)
+    or  (magic != PacketLog::MAGIC) or (version != PacketLog::VERSION))
+    {
+        sLog.Error( "PacketLog", "'%s' is not a packet log (or is of another version).", filename );
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void PacketLogReader::Close()
+{
+    if (mFile == nullptr)
+        return;
+
+    fclose( mFile );
+    mFile = nullptr;
+}
+
+bool PacketLogReader::Read( PacketLog::Record& into )
+{
+    if (mFile == nullptr)
+        return false;
+
+    uint32 length(0);
+    if ((fread( &into.time, sizeof( into.time ), 1, mFile ) != 1)
+    or  (fread( &into.direction, sizeof( into.direction ), 1, mFile ) != 1)
+    or  (fread( &length, sizeof( length ), 1, mFile ) != 1))
+        return false;
+
+    into.data.Resize<uint8>( length );
+    if ((length > 0) and (fread( &into.data[ 0 ], 1, length, mFile ) != length))
+        return false;
+
+    return true;
+}
@@ -0,0 +1,115 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#ifndef __NETWORK__PACKET_LOG_H__INCL__
+#define __NETWORK__PACKET_LOG_H__INCL__
+
+#include <chrono>
+
+#include "threading/Mutex.h"
+#include "utils/Buffer.h"
+
+/**
+ * @brief Recorded session packets, for replay.
+ *
+ * File layout (little endian):
+ *  header: uint32 magic, uint16 version, int64 start time (Win32 filetime)
+ *  record: int64 time (us since start), uint8 direction, uint32 length, packet
+ *
+ * Packets are stored as they went over the wire, minus the length
+ * prefix; ie. marshaled and maybe deflated.  InflateUnmarshal() reads them.
+ */
+namespace PacketLog {
+    static const uint32 MAGIC = 0x4C504B45;     // "EKPL"
+    static const uint16 VERSION = 1;
+
+    enum Direction {
+        INBOUND  = 0,   ///< client to server
+        OUTBOUND = 1    ///< server to client
+    };
+
+    struct Record {
+        int64 time;
+        uint8 direction;
+        Buffer data;
+    };
+}
+
+/**
+ * @brief Writes a packet log.
+ *
+ * Thread safe; the connection thread writes inbound packets while the
+ * main loop writes outbound ones.
+ */
+class PacketLogWriter
+{
+public:
+    PacketLogWriter();
+    ~PacketLogWriter();
+
+    bool Open( const char* filename );
+    void Close();
+
+    /**
+     * @param[in] direction PacketLog::Direction
+     * @param[in] data      Packet as sent, without the length prefix.
+     * @param[in] length    Length of data.
+     */
+    void Write( uint8 direction, const uint8* data, uint32 length );
+
+protected:
+    Mutex mMutex;
+    FILE* mFile;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+/**
+ * @brief Reads a packet log written by PacketLogWriter.
+ */
+class PacketLogReader
+{
+public:
+    PacketLogReader();
+    ~PacketLogReader();
+
+    bool Open( const char* filename );
+    void Close();
+
+    /**
+     * @brief Reads next record.
+     *
+     * @return false at end of log, or if the log is truncated.
+     */
+    bool Read( PacketLog::Record& into );
+
+    /** @return Time the log was started, as Win32 filetime. */
+    int64 GetStartTime() const { return mStartTime; }
+
+protected:
+    FILE* mFile;
+    int64 mStartTime;
+};
+
+#endif /* !__NETWORK__PACKET_LOG_H__INCL__ */
@@ -83,11 +83,11 @@ PyPacket *PyPacket::Clone() const
         res->source = source;
         res->dest = dest;
         res->userid = userid;
-        res->payload = payload->Clone()->AsTuple();
-    if (named_payload == nullptr)
-        res->named_payload = nullptr;
-    else
-        res->named_payload = named_payload->Clone()->AsDict();
+    // payloads are shared; MakeMutable() them before changing
+        res->payload = payload;
+        res->named_payload = named_payload;
+    PySafeIncRef( payload );
+    PySafeIncRef( named_payload );
     return res;
 }
 
@@ -567,11 +567,11 @@ PyCallStream *PyCallStream::Clone() const {
     res->remoteObject = remoteObject;
     res->remoteObjectStr = remoteObjectStr;
     res->method = method;
-    res->arg_tuple = arg_tuple->Clone()->AsTuple();
-    if (arg_dict == nullptr)
-        res->arg_dict = nullptr;
-    else
-        res->arg_dict = arg_dict->Clone()->AsDict();
+    // args are shared; MakeMutable() them before changing
+    res->arg_tuple = arg_tuple;
+    res->arg_dict = arg_dict;
+    PySafeIncRef( arg_tuple );
+    PySafeIncRef( arg_dict );
 
     return res;
 }
@@ -803,7 +803,9 @@ EVENotificationStream::~EVENotificationStream() {
 
 EVENotificationStream *EVENotificationStream::Clone() const {
     EVENotificationStream *res = new EVENotificationStream();
-    res->args = args->Clone()->AsTuple();
+    // args are shared; MakeMutable() them before changing
+    res->args = args;
+    PySafeIncRef( args );
     return res;
 }
 
@@ -26,7 +26,11 @@
 
 #include "../../eve-common/eve-common.h"
 
+#include <shared_mutex>
+#include <string_view>
+
 #include "marshal/EVEMarshal.h"
+#include "marshal/EVEMarshalStringTable.h"
 #include "marshal/EVEUnmarshal.h"
 //#include "marshal/EVEMarshalOpcodes.h"
 #include "python/classes/PyDatabase.h"
@@ -34,6 +38,7 @@
 #include "python/PyVisitor.h"
 #include "python/PyRep.h"
 #include "utils/EVEUtils.h"
+#include "utils/Metrics.h"
 
 /** Lookup table for PyRep type object type names. */
 const char* const s_mTypeString[] =
@@ -60,6 +65,9 @@ const char* const s_mTypeString[] =
     "Invalid Type"      //19
 };
 
+/** Live objects per PyType; relaxed atomics, as unmarshal runs on the connection threads too. */
+static std::atomic<int64> s_mLiveCount[ PyRep::PyTypeError + 1 ];
+
 /** @todo  this entire class should be better thought-out for class d'tors and object lifetime
  *         however, i dont fully understand it enough to implement better memMgmt at this time
  *              -allan 10Jan19
@@ -70,15 +78,32 @@ const char* const s_mTypeString[] =
 /************************************************************************/
 /* PyRep base Class                                                     */
 /************************************************************************/
-PyRep::PyRep(PyType t) : RefObject(1), mType( t ) { }
+PyRep::PyRep(PyType t) : RefObject(1), mType( t )
+{
+    s_mLiveCount[ mType ].fetch_add( 1, std::memory_order_relaxed );
+}
 
 PyRep::PyRep(const PyRep& oth) : RefObject(1), mType(oth.mType)
 {
     //sLog.Cyan("PyRep()", "Copy C'tor.");
+    s_mLiveCount[ mType ].fetch_add( 1, std::memory_order_relaxed );
 }
 PyRep::~PyRep()
 {
     //sLog.Error("PyRep()", "D'tor. count: %u", GetCount());
+    s_mLiveCount[ mType ].fetch_sub( 1, std::memory_order_relaxed );
+}
+
+int64 PyRep::GetLiveCount( PyType type )
+{
+    return s_mLiveCount[ type ].load( std::memory_order_relaxed );
+}
+
+void PyRep::RegisterMetrics()
+{
+    for (uint8 type = PyTypeInt; type < PyTypeError; ++type)
+        sMetrics.AddGaugeFunc( "evemu_pyrep_live", "Live PyRep objects, by type.", {{"type", s_mTypeString[ type ]}},
+                               std::bind( &PyRep::GetLiveCount, (PyType)type ) );
 }
 
 const char* PyRep::TypeString() const
@@ -492,24 +517,25 @@ size_t PyBuffer::size() const
 /* PyString                                                             */
 /************************************************************************/
 PyString::PyString( const char* str )
-: PyRep( PyRep::PyTypeString ), mValue( str ), mHashCache( -1 ) {}
+: PyRep( PyRep::PyTypeString ), mValue( str ), mHashCache( -1 ), mInterned( false ), mTableIndex( 0 ) {}
 PyString::PyString( const char* str, size_t len )
-: PyRep( PyRep::PyTypeString ), mValue( str, len ), mHashCache( -1 ) {}
+: PyRep( PyRep::PyTypeString ), mValue( str, len ), mHashCache( -1 ), mInterned( false ), mTableIndex( 0 ) {}
 PyString::PyString( const std::string& str )
-: PyRep( PyRep::PyTypeString ), mValue( str ), mHashCache( -1 ) {}
+: PyRep( PyRep::PyTypeString ), mValue( str ), mHashCache( -1 ), mInterned( false ), mTableIndex( 0 ) {}
 
 PyString::PyString( const PyBuffer& buf )
-: PyRep( PyRep::PyTypeString ), mValue( (const char *) &buf.content()[0], buf.content().size() ), mHashCache( -1 )
+: PyRep( PyRep::PyTypeString ), mValue( (const char *) &buf.content()[0], buf.content().size() ), mHashCache( -1 ),
+  mInterned( false ), mTableIndex( 0 )
 {
     //sLog.Cyan("PyString(PyBuffer)", "Copy C'tor.");
 }
 PyString::PyString( const PyToken& token )
-: PyRep( PyRep::PyTypeString ), mValue( token.content() ), mHashCache( -1 )
+: PyRep( PyRep::PyTypeString ), mValue( token.content() ), mHashCache( -1 ), mInterned( false ), mTableIndex( 0 )
 {
     //sLog.Cyan("PyString(PyToken)", "Copy C'tor.");
 }
 PyString::PyString( const PyString& oth )
-: PyRep( PyRep::PyTypeString ), mValue( oth.mValue ), mHashCache( oth.mHashCache )
+: PyRep( PyRep::PyTypeString ), mValue( oth.mValue ), mHashCache( oth.mHashCache ), mInterned( false ), mTableIndex( oth.mTableIndex )
 {
     //sLog.Cyan("PyString(PyString)", "Copy C'tor.");
 }
@@ -517,6 +543,9 @@ PyString::PyString( const PyString& oth )
 PyRep* PyString::Clone() const
 {
     //sLog.Magenta("PyString()", "Clone.");
+    // interned strings are immutable and never freed; no need for a copy
+    if (mInterned)
+        return const_cast<PyString*>( this );
     return new PyString(*this);
 }
 
@@ -539,6 +568,100 @@ int32 PyString::hash() const
     return mHashCache;
 }
 
+/**
+ * @brief Process-wide pool behind PyString::Intern().
+ *
+ * Seeded with the marshal string table, so table strings keep their index.
+ * Strings are only ever added, so lookups only need a shared lock.
+ */
+class PyString::Pool
+{
+public:
+    static Pool& get()
+    {
+        static Pool pool;
+        return pool;
+    }
+
+    PyString* Find( std::string_view str )
+    {
+        std::shared_lock<std::shared_mutex> lock( mMutex );
+        StringMap::const_iterator itr = mStrings.find( str );
+        if (itr == mStrings.end())
+            return nullptr;
+        return itr->second;
+    }
+
+    PyString* Add( std::string_view str )
+    {
+        PyString* res( Find( str ) );
+        if (res != nullptr)
+            return res;
+
+        std::unique_lock<std::shared_mutex> lock( mMutex );
+        // somebody may have beaten us to it
+        StringMap::const_iterator itr = mStrings.find( str );
+        if (itr != mStrings.end())
+            return itr->second;
+
+        return _Add( new PyString( str.data(), str.size() ), STRING_TABLE_ERROR );
+    }
+
+    PyString* FromStringTable( uint8 index ) const
+    {
+        if ((index == STRING_TABLE_ERROR) or (index >= mTable.size()))
+            return nullptr;
+        return mTable[ index ];
+    }
+
+private:
+    Pool()
+    : mTable( 1, nullptr )
+    {
+        const char* str(nullptr);
+        for (uint8 i = 1; ( str = sMarshalStringTable.LookupString( i ) ) != nullptr; ++i)
+            mTable.push_back( _Add( new PyString( str ), i ) );
+    }
+
+    PyString* _Add( PyString* str, uint8 index )
+    {
+        str->hash();
+        str->mInterned = true;
+        str->mTableIndex = index;
+        str->Pin();
+        // key views the pinned string's own content
+        mStrings.emplace( str->content(), str );
+        return str;
+    }
+
+    typedef std::unordered_map<std::string_view, PyString*> StringMap;
+
+    std::shared_mutex mMutex;
+    StringMap mStrings;
+    /** interned string table items, by index; slot 0 is unused */
+    std::vector<PyString*> mTable;
+};
+
+PyString* PyString::Intern( const char* str )
+{
+    return Pool::get().Add( str );
+}
+
+PyString* PyString::Intern( const std::string& str )
+{
+    return Pool::get().Add( str );
+}
+
+PyString* PyString::Lookup( const char* str, size_t len )
+{
+    return Pool::get().Find( std::string_view( str, len ) );
+}
+
+PyString* PyString::FromStringTable( uint8 index )
+{
+    return Pool::get().FromStringTable( index );
+}
+
 /************************************************************************/
 /* PyWString                                                            */
 /************************************************************************/
@@ -621,6 +744,9 @@ bool PyToken::visit( PyVisitor& v ) const
 PyTuple::PyTuple( size_t item_count ) : PyRep( PyRep::PyTypeTuple ), items( item_count, nullptr ) {}
 PyTuple::PyTuple( const PyTuple& oth ) : PyRep( PyRep::PyTypeTuple ), items(oth.items)
 {
+    // items are shared with oth
+    for (PyRep* cur : items)
+        PySafeIncRef( cur );
     //sLog.Cyan("PyTuple()", "Copy C'tor.");
 }
 
@@ -630,6 +756,16 @@ PyRep* PyTuple::Clone() const
     return new PyTuple( *this );
 }
 
+PyTuple* PyTuple::MakeMutable()
+{
+    if (GetCount() < 2)
+        return this;
+
+    PyTuple* res = new PyTuple( *this );
+    PyDecRef( this );
+    return res;
+}
+
 bool PyTuple::visit( PyVisitor& v ) const
 {
     return v.VisitTuple( this );
@@ -689,6 +825,9 @@ int32 PyTuple::hash() const
 PyList::PyList(size_t item_count) : PyRep(PyRep::PyTypeList), items(item_count, nullptr) { }
 PyList::PyList(const PyList& oth) : PyRep(PyRep::PyTypeList), items(oth.items)
 {
+    // items are shared with oth
+    for (PyRep* cur : items)
+        PySafeIncRef( cur );
     //sLog.Cyan("PyList()", "Copy C'tor.");
 }
 
@@ -704,6 +843,16 @@ PyRep* PyList::Clone() const
     return new PyList(*this);
 }
 
+PyList* PyList::MakeMutable()
+{
+    if (GetCount() < 2)
+        return this;
+
+    PyList* res = new PyList( *this );
+    PyDecRef( this );
+    return res;
+}
+
 bool PyList::visit( PyVisitor& v ) const
 {
     return v.VisitList( this );
@@ -740,9 +889,235 @@ PyList& PyList::operator=( const PyList& oth )
 /************************************************************************/
 /* PyRep Dict Class                                                     */
 /************************************************************************/
+PyDict::Storage::Storage()
+: mEntries( mInline ),
+  mSize( 0 ),
+  mCapacity( InlineSize ),
+  mIndex( nullptr ),
+  mIndexMask( 0 )
+{
+}
+
+PyDict::Storage::Storage( const Storage& oth )
+: Storage()
+{
+    *this = oth;
+}
+
+PyDict::Storage& PyDict::Storage::operator=( const Storage& oth )
+{
+    if (this == &oth)
+        return *this;
+
+    clear();
+    reserve( oth.mSize );
+    std::copy( oth.begin(), oth.end(), mEntries );
+    mSize = oth.mSize;
+    if (mIndex != nullptr)
+        _reindex();
+
+    return *this;
+}
+
+PyDict::Storage::~Storage()
+{
+    clear();
+}
+
+void PyDict::Storage::clear()
+{
+    if (mEntries != mInline)
+        delete[] mEntries;
+    delete[] mIndex;
+
+    mEntries = mInline;
+    mSize = 0;
+    mCapacity = InlineSize;
+    mIndex = nullptr;
+    mIndexMask = 0;
+}
+
+void PyDict::Storage::reserve( size_t count )
+{
+    if (count <= mCapacity)
+        return;
+
+    size_t capacity = mCapacity;
+    while (capacity < count)
+        capacity *= 2;
+
+    Entry* entries = new Entry[ capacity ];
+    std::copy( begin(), end(), entries );
+    if (mEntries != mInline)
+        delete[] mEntries;
+    mEntries = entries;
+    mCapacity = capacity;
+
+    _reindex();
+}
+
+void PyDict::Storage::_grow()
+{
+    reserve( mCapacity * 2 );
+}
+
+void PyDict::Storage::_reindex()
+{
+    // at most 2/3 full
+    size_t slots = 1;
+    while (slots < mCapacity * 3 / 2)
+        slots *= 2;
+
+    if (slots != mIndexMask + 1) {
+        delete[] mIndex;
+        mIndex = new uint32[ slots ];
+        mIndexMask = slots - 1;
+    }
+    std::fill( mIndex, mIndex + slots, UINT32_MAX );
+
+    for (size_t i = 0; i < mSize; ++i) {
+        size_t perturb = (uint32)mEntries[ i ].hash;
+        size_t slot = perturb & mIndexMask;
+        while (mIndex[ slot ] != UINT32_MAX) {
+            perturb >>= 5;
+            slot = ( slot * 5 + perturb + 1 ) & mIndexMask;
+        }
+        mIndex[ slot ] = (uint32)i;
+    }
+}
+
+template<class Match>
+PyDict::Storage::iterator PyDict::Storage::_find( int32 hash, Match match ) const
+{
+    Entry* const last = mEntries + mSize;
+    if (mIndex == nullptr) {
+        for (Entry* cur = mEntries; cur != last; ++cur)
+            if ((cur->hash == hash) and match( cur->first ))
+                return cur;
+        return last;
+    }
+
+    // same probe sequence as _reindex()
+    size_t perturb = (uint32)hash;
+    size_t slot = perturb & mIndexMask;
+    while (mIndex[ slot ] != UINT32_MAX) {
+        Entry* cur = mEntries + mIndex[ slot ];
+        if ((cur->hash == hash) and match( cur->first ))
+            return cur;
+        perturb >>= 5;
+        slot = ( slot * 5 + perturb + 1 ) & mIndexMask;
+    }
+    return last;
+}
+
+PyDict::Storage::iterator PyDict::Storage::find( const PyRep* key, int32 hash ) const
+{
+    return _find( hash, [key]( const PyRep* cur ) { return PyDict::KeyEquals( cur, key ); } );
+}
+
+PyDict::Storage::iterator PyDict::Storage::find( const std::string& str, int32 hash ) const
+{
+    return _find( hash, [&str]( const PyRep* cur ) {
+        if (cur->IsString())
+            return cur->AsString()->content() == str;
+        if (cur->IsWString())
+            return cur->AsWString()->content() == str;
+        return false;
+    } );
+}
+
+void PyDict::Storage::insert( PyRep* key, PyRep* value, int32 hash )
+{
+    if (mSize == mCapacity)
+        _grow();
+
+    Entry& entry = mEntries[ mSize ];
+    entry.first = key;
+    entry.second = value;
+    entry.hash = hash;
+
+    if (mIndex != nullptr) {
+        size_t perturb = (uint32)hash;
+        size_t slot = perturb & mIndexMask;
+        while (mIndex[ slot ] != UINT32_MAX) {
+            perturb >>= 5;
+            slot = ( slot * 5 + perturb + 1 ) & mIndexMask;
+        }
+        mIndex[ slot ] = (uint32)mSize;
+    }
+
+    ++mSize;
+}
+
+bool PyDict::KeyEquals( const PyRep* key1, const PyRep* key2 )
+{
+    if (key1 == key2)
+        return true;
+    // the usual keys
+    if (key1->IsInt() and key2->IsInt())
+        return key1->AsInt()->value() == key2->AsInt()->value();
+    if (key1->IsString() and key2->IsString()) {
+        const PyString* str1(key1->AsString()), *str2(key2->AsString());
+        // interned strings are unique, so two of them only match by pointer
+        if (str1->IsInterned() and str2->IsInterned())
+            return false;
+        return str1->content() == str2->content();
+    }
+
+    switch (key1->GetType()) {
+        case PyTypeInt:
+        case PyTypeLong:
+        case PyTypeBool:
+        case PyTypeFloat: {
+            if (!key2->IsInt() and !key2->IsLong() and !key2->IsBool() and !key2->IsFloat())
+                return false;
+            if (key1->IsFloat() or key2->IsFloat())
+                return PyRep::FloatValue( const_cast<PyRep*>( key1 ) ) == PyRep::FloatValue( const_cast<PyRep*>( key2 ) );
+            return PyRep::IntegerValue( const_cast<PyRep*>( key1 ) ) == PyRep::IntegerValue( const_cast<PyRep*>( key2 ) );
+        }
+        case PyTypeString:
+        case PyTypeWString: {
+            const std::string& str1 = ( key1->IsString() ? key1->AsString()->content() : key1->AsWString()->content() );
+            if (key2->IsString())
+                return str1 == key2->AsString()->content();
+            if (key2->IsWString())
+                return str1 == key2->AsWString()->content();
+            return false;
+        }
+        case PyTypeBuffer: {
+            if (!key2->IsBuffer())
+                return false;
+            const Buffer& buf1 = key1->AsBuffer()->content();
+            const Buffer& buf2 = key2->AsBuffer()->content();
+            return (buf1.size() == buf2.size()) and std::equal( buf1.begin<uint8>(), buf1.end<uint8>(), buf2.begin<uint8>() );
+        }
+        case PyTypeTuple: {
+            if (!key2->IsTuple())
+                return false;
+            const PyTuple* tuple1 = key1->AsTuple();
+            const PyTuple* tuple2 = key2->AsTuple();
+            if (tuple1->size() != tuple2->size())
+                return false;
+            for (size_t i = 0; i < tuple1->size(); ++i)
+                if (!KeyEquals( tuple1->GetItem( i ), tuple2->GetItem( i ) ))
+                    return false;
+            return true;
+        }
+        case PyTypeNone:
+            return key2->IsNone();
+        default:
+            return false;
+    }
+}
+
 PyDict::PyDict() : PyRep( PyRep::PyTypeDict ), items() { }
 PyDict::PyDict( const PyDict& oth ) : PyRep( PyRep::PyTypeDict ), items(oth.items)
 {
+    // keys and values are shared with oth
+    for (iterator cur = items.begin(); cur != items.end(); ++cur) {
+        PyIncRef( cur->first );
+        PySafeIncRef( cur->second );
+    }
     //sLog.Cyan("PyDict()", "Copy C'tor.");
 }
 
@@ -762,6 +1137,16 @@ PyRep* PyDict::Clone() const
     return new PyDict(*this);
 }
 
+PyDict* PyDict::MakeMutable()
+{
+    if (GetCount() < 2)
+        return this;
+
+    PyDict* res = new PyDict( *this );
+    PyDecRef( this );
+    return res;
+}
+
 bool PyDict::visit( PyVisitor& v ) const
 {
     return v.VisitDict( this );
@@ -782,7 +1167,11 @@ PyRep* PyDict::GetItem( PyRep* key ) const
 {
     assert( key != nullptr );
 
-    const_iterator res = items.find( key );
+    int32 hash = key->hash();
+    if (hash == -1)
+        return nullptr;
+
+    const_iterator res = items.find( key, hash );
     if (res == items.end() )
         return nullptr;
 
@@ -793,11 +1182,15 @@ PyRep* PyDict::GetItemString( const char* key ) const
 {
     assert( key != nullptr );
 
-    PyString* str = new PyString( key );
-    PyRep* res = GetItem( str );
-    PyDecRef( str );
+    // same hash as PyString::hash(), without making one
+    std::string str( key );
+    int32 hash = ( str.empty() ? 0 : (int32)std::hash<std::string>{}( str ) );
 
-    return res;
+    const_iterator res = items.find( str, hash );
+    if (res == items.end() )
+        return nullptr;
+
+    return res->second;
 }
 
 void PyDict::SetItem( PyRep* key, PyRep* value )
@@ -808,14 +1201,15 @@ void PyDict::SetItem( PyRep* key, PyRep* value )
     /* note: add check if the key object is hashable
      * if not ( it will return -1 ) return false;
      */
-    if (key->hash() == -1)
+    int32 hash = key->hash();
+    if (hash == -1)
         return;
 
     /* check if we need to replace a dictionary entry */
-    iterator itr = items.find( key );
+    iterator itr = items.find( key, hash );
     if (itr == items.end()) {
-        // Keep both key & value  (make_pair makes copy of args passed)
-        items.insert( std::make_pair( key, value ) );
+        // Keep both key & value
+        items.insert( key, value, hash );
     } else {
         // We found 'key' in current dict, so use itr->first and decRef 'key'.
         // is this right?
@@ -853,10 +1247,13 @@ PyDict& PyDict::operator=( const PyDict& oth )
 PyObject::PyObject( PyString* type, PyRep* args )
 : PyRep(PyRep::PyTypeObject), mType(type), mArguments(args) { }
 PyObject::PyObject(const char* type, PyRep* args )
-: PyRep(PyRep::PyTypeObject), mType(new PyString(type)), mArguments(args) { }
+: PyRep(PyRep::PyTypeObject), mType(PyString::Intern(type)), mArguments(args) { }
 PyObject::PyObject(const PyObject& oth)
 : PyRep(PyRep::PyTypeObject), mType(oth.mType), mArguments(oth.arguments())
 {
+    // shared with oth, and both of us DecRef them.  MakeMutable() before changing either
+    PyIncRef( mType );
+    PyIncRef( mArguments );
     //sLog.Cyan("PyObject()", "Copy C'tor.");
 }
 
@@ -872,6 +1269,18 @@ PyRep* PyObject::Clone() const
     return new PyObject( *this );
 }
 
+PyObject* PyObject::MakeMutable()
+{
+    // copies share the arguments too, so they must be ours alone as well
+    if ((GetCount() < 2) and (mArguments->GetCount() < 2))
+        return this;
+
+    PyIncRef( mType );
+    PyObject* res = new PyObject( mType, mArguments->Clone() );
+    PyDecRef( this );
+    return res;
+}
+
 bool PyObject::visit( PyVisitor& v ) const
 {
     return v.VisitObject( this );
@@ -885,6 +1294,9 @@ PyObjectEx::PyObjectEx(bool is_type_2, PyRep* header) : PyRep(PyRep::PyTypeObjec
 PyObjectEx::PyObjectEx( const PyObjectEx& oth ) : PyRep( PyRep::PyTypeObjectEx ),
 mHeader(oth.header()->Clone()), mIsType2(oth.isType2()), mList(oth.mList), mDict(oth.mDict)
 {
+    // list and dict are shared with oth, and both of us DecRef them.  header gets its own (shallow) copy, as before
+    PyIncRef( mList );
+    PyIncRef( mDict );
     //sLog.Cyan("PyObjectEx()", "Copy C'tor.");
 }
 
@@ -1111,8 +1523,10 @@ PyTuple* PyObjectEx_Type2::_CreateHeader( PyToken* args, PyDict* keywords, bool
 PyPackedRow::PyPackedRow(DBRowDescriptor* header)
 : PyRep(PyRep::PyTypePackedRow), mHeader(header), mFields(new PyList(header->ColumnCount()) ) { }
 PyPackedRow::PyPackedRow(const PyPackedRow& oth )
-: PyRep(PyRep::PyTypePackedRow), mHeader(oth.header()), mFields(oth.mFields)
+: PyRep(PyRep::PyTypePackedRow), mHeader(oth.header()), mFields(new PyList( *oth.mFields ))
 {
+    // header is shared with oth, and both of us DecRef it
+    PyIncRef( mHeader );
     //sLog.Cyan("PyPackedRow()", "Copy C'tor.");
 }
 
@@ -1128,6 +1542,16 @@ PyRep* PyPackedRow::Clone() const
     return new PyPackedRow(*this);
 }
 
+PyPackedRow* PyPackedRow::MakeMutable()
+{
+    if (GetCount() < 2)
+        return this;
+
+    PyPackedRow* res = new PyPackedRow( *this );
+    PyDecRef( this );
+    return res;
+}
+
 bool PyPackedRow::visit( PyVisitor& v ) const
 {
     return v.VisitPackedRow( this );
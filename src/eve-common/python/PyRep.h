@@ -121,6 +121,11 @@ public:
 
     const char* TypeString() const;
 
+    /** @return Number of live objects of type, for leak hunting. */
+    static int64 GetLiveCount( PyType type );
+    /** @brief Serves GetLiveCount() for each type as the evemu_pyrep_live metric. */
+    static void RegisterMetrics();
+
     // tools for easy access, less typecasting...
     PyInt* AsInt()                                       { assert( IsInt() ); return (PyInt*)this; }
     const PyInt* AsInt() const                           { assert( IsInt() ); return (const PyInt*)this; }
@@ -199,6 +204,11 @@ public:
     /**
      * @brief Clones object.
      *
+     * Containers are copied shallowly; the copy holds its own references
+     * to the items of the original.  Trees are shared copy-on-write:
+     * before changing a container that may be shared, swap your reference
+     * for the one MakeMutable() returns, which copies only if refcount > 1.
+     *
      * @return Identical copy of object.
      */
     virtual PyRep* Clone() const;
@@ -232,6 +242,9 @@ public:
     static double FloatValue(PyRep* pRep);
 
 protected:
+    // pins its immutable singletons
+    friend class pyStatic;
+
     virtual ~PyRep();
     const PyType mType;
 };
@@ -477,10 +490,36 @@ public:
     // updated to use std::hash for strings.  better checks without collision (so far)
     int32 hash() const;
 
+    /**
+     * @brief Gets the interned copy of a string, adding it on first use.
+     *
+     * There is only one interned PyString per content, so interned strings
+     * compare by pointer.  They are pinned and shared by all threads; the
+     * result may be used in place of a new PyString (SetItem etc.).
+     *
+     * @note only for bounded sets of identifiers (service, method and column names,
+     *  type strings, session keys); never intern strings a client sent us.
+     */
+    static PyString* Intern( const char* str );
+    static PyString* Intern( const std::string& str );
+    /** @return the interned copy of the string; NULL if it isn't interned.  Never adds to the pool. */
+    static PyString* Lookup( const char* str, size_t len );
+    /** @return the interned string of a MarshalStringTable index; NULL if out of range. */
+    static PyString* FromStringTable( uint8 index );
+
+    bool IsInterned() const                             { return mInterned; }
+    /** @return MarshalStringTable index of the string; 0 if unknown or it has none. */
+    uint8 GetTableIndex() const                         { return mTableIndex; }
+
 protected:
     virtual ~PyString()                                 { /* do nothing here */ }
     const std::string mValue;
     mutable int32 mHashCache;
+    bool mInterned;
+    uint8 mTableIndex;
+
+private:
+    class Pool;
 };
 
 /**
@@ -599,6 +638,8 @@ public:
     PyTuple& operator= (PyTuple&& oth) = delete;
 
     PyRep* Clone() const;
+    /** @return this if unshared, a shallow copy otherwise; consumes our reference.  see Clone() */
+    PyTuple* MakeMutable();
     bool visit( PyVisitor& v ) const;
 
     const_iterator begin() const                        { return items.begin(); }
@@ -671,6 +712,8 @@ public:
 
 
     PyRep* Clone() const;
+    /** @return this if unshared, a shallow copy otherwise; consumes our reference.  see Clone() */
+    PyList* MakeMutable();
     bool visit( PyVisitor& v ) const;
 
     const_iterator begin() const                        { return items.begin(); }
@@ -731,39 +774,86 @@ protected:
  * @brief Python's dictionary.
  *
  * Dictionary; completely mutable associative container.
+ * Iterates in insertion order, so a dict marshals as it was built or unmarshaled.
  */
 class PyDict : public PyRep
 {
-protected:
-    // hash function
-    class _hash : public std::function<PyRep*(size_t)>
+public:
+    /** @brief Dictionary entry; ->first / ->second as with std::map iterators. */
+    struct Entry
     {
-    public:
-        size_t operator()( const PyRep* _Keyval ) const
-        {
-            assert( _Keyval );
-
-            return (size_t)_Keyval->hash();
-        }
+        PyRep* first;
+        PyRep* second;
+        int32 hash;
     };
 
-    // comparison function
-    class _comp : public std::function<PyRep*(PyRep*, bool)>
+    /**
+     * @brief Storage of PyDict: open addressing hash table.
+     *
+     * Entries are kept in an array, in insertion order; an index of
+     * entry numbers maps hashes to them, probed the way Python does.
+     * Up to InlineSize entries live inside the table itself and have no
+     * index: scanning their cached hashes is cheaper than hashing into one.
+     *
+     * Holds pointers only; reference counting is left to PyDict.
+     */
+    class Storage
     {
     public:
-        bool operator()( const PyRep* _Arg1, const PyRep* _Arg2 ) const
-        {
-            assert( _Arg1 );
-            assert( _Arg2 );
-
-            return ( _Arg1->hash() == _Arg2->hash() );
-        }
+        typedef Entry*          iterator;
+        typedef const Entry*    const_iterator;
+
+        static const size_t InlineSize = 8;
+
+        Storage();
+        Storage( const Storage& oth );
+        Storage& operator=( const Storage& oth );
+        ~Storage();
+
+        iterator begin()                                { return mEntries; }
+        iterator end()                                  { return mEntries + mSize; }
+        const_iterator begin() const                    { return mEntries; }
+        const_iterator end() const                      { return mEntries + mSize; }
+
+        size_t size() const                             { return mSize; }
+        bool empty() const                              { return mSize == 0; }
+        void clear();
+        void reserve( size_t count );
+
+        /** @return entry of key, end() if there is none. */
+        iterator find( const PyRep* key, int32 hash ) const;
+        /** @return entry of a String or WString key with content str, end() if there is none. */
+        iterator find( const std::string& str, int32 hash ) const;
+        /** @brief Adds an entry; key must not be in the table yet. */
+        void insert( PyRep* key, PyRep* value, int32 hash );
+
+    protected:
+        template<class Match>
+        iterator _find( int32 hash, Match match ) const;
+        void _grow();
+        void _reindex();
+
+        Entry* mEntries;
+        size_t mSize;
+        size_t mCapacity;
+        // entry numbers, UINT32_MAX for empty slots; NULL while entries are inline
+        uint32* mIndex;
+        size_t mIndexMask;
+        Entry mInline[ InlineSize ];
     };
 
-public:
-    typedef std::unordered_map<PyRep*, PyRep*, _hash, _comp>   storage_type;
-    typedef storage_type::iterator                             iterator;
-    typedef storage_type::const_iterator                       const_iterator;
+    typedef Storage                     storage_type;
+    typedef storage_type::iterator      iterator;
+    typedef storage_type::const_iterator const_iterator;
+
+    /**
+     * @brief Key equality: same value, not just same hash.
+     *
+     * Numbers compare by value across Int, Long, Float and Bool, and
+     * String and WString by content, as they do in Python (and hash alike).
+     * Tuples compare item by item; anything else only equals itself.
+     */
+    static bool KeyEquals( const PyRep* key1, const PyRep* key2 );
 
     // default c'tor
     PyDict();
@@ -777,6 +867,8 @@ public:
     PyDict& operator=(PyDict&& oth) =delete;
 
     PyRep* Clone() const;
+    /** @return this if unshared, a shallow copy otherwise; consumes our reference.  see Clone() */
+    PyDict* MakeMutable();
     bool visit( PyVisitor& v ) const;
 
     const_iterator begin() const { return items.begin(); }
@@ -855,6 +947,8 @@ public:
 
 
     PyRep* Clone() const;
+    /** @return this if unshared, a shallow copy otherwise; consumes our reference.  see Clone() */
+    PyObject* MakeMutable();
     bool visit( PyVisitor& v ) const;
 
     PyString* type() const { return mType; }
@@ -993,6 +1087,8 @@ public:
 
 
     PyRep* Clone() const;
+    /** @return this if unshared, a shallow copy otherwise; consumes our reference.  see Clone() */
+    PyPackedRow* MakeMutable();
     bool visit( PyVisitor& v ) const;
 
     // Header:
@@ -1116,7 +1212,7 @@ protected:
 template<typename Iter>
 inline PyBuffer::PyBuffer( Iter first, Iter last ) : PyRep( PyRep::PyTypeBuffer ), mValue( new Buffer( first, last ) ), mHashCache( -1 ) {}
 template<typename Iter>
-inline PyString::PyString( Iter first, Iter last ) : PyRep( PyRep::PyTypeString ), mValue( first, last ), mHashCache( -1 ) {}
+inline PyString::PyString( Iter first, Iter last ) : PyRep( PyRep::PyTypeString ), mValue( first, last ), mHashCache( -1 ), mInterned( false ), mTableIndex( 0 ) {}
 template<typename Iter>
 inline PyWString::PyWString( Iter first, Iter last ) : PyRep( PyRep::PyTypeWString ), mValue( first, last ), mHashCache( -1 ) {}
 template<typename Iter>
@@ -1186,6 +1282,17 @@ public:
         m_dict = new PyDict();
         m_list = new PyList();
         m_tuple = new PyTuple(0);
+
+        /* the scalars are handed out on every thread (connection threads unmarshal None and bools),
+         *  and refcounts are not atomic, so pin them.  the empty containers stay counted, as
+         *  MakeMutable() goes by refcount to decide whether they are shared.
+         */
+        m_none->Pin();
+        m_zero->Pin();
+        m_one->Pin();
+        m_negone->Pin();
+        m_true->Pin();
+        m_false->Pin();
     }
 
    ~pyStatic()
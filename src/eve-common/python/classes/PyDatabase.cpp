@@ -75,16 +75,11 @@ DBTYPE DBRowDescriptor::GetColumnType( uint32 index ) const
 uint32 DBRowDescriptor::FindColumn( const char* name ) const
 {
     uint32 cc(ColumnCount());
-    PyString* stringName = new PyString( name );
 
-    for( uint32 i(0); i < cc; ++i ) {
-        if( stringName->hash() == GetColumnName( i )->hash() ) {
-            PyDecRef( stringName );
+    for( uint32 i(0); i < cc; ++i )
+        if( GetColumnName( i )->content() == name )
             return i;
-        }
-    }
 
-    PyDecRef( stringName );
     return cc;
 }
 
@@ -96,7 +91,7 @@ bool DBRowDescriptor::VerifyValue( uint32 index, PyRep* value )
 void DBRowDescriptor::AddColumn( const char* name, DBTYPE type )
 {
     PyTuple* col = new PyTuple( 2 );
-        col->SetItem( 0, new PyString( name ) );
+        col->SetItem( 0, PyString::Intern( name ) );
         col->SetItem( 1, new PyInt( type ) );
     _GetColumnList()->items.push_back( col );
 }
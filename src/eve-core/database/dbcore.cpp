@@ -30,6 +30,7 @@
 #include "log/LogNew.h"
 #include "log/logsys.h"
 #include "utils/misc.h"
+#include "utils/Trace.h"
 #include "utils/utils_time.h"
 //#include "../eve-server/Profiler.h"
 
@@ -47,9 +48,8 @@ public:
 
 
 DBcore::DBcore()
-: mysql(nullptr),
+: mQueryHook(nullptr),
 pSocket(false),
-pStatus(Closed),
 pReconnect(false),
 pProfile(false),
 pCompress(false),
@@ -57,33 +57,42 @@ pSSL(false),
 pPort(3306)
 {
     mysql_thread_init();    // this is for each thread used for db connections
-    mysql = mysql_init(nullptr);
+    mMain.mysql = mysql_init(nullptr);
 }
 
-void DBcore::Connect(uint* errnum, char* errbuf)
+void DBcore::Connect(DBConnection& conn, uint* errnum, char* errbuf)
 {
-    sLog.Cyan("          DB User", " %s", pUser.c_str());
-    sLog.Cyan("         DataBase", " %s", pDatabase.c_str());
+    // worker connections only log errors
+    bool verbose(&conn == &mMain);
+    if (verbose) {
+        sLog.Cyan("          DB User", " %s", pUser.c_str());
+        sLog.Cyan("         DataBase", " %s", pDatabase.c_str());
+    }
 
     // options should be called BEFORE mysql_real_connect()
     if (pSocket) {
         enum mysql_protocol_type prot_type = MYSQL_PROTOCOL_SOCKET;
-        if (mysql_options(mysql, MYSQL_OPT_PROTOCOL, (void*)&prot_type) == 0) {
-            sLog.Cyan("        DB Server", " Unix Socket Connection");
+        if (mysql_options(conn.mysql, MYSQL_OPT_PROTOCOL, (void*)&prot_type) == 0) {
+            if (verbose)
+                sLog.Cyan("        DB Server", " Unix Socket Connection");
         } else {
             sLog.Error("        DB Server", " Unix Socket Connection Option Failed");
             enum mysql_protocol_type prot_type = MYSQL_PROTOCOL_TCP;
-            if (mysql_options(mysql, MYSQL_OPT_PROTOCOL, (void*)&prot_type) == 0)
-                sLog.Cyan("        DB Server", " %s:%d", pHost.c_str(), pPort);
-            else
+            if (mysql_options(conn.mysql, MYSQL_OPT_PROTOCOL, (void*)&prot_type) == 0) {
+                if (verbose)
+                    sLog.Cyan("        DB Server", " %s:%d", pHost.c_str(), pPort);
+            } else {
                 sLog.Error("        DB Server", " TCP Connection Option Failed");
+            }
         }
     } else {
         enum mysql_protocol_type prot_type = MYSQL_PROTOCOL_TCP;
-        if (mysql_options(mysql, MYSQL_OPT_PROTOCOL, (void*)&prot_type) == 0)
-            sLog.Cyan("        DB Server", " %s:%d", pHost.c_str(), pPort);
-        else
+        if (mysql_options(conn.mysql, MYSQL_OPT_PROTOCOL, (void*)&prot_type) == 0) {
+            if (verbose)
+                sLog.Cyan("        DB Server", " %s:%d", pHost.c_str(), pPort);
+        } else {
             sLog.Error("        DB Server", " TCP Connection Option Failed");
+        }
     }
 
     int32 flags = CLIENT_FOUND_ROWS; //2
@@ -92,7 +101,8 @@ void DBcore::Connect(uint* errnum, char* errbuf)
     // sql-ssl  needs more info/settings to properly use....however, not needed when using socket under linux
     if (pSSL and !pSocket)
         flags |= CLIENT_SSL;
-    sLog.Cyan("    Connect Flags", " %x", flags);
+    if (verbose)
+        sLog.Cyan("    Connect Flags", " %x", flags);
     /*
      *    unsigned int conn_timeout = 2;
      *    // not sure if this one will really be used here
@@ -110,60 +120,66 @@ void DBcore::Connect(uint* errnum, char* errbuf)
 */
     if (pReconnect) {
         my_bool reconnect = true;
-        if (mysql_options(mysql, MYSQL_OPT_RECONNECT, (void*)&reconnect) == 0) // this will enable auto-reconnect...and render my Reconnect() worthless
-            sLog.Green(" DataBase Manager", "DataBase AutoReconnect Enabled");
-        else
+        if (mysql_options(conn.mysql, MYSQL_OPT_RECONNECT, (void*)&reconnect) == 0) { // this will enable auto-reconnect...and render my Reconnect() worthless
+            if (verbose)
+                sLog.Green(" DataBase Manager", "DataBase AutoReconnect Enabled");
+        } else {
             sLog.Error(" DataBase Manager", "DataBase AutoReconnect Option Failed");
-    } else
+        }
+    } else if (verbose) {
         sLog.Yellow(" DataBase Manager", "DataBase AutoReconnect Disabled");
+    }
 
-    if (mysql_real_connect(mysql, pHost.c_str(), pUser.c_str(), pPassword.c_str(), pDatabase.c_str(), pPort, 0, flags) == nullptr) {
-        pStatus = Error;
-        *errnum = mysql_errno(mysql);
+    if (mysql_real_connect(conn.mysql, pHost.c_str(), pUser.c_str(), pPassword.c_str(), pDatabase.c_str(), pPort, 0, flags) == nullptr) {
+        conn.status = Error;
+        *errnum = mysql_errno(conn.mysql);
         if (errbuf != nullptr)
-            snprintf(errbuf, MYSQL_ERRMSG_SIZE, "#%i: %s", mysql_errno(mysql), mysql_error(mysql));
+            snprintf(errbuf, MYSQL_ERRMSG_SIZE, "#%i: %s", mysql_errno(conn.mysql), mysql_error(conn.mysql));
         DBerror err;
         err.SetError(*errnum, errbuf);
         sLog.Error( "       ServerInit", "Unable to connect to the database: %s", err.c_str() );
         return;
     } else {
-        pStatus = Connected;
+        conn.status = Connected;
         //mysql_get_socket();
-        sLog.Blue(" DataBase Manager", "DataBase Connected");
+        if (verbose)
+            sLog.Blue(" DataBase Manager", "DataBase Connected");
     }
 
     // Setup character set we wish to use
-    if (mysql_set_character_set(mysql, "utf8") == 0)
-        sLog.Cyan(" DataBase Manager", "DataBase Character set: %s", mysql_character_set_name(mysql));
+    if ((mysql_set_character_set(conn.mysql, "utf8") == 0) and verbose)
+        sLog.Cyan(" DataBase Manager", "DataBase Character set: %s", mysql_character_set_name(conn.mysql));
 }
 
-bool DBcore::Reconnect()
+bool DBcore::Reconnect(DBConnection& conn)
 {
     _log(DATABASE__MESSAGE, "DBCore attempting to recover...");
-    Close();
-    mysql = mysql_init(nullptr);
+    // only this connection is reopened.  Close() would end the client library for every connection
+    conn.status = Closed;
+    mysql_close(conn.mysql);
+    conn.mysql = mysql_init(nullptr);
     uint errnum = 0;
     char errbuf[1024];
     errbuf[0] = 0;
-    MutexLock lock(MDatabase);
-    Connect(&errnum, errbuf);
+    MutexLock lock(conn.lock);
+    Connect(conn, &errnum, errbuf);
 
-    if (pStatus == Connected)
+    if (conn.status == Connected)
         _log(DATABASE__MESSAGE, "DBCore recovery successful.  Continuing.");
 
-    return pStatus;
+    return (conn.status == Connected);
 }
 
 void DBcore::Initialize(std::string host, std::string user, std::string password, std::string database, bool compress/*false*/,
                         bool SSL/*false*/, int16 port/*3306*/, bool socket/*false*/, bool reconnect/*false*/, bool profile/*false*/)
 {
-    if (mysql == nullptr)
-        mysql = mysql_init(nullptr);    // try again
-    if (mysql == nullptr) {
+    if (mMain.mysql == nullptr)
+        mMain.mysql = mysql_init(nullptr);    // try again
+    if (mMain.mysql == nullptr) {
         sLog.Error( "       ServerInit", "Unable to connect to the database:  mysql_init returned null");
         return;
     }
-    if (pStatus == Connected)
+    if (mMain.status == Connected)
         return;
 
     pHost = host;
@@ -186,15 +202,21 @@ void DBcore::Initialize(std::string host, std::string user, std::string password
     char errbuf[1024];
     errbuf[0] = 0;
 
-    MutexLock lock(MDatabase);
+    MutexLock lock(mMain.lock);
 
-    Connect(&errnum, errbuf);
+    Connect(mMain, &errnum, errbuf);
     sLog.Blue(" DataBase Manager", "DataBase Manager Initialized");
 }
 
 void DBcore::Close() {
-    pStatus = Closed;
-    mysql_close(mysql);
+    for (auto cur : mWorkers) {
+        mysql_close(cur->mysql);
+        SafeDelete(cur);
+    }
+    mWorkers.clear();
+
+    mMain.status = Closed;
+    mysql_close(mMain.mysql);
     mysql_server_end();
     mysql_thread_end();   // this is for each thread used for db connections
 }
@@ -211,53 +233,147 @@ void DBcore::CallShutdown()
     sConsole.HaltServer(true);
 } */
 
+thread_local DBcore::QuerySite DBcore::tSite(nullptr, 0);
+
+void DBcore::RunQueryHook(const char* query)
+{
+    // runs before the connection lock is taken, as the hook may run queries of its own
+    if (mQueryHook != nullptr)
+        mQueryHook(query);
+}
+
+thread_local DBcore::DBConnection* DBcore::tConn(nullptr);
+
+uint8 DBcore::AddConnections(uint8 count)
+{
+    uint8 opened(0);
+    for (uint8 i = 0; i < count; ++i) {
+        DBConnection* pConn = new DBConnection();
+        pConn->mysql = mysql_init(nullptr);
+        if (pConn->mysql == nullptr) {
+            SafeDelete(pConn);
+            break;
+        }
+
+        uint errnum = 0;
+        char errbuf[1024];
+        errbuf[0] = 0;
+        Connect(*pConn, &errnum, errbuf);
+        if (pConn->status != Connected) {
+            mysql_close(pConn->mysql);
+            SafeDelete(pConn);
+            break;
+        }
+        mWorkers.push_back(pConn);
+        ++opened;
+    }
+
+    sLog.Blue(" DataBase Manager", "Opened %u of %u worker connections.", opened, count);
+    return opened;
+}
+
+void DBcore::BindThread(uint8 index)
+{
+    mysql_thread_init();    // this is for each thread used for db connections
+    tConn = (index < mWorkers.size() ? mWorkers[index] : nullptr);
+}
+
+void DBcore::UnbindThread()
+{
+    tConn = nullptr;
+    mysql_thread_end();
+}
+
+DBcore::QuerySite DBcore::TakeSite()
+{
+    // only good for the call it was set for
+    QuerySite site(tSite);
+    tSite.first = nullptr;
+    return site;
+}
+
 // Sends the MySQL server a ping
 void DBcore::ping()
 {
     // well, if it's locked, someone's using it. If someone's using it, it doesn't need a ping
-    if ( MDatabase.TryLock() ) {
-        mysql_ping(mysql);
-        MDatabase.Unlock();
+    if ( mMain.lock.TryLock() ) {
+        mysql_ping(mMain.mysql);
+        mMain.lock.Unlock();
+    }
+    // idle worker connections would otherwise time out between logins
+    for (auto cur : mWorkers) {
+        if ( cur->lock.TryLock() ) {
+            mysql_ping(cur->mysql);
+            cur->lock.Unlock();
+        }
     }
 }
 
 //query which returns a result (error is stored in the result if it occurs)
 bool DBcore::RunQuery(DBQueryResult &into, const char *query_fmt, ...) {
-    MutexLock lock(MDatabase);
+    // span includes the wait for the connection lock
+    TRACE_SPAN("DBcore::RunQuery");
+    QuerySite site(TakeSite());
 
-    char query[4096];
+    // formatted length is not limited here (bulk IN() queries can run well past 4k)
     va_list vlist;
     va_start(vlist, query_fmt);
-    int querylen = std::vsnprintf(query, 4096, query_fmt, vlist);
+    char* query(nullptr);
+    int querylen = vasprintf(&query, query_fmt, vlist);
     va_end(vlist);
+    if (querylen < 0) {
+        // query is undefined here; nothing to free
+        into.error.SetError(0xFFFF, "DBcore::RunQuery: Failed to format query");
+        codelog(DATABASE__ERROR, "DBCore::RunQuery: failed to format query '%s'", query_fmt);
+        return false;
+    }
 
-    if (!DoQuery_locked(into.error, query, querylen))
+    RunQueryHook(query);
+    DBConnection& conn(GetConnection());
+    MutexLock lock(conn.lock);
+
+    if (!DoQuery_locked(conn, into.error, site, query, querylen)) {
+        free(query);
         return false;
+    }
 
-    uint col_count = mysql_field_count(mysql);
+    uint col_count = mysql_field_count(conn.mysql);
     if (col_count == 0) {
         into.error.SetError(0xFFFF, "DBcore::RunQuery: No Result");
         codelog(DATABASE__ERROR, "DBCore::RunQuery: %s failed because it did not return a result", query);
         EvE::traceStack();
+        free(query);
         return false;
     }
+    free(query);
 
-    into.SetResult(mysql_store_result(mysql), col_count);
+    into.SetResult(mysql_store_result(conn.mysql), col_count);
 
     return true;
 }
 
 //query which returns only error status
 bool DBcore::RunQuery(DBerror &err, const char *query_fmt, ...) {
-    MutexLock lock(MDatabase);
+    // span includes the wait for the connection lock
+    TRACE_SPAN("DBcore::RunQuery");
+    QuerySite site(TakeSite());
 
     va_list args;
     va_start(args, query_fmt);
     char* query(nullptr);
     int querylen = vasprintf(&query, query_fmt, args);
     va_end(args);
+    if (querylen < 0) {
+        err.SetError(0xFFFF, "DBcore::RunQuery: Failed to format query");
+        codelog(DATABASE__ERROR, "DBCore::RunQuery: failed to format query '%s'", query_fmt);
+        return false;
+    }
 
-    if (!DoQuery_locked(err, query, querylen)) {
+    RunQueryHook(query);
+    DBConnection& conn(GetConnection());
+    MutexLock lock(conn.lock);
+
+    if (!DoQuery_locked(conn, err, site, query, querylen)) {
         free(query);
         return false;
     }
@@ -268,83 +384,105 @@ bool DBcore::RunQuery(DBerror &err, const char *query_fmt, ...) {
 
 //query which returns affected rows:  (not used)
 bool DBcore::RunQuery(DBerror &err, uint32 &affected_rows, const char *query_fmt, ...) {
-    MutexLock lock(MDatabase);
+    // span includes the wait for the connection lock
+    TRACE_SPAN("DBcore::RunQuery");
+    QuerySite site(TakeSite());
 
     va_list args;
     va_start(args, query_fmt);
     char* query(nullptr);
     int querylen = vasprintf(&query, query_fmt, args);
     va_end(args);
+    if (querylen < 0) {
+        err.SetError(0xFFFF, "DBcore::RunQuery: Failed to format query");
+        codelog(DATABASE__ERROR, "DBCore::RunQuery: failed to format query '%s'", query_fmt);
+        return false;
+    }
+
+    RunQueryHook(query);
+    DBConnection& conn(GetConnection());
+    MutexLock lock(conn.lock);
 
-    if (!DoQuery_locked(err, query, querylen)) {
+    if (!DoQuery_locked(conn, err, site, query, querylen)) {
         free(query);
         return false;
     }
     free(query);
 
-    affected_rows = (uint32)mysql_affected_rows(mysql);
+    affected_rows = (uint32)mysql_affected_rows(conn.mysql);
 
     return true;
 }
 
 //query which returns last insert ID:
 bool DBcore::RunQueryLID(DBerror &err, uint32 &last_insert_id, const char *query_fmt, ...) {
-    MutexLock lock(MDatabase);
+    // span includes the wait for the connection lock
+    TRACE_SPAN("DBcore::RunQuery");
+    QuerySite site(TakeSite());
 
     va_list args;
     va_start(args, query_fmt);
     char* query(nullptr);
     int querylen = vasprintf(&query, query_fmt, args);
     va_end(args);
+    if (querylen < 0) {
+        err.SetError(0xFFFF, "DBcore::RunQuery: Failed to format query");
+        codelog(DATABASE__ERROR, "DBCore::RunQuery: failed to format query '%s'", query_fmt);
+        return false;
+    }
+
+    RunQueryHook(query);
+    DBConnection& conn(GetConnection());
+    MutexLock lock(conn.lock);
 
-    if (!DoQuery_locked(err, query, querylen)) {
+    if (!DoQuery_locked(conn, err, site, query, querylen)) {
         free(query);
         return false;
     }
     free(query);
 
-    last_insert_id = (uint32)mysql_insert_id(mysql);
+    last_insert_id = (uint32)mysql_insert_id(conn.mysql);
 
     return true;
 }
 
-bool DBcore::DoQuery_locked(DBerror &err, const char *query, int querylen, bool retry/*true*/)
+bool DBcore::DoQuery_locked(DBConnection& conn, DBerror &err, const QuerySite& site, const char *query, int querylen, bool retry/*true*/)
 {
     double profileStartTime = GetTimeUSeconds();
 
-    if (mysql == nullptr) {
-        pStatus = Error;
+    if (conn.mysql == nullptr) {
+        conn.status = Error;
         codelog(DATABASE__ERROR, "DBCore - mysql = null");
-        if (!Reconnect())
+        if (!Reconnect(conn))
             return false;
     }
 
-    if (pStatus != Connected) {
+    if (conn.status != Connected) {
         codelog(DATABASE__ERROR, "DBCore - Status != Connected");
         _log(DATABASE__MESSAGE, "DBCore error detected.  Look for error msgs in logs prior to this point.");
-        if (!Reconnect())
+        if (!Reconnect(conn))
             return false;
     }
 
     if (is_log_enabled(DATABASE__QUERIES))
         _log(DATABASE__QUERIES, "DBcore Query - %s", query);
 
-    if (mysql_real_query(mysql, query, querylen)) {
-        uint num = mysql_errno(mysql);
+    if (mysql_real_query(conn.mysql, query, querylen)) {
+        uint num = mysql_errno(conn.mysql);
         if (num > 0)
-            pStatus = Error;
+            conn.status = Error;
 
         // there are many correctable errors to check for
         if ((num == CR_SERVER_LOST) or (num == CR_SERVER_GONE_ERROR)) {
             _log(DATABASE__ERROR, "DBCore error - server lost or gone.");
-            if (!Reconnect())
+            if (!Reconnect(conn))
                 return false;
         }
 
-        if ((pStatus == Connected) and retry)
-            return DoQuery_locked(err, query, querylen, retry);
+        if ((conn.status == Connected) and retry)
+            return DoQuery_locked(conn, err, site, query, querylen, retry);
 
-        err.SetError(num, mysql_error(mysql));
+        err.SetError(num, mysql_error(conn.mysql));
         codelog(DATABASE__ERROR, "DBCore Query - #%u in '%s': %s", err.GetErrNo(), query, err.c_str());
         return false;
     }
@@ -354,21 +492,44 @@ bool DBcore::DoQuery_locked(DBerror &err, const char *query, int querylen, bool
     if (pProfile)
         sProfiler.AddTime(9, GetTimeUSeconds() - profileStartTime);
 
+    GetQueryMetric(site).Observe((GetTimeUSeconds() - profileStartTime) / 1e6);
+
     return true;
 }
 
+MetricHistogram& DBcore::GetQueryMetric(const QuerySite& site)
+{
+    // queries on worker connections get here in parallel with the main one
+    MutexLock lock(MMetrics);
+    std::map<QuerySite, MetricHistogram*>::iterator itr = mQueryMetrics.find(site);
+    if (itr != mQueryMetrics.end())
+        return *itr->second;
+
+    // file:line of the sDatabase call.  one series per call site, however the query text is built
+    std::string label("unknown");
+    if (site.first != nullptr) {
+        const char* file = strrchr(site.first, '/');
+        label = (file == nullptr ? site.first : file + 1);
+        label += ":" + std::to_string(site.second);
+    }
+
+    MetricHistogram* metric = &sMetrics.GetHistogram("evemu_db_query_seconds", "Database query time, by call site.", {{"site", label}});
+    mQueryMetrics.emplace(site, metric);
+    return *metric;
+}
+
 
 int32 DBcore::DoEscapeString(char* tobuf, const char* frombuf, int32 fromlen)
 {
-    return mysql_real_escape_string(mysql, tobuf, frombuf, fromlen);
+    return mysql_real_escape_string(GetConnection().mysql, tobuf, frombuf, fromlen);
 }
 
 void DBcore::DoEscapeString(std::string &to, const std::string &from)
 {
-    assert(mysql);
+    assert(GetConnection().mysql);
     uint32 len = (uint32)from.length();
     to.resize(len * 2);   // make enough room
-    uint32 esc_len = mysql_real_escape_string(mysql, &to[0], from.c_str(), len);
+    uint32 esc_len = mysql_real_escape_string(GetConnection().mysql, &to[0], from.c_str(), len);
     to.resize(esc_len + 1); // optional.
 }
 
@@ -38,6 +38,7 @@
 #include "utils/Singleton.h"
 #include "database/dbtype.h"
 #include "threading/Mutex.h"
+#include "utils/Metrics.h"
 
 class DBcore;
 
@@ -169,23 +170,65 @@ public:
     //static void ReplaceSlash(const char *str);
     void    ping();
 
-    eStatus GetStatus() const { return pStatus; }
+    eStatus GetStatus() const { return mMain.status; }
+
+    /* opens 'count' more connections, for worker threads (LoginPool).  call after Initialize().
+     *  a thread bound to one with BindThread() runs its queries there, in parallel with the main connection.
+     *  returns how many were opened.
+     */
+    uint8   AddConnections(uint8 count);
+    // routes this thread's queries to worker connection 'index'.  unbound threads (and bad indexes) use the main connection
+    void    BindThread(uint8 index);
+    void    UnbindThread();
+
+    /* called with every formatted query before it runs, from the querying thread, without the connection lock.
+     *  lets a write-behind queue (ItemDB's new entity rows) flush anything the query could depend on.
+     *  set once at startup, before other threads query.
+     */
+    typedef void (*QueryHook)(const char* query);
+    void SetQueryHook(QueryHook hook) { mQueryHook = hook; }
+
+    // sets the call site the next query's latency is recorded under.  used by the sDatabase macro
+    DBcore& AtSite(const char* file, int line) { tSite.first = file; tSite.second = line; return *this; }
 
 protected:
-    MYSQL*  getMySQL()              { return mysql; }
+    // one mysql connection and the lock its queries run under
+    struct DBConnection {
+        DBConnection() : mysql(nullptr), status(Closed) { }
+        MYSQL*  mysql;
+        eStatus status;
+        Mutex   lock;
+    };
 
-    void Connect(uint* errnum = 0, char* errbuf = 0);
+    MYSQL*  getMySQL()              { return mMain.mysql; }
 
-    bool Reconnect();
+    void Connect(DBConnection& conn, uint* errnum = 0, char* errbuf = 0);
+
+    bool Reconnect(DBConnection& conn);
     //void CallShutdown();
 
 private:
-    //MDatabase must be locked before these calls:
-    bool    DoQuery_locked(DBerror &err, const char *query, int querylen, bool retry = true);
-
-    MYSQL*  mysql;
-    Mutex   MDatabase;
-    eStatus pStatus;
+    // __FILE__, __LINE__ of a query
+    typedef std::pair<const char*, int> QuerySite;
+    // returns and clears this thread's call site
+    static QuerySite TakeSite();
+    void RunQueryHook(const char* query);
+    // this thread's connection
+    DBConnection& GetConnection()   { return (tConn == nullptr ? mMain : *tConn); }
+
+    //conn.lock must be locked before these calls:
+    bool    DoQuery_locked(DBConnection& conn, DBerror &err, const QuerySite& site, const char *query, int querylen, bool retry = true);
+    // latency histogram for a query call site
+    MetricHistogram& GetQueryMetric(const QuerySite& site);
+
+    static thread_local QuerySite tSite;
+    static thread_local DBConnection* tConn;
+
+    DBConnection mMain;
+    std::vector<DBConnection*> mWorkers;
+    QueryHook mQueryHook;
+    Mutex   MMetrics;
+    std::map<QuerySite, MetricHistogram*> mQueryMetrics;
 
     bool    pCompress;
     bool    pProfile;
@@ -202,6 +245,6 @@ private:
 };
 
 #define sDatabase \
-( DBcore::get() )
+( DBcore::get().AtSite(__FILE__, __LINE__) )
 
 #endif /* !__DATABASE__DBCORE_H__INCL__ */
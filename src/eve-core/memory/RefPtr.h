@@ -58,7 +58,8 @@ public:
      */
     RefObject(uint16 initRefCount)
     : mRefCount(initRefCount),
-    mDeleted(false)
+    mDeleted(false),
+    mPinned(false)
     {
     }
 
@@ -80,13 +81,24 @@ public:
 
     uint16 GetCount()           { return mRefCount; }
     bool IsDeleted()            { return mDeleted; }
+    bool IsPinned() const       { return mPinned; }
 
 protected:
+    /**
+     * @brief Pins object in memory.
+     *
+     * Reference counting is a no-op on a pinned object and it is never deleted,
+     * so it may be shared between threads as long as it is not modified.
+     */
+    void Pin() const            { mPinned = true; }
+
     /**
      * @brief Increments reference count of object by one.
      */
     void IncRef() const
     {
+        if (mPinned)
+            return;
         // ---modulefix; issue with installing and uninstalling modules caused a soft freeze and unable to make changes to modules in fit screen.
         if (mDeleted) {
             _log(REFPTR__ERROR, "IncRef() - Attempted to increase ref count on deleted object! Current Count: %u", mRefCount);
@@ -107,6 +119,8 @@ protected:
      */
     void DecRef() const
     {
+        if (mPinned)
+            return;
         if (mDeleted) {
             // ---modulefix; issue with installing and uninstalling modules caused a soft freeze and unable to make changes to modules in fit screen.
             _log(REFPTR__ERROR, "IncRef() - Attempted to increase ref count on deleted object! Current Count: %u", mRefCount);
@@ -127,6 +141,7 @@ private:
     /// Reference count of instance.
     mutable uint16 mRefCount;
     mutable bool mDeleted;
+    mutable bool mPinned;
 };
 
 /**
@@ -27,6 +27,10 @@
 
 #include "network/Socket.h"
 
+#ifndef HAVE_WINSOCK2_H
+#   include <sys/uio.h>
+#endif /* !HAVE_WINSOCK2_H */
+
 Socket::Socket( int af, int type, int protocol )
 : mSock( INVALID_SOCKET )
 {
@@ -81,6 +85,35 @@ unsigned int Socket::sendto( const void* buf, unsigned int len, int flags, const
     return ::sendto( mSock, (const char*)buf, len, flags, to, tolen );
 }
 
+unsigned int Socket::sendv( const void* const* bufs, const unsigned int* lens, unsigned int count, int flags )
+{
+    assert( count <= SOCKET_SENDV_MAX );
+#ifdef HAVE_WINSOCK2_H
+    WSABUF wsabufs[ SOCKET_SENDV_MAX ];
+    for( unsigned int i = 0; i < count; ++i ) {
+        wsabufs[ i ].buf = (char*)bufs[ i ];
+        wsabufs[ i ].len = lens[ i ];
+    }
+
+    DWORD sent = 0;
+    if( ::WSASend( mSock, wsabufs, count, &sent, 0, nullptr, nullptr ) == SOCKET_ERROR )
+        return SOCKET_ERROR;
+    return sent;
+#else
+    iovec iov[ SOCKET_SENDV_MAX ];
+    for( unsigned int i = 0; i < count; ++i ) {
+        iov[ i ].iov_base = (void*)bufs[ i ];
+        iov[ i ].iov_len = lens[ i ];
+    }
+
+    msghdr msg;
+    ::memset( &msg, 0, sizeof( msg ) );
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    return ::sendmsg( mSock, &msg, flags );
+#endif /* !HAVE_WINSOCK2_H */
+}
+
 int Socket::bind( const sockaddr* name, unsigned int namelen )
 {
     return ::bind( mSock, name, namelen );
@@ -91,6 +124,11 @@ int Socket::listen( int backlog )
     return ::listen( mSock, backlog );
 }
 
+int Socket::getsockname( sockaddr* name, PSOCKLEN_T namelen )
+{
+    return ::getsockname( mSock, name, namelen );
+}
+
 Socket* Socket::accept( sockaddr* addr, PSOCKLEN_T addrlen )
 {
     SOCKET sock = ::accept( mSock, addr, addrlen );
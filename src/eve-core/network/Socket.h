@@ -26,6 +26,9 @@
 #ifndef __SOCKET_H__INCL__
 #define __SOCKET_H__INCL__
 
+/** Max buffers Socket::sendv takes in one call; well under IOV_MAX. */
+static const unsigned int SOCKET_SENDV_MAX = 64;
+
 /**
  * @brief Simple wrapper for sockets.
  *
@@ -43,9 +46,13 @@ public:
     unsigned int recvfrom( void* buf, unsigned int len, int flags, sockaddr* from, PSOCKLEN_T fromlen );
     unsigned int send( const void* buf, unsigned int len, int flags );
     unsigned int sendto( const void* buf, unsigned int len, int flags, const sockaddr* to, unsigned int tolen );
+    /** gathered send of 'count' buffers in one call (sendmsg/WSASend). count must not exceed SOCKET_SENDV_MAX. */
+    unsigned int sendv( const void* const* bufs, const unsigned int* lens, unsigned int count, int flags );
 
     int bind( const sockaddr* name, unsigned int namelen );
     int listen( int backlog = SOMAXCONN );
+    /** local address; after bind() to port 0 this holds the port the system picked. */
+    int getsockname( sockaddr* name, PSOCKLEN_T namelen );
 
     Socket* accept( sockaddr* addr, PSOCKLEN_T addrlen );
 
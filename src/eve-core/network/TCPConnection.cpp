@@ -32,15 +32,23 @@
 #include "network/NetUtils.h"
 #include "threading/Threading.h"
 #include "utils/timer.h"
+#include "utils/Trace.h"
 
 const uint32 TCPCONN_RECVBUF_SIZE = 0x1000;
 const uint32 TCPCONN_LOOP_GRANULARITY = 5;  /* 5ms */
+const uint32 TCPCONN_SENDQUEUE_SIZE = 1024;
 
 TCPConnection::TCPConnection()
 : mSock(nullptr),
   mSockState(STATE_DISCONNECTED),
   mrIP(0),
   mrPort(0),
+  mSendQueue(TCPCONN_SENDQUEUE_SIZE),
+  mSendOverflowing(false),
+  mSendOffset(0),
+  mSendCalls(0),
+  mSentBuffers(0),
+  mSendQueueBytes(0),
   mRecvBuf(nullptr)
 {
 }
@@ -50,6 +58,12 @@ TCPConnection::TCPConnection(Socket* socket, uint32 mrIP, uint16 mrPort)
   mSockState(STATE_CONNECTED),
   mrIP(mrIP),
   mrPort(mrPort),
+  mSendQueue(TCPCONN_SENDQUEUE_SIZE),
+  mSendOverflowing(false),
+  mSendOffset(0),
+  mSendCalls(0),
+  mSentBuffers(0),
+  mSendQueueBytes(0),
   mRecvBuf(nullptr)
 {
     // Start worker thread
@@ -172,19 +186,23 @@ bool TCPConnection::Send(Buffer** data)
     Buffer* buf = *data;
     *data = nullptr;
 
-    // Check we are in STATE_CONNECTED
-    MutexLock sockLock(mMSock);
-
+    // Check we are in STATE_CONNECTED.  no lock here; a buffer which races
+    //  a disconnect is dropped by ClearBuffers() on reconnect or destruction
     if (GetState() != STATE_CONNECTED) {
         SafeDelete(buf);
         return false;
     }
 
-    // Push buffer to the send queue
-    MutexLock queueLock(mMSendQueue);
+    mSendQueueBytes.fetch_add(buf->size(), std::memory_order_relaxed);
+
+    // Push buffer to the send queue, unless earlier buffers are waiting in overflow
+    if (!mSendOverflowing.load(std::memory_order_acquire))
+        if (mSendQueue.Push(buf))
+            return true;
 
-    mSendQueue.push_back(buf);
-    buf = nullptr;
+    MutexLock queueLock(mMSendOverflow);
+    mSendOverflow.push_back(buf);
+    mSendOverflowing.store(true, std::memory_order_release);
 
     return true;
 }
@@ -251,6 +269,37 @@ bool TCPConnection::Process() {
     }
 }
 
+void TCPConnection::TakeSendQueue()
+{
+    Buffer* buf(nullptr);
+    while (mSendQueue.Pop(buf))
+        PushPending(buf);
+
+    if (!mSendOverflowing.load(std::memory_order_acquire))
+        return;
+
+    // overflow only gets buffers pushed after everything already in the queue, so it goes last.
+    //  drain the queue again under the lock to pick up anything that beat the overflow flag
+    MutexLock queueLock(mMSendOverflow);
+    while (mSendQueue.Pop(buf))
+        PushPending(buf);
+    while (!mSendOverflow.empty()) {
+        PushPending(mSendOverflow.front());
+        mSendOverflow.pop_front();
+    }
+    mSendOverflowing.store(false, std::memory_order_release);
+}
+
+void TCPConnection::PushPending(Buffer* buf)
+{
+    // empty buffers would only make holes in the gather list
+    if (buf->size() > 0) {
+        mSendPending.push_back(buf);
+    } else {
+        SafeDelete(buf);
+    }
+}
+
 bool TCPConnection::SendData(char* errbuf)
 {
     if(errbuf)
@@ -262,49 +311,68 @@ bool TCPConnection::SendData(char* errbuf)
     if(state != STATE_CONNECTED && state != STATE_DISCONNECTING)
         return false;
 
-    mMSendQueue.Lock();
-    Buffer* buf(nullptr);
-    int status(0);
-    while (!mSendQueue.empty()) {
-        buf = mSendQueue.front();
-        mSendQueue.pop_front();
-        mMSendQueue.Unlock();
-        if (mSendQueue.empty()) {
-            status = mSock->send(&(*buf)[ 0 ], (uint)buf->size(), MSG_NOSIGNAL);
-        } else {
-            status = mSock->send(&(*buf)[ 0 ], (uint)buf->size(), (MSG_NOSIGNAL | MSG_MORE));
+    const void* bufs[ SOCKET_SENDV_MAX ];
+    uint lens[ SOCKET_SENDV_MAX ];
+    while (true) {
+        TakeSendQueue();
+        if (mSendPending.empty())
+            return true;
+
+        TRACE_SPAN( "TCPConnection::SendData" );
+
+        // gather as many pending buffers as one call takes
+        uint count(0);
+        size_t total(0), offset(mSendOffset);
+        for (auto cur : mSendPending) {
+            bufs[count] = &(*cur)[ offset ];
+            lens[count] = (uint)(cur->size() - offset);
+            total += lens[count];
+            offset = 0;
+            if (++count == SOCKET_SENDV_MAX)
+                break;
         }
+
+        int status = mSock->sendv(bufs, lens, count, MSG_NOSIGNAL);
+        mSendCalls.fetch_add(1, std::memory_order_relaxed);
         if (status == SOCKET_ERROR) {
-            if (errno == EWOULDBLOCK) {
-                status = 0;
-            }
-            else {
-                if(errbuf)
-                    snprintf(errbuf, TCPCONN_ERRBUF_SIZE, "%s", strerror(errno));
-                SafeDelete(buf);
-                return false;
-            }
+#ifdef HAVE_WINSOCK2_H
+            if (WSAGetLastError() == WSAEWOULDBLOCK)
+                return true;
+#else
+            if (errno == EWOULDBLOCK)
+                return true;
+#endif
+            if(errbuf)
+                snprintf(errbuf, TCPCONN_ERRBUF_SIZE, "%s", strerror(errno));
+            return false;
         }
 
-        if ((size_t)status > buf->size()) {
+        if ((size_t)status > total) {
             if (errbuf)
                 snprintf(errbuf, TCPCONN_ERRBUF_SIZE, "WTF?!?   status > size.");
-
-            SafeDelete(buf);
             return false;
-        } else if ((size_t)status < buf->size()) {
-            if (status > 0)
-                buf->AssignSeq(buf->begin<uint8>() + status, buf->end<uint8>());
-            MutexLock queueLock(mMSendQueue);
-            mSendQueue.push_front(buf);
-            buf = nullptr;
-        } else {
-            SafeDelete(buf);
         }
-        mMSendQueue.Lock();
+
+        // release what went out; a partial buffer stays at the front with its offset
+        size_t sent(status);
+        while (!mSendPending.empty()) {
+            size_t left = mSendPending.front()->size() - mSendOffset;
+            if (sent < left) {
+                mSendOffset += sent;
+                break;
+            }
+            sent -= left;
+            mSendQueueBytes.fetch_sub(mSendPending.front()->size(), std::memory_order_relaxed);
+            SafeDelete(mSendPending.front());
+            mSendPending.pop_front();
+            mSendOffset = 0;
+            mSentBuffers.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // socket buffer is full; try again next loop
+        if ((size_t)status < total)
+            return true;
     }
-    mMSendQueue.Unlock();
-    return true;
 }
 
 bool TCPConnection::RecvData(char* errbuf)
@@ -374,14 +442,17 @@ void TCPConnection::DoDisconnect()
 
 void TCPConnection::ClearBuffers()
 {
-    MutexLock lock(mMSendQueue);
+    // called from the connection thread, or after it has stopped
+    TakeSendQueue();
 
     Buffer* buf = nullptr;
-    while (!mSendQueue.empty()) {
-        buf = mSendQueue.front();
-        mSendQueue.pop_front();
+    while (!mSendPending.empty()) {
+        buf = mSendPending.front();
+        mSendPending.pop_front();
+        mSendQueueBytes.fetch_sub(buf->size(), std::memory_order_relaxed);
         SafeDelete(buf);
     }
+    mSendOffset = 0;
     SafeDelete(mRecvBuf);
 }
 
@@ -391,13 +462,15 @@ void* TCPConnection::TCPConnectionLoop(void* arg)
     assert(tcpc != nullptr);
 
     tcpc->TCPConnectionLoop();
-    sThread.RemoveThread(tcpc->mThread);
 
     return nullptr;
 }
 
 void TCPConnection::TCPConnectionLoop()
 {
+    // there is one of these per client, so keep their spans few
+    TraceRecorder::SetRingSize( TraceRecorder::SMALL_RING_SIZE );
+
     mMLoopRunning.Lock();
     uint32 start = GetTickCount();
     while (Process()) {
@@ -408,5 +481,7 @@ void TCPConnection::TCPConnectionLoop()
         start = GetTickCount();
     }
     DoDisconnect();
+    // owner may delete us as soon as the loop mutex is released
+    sThread.RemoveThread(mThread);
     mMLoopRunning.Unlock();
 }
@@ -27,6 +27,7 @@
 #define __NETWORK__TCP_CONNECTION_H__INCL__
 
 #include "network/Socket.h"
+#include "threading/LockFreeQueue.h"
 #include "threading/Mutex.h"
 #include "utils/Buffer.h"
 
@@ -36,6 +37,8 @@ static const uint32 TCPCONN_ERRBUF_SIZE = 1024;
 extern const uint32 TCPCONN_RECVBUF_SIZE;
 /** Time (in milliseconds) between periodical process for incoming/outgoing data. */
 extern const uint32 TCPCONN_LOOP_GRANULARITY;
+/** Number of buffers the lock-free send queue holds before Send() falls back to the overflow list. */
+extern const uint32 TCPCONN_SENDQUEUE_SIZE;
 
 /**
  * @brief Generic class for TCP connections.
@@ -74,7 +77,14 @@ public:
      */
     std::string GetAddress();
     /** @return Current state of connection. */
-    state_t GetState() const { return mSockState; }
+    state_t GetState() const { return mSockState.load( std::memory_order_acquire ); }
+
+    /** @return Number of send calls made on the socket. */
+    int64 GetSendCalls() const { return mSendCalls.load( std::memory_order_relaxed ); }
+    /** @return Number of buffers fully written to the socket. */
+    int64 GetSentBuffers() const { return mSentBuffers.load( std::memory_order_relaxed ); }
+    /** @return Bytes accepted by Send() and not yet written to the socket. */
+    int64 GetSendQueueBytes() const { return mSendQueueBytes.load( std::memory_order_relaxed ); }
 
     /**
      * @brief Connects to specified address.
@@ -113,6 +123,9 @@ public:
     /**
      * @brief Enqueues data to be sent.
      *
+     * Never takes a lock unless the send queue is full; may be
+     * called from any thread.
+     *
      * @param[in] data Buffer with data; pointer is invalidated by the function.
      *
      * @return True if data has been accepted, false if not.
@@ -163,6 +176,8 @@ protected:
     /**
      * @brief Sends data in send queue.
      *
+     * Gathers up to SOCKET_SENDV_MAX queued buffers into each send call.
+     *
      * @param[out] errbuf Buffer which receives desription of error.
      *
      * @return True if send was OK, false if not.
@@ -176,6 +191,14 @@ protected:
      * @return True if receive was OK, false if not.
      */
     virtual bool RecvData( char* errbuf = 0 );
+    /**
+     * @brief Moves queued buffers into mSendPending, keeping send order.
+     */
+    void TakeSendQueue();
+    /**
+     * @brief Appends buf to mSendPending; empty buffers are deleted instead.
+     */
+    void PushPending( Buffer* buf );
     /**
      * @brief Disconnects socket.
      */
@@ -204,8 +227,8 @@ protected:
     mutable Mutex mMSock;
     /** Socket for connection. */
     Socket* mSock;
-    /** State the socket is in. */
-    state_t mSockState;
+    /** State the socket is in; changed under mMSock, read without it. */
+    std::atomic<state_t> mSockState;
     /** Remote IP the socket is connected to. */
     uint32 mrIP;
     /** Remote TCP port the socket is connected to; is in host byte order. */
@@ -214,10 +237,22 @@ protected:
     /** When a thread is running TCPConnectionLoop, it acquires this mutex first; used for synchronization. */
     mutable Mutex mMLoopRunning;
 
-    /** Mutex protecting send queue. */
-    mutable Mutex mMSendQueue;
-    /** Send queue. */
-    std::deque<Buffer*> mSendQueue;
+    /** Send queue; any thread pushes, the connection thread pops. */
+    MPSCQueue<Buffer*> mSendQueue;
+    /** Mutex protecting send overflow list. */
+    mutable Mutex mMSendOverflow;
+    /** Buffers which didnt fit in mSendQueue, sent after it. */
+    std::deque<Buffer*> mSendOverflow;
+    /** Set while mSendOverflow is in use, so later buffers queue behind it. */
+    std::atomic<bool> mSendOverflowing;
+    /** Buffers taken from the queues and not fully sent yet; connection thread only. */
+    std::deque<Buffer*> mSendPending;
+    /** Bytes of mSendPending.front() already sent. */
+    size_t mSendOffset;
+    /** Send stats. */
+    std::atomic<int64> mSendCalls;
+    std::atomic<int64> mSentBuffers;
+    std::atomic<int64> mSendQueueBytes;
 
     /** Receive buffer. */
     Buffer* mRecvBuf;
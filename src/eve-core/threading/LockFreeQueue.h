@@ -0,0 +1,179 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#ifndef __THREADING__LOCK_FREE_QUEUE_H__INCL__
+#define __THREADING__LOCK_FREE_QUEUE_H__INCL__
+
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Bounded multi-producer, single-consumer queue.
+ *
+ * Push() may be called from any thread and never blocks; it returns
+ * false when the queue is full. Pop() must only be called from one
+ * thread at a time. Capacity is rounded up to a power of two.
+ *
+ * Meant for small trivially-copyable items (ie. pointers).
+ */
+template<typename T>
+class MPSCQueue
+{
+public:
+    explicit MPSCQueue( size_t capacity )
+    : mMask( RoundCapacity( capacity ) - 1 ),
+      mCells( new Cell[ mMask + 1 ] ),
+      mHead( 0 ),
+      mTail( 0 )
+    {
+        for( size_t i = 0; i <= mMask; ++i )
+            mCells[ i ].seq.store( i, std::memory_order_relaxed );
+    }
+
+    size_t Capacity() const { return mMask + 1; }
+    /** @note only exact when called from the consumer with no producers running. */
+    bool Empty() const { return mHead.load( std::memory_order_acquire ) == mTail.load( std::memory_order_acquire ); }
+
+    bool Push( const T& item )
+    {
+        Cell* cell(nullptr);
+        size_t pos = mHead.load( std::memory_order_relaxed );
+        while( true ) {
+            cell = &mCells[ pos & mMask ];
+            size_t seq = cell->seq.load( std::memory_order_acquire );
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+            if( dif == 0 ) {
+                if( mHead.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+                    break;
+            } else if( dif < 0 ) {
+                // full
+                return false;
+            } else {
+                pos = mHead.load( std::memory_order_relaxed );
+            }
+        }
+
+        cell->data = item;
+        cell->seq.store( pos + 1, std::memory_order_release );
+        return true;
+    }
+
+    bool Pop( T& item )
+    {
+        size_t pos = mTail.load( std::memory_order_relaxed );
+        Cell* cell = &mCells[ pos & mMask ];
+        // a claimed cell that isnt written yet reads as empty
+        if( (intptr_t)cell->seq.load( std::memory_order_acquire ) - (intptr_t)(pos + 1) < 0 )
+            return false;
+
+        item = cell->data;
+        cell->seq.store( pos + mMask + 1, std::memory_order_release );
+        mTail.store( pos + 1, std::memory_order_relaxed );
+        return true;
+    }
+
+protected:
+    static size_t RoundCapacity( size_t capacity )
+    {
+        size_t size = 2;
+        while( size < capacity )
+            size <<= 1;
+        return size;
+    }
+
+    struct Cell {
+        std::atomic<size_t> seq;
+        T data;
+    };
+
+    const size_t mMask;
+    std::unique_ptr<Cell[]> mCells;
+    // producers and consumer each get their own cache line
+    alignas(64) std::atomic<size_t> mHead;
+    alignas(64) std::atomic<size_t> mTail;
+};
+
+/**
+ * @brief Bounded single-producer, single-consumer queue.
+ *
+ * Push() must only be called from the producer thread and Pop() only
+ * from the consumer thread. Neither blocks. Capacity is rounded up
+ * to a power of two.
+ */
+template<typename T>
+class SPSCQueue
+{
+public:
+    explicit SPSCQueue( size_t capacity )
+    : mMask( RoundCapacity( capacity ) - 1 ),
+      mItems( new T[ mMask + 1 ] ),
+      mHead( 0 ),
+      mTail( 0 )
+    {
+    }
+
+    size_t Capacity() const { return mMask + 1; }
+    bool Empty() const { return mHead.load( std::memory_order_acquire ) == mTail.load( std::memory_order_acquire ); }
+    /** @note exact when called from the producer; Push() will then succeed if this returns false. */
+    bool Full() const { return mHead.load( std::memory_order_relaxed ) - mTail.load( std::memory_order_acquire ) > mMask; }
+
+    bool Push( const T& item )
+    {
+        size_t head = mHead.load( std::memory_order_relaxed );
+        if( head - mTail.load( std::memory_order_acquire ) > mMask )
+            return false;
+
+        mItems[ head & mMask ] = item;
+        mHead.store( head + 1, std::memory_order_release );
+        return true;
+    }
+
+    bool Pop( T& item )
+    {
+        size_t tail = mTail.load( std::memory_order_relaxed );
+        if( tail == mHead.load( std::memory_order_acquire ) )
+            return false;
+
+        item = mItems[ tail & mMask ];
+        mTail.store( tail + 1, std::memory_order_release );
+        return true;
+    }
+
+protected:
+    static size_t RoundCapacity( size_t capacity )
+    {
+        size_t size = 2;
+        while( size < capacity )
+            size <<= 1;
+        return size;
+    }
+
+    const size_t mMask;
+    std::unique_ptr<T[]> mItems;
+    alignas(64) std::atomic<size_t> mHead;
+    alignas(64) std::atomic<size_t> mTail;
+};
+
+#endif /* !__THREADING__LOCK_FREE_QUEUE_H__INCL__ */
@@ -10,6 +10,7 @@
 #ifndef EVE_THREADING_H
 #define EVE_THREADING_H
 
+#include <mutex>
 #include <thread>
 
 #include "../eve-core.h"
@@ -33,7 +34,7 @@ public:
     void ListThreads();
 
 
-    uint8 Count()                           { return (uint8)(m_threads.size()); }
+    uint8 Count()                           { std::lock_guard<std::mutex> lock(m_mutex); return (uint8)(m_threads.size()); }
 
 protected:
     char* buf;
@@ -45,6 +46,8 @@ protected:
     uint32 bufferLen;
 
 private:
+    // connection threads add and remove themselves concurrently
+    std::mutex m_mutex;
     std::vector<std::thread*> m_threads;
 };
 
@@ -0,0 +1,53 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-core.h"
+
+#include "threading/WakeEvent.h"
+
+void WakeEvent::Notify()
+{
+    if (mSignaled.exchange( true, std::memory_order_acq_rel ))
+        return;     // already pending; waiter will see it
+
+    // lock so the notify cant fall between the waiter's check and its sleep
+    std::lock_guard<std::mutex> lock( mMutex );
+    mCondition.notify_one();
+}
+
+bool WakeEvent::WaitUntil( const std::chrono::steady_clock::time_point& deadline )
+{
+    std::unique_lock<std::mutex> lock( mMutex );
+    mCondition.wait_until( lock, deadline, [this] { return mSignaled.load( std::memory_order_acquire ); } );
+    // exchange, not store; a notify landing after the wakeup is still seen (and its work with it)
+    return mSignaled.exchange( false, std::memory_order_acq_rel );
+}
+
+WakeEvent& WakeEvent::MainLoop()
+{
+    // function static; connection threads may be first to get here
+    static WakeEvent event;
+    return event;
+}
@@ -0,0 +1,68 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#ifndef __THREADING__WAKE_EVENT_H__INCL__
+#define __THREADING__WAKE_EVENT_H__INCL__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+/**
+ * @brief Auto-reset event a sleeping thread can be woken with.
+ *
+ * Notify() may be called from any thread; a notify made while nobody
+ * waits is kept, so the next wait returns at once.  Notify() only takes
+ * the lock for the first notify after a wait, so producers calling it
+ * per packet stay cheap.
+ */
+class WakeEvent
+{
+public:
+    WakeEvent() : mSignaled( false ) { }
+
+    void Notify();
+    /**
+     * @brief Waits until notified or until deadline, and resets the event.
+     *
+     * @return True if notified, false if deadline passed.
+     */
+    bool WaitUntil( const std::chrono::steady_clock::time_point& deadline );
+
+    /** @return The event the server main loop sleeps on. */
+    static WakeEvent& MainLoop();
+
+protected:
+    std::atomic<bool> mSignaled;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+};
+
+/* wakes the main loop early; called by network, login and console threads when they have work for it */
+#define sMainLoopWake \
+    ( WakeEvent::MainLoop() )
+
+#endif /* !__THREADING__WAKE_EVENT_H__INCL__ */
@@ -29,6 +29,7 @@
 #include "eve-core.h"
 
 #include "utils/Deflate.h"
+#include "utils/Metrics.h"
 
 const uint8 DeflateHeaderByte = 0x78; //'x'
 
@@ -49,6 +50,9 @@ bool DeflateData( Buffer& data )
 
 bool DeflateData( const Buffer& input, Buffer& output )
 {
+    static MetricCounter& bytesIn = sMetrics.GetCounter( "evemu_deflate_bytes_total", "Bytes through DeflateData(), before (in) and after (out).", {{"stage", "in"}} );
+    static MetricCounter& bytesOut = sMetrics.GetCounter( "evemu_deflate_bytes_total", "Bytes through DeflateData(), before (in) and after (out).", {{"stage", "out"}} );
+
     const Buffer::iterator<uint8> out = output.end<uint8>();
 
     size_t outputSize = compressBound( input.size() );
@@ -59,6 +63,8 @@ bool DeflateData( const Buffer& input, Buffer& output )
     if( Z_OK == res )
     {
         output.ResizeAt( out, outputSize );
+        bytesIn.Inc( input.size() );
+        bytesOut.Inc( outputSize );
         return true;
     }
     else
@@ -80,6 +86,9 @@ bool InflateData( Buffer& data )
 
 bool InflateData( const Buffer& input, Buffer& output )
 {
+    static MetricCounter& bytesIn = sMetrics.GetCounter( "evemu_inflate_bytes_total", "Bytes through InflateData(), before (in) and after (out).", {{"stage", "in"}} );
+    static MetricCounter& bytesOut = sMetrics.GetCounter( "evemu_inflate_bytes_total", "Bytes through InflateData(), before (in) and after (out).", {{"stage", "out"}} );
+
     const Buffer::iterator<uint8> out = output.end<uint8>();
 
     size_t outputSize = 0;
@@ -97,6 +106,8 @@ bool InflateData( const Buffer& input, Buffer& output )
     if( Z_OK == res )
     {
         output.ResizeAt( out, outputSize );
+        bytesIn.Inc( input.size() );
+        bytesOut.Inc( outputSize );
         return true;
     }
     else
@@ -0,0 +1,243 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-core.h"
+
+#include "log/LogNew.h"
+#include "utils/Metrics.h"
+
+const std::vector<double> MetricRegistry::TIME_BUCKETS = {
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5
+};
+
+namespace {
+
+const char* const TYPE_NAMES[] = {
+    "counter",
+    "gauge",
+    "histogram"
+};
+
+void AppendValue( std::string& into, double value )
+{
+    char buf[ 32 ];
+    snprintf( buf, sizeof( buf ), "%.17g", value );
+    into += buf;
+}
+
+void AppendValue( std::string& into, int64 value )
+{
+    into += std::to_string( value );
+}
+
+// name{labels} value
+template<typename T>
+void AppendSample( std::string& into, const std::string& name, const char* suffix, const std::string& labels, const std::string& extra, T value )
+{
+    into += name;
+    into += suffix;
+    if (!labels.empty() or !extra.empty()) {
+        into += '{';
+        into += labels;
+        if (!labels.empty() and !extra.empty())
+            into += ',';
+        into += extra;
+        into += '}';
+    }
+    into += ' ';
+    AppendValue( into, value );
+    into += '\n';
+}
+
+}
+
+MetricHistogram::MetricHistogram( const std::vector<double>& bounds )
+: mBounds( bounds ),
+  mBuckets( new std::atomic<int64>[ bounds.size() + 1 ] ),
+  mSum( 0 )
+{
+    for (size_t i = 0; i <= mBounds.size(); ++i)
+        mBuckets[ i ].store( 0, std::memory_order_relaxed );
+}
+
+void MetricHistogram::Observe( double value )
+{
+    size_t index(0);
+    while ((index < mBounds.size()) and (value > mBounds[ index ]))
+        ++index;
+
+    mBuckets[ index ].fetch_add( 1, std::memory_order_relaxed );
+    mSum.fetch_add( (int64)( value * 1e6 ), std::memory_order_relaxed );
+}
+
+MetricRegistry::MetricRegistry()
+{
+}
+
+MetricRegistry::~MetricRegistry()
+{
+    for (auto& family : mFamilies)
+        for (auto& cur : family.second.series)
+            DeleteSeries( cur.second );
+    for (auto& family : mDiscarded)
+        for (auto& cur : family.second.series)
+            DeleteSeries( cur.second );
+}
+
+MetricCounter& MetricRegistry::GetCounter( const char* name, const char* help, const MetricLabels& labels/*MetricLabels()*/ )
+{
+    MutexLock lock( mMutex );
+    Series& series = GetSeries( name, help, TYPE_COUNTER, labels );
+    if (series.counter == nullptr)
+        series.counter = new MetricCounter();
+    return *series.counter;
+}
+
+MetricGauge& MetricRegistry::GetGauge( const char* name, const char* help, const MetricLabels& labels/*MetricLabels()*/ )
+{
+    MutexLock lock( mMutex );
+    Series& series = GetSeries( name, help, TYPE_GAUGE, labels );
+    if (series.gauge == nullptr)
+        series.gauge = new MetricGauge();
+    return *series.gauge;
+}
+
+MetricHistogram& MetricRegistry::GetHistogram( const char* name, const char* help, const MetricLabels& labels/*MetricLabels()*/,
+                                               const std::vector<double>& bounds/*TIME_BUCKETS*/ )
+{
+    MutexLock lock( mMutex );
+    Series& series = GetSeries( name, help, TYPE_HISTOGRAM, labels );
+    if (series.histogram == nullptr)
+        series.histogram = new MetricHistogram( bounds );
+    return *series.histogram;
+}
+
+void MetricRegistry::AddGaugeFunc( const char* name, const char* help, const MetricLabels& labels, const std::function<int64()>& func )
+{
+    MutexLock lock( mMutex );
+    GetSeries( name, help, TYPE_GAUGE, labels ).func = func;
+}
+
+void MetricRegistry::Remove( const char* name, const MetricLabels& labels )
+{
+    MutexLock lock( mMutex );
+    std::map<std::string, Family>::iterator family = mFamilies.find( name );
+    if (family == mFamilies.end())
+        return;
+
+    std::map<std::string, Series>::iterator itr = family->second.series.find( RenderLabels( labels ) );
+    if (itr == family->second.series.end())
+        return;
+
+    DeleteSeries( itr->second );
+    family->second.series.erase( itr );
+}
+
+std::string MetricRegistry::Serialize()
+{
+    std::string out;
+    MutexLock lock( mMutex );
+    for (auto& family : mFamilies) {
+        if (family.second.series.empty())
+            continue;
+
+        const std::string& name = family.first;
+        out += "# HELP " + name + " " + family.second.help + "\n";
+        out += "# TYPE " + name + " " + TYPE_NAMES[ family.second.type ] + "\n";
+
+        for (auto& cur : family.second.series) {
+            const Series& series = cur.second;
+            if (series.counter != nullptr) {
+                AppendSample( out, name, "", cur.first, "", series.counter->Get() );
+            } else if (series.gauge != nullptr) {
+                AppendSample( out, name, "", cur.first, "", series.gauge->Get() );
+            } else if (series.func) {
+                AppendSample( out, name, "", cur.first, "", series.func() );
+            } else if (series.histogram != nullptr) {
+                // buckets are read once each, so _count always matches the +Inf bucket
+                const std::vector<double>& bounds = series.histogram->GetBounds();
+                int64 count(0);
+                for (size_t i = 0; i < bounds.size(); ++i) {
+                    count += series.histogram->GetBucket( i );
+                    std::string le( "le=\"" );
+                    AppendValue( le, bounds[ i ] );
+                    le += '"';
+                    AppendSample( out, name, "_bucket", cur.first, le, count );
+                }
+                count += series.histogram->GetBucket( bounds.size() );
+                AppendSample( out, name, "_bucket", cur.first, "le=\"+Inf\"", count );
+                AppendSample( out, name, "_sum", cur.first, "", series.histogram->GetSum() );
+                AppendSample( out, name, "_count", cur.first, "", count );
+            }
+        }
+    }
+
+    return out;
+}
+
+MetricRegistry::Series& MetricRegistry::GetSeries( const char* name, const char* help, Type type, const MetricLabels& labels )
+{
+    std::map<std::string, Family>::iterator itr = mFamilies.find( name );
+    if (itr == mFamilies.end()) {
+        itr = mFamilies.emplace( name, Family() ).first;
+        itr->second.type = type;
+        itr->second.help = help;
+    } else if (itr->second.type != type) {
+        // keep the caller working, but out of the scrape
+        sLog.Error( "MetricRegistry", "Metric '%s' is a %s; requested as a %s.", name, TYPE_NAMES[ itr->second.type ], TYPE_NAMES[ type ] );
+        itr = mDiscarded.emplace( name, Family() ).first;
+        itr->second.type = type;
+    }
+
+    return itr->second.series[ RenderLabels( labels ) ];
+}
+
+void MetricRegistry::DeleteSeries( Series& series )
+{
+    SafeDelete( series.counter );
+    SafeDelete( series.gauge );
+    SafeDelete( series.histogram );
+}
+
+std::string MetricRegistry::RenderLabels( const MetricLabels& labels )
+{
+    std::string out;
+    for (auto& cur : labels) {
+        if (!out.empty())
+            out += ',';
+        out += cur.first;
+        out += "=\"";
+        for (auto c : cur.second) {
+            switch (c) {
+                case '\\': out += "\\\\"; break;
+                case '"':  out += "\\\""; break;
+                case '\n': out += "\\n";  break;
+                default:   out += c;      break;
+            }
+        }
+        out += '"';
+    }
+    return out;
+}
@@ -0,0 +1,165 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#ifndef __UTILS__METRICS_H__INCL__
+#define __UTILS__METRICS_H__INCL__
+
+#include <atomic>
+
+#include "threading/Mutex.h"
+#include "utils/Singleton.h"
+
+/// label name/value pairs of one series, ie. {{"system", "Jita"}}
+typedef std::vector<std::pair<std::string, std::string>> MetricLabels;
+
+/** @brief Monotonic count; updated with one relaxed atomic add. */
+class MetricCounter
+{
+public:
+    MetricCounter() : mValue( 0 ) { }
+
+    void Inc( int64 count=1 )               { mValue.fetch_add( count, std::memory_order_relaxed ); }
+    int64 Get() const                       { return mValue.load( std::memory_order_relaxed ); }
+
+protected:
+    std::atomic<int64> mValue;
+};
+
+/** @brief Value that goes up and down; updated with one relaxed atomic op. */
+class MetricGauge
+{
+public:
+    MetricGauge() : mValue( 0 ) { }
+
+    void Set( int64 value )                 { mValue.store( value, std::memory_order_relaxed ); }
+    void Add( int64 value )                 { mValue.fetch_add( value, std::memory_order_relaxed ); }
+    int64 Get() const                       { return mValue.load( std::memory_order_relaxed ); }
+
+protected:
+    std::atomic<int64> mValue;
+};
+
+/**
+ * @brief Distribution of observed values, in fixed buckets.
+ *
+ * Observe() is a bucket search plus two relaxed atomic adds; the sum is
+ * kept in fixed point (1/1e6 units) so it can be added atomically too.
+ */
+class MetricHistogram
+{
+public:
+    /// @param[in] bounds Upper bucket bounds, ascending; +Inf is implied.
+    MetricHistogram( const std::vector<double>& bounds );
+
+    void Observe( double value );
+
+    const std::vector<double>& GetBounds() const { return mBounds; }
+    /// @return Observations in bucket index (not cumulative); index GetBounds().size() is +Inf.
+    int64 GetBucket( size_t index ) const   { return mBuckets[ index ].load( std::memory_order_relaxed ); }
+    double GetSum() const                   { return mSum.load( std::memory_order_relaxed ) / 1e6; }
+
+protected:
+    const std::vector<double> mBounds;
+    std::unique_ptr<std::atomic<int64>[]> mBuckets;
+    std::atomic<int64> mSum;
+};
+
+/**
+ * @brief Process wide metrics, served in the Prometheus text format.
+ *
+ * Metrics are looked up (and created) by name and labels, under the
+ * registry lock; callers keep the returned reference and update it
+ * lock free from any thread.  References stay valid until the series
+ * is Remove()d, or for the life of the process.
+ *
+ * Serialize() only reads the atomics, under the registry lock, so
+ * scraping never waits on the main loop or any other thread doing work;
+ * it only holds off registrations while it runs.
+ *
+ * Gauge functions are called by Serialize() on the scraping thread, so
+ * they must only read atomics or other thread safe state.
+ *
+ * The singleton is not thread safe on first access, so main() should
+ * touch it before starting other threads.
+ */
+class MetricRegistry
+: public Singleton<MetricRegistry>
+{
+public:
+    MetricRegistry();
+    ~MetricRegistry();
+
+    /// Default histogram buckets, in seconds; 100us to 2.5s.
+    static const std::vector<double> TIME_BUCKETS;
+
+    MetricCounter& GetCounter( const char* name, const char* help, const MetricLabels& labels=MetricLabels() );
+    MetricGauge& GetGauge( const char* name, const char* help, const MetricLabels& labels=MetricLabels() );
+    MetricHistogram& GetHistogram( const char* name, const char* help, const MetricLabels& labels=MetricLabels(), const std::vector<double>& bounds=TIME_BUCKETS );
+    /// Adds (or replaces) a gauge whose value is read by calling func at scrape time.
+    void AddGaugeFunc( const char* name, const char* help, const MetricLabels& labels, const std::function<int64()>& func );
+
+    /// Removes a series; references to it are invalid afterwards.
+    void Remove( const char* name, const MetricLabels& labels );
+
+    /// @return All metrics in the Prometheus text exposition format (version 0.0.4).
+    std::string Serialize();
+
+protected:
+    enum Type {
+        TYPE_COUNTER,
+        TYPE_GAUGE,
+        TYPE_HISTOGRAM
+    };
+
+    struct Series {
+        Series() : counter( nullptr ), gauge( nullptr ), histogram( nullptr ) { }
+
+        MetricCounter* counter;
+        MetricGauge* gauge;
+        MetricHistogram* histogram;
+        std::function<int64()> func;
+    };
+
+    struct Family {
+        Type type;
+        std::string help;
+        /// by rendered label string, ie. 'system="Jita"'
+        std::map<std::string, Series> series;
+    };
+
+    Series& GetSeries( const char* name, const char* help, Type type, const MetricLabels& labels );
+    static void DeleteSeries( Series& series );
+    static std::string RenderLabels( const MetricLabels& labels );
+
+    Mutex mMutex;
+    std::map<std::string, Family> mFamilies;
+    /// series requested with the wrong type; kept alive, but not served
+    std::map<std::string, Family> mDiscarded;
+};
+
+#define sMetrics \
+    ( MetricRegistry::get() )
+
+#endif /* !__UTILS__METRICS_H__INCL__ */
@@ -0,0 +1,229 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-core.h"
+
+#include "utils/Trace.h"
+
+const uint32 TraceRecorder::RING_SIZE;
+const uint32 TraceRecorder::SMALL_RING_SIZE;
+std::atomic<bool> TraceRecorder::mEnabled( false );
+
+/* owns the calling thread's ring, and hands it back for reuse when the thread exits */
+struct TraceThread
+{
+    TraceThread() : ring( nullptr ), size( TraceRecorder::RING_SIZE ) { }
+    ~TraceThread()
+    {
+        if (ring != nullptr)
+            sTrace.ReleaseRing( ring );
+    }
+
+    TraceRecorder::Ring* ring;
+    /// size of the ring this thread will get
+    uint32 size;
+};
+
+namespace {
+
+thread_local TraceThread tThread;
+
+void AppendString( std::string& into, const char* str )
+{
+    into += '"';
+    for (; *str != '\0'; ++str) {
+        switch (*str) {
+            case '"':   into += "\\\""; break;
+            case '\\':  into += "\\\\"; break;
+            case '\n':  into += "\\n";  break;
+            case '\r':  into += "\\r";  break;
+            case '\t':  into += "\\t";  break;
+            default: {
+                if ((uint8)*str < 0x20) {
+                    char buf[ 8 ];
+                    snprintf( buf, sizeof( buf ), "\\u%04x", (uint8)*str );
+                    into += buf;
+                } else {
+                    into += *str;
+                }
+            } break;
+        }
+    }
+    into += '"';
+}
+
+}
+
+TraceRecorder::TraceRecorder()
+: mNextTid( 0 ),
+  mStartTime( Now() )
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    // rings are left to the OS; detached threads may still be recording while the process exits
+}
+
+int64 TraceRecorder::Now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+void TraceRecorder::Record( const char* name, const char* detail, int64 start, int64 end )
+{
+    Ring* ring = GetRing();
+    int64 index = ring->head.load( std::memory_order_relaxed );
+    Event& event = ring->events[ index & ( ring->size - 1 ) ];
+
+    // seqlock write; Serialize() drops a span whose seq changed while it read it
+    event.seq.store( 2 * index + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+    event.name.store( name, std::memory_order_relaxed );
+    event.detail.store( detail, std::memory_order_relaxed );
+    event.start.store( start, std::memory_order_relaxed );
+    event.end.store( end, std::memory_order_relaxed );
+    event.seq.store( 2 * index + 2, std::memory_order_release );
+
+    ring->head.store( index + 1, std::memory_order_release );
+}
+
+void TraceRecorder::SetThreadName( const char* name )
+{
+    Ring* ring = GetRing();
+
+    MutexLock lock( mMutex );
+    ring->threadName = name;
+}
+
+void TraceRecorder::SetRingSize( uint32 size )
+{
+    assert( ( size > 0 ) and ( ( size & ( size - 1 ) ) == 0 ) );
+    if (tThread.ring == nullptr)
+        tThread.size = size;
+}
+
+const char* TraceRecorder::Intern( const std::string& str )
+{
+    MutexLock lock( mMutex );
+    // set nodes dont move, so the pointer stays good
+    return mStrings.insert( str ).first->c_str();
+}
+
+TraceRecorder::Ring* TraceRecorder::GetRing()
+{
+    if (tThread.ring != nullptr)
+        return tThread.ring;
+
+    MutexLock lock( mMutex );
+
+    Ring* ring(nullptr);
+    for (auto cur : mRings) {
+        if (!cur->inUse and (cur->size == tThread.size)) {
+            ring = cur;
+            break;
+        }
+    }
+
+    if (ring == nullptr) {
+        ring = new Ring();
+        ring->size = tThread.size;
+        ring->events.reset( new Event[ ring->size ] );
+        for (uint32 i = 0; i < ring->size; ++i)
+            ring->events[ i ].seq.store( 0, std::memory_order_relaxed );
+        ring->head.store( 0, std::memory_order_relaxed );
+        mRings.push_back( ring );
+    }
+
+    // a reused ring gets a new tid; the previous thread's spans are no longer served
+    ring->inUse = true;
+    ring->first = ring->head.load( std::memory_order_relaxed );
+    ring->tid = ++mNextTid;
+    ring->threadName = "thread " + std::to_string( ring->tid );
+
+    tThread.ring = ring;
+    return ring;
+}
+
+void TraceRecorder::ReleaseRing( Ring* ring )
+{
+    MutexLock lock( mMutex );
+    ring->inUse = false;
+}
+
+std::string TraceRecorder::Serialize( double seconds )
+{
+    const int64 since = Now() - (int64)( seconds * 1000000.0 );
+
+    std::string into( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" );
+    bool first(true);
+    char buf[ 96 ];
+
+    MutexLock lock( mMutex );
+    for (auto ring : mRings) {
+        const int64 head = ring->head.load( std::memory_order_acquire );
+        const int64 begin = std::max( ring->first, ( head > ring->size ? head - ring->size : 0 ) );
+        if (!ring->inUse and (begin == head))
+            continue;
+
+        snprintf( buf, sizeof( buf ), "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", ring->tid );
+        if (!first)
+            into += ',';
+        first = false;
+        into += buf;
+        AppendString( into, ring->threadName.c_str() );
+        into += "}}";
+
+        for (int64 i = begin; i < head; ++i) {
+            Event& event = ring->events[ i & ( ring->size - 1 ) ];
+            const int64 seq = event.seq.load( std::memory_order_acquire );
+            const char* name = event.name.load( std::memory_order_relaxed );
+            const char* detail = event.detail.load( std::memory_order_relaxed );
+            const int64 start = event.start.load( std::memory_order_relaxed );
+            const int64 end = event.end.load( std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_acquire );
+            // overwritten (or being written) by the ring's thread while we read it
+            if ((seq != 2 * i + 2) or (event.seq.load( std::memory_order_relaxed ) != seq))
+                continue;
+            if (start < since)
+                continue;
+
+            into += ",{\"ph\":\"X\",\"name\":";
+            AppendString( into, name );
+            snprintf( buf, sizeof( buf ), ",\"pid\":1,\"tid\":%u,\"ts\":%lli,\"dur\":%lli",
+                      ring->tid, (long long)( start - mStartTime ), (long long)( end - start ) );
+            into += buf;
+            if (detail != nullptr) {
+                into += ",\"args\":{\"detail\":";
+                AppendString( into, detail );
+                into += '}';
+            }
+            into += '}';
+        }
+    }
+    into += "]}";
+
+    return into;
+}
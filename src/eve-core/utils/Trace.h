@@ -0,0 +1,160 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#ifndef __UTILS__TRACE_H__INCL__
+#define __UTILS__TRACE_H__INCL__
+
+#include <atomic>
+#include <unordered_set>
+
+#include "threading/Mutex.h"
+#include "utils/Singleton.h"
+
+/**
+ * @brief Timed spans, kept for a Chrome trace (Perfetto) dump.
+ *
+ * Each thread records into its own ring of the last RING_SIZE spans,
+ * allocated on its first span (about 320KB) and handed to a later
+ * thread once it exits.  Threads that run one per client, like the
+ * TCPConnection loops, ask for SMALL_RING_SIZE (about 10KB) instead.
+ * Recording takes no lock, and a full ring overwrites its oldest span.
+ * Serialize() reads every ring, and renders the spans that started in
+ * the last few seconds as Chrome trace event JSON, which loads in
+ * chrome://tracing and ui.perfetto.dev.
+ *
+ * Span names and details are kept as pointers, so they must live for
+ * the life of the process: literals, interned PyStrings, or strings
+ * from Intern().
+ *
+ * The singleton is not thread safe on first access, so main() should
+ * touch it before starting other threads.
+ */
+class TraceRecorder
+: public Singleton<TraceRecorder>
+{
+public:
+    TraceRecorder();
+    ~TraceRecorder();
+
+    /// Spans kept per thread.
+    static const uint32 RING_SIZE = 8192;
+    /// Spans kept per thread, for threads that call SetRingSize( SMALL_RING_SIZE ).
+    static const uint32 SMALL_RING_SIZE = 256;
+
+    static bool IsEnabled()                 { return mEnabled.load( std::memory_order_relaxed ); }
+    static void SetEnabled( bool enabled )  { mEnabled.store( enabled, std::memory_order_relaxed ); }
+    /// @return Microseconds on the steady clock.
+    static int64 Now();
+
+    /// Records one span on the calling thread.
+    void Record( const char* name, const char* detail, int64 start, int64 end );
+    /// Names the calling thread in dumps; default is 'thread <n>'.
+    void SetThreadName( const char* name );
+    /// Sets the calling thread's ring size, a power of two; ignored once it has a ring.
+    static void SetRingSize( uint32 size );
+    /// @return A copy of str that lives for the life of the process; for span names built at runtime.
+    const char* Intern( const std::string& str );
+
+    /// @return Spans started in the last 'seconds', as Chrome trace event JSON.
+    std::string Serialize( double seconds );
+
+protected:
+    /* one span; fields are atomics so Serialize() can read a ring while its thread writes it */
+    struct Event {
+        /// 2*index+1 while being written, 2*index+2 once written
+        std::atomic<int64> seq;
+        std::atomic<const char*> name;
+        std::atomic<const char*> detail;
+        std::atomic<int64> start;
+        std::atomic<int64> end;
+    };
+    struct Ring {
+        std::unique_ptr<Event[]> events;
+        /// spans written; only the owning thread writes it
+        std::atomic<int64> head;
+        /// first span of the current owner; older ones belong to a thread that exited
+        int64 first;
+        /// spans kept; a power of two
+        uint32 size;
+        uint32 tid;
+        std::string threadName;
+        bool inUse;
+    };
+    friend struct TraceThread;
+
+    Ring* GetRing();
+    void ReleaseRing( Ring* ring );
+
+    static std::atomic<bool> mEnabled;
+
+    /// protects the ring list, ring ownership and names, and mStrings
+    Mutex mMutex;
+    std::vector<Ring*> mRings;
+    uint32 mNextTid;
+    int64 mStartTime;
+    std::unordered_set<std::string> mStrings;
+};
+
+#define sTrace \
+    ( TraceRecorder::get() )
+
+/**
+ * @brief Records a span for its scope.
+ *
+ * While tracing is off this costs one relaxed load and a branch on
+ * entry, and a test of mName on exit.
+ */
+class TraceSpan
+{
+public:
+    TraceSpan( const char* name, const char* detail=nullptr )
+    {
+        if (TraceRecorder::IsEnabled()) {
+            mName = name;
+            mDetail = detail;
+            mStart = TraceRecorder::Now();
+        } else {
+            mName = nullptr;
+        }
+    }
+    ~TraceSpan()
+    {
+        if (mName != nullptr)
+            sTrace.Record( mName, mDetail, mStart, TraceRecorder::Now() );
+    }
+
+protected:
+    const char* mName;
+    const char* mDetail;
+    int64 mStart;
+};
+
+#define TRACE_SPAN_NAME2( line ) _traceSpan##line
+#define TRACE_SPAN_NAME( line ) TRACE_SPAN_NAME2( line )
+/// Records a span from here to the end of the enclosing scope.
+#define TRACE_SPAN( ... ) \
+    TraceSpan TRACE_SPAN_NAME( __LINE__ )( __VA_ARGS__ )
+
+#endif /* !__UTILS__TRACE_H__INCL__ */
@@ -0,0 +1,690 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-loadtest.h"
+
+#include "LoadBot.h"
+#include "LoadStats.h"
+
+// loop/wait steps dont send anything, so cap how many run per Process() in case a loop has nothing else
+static const uint8 MAX_STEPS_PER_PROCESS = 64;
+
+LoadBot::LoadBot( uint32 number, const LoadConfig& config, const LoadScenario& scenario, LoadStats& stats, const std::vector<LoadBot*>& bots )
+: mNumber( number ),
+  mConfig( config ),
+  mScenario( scenario ),
+  mStats( stats ),
+  mBots( bots ),
+  mName( config.prefix + std::to_string( number ) ),
+  mNet( nullptr ),
+  mState( STATE_VERSION ),
+  mConnectTime( 0.0 ),
+  mUserID( 0 ),
+  mClientID( 0 ),
+  mNodeID( 0 ),
+  mCharID( 0 ),
+  mShipID( 0 ),
+  mStationID( 0 ),
+  mSystemID( 0 ),
+  mLastCallID( 0 ),
+  mStep( 0 ),
+  mWaitUntil( 0.0 ),
+  mJoinedChannel( 0 ),
+  mNextBookmark( 0 ),
+  mNextTarget( number )
+{
+}
+
+LoadBot::~LoadBot()
+{
+    SafeDelete( mNet );
+}
+
+bool LoadBot::Connect()
+{
+    char errbuf[ TCPCONN_ERRBUF_SIZE ];
+    mNet = new EVETCPConnection();
+    mConnectTime = GetTimeMSeconds();
+    if (!mNet->Connect( mConfig.ip, mConfig.port, errbuf )) {
+        Fail( "Connect failed: %s", errbuf );
+        return false;
+    }
+
+    mState = STATE_VERSION;
+    return true;
+}
+
+void LoadBot::Fail( const char* fmt, ... )
+{
+    va_list args;
+    va_start( args, fmt );
+    char* str(nullptr);
+    vasprintf( &str, fmt, args );
+    va_end( args );
+
+    sLog.Error( "LoadBot", "%s: %s", mName.c_str(), str );
+    free( str );
+
+    mState = STATE_FAILED;
+    if (mNet != nullptr)
+        mNet->Disconnect();
+}
+
+bool LoadBot::Process()
+{
+    if (mState >= STATE_DONE)
+        return false;
+
+    if (mNet->GetState() != TCPConnection::STATE_CONNECTED) {
+        Fail( "Connection lost." );
+        return false;
+    }
+
+    PyRep* rep(nullptr);
+    PyPacket* packet(nullptr);
+    while (mState < STATE_DONE) {
+        packet = mNet->PopPacket( rep );
+        if (packet == nullptr) {
+            if (rep == nullptr)
+                break;
+
+            if (mState != STATE_READY) {
+                HandleHandshake( rep );
+                continue;
+            }
+
+            // received before decoding was switched on
+            packet = new PyPacket();
+            if (!packet->Decode( &rep )) {  //rep is consumed here
+                SafeDelete( packet );
+                continue;
+            }
+        }
+
+        HandlePacket( packet );
+        SafeDelete( packet );
+    }
+
+    if (mState == STATE_READY)
+        Tick();
+
+    mNet->FlushSendQueue();
+    return (mState < STATE_DONE);
+}
+
+void LoadBot::Tick()
+{
+    for (uint8 i = 0; i < MAX_STEPS_PER_PROCESS; ++i) {
+        if ((mState != STATE_READY) or !mPending.empty() or (GetTimeMSeconds() < mWaitUntil))
+            break;
+        RunStep();
+    }
+}
+
+/*************************************************************************/
+/* handshake                                                             */
+/*************************************************************************/
+void LoadBot::HandleHandshake( PyRep* rep )
+{
+    switch (mState) {
+        case STATE_VERSION: {
+            VersionExchangeServer server;
+            if (!server.Decode( &rep )) {
+                Fail( "Received invalid version exchange." );
+                return;
+            }
+
+            // echo their version, then send everything up to the login in one go.  the server handles them in order.
+            VersionExchangeClient version;
+                version.birthday = server.birthday;
+                version.macho_version = server.macho_version;
+                version.user_count = server.user_count;
+                version.version_number = server.version_number;
+                version.build_version = server.build_version;
+                version.project_version = server.project_version;
+            PyRep* res(version.Encode());
+            mNet->QueueRep( res );
+
+            NetCommand_VK vk;
+                vk.vipKey = "loadtest";
+            res = vk.Encode();
+            mNet->QueueRep( res );
+
+            CryptoRequestPacket cr;
+                cr.keyVersion = "placebo";
+                cr.keyParams = new PyDict();
+            res = cr.Encode();
+            mNet->QueueRep( res );
+
+            CryptoChallengePacket ccp;
+                ccp.clientChallenge = "";
+                ccp.macho_version = server.macho_version;
+                ccp.boot_version = server.version_number;
+                ccp.boot_build = server.build_version;
+                ccp.boot_codename = server.project_version;
+                ccp.boot_region = "ccp";
+                ccp.user_name = mName;
+                ccp.user_password = mConfig.password;
+                ccp.user_password_hash = "";
+                ccp.user_languageid = "EN";
+                ccp.user_affiliateid = 0;
+            res = ccp.Encode();
+            mNet->QueueRep( res );
+
+            mState = STATE_LOGIN;
+        } break;
+        case STATE_LOGIN: {
+            // "OK CC" for the crypto request, then the password version
+            if (rep->IsString() or rep->IsInt()) {
+                PyDecRef( rep );
+                return;
+            }
+            if (rep->IsObjectEx()) {
+                // GPSTransportClosed
+                PyDecRef( rep );
+                Fail( "Login refused." );
+                return;
+            }
+
+            CryptoServerHandshake server;
+            if (!server.Decode( &rep )) {
+                Fail( "Received invalid server handshake." );
+                return;
+            }
+
+            CryptoHandshakeResult result;
+                result.challenge_responsehash = server.challenge_responsehash;
+                result.func_output = "";
+                result.func_result = PyStatic.NewNone();
+            PyRep* res(result.Encode());
+            mNet->QueueRep( res );
+
+            mState = STATE_HANDSHAKE;
+        } break;
+        case STATE_HANDSHAKE: {
+            CryptoHandshakeAck ack;
+            if (!ack.Decode( &rep )) {
+                Fail( "Received invalid handshake ack." );
+                return;
+            }
+
+            mUserID = ack.userid;
+            mClientID = ack.user_clientid;
+            mStats.AddCall( "login", GetTimeMSeconds() - mConnectTime );
+
+            mNet->SetDecodePackets( true );
+            mState = STATE_READY;
+        } break;
+        default: {
+            PyDecRef( rep );
+        } break;
+    }
+}
+
+/*************************************************************************/
+/* packets                                                               */
+/*************************************************************************/
+void LoadBot::HandlePacket( PyPacket* packet )
+{
+    switch (packet->type) {
+        case CALL_RSP: {
+            HandleCallRsp( packet, false );
+        } break;
+        case ERRORRESPONSE: {
+            HandleCallRsp( packet, true );
+        } break;
+        case SESSIONCHANGENOTIFICATION: {
+            SessionChangeNotification scn;
+            if (scn.Decode( packet->payload ))
+                HandleSessionChange( scn.changes, false );
+        } break;
+        case SESSIONINITIALSTATENOTIFICATION: {
+            SessionInitialState sis;
+            if (sis.Decode( packet->payload ))
+                HandleSessionChange( sis.initialstate, true );
+        } break;
+        case NOTIFICATION: {
+            mStats.AddNotification();
+        } break;
+        default: {
+            // pings and the like; nothing to do
+        } break;
+    }
+}
+
+void LoadBot::HandleCallRsp( PyPacket* packet, bool error )
+{
+    std::map<int64, PendingCall>::iterator itr = mPending.find( packet->dest.callID );
+    if (itr == mPending.end())
+        return;
+
+    PendingCall pending( itr->second );
+    mPending.erase( itr );
+
+    PyRep* result( error ? nullptr : GetCallResult( packet ) );
+    mStats.AddCall( pending.name, GetTimeMSeconds() - pending.sendTime, error or (result == nullptr) );
+
+    if (!pending.bindService.empty() and (result != nullptr)) {
+        std::string bind;
+        if (SplitBindResult( result, bind ))
+            SetBind( pending.bindService, bind );
+        else
+            result = nullptr;
+    }
+
+    (this->*pending.handler)( result );
+}
+
+void LoadBot::SetBind( const std::string& service, const std::string& bind )
+{
+    uint32 nodeID(0), bindID(0);
+    if (sscanf( bind.c_str(), "N=%u:%u", &nodeID, &bindID ) != 2)
+        return;
+
+    mNodeID = nodeID;
+    mBinds[ service ] = bind;
+}
+
+PyRep* LoadBot::GetCallResult( PyPacket* packet )
+{
+    // result is in a substream; errors arent
+    if ((packet->payload == nullptr) or (packet->payload->size() == 0) or !packet->payload->GetItem( 0 )->IsSubStream())
+        return nullptr;
+
+    PySubStream* ss = packet->payload->GetItem( 0 )->AsSubStream();
+    ss->DecodeData();
+    return ss->decoded();
+}
+
+bool LoadBot::SplitBindResult( PyRep*& result, std::string& bind )
+{
+    // MachoBindObject returns (substruct(substream(OID)), callResult), OID being (bindString, timestamp)
+    if (!result->IsTuple() or (result->AsTuple()->size() != 2) or !result->AsTuple()->GetItem( 0 )->IsSubStruct())
+        return false;
+
+    PyRep* sub = result->AsTuple()->GetItem( 0 )->AsSubStruct()->sub();
+    if (!sub->IsSubStream())
+        return false;
+
+    sub->AsSubStream()->DecodeData();
+    PyRep* oid = sub->AsSubStream()->decoded();
+    if ((oid == nullptr) or !oid->IsTuple() or (oid->AsTuple()->size() == 0))
+        return false;
+
+    bind = PyRep::StringContent( oid->AsTuple()->GetItem( 0 ) );
+    result = result->AsTuple()->GetItem( 1 );
+    return true;
+}
+
+void LoadBot::HandleSessionChange( PyDict* changes, bool initial )
+{
+    if (changes == nullptr)
+        return;
+
+    const uint32 oldStation(mStationID), oldSystem(mSystemID);
+    for (PyDict::const_iterator cur = changes->begin(); cur != changes->end(); ++cur) {
+        // changes are (old, new)
+        PyRep* value(cur->second);
+        if (!initial) {
+            if (!value->IsTuple() or (value->AsTuple()->size() != 2))
+                continue;
+            value = value->AsTuple()->GetItem( 1 );
+        }
+
+        const std::string key( PyRep::StringContent( cur->first ) );
+        if (key == "charid") {
+            mCharID = PyRep::IntegerValueU32( value );
+        } else if (key == "shipid") {
+            mShipID = PyRep::IntegerValueU32( value );
+        } else if (key == "stationid") {
+            mStationID = PyRep::IntegerValueU32( value );
+        } else if (key == "solarsystemid2") {
+            mSystemID = PyRep::IntegerValueU32( value );
+        }
+    }
+
+    // bound objects are per location
+    if ((oldStation != mStationID) or (oldSystem != mSystemID))
+        mBinds.clear();
+}
+
+/*************************************************************************/
+/* calls                                                                 */
+/*************************************************************************/
+void LoadBot::Call( const char* service, const char* method, PyTuple* args, CallHandler handler, PyDict* kwargs/*nullptr*/ )
+{
+    PyAddress dest;
+        dest.type = PyAddress::Any;
+        dest.service = service;
+
+    PendingCall pending;
+        pending.name = std::string( service ) + "." + method;
+        pending.handler = handler;
+
+    SendCall( dest, new PyInt( 1 ), method, args, kwargs, pending );
+}
+
+void LoadBot::CallBound( const char* service, PyRep* bindParams, const char* method, PyTuple* args, CallHandler handler, PyDict* kwargs/*nullptr*/ )
+{
+    PendingCall pending;
+        pending.name = std::string( service ) + "." + method;
+        pending.handler = handler;
+
+    std::map<std::string, std::string>::const_iterator itr = mBinds.find( service );
+    if (itr != mBinds.end()) {
+        PyDecRef( bindParams );
+
+        PyAddress dest;
+            dest.type = PyAddress::Node;
+            dest.objectID = mNodeID;
+
+        SendCall( dest, new PyString( itr->second ), method, args, kwargs, pending );
+        return;
+    }
+
+    // bind and call in one go, like the client does
+    PyTuple* call = new PyTuple( 3 );
+        call->SetItem( 0, new PyString( method ) );
+        call->SetItem( 1, args );
+        call->SetItem( 2, ( kwargs == nullptr ? new PyDict() : kwargs ) );
+    PyTuple* bindArgs = new PyTuple( 2 );
+        bindArgs->SetItem( 0, bindParams );
+        bindArgs->SetItem( 1, call );
+
+    PyAddress dest;
+        dest.type = PyAddress::Any;
+        dest.service = service;
+
+    pending.bindService = service;
+    SendCall( dest, new PyInt( 1 ), "MachoBindObject", bindArgs, nullptr, pending );
+}
+
+void LoadBot::SendCall( const PyAddress& dest, PyRep* remoteObject, const char* method, PyTuple* args, PyDict* kwargs, PendingCall& pending )
+{
+    // payload is ((flag, substream((remoteObject, method, args, kwargs))),)  see PyCallStream::Decode()
+    PyTuple* call = new PyTuple( 4 );
+        call->SetItem( 0, remoteObject );
+        call->SetItem( 1, new PyString( method ) );
+        call->SetItem( 2, args );
+        call->SetItem( 3, ( kwargs == nullptr ? PyStatic.NewNone() : kwargs ) );
+    PyTuple* stream = new PyTuple( 2 );
+        stream->SetItem( 0, new PyInt( remoteObject->IsString() ? 1 : 0 ) );
+        stream->SetItem( 1, new PySubStream( call ) );
+
+    PyPacket packet;
+        packet.type_string = "macho.CallReq";
+        packet.type = CALL_REQ;
+        packet.source.type = PyAddress::Client;
+        packet.source.objectID = mClientID;
+        packet.source.callID = ++mLastCallID;
+        packet.dest = dest;
+        packet.userid = mUserID;
+        packet.payload = new PyTuple( 1 );
+        packet.payload->SetItem( 0, stream );
+
+    PyRep* rep(packet.Encode());
+    // Encode() hands the payload over to rep
+    packet.payload = nullptr;
+    mNet->QueueRep( rep );    //consumed
+
+    pending.sendTime = GetTimeMSeconds();
+    mPending[ mLastCallID ] = pending;
+}
+
+/*************************************************************************/
+/* scenario                                                              */
+/*************************************************************************/
+void LoadBot::NextStep()
+{
+    ++mStep;
+}
+
+void LoadBot::RunStep()
+{
+    if (mStep >= mScenario.size()) {
+        mState = STATE_DONE;
+        return;
+    }
+
+    const LoadStep& step = mScenario[ mStep ];
+    switch (step.op) {
+        case LoadStep::OP_SELECT: {
+            Call( "charUnboundMgr", "GetCharactersToSelect", new PyTuple( 0 ), &LoadBot::OnCharacters );
+        } break;
+        case LoadStep::OP_BOOKMARKS: {
+            Call( "bookmark", "GetBookmarks", new PyTuple( 0 ), &LoadBot::OnBookmarks );
+        } break;
+        case LoadStep::OP_ORDER: {
+            if (mStationID == 0) {
+                mStats.AddSkip( "marketProxy.PlaceCharOrder" );
+                NextStep();
+                break;
+            }
+
+            // 1 unit buy order, station range, 1 day
+            PyTuple* args = new PyTuple( 11 );
+                args->SetItem( 0, new PyInt( mStationID ) );
+                args->SetItem( 1, new PyInt( step.count ) );
+                args->SetItem( 2, new PyFloat( atof( step.text.c_str() ) ) );
+                args->SetItem( 3, new PyInt( 1 ) );
+                args->SetItem( 4, new PyInt( 1 ) );
+                args->SetItem( 5, new PyInt( -1 ) );
+                args->SetItem( 6, PyStatic.NewNone() );
+                args->SetItem( 7, new PyInt( 1 ) );
+                args->SetItem( 8, new PyInt( 1 ) );
+                args->SetItem( 9, new PyBool( false ) );
+                args->SetItem( 10, PyStatic.NewNone() );
+            Call( "marketProxy", "PlaceCharOrder", args, &LoadBot::OnDone );
+        } break;
+        case LoadStep::OP_CHAT: {
+            if (mSystemID == 0) {
+                mStats.AddSkip( "LSC.SendMessage" );
+                NextStep();
+                break;
+            }
+
+            if (mJoinedChannel != mSystemID) {
+                PyList* channels = new PyList();
+                    channels->AddItem( GetLocalChannel() );
+                PyTuple* args = new PyTuple( 2 );
+                    args->SetItem( 0, channels );
+                    args->SetItem( 1, new PyLong( 1 ) );
+                Call( "LSC", "JoinChannels", args, &LoadBot::OnChannelJoined );
+                break;
+            }
+
+            PyTuple* args = new PyTuple( 2 );
+                args->SetItem( 0, GetLocalChannel() );
+                args->SetItem( 1, new PyWString( step.text ) );
+            Call( "LSC", "SendMessage", args, &LoadBot::OnDone );
+        } break;
+        case LoadStep::OP_UNDOCK: {
+            if (mStationID == 0) {
+                mStats.AddSkip( "ship.Undock" );
+                NextStep();
+                break;
+            }
+
+            PyTuple* bindParams = new PyTuple( 2 );
+                bindParams->SetItem( 0, new PyInt( mStationID ) );
+                bindParams->SetItem( 1, new PyInt( EVEDB::invGroups::Station ) );
+            PyTuple* args = new PyTuple( 2 );
+                args->SetItem( 0, new PyInt( mShipID ) );
+                args->SetItem( 1, new PyBool( false ) );
+            CallBound( "ship", bindParams, "Undock", args, &LoadBot::OnUndocked );
+        } break;
+        case LoadStep::OP_WARP: {
+            uint32 bookmarkID(0);
+            if (IsInSpace()) {
+                for (size_t i = 0; i < mBookmarks.size(); ++i) {
+                    const std::pair<uint32, uint32>& bm = mBookmarks[ ( mNextBookmark + i ) % mBookmarks.size() ];
+                    if (bm.second == mSystemID) {
+                        bookmarkID = bm.first;
+                        mNextBookmark += i + 1;
+                        break;
+                    }
+                }
+            }
+            if (bookmarkID == 0) {
+                mStats.AddSkip( "beyonce.CmdWarpToStuff" );
+                NextStep();
+                break;
+            }
+
+            PyTuple* args = new PyTuple( 2 );
+                args->SetItem( 0, new PyString( "bookmark" ) );
+                args->SetItem( 1, new PyInt( bookmarkID ) );
+            CallBound( "beyonce", new PyInt( mSystemID ), "CmdWarpToStuff", args, &LoadBot::OnDone );
+        } break;
+        case LoadStep::OP_LOCK: {
+            LoadBot* target = FindTarget();
+            if (target == nullptr) {
+                mStats.AddSkip( "dogmaIM.AddTarget" );
+                NextStep();
+                break;
+            }
+
+            PyTuple* bindParams = new PyTuple( 2 );
+                bindParams->SetItem( 0, new PyInt( mSystemID ) );
+                bindParams->SetItem( 1, new PyInt( EVEDB::invGroups::Solar_System ) );
+            PyTuple* args = new PyTuple( 1 );
+                args->SetItem( 0, new PyInt( target->GetShipID() ) );
+            CallBound( "dogmaIM", bindParams, "AddTarget", args, &LoadBot::OnDone );
+        } break;
+        case LoadStep::OP_CALL: {
+            Call( step.text.c_str(), step.text2.c_str(), new PyTuple( 0 ), &LoadBot::OnDone );
+        } break;
+        case LoadStep::OP_WAIT: {
+            mWaitUntil = GetTimeMSeconds() + step.count;
+            NextStep();
+        } break;
+        case LoadStep::OP_LOOP: {
+            mLoops.push_back( step.count );
+            NextStep();
+        } break;
+        case LoadStep::OP_END: {
+            // a count of 0 loops until the run ends
+            uint32& left = mLoops.back();
+            if ((left == 0) or (--left > 0)) {
+                mStep = step.jump + 1;
+            } else {
+                mLoops.pop_back();
+                NextStep();
+            }
+        } break;
+    }
+}
+
+PyTuple* LoadBot::GetLocalChannel() const
+{
+    // (('solarsystemid2', systemID),)
+    PyTuple* desc = new PyTuple( 2 );
+        desc->SetItem( 0, new PyString( "solarsystemid2" ) );
+        desc->SetItem( 1, new PyInt( mSystemID ) );
+    PyTuple* channel = new PyTuple( 1 );
+        channel->SetItem( 0, desc );
+    return channel;
+}
+
+LoadBot* LoadBot::FindTarget()
+{
+    if (!IsInSpace())
+        return nullptr;
+
+    // round robin over the other bots in space here
+    for (size_t i = 0; i < mBots.size(); ++i) {
+        LoadBot* bot = mBots[ ++mNextTarget % mBots.size() ];
+        if ((bot != this) and (bot->GetState() == STATE_READY) and bot->IsInSpace()
+        and (bot->GetSystemID() == mSystemID) and (bot->GetShipID() != 0))
+            return bot;
+    }
+
+    return nullptr;
+}
+
+void LoadBot::OnCharacters( PyRep* result )
+{
+    // CRowset of (characterID, characterName, ...)
+    uint32 charID(0);
+    if ((result != nullptr) and result->IsObjectEx()) {
+        const PyList& rows = result->AsObjectEx()->list();
+        if ((rows.size() > 0) and rows.GetItem( 0 )->IsPackedRow())
+            charID = PyRep::IntegerValueU32( rows.GetItem( 0 )->AsPackedRow()->GetField( 0 ) );
+    }
+
+    if (charID == 0) {
+        Fail( "No character to select." );
+        return;
+    }
+
+    PyTuple* args = new PyTuple( 1 );
+        args->SetItem( 0, new PyInt( charID ) );
+    Call( "charUnboundMgr", "SelectCharacterID", args, &LoadBot::OnDone );
+}
+
+void LoadBot::OnBookmarks( PyRep* result )
+{
+    // (list of util.KeyVal, folders)
+    mBookmarks.clear();
+    if ((result != nullptr) and result->IsTuple() and (result->AsTuple()->size() > 0) and result->AsTuple()->GetItem( 0 )->IsList()) {
+        const PyList* list = result->AsTuple()->GetItem( 0 )->AsList();
+        for (PyList::const_iterator cur = list->begin(); cur != list->end(); ++cur) {
+            if (!(*cur)->IsObject() or !(*cur)->AsObject()->arguments()->IsDict())
+                continue;
+            const PyDict* bm = (*cur)->AsObject()->arguments()->AsDict();
+            mBookmarks.push_back( std::make_pair( PyRep::IntegerValueU32( bm->GetItemString( "bookmarkID" ) ),
+                                                  PyRep::IntegerValueU32( bm->GetItemString( "locationID" ) ) ) );
+        }
+    }
+
+    NextStep();
+}
+
+void LoadBot::OnUndocked( PyRep* result )
+{
+    if ((result == nullptr) or !IsInSpace()) {
+        NextStep();
+        return;
+    }
+
+    // the client binds the new system's ballpark next, which gets it the destiny state
+    CallBound( "beyonce", new PyInt( mSystemID ), "GetFormations", new PyTuple( 0 ), &LoadBot::OnDone );
+}
+
+void LoadBot::OnChannelJoined( PyRep* result )
+{
+    // SendMessage goes out on the next RunStep()
+    if (result != nullptr) {
+        mJoinedChannel = mSystemID;
+        return;
+    }
+
+    NextStep();
+}
+
+void LoadBot::OnDone( PyRep* result )
+{
+    NextStep();
+}
@@ -0,0 +1,172 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#ifndef __LOAD_BOT_H__INCL__
+#define __LOAD_BOT_H__INCL__
+
+#include "LoadScenario.h"
+
+class LoadStats;
+
+/** Settings shared by all bots. */
+struct LoadConfig
+{
+    uint32 ip;
+    uint16 port;
+    /// account names are <prefix><n>
+    std::string prefix;
+    std::string password;
+};
+
+/**
+ * @brief Headless client; logs in one account and runs the scenario on it.
+ *
+ * Speaks the macho protocol over EVETCPConnection: version exchange,
+ * placebo crypto, plain password login, then CallReq packets to
+ * services and bound objects.  Calls are sent one at a time, and their
+ * round trip is recorded in LoadStats.
+ *
+ * Accounts need a character that is docked; the bot selects the
+ * first one.
+ */
+class LoadBot
+{
+public:
+    LoadBot( uint32 number, const LoadConfig& config, const LoadScenario& scenario, LoadStats& stats, const std::vector<LoadBot*>& bots );
+    virtual ~LoadBot();
+
+    enum State {
+        STATE_VERSION,      ///< waiting for server version
+        STATE_LOGIN,        ///< login sent; waiting for server handshake
+        STATE_HANDSHAKE,    ///< waiting for handshake ack
+        STATE_READY,        ///< running scenario
+        STATE_DONE,
+        STATE_FAILED
+    };
+
+    bool Connect();
+    /**
+     * @brief Handles received packets and advances the scenario.
+     *
+     * @return false once the bot is done or has failed.
+     */
+    bool Process();
+
+    State GetState() const                              { return mState; }
+    const std::string& GetName() const                  { return mName; }
+    uint32 GetShipID() const                            { return mShipID; }
+    uint32 GetSystemID() const                          { return mSystemID; }
+    bool IsInSpace() const                              { return (mSystemID != 0) and (mStationID == 0); }
+
+protected:
+    typedef void (LoadBot::*CallHandler)( PyRep* result );
+
+    struct PendingCall {
+        std::string name;
+        /// service the call also binds, if any
+        std::string bindService;
+        double sendTime;
+        CallHandler handler;
+    };
+
+    void Fail( const char* fmt, ... );
+    /// Runs once per Process() while ready; runs scenario steps.
+    virtual void Tick();
+
+    /* handshake */
+    void HandleHandshake( PyRep* rep );
+
+    /* packets */
+    virtual void HandlePacket( PyPacket* packet );
+    void HandleCallRsp( PyPacket* packet, bool error );
+    void HandleSessionChange( PyDict* changes, bool initial );
+
+    /* calls */
+    void Call( const char* service, const char* method, PyTuple* args, CallHandler handler, PyDict* kwargs=nullptr );
+    /// calls method on a bound object of service; binds it first (in the same call) if needed.
+    void CallBound( const char* service, PyRep* bindParams, const char* method, PyTuple* args, CallHandler handler, PyDict* kwargs=nullptr );
+    void SendCall( const PyAddress& dest, PyRep* remoteObject, const char* method, PyTuple* args, PyDict* kwargs, PendingCall& pending );
+    /// remembers a bound object of service, from its bind string ("N=node:id").
+    void SetBind( const std::string& service, const std::string& bind );
+
+    /// @return decoded result of a CallRsp; NULL if there is none.
+    static PyRep* GetCallResult( PyPacket* packet );
+    /**
+     * @brief Splits a MachoBindObject result into its bind string and call result.
+     *
+     * @return false if result isnt a bind result.
+     */
+    static bool SplitBindResult( PyRep*& result, std::string& bind );
+
+    /* scenario */
+    void RunStep();
+    void NextStep();
+    LoadBot* FindTarget();
+    PyTuple* GetLocalChannel() const;
+
+    void OnCharacters( PyRep* result );
+    void OnBookmarks( PyRep* result );
+    void OnUndocked( PyRep* result );
+    void OnChannelJoined( PyRep* result );
+    void OnDone( PyRep* result );
+
+    const uint32 mNumber;
+    const LoadConfig& mConfig;
+    const LoadScenario& mScenario;
+    LoadStats& mStats;
+    const std::vector<LoadBot*>& mBots;
+
+    std::string mName;
+    EVETCPConnection* mNet;
+    State mState;
+    double mConnectTime;
+
+    /* session */
+    uint32 mUserID;
+    int64 mClientID;
+    uint32 mNodeID;
+    uint32 mCharID;
+    uint32 mShipID;
+    uint32 mStationID;
+    uint32 mSystemID;
+
+    int64 mLastCallID;
+    std::map<int64, PendingCall> mPending;
+    /// bound object strings ("N=node:id"), by service
+    std::map<std::string, std::string> mBinds;
+
+    /* scenario state */
+    size_t mStep;
+    /// remaining iterations for each open loop
+    std::vector<uint32> mLoops;
+    double mWaitUntil;
+    uint32 mJoinedChannel;
+    size_t mNextBookmark;
+    size_t mNextTarget;
+    /// bookmarkID, locationID
+    std::vector<std::pair<uint32, uint32>> mBookmarks;
+};
+
+#endif /* !__LOAD_BOT_H__INCL__ */
@@ -0,0 +1,161 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-loadtest.h"
+
+#include "LoadScenario.h"
+
+namespace {
+
+const char* const STEP_NAMES[] = {
+    "select",
+    "bookmarks",
+    "order",
+    "chat",
+    "undock",
+    "warp",
+    "lock",
+    "call",
+    "wait",
+    "loop",
+    "end"
+};
+
+}
+
+const char* LoadScenario::GetStepName( LoadStep::Op op )
+{
+    return STEP_NAMES[ op ];
+}
+
+bool LoadScenario::Load( const char* filename )
+{
+    FILE* file = fopen( filename, "r" );
+    if (file == nullptr) {
+        sLog.Error( "LoadScenario", "Unable to open scenario '%s'.", filename );
+        return false;
+    }
+
+    std::string text;
+    char buf[ 0x400 ];
+    while (fgets( buf, sizeof( buf ), file ) != nullptr)
+        text += buf;
+    fclose( file );
+
+    return Parse( text, filename );
+}
+
+bool LoadScenario::Parse( const std::string& text, const char* source/*"scenario"*/ )
+{
+    mSteps.clear();
+    std::vector<uint32> loops;
+
+    uint32 lineNo(0);
+    size_t pos(0);
+    while (pos < text.size()) {
+        size_t eol = text.find( '\n', pos );
+        if (eol == std::string::npos)
+            eol = text.size();
+        std::string line( text, pos, eol - pos );
+        pos = eol + 1;
+        ++lineNo;
+
+        size_t comment = line.find( '#' );
+        if (comment != std::string::npos)
+            line.erase( comment );
+
+        Seperator sep( line.c_str() );
+        if (sep.argCount() == 0)
+            continue;
+
+        LoadStep step;
+        step.count = 0;
+        step.jump = 0;
+
+        uint8 op(0);
+        for (; op <= LoadStep::OP_END; ++op)
+            if (sep.arg( 0 ) == STEP_NAMES[ op ])
+                break;
+        if (op > LoadStep::OP_END) {
+            sLog.Error( "LoadScenario", "%s:%u: unknown step '%s'.", source, lineNo, sep.arg( 0 ).c_str() );
+            return false;
+        }
+        step.op = (LoadStep::Op)op;
+
+        switch (step.op) {
+            case LoadStep::OP_ORDER: {
+                step.count = ( sep.argCount() > 1 ? atoi( sep.arg( 1 ).c_str() ) : 34 );  // tritanium
+                step.text = ( sep.argCount() > 2 ? sep.arg( 2 ) : "1.0" );
+            } break;
+            case LoadStep::OP_CHAT: {
+                // rest of the line, as typed
+                size_t start = line.find( sep.arg( 0 ) ) + sep.arg( 0 ).size();
+                start = line.find_first_not_of( " \t", start );
+                step.text = ( start == std::string::npos ? "o7" : line.substr( start ) );
+                while (!step.text.empty() and isspace( (uint8)step.text.back() ))
+                    step.text.pop_back();
+            } break;
+            case LoadStep::OP_CALL: {
+                if (sep.argCount() < 3) {
+                    sLog.Error( "LoadScenario", "%s:%u: usage: call <service> <method>", source, lineNo );
+                    return false;
+                }
+                step.text = sep.arg( 1 );
+                step.text2 = sep.arg( 2 );
+            } break;
+            case LoadStep::OP_WAIT: {
+                if ((sep.argCount() < 2) or !sep.isNumber( 1 )) {
+                    sLog.Error( "LoadScenario", "%s:%u: usage: wait <ms>", source, lineNo );
+                    return false;
+                }
+                step.count = atoi( sep.arg( 1 ).c_str() );
+            } break;
+            case LoadStep::OP_LOOP: {
+                step.count = ( sep.argCount() > 1 ? atoi( sep.arg( 1 ).c_str() ) : 0 );
+                loops.push_back( mSteps.size() );
+            } break;
+            case LoadStep::OP_END: {
+                if (loops.empty()) {
+                    sLog.Error( "LoadScenario", "%s:%u: 'end' without 'loop'.", source, lineNo );
+                    return false;
+                }
+                step.jump = loops.back();
+                mSteps[ loops.back() ].jump = mSteps.size();
+                loops.pop_back();
+            } break;
+            default:
+                break;
+        }
+
+        mSteps.push_back( step );
+    }
+
+    if (!loops.empty()) {
+        sLog.Error( "LoadScenario", "%s: %lu 'loop' without 'end'.", source, loops.size() );
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,77 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#ifndef __LOAD_SCENARIO_H__INCL__
+#define __LOAD_SCENARIO_H__INCL__
+
+/** One line of a scenario script. */
+struct LoadStep
+{
+    enum Op {
+        OP_SELECT,      ///< select                 pick first character on the account
+        OP_BOOKMARKS,   ///< bookmarks              read bookmarks, for warp
+        OP_ORDER,       ///< order [typeID] [price] place a 1 unit buy order in current station
+        OP_CHAT,        ///< chat <text>            say something in local
+        OP_UNDOCK,      ///< undock
+        OP_WARP,        ///< warp                   warp to next bookmark in current system
+        OP_LOCK,        ///< lock                   lock another bot's ship in current system
+        OP_CALL,        ///< call <service> <method> argumentless service call
+        OP_WAIT,        ///< wait <ms>
+        OP_LOOP,        ///< loop [count]           repeat up to matching 'end'; 0 = until run ends
+        OP_END
+    };
+
+    Op op;
+    /// loop count, wait time, order typeID
+    uint32 count;
+    /// OP_LOOP: index of its OP_END; OP_END: index of its OP_LOOP
+    uint32 jump;
+    std::string text;
+    std::string text2;
+};
+
+/**
+ * @brief Scenario script shared by all bots.
+ *
+ * One step per line, '#' starts a comment.  See LoadStep::Op for the
+ * available steps.  Every bot runs the script on its own, starting
+ * with its login.
+ */
+class LoadScenario
+{
+public:
+    bool Load( const char* filename );
+    bool Parse( const std::string& text, const char* source="scenario" );
+
+    size_t size() const                                 { return mSteps.size(); }
+    const LoadStep& operator[]( size_t index ) const    { return mSteps[ index ]; }
+
+    static const char* GetStepName( LoadStep::Op op );
+
+protected:
+    std::vector<LoadStep> mSteps;
+};
+
+#endif /* !__LOAD_SCENARIO_H__INCL__ */
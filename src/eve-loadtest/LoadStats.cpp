@@ -0,0 +1,105 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-loadtest.h"
+
+#include "LoadStats.h"
+
+namespace {
+
+double Percentile( const std::vector<double>& sorted, uint8 pct )
+{
+    if (sorted.empty())
+        return 0.0;
+    return sorted[ std::min( sorted.size() - 1, sorted.size() * pct / 100 ) ];
+}
+
+}
+
+LoadStats::LoadStats()
+: mStartTime( GetTimeMSeconds() ),
+  mNotifications( 0 )
+{
+}
+
+void LoadStats::Start()
+{
+    mStartTime = GetTimeMSeconds();
+}
+
+void LoadStats::AddCall( const std::string& name, double latency, bool error/*false*/ )
+{
+    Samples& samples = mSamples[ name ];
+    samples.latency.push_back( latency );
+    if (error)
+        ++samples.errors;
+}
+
+void LoadStats::AddSkip( const std::string& name )
+{
+    ++mSamples[ name ].skipped;
+}
+
+void LoadStats::AddDiff( const std::string& name )
+{
+    ++mSamples[ name ].diffs;
+}
+
+uint32 LoadStats::GetCallCount() const
+{
+    uint32 count(0);
+    for (auto& cur : mSamples)
+        count += cur.second.latency.size();
+    return count;
+}
+
+void LoadStats::Report() const
+{
+    const double seconds = std::max( 0.001, ( GetTimeMSeconds() - mStartTime ) / 1000.0 );
+
+    ::printf( "\n%-40s %8s %6s %6s %6s %9s %9s %9s %9s %9s\n",
+              "call", "count", "errors", "skip", "diff", "calls/s", "p50 ms", "p90 ms", "p99 ms", "max ms" );
+
+    std::vector<double> all;
+    uint32 errors(0), skipped(0), diffs(0);
+    for (auto& cur : mSamples) {
+        std::vector<double> sorted( cur.second.latency );
+        std::sort( sorted.begin(), sorted.end() );
+        all.insert( all.end(), sorted.begin(), sorted.end() );
+        errors += cur.second.errors;
+        skipped += cur.second.skipped;
+        diffs += cur.second.diffs;
+
+        ::printf( "%-40s %8lu %6u %6u %6u %9.1f %9.2f %9.2f %9.2f %9.2f\n",
+                  cur.first.c_str(), sorted.size(), cur.second.errors, cur.second.skipped, cur.second.diffs, sorted.size() / seconds,
+                  Percentile( sorted, 50 ), Percentile( sorted, 90 ), Percentile( sorted, 99 ), ( sorted.empty() ? 0.0 : sorted.back() ) );
+    }
+
+    std::sort( all.begin(), all.end() );
+    ::printf( "%-40s %8lu %6u %6u %6u %9.1f %9.2f %9.2f %9.2f %9.2f\n",
+              "total", all.size(), errors, skipped, diffs, all.size() / seconds,
+              Percentile( all, 50 ), Percentile( all, 90 ), Percentile( all, 99 ), ( all.empty() ? 0.0 : all.back() ) );
+    ::printf( "\n%u notifications received in %.1fs (%.1f/s)\n", mNotifications, seconds, mNotifications / seconds );
+}
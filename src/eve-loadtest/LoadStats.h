@@ -0,0 +1,74 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#ifndef __LOAD_STATS_H__INCL__
+#define __LOAD_STATS_H__INCL__
+
+/**
+ * @brief Call latency and throughput counters for a load test run.
+ *
+ * Samples are kept per call name ("service.method"), and reported as
+ * count, rate and latency percentiles at the end of the run.  The diff
+ * column is only filled in by replays.
+ */
+class LoadStats
+{
+public:
+    LoadStats();
+
+    /// Marks the start of the measured run.
+    void Start();
+
+    /**
+     * @param[in] name     Call name.
+     * @param[in] latency  Round trip time, in ms.
+     * @param[in] error    true if the call got an error response.
+     */
+    void AddCall( const std::string& name, double latency, bool error=false );
+    /// Counts a scenario step that could not run (ie. no target in range).
+    void AddSkip( const std::string& name );
+    /// Counts a replayed call whose result differs from the recorded one.
+    void AddDiff( const std::string& name );
+    void AddNotification()                              { ++mNotifications; }
+
+    uint32 GetCallCount() const;
+
+    /// Prints the results table to stdout.
+    void Report() const;
+
+protected:
+    struct Samples {
+        std::vector<double> latency;
+        uint32 errors;
+        uint32 skipped;
+        uint32 diffs;
+    };
+
+    double mStartTime;
+    uint32 mNotifications;
+    std::map<std::string, Samples> mSamples;
+};
+
+#endif /* !__LOAD_STATS_H__INCL__ */
@@ -0,0 +1,259 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+
+#include "eve-loadtest.h"
+
+#include "marshal/EVEMarshal.h"
+#include "marshal/EVEUnmarshal.h"
+#include "network/PacketLog.h"
+
+#include "LoadStats.h"
+#include "ReplayBot.h"
+
+// replay has no script; the log is the script
+static const LoadScenario EMPTY_SCENARIO;
+
+ReplayBot::ReplayBot( uint32 number, const std::string& account, const LoadConfig& config, LoadStats& stats, const std::vector<LoadBot*>& bots, double speed )
+: LoadBot( number, config, EMPTY_SCENARIO, stats, bots ),
+  mSpeed( speed ),
+  mStartTime( 0.0 ),
+  mNextCall( 0 )
+{
+    // the log belongs to an account, so use its name as given
+    mName = account;
+}
+
+ReplayBot::~ReplayBot()
+{
+    for (auto cur : mCalls)
+        SafeDelete( cur.packet );
+}
+
+bool ReplayBot::Load( const char* filename )
+{
+    PacketLogReader log;
+    if (!log.Open( filename )) {
+        sLog.Error( "ReplayBot", "Unable to open packet log '%s'.", filename );
+        return false;
+    }
+
+    PacketLog::Record record;
+    while (log.Read( record )) {
+        PyRep* rep = InflateUnmarshal( record.data );
+        if (rep == nullptr)
+            continue;
+
+        PyPacket* packet = new PyPacket();
+        if (!packet->Decode( &rep )) {  //rep is consumed here
+            SafeDelete( packet );
+            continue;
+        }
+
+        if (record.direction == PacketLog::INBOUND) {
+            // pings and such are answered by us as they come
+            if (packet->type == CALL_REQ) {
+                RecordedCall call;
+                    call.time = record.time;
+                    call.packet = packet;
+                mCalls.push_back( call );
+                continue;
+            }
+        } else if ((packet->type == CALL_RSP) or (packet->type == ERRORRESPONSE)) {
+            RecordedResult& result = mResults[ packet->dest.callID ];
+            result.error = (packet->type == ERRORRESPONSE);
+            GetResultData( packet, result.bind, result.data );
+        }
+
+        SafeDelete( packet );
+    }
+
+    // bound calls are named after the service that bound them
+    for (auto& cur : mCalls) {
+        std::map<int64, RecordedResult>::const_iterator itr = mResults.find( cur.packet->source.callID );
+        if ((itr != mResults.end()) and !itr->second.bind.empty())
+            mBindServices[ itr->second.bind ] = cur.packet->dest.service;
+    }
+
+    sLog.Log( "ReplayBot", "%s: loaded %lu calls and %lu results from '%s'.", mName.c_str(), mCalls.size(), mResults.size(), filename );
+    return !mCalls.empty();
+}
+
+void ReplayBot::Tick()
+{
+    if (mStartTime == 0.0)
+        mStartTime = GetTimeMSeconds();
+
+    // recorded times are relative to the first call, so the gap between login and the first call is dropped
+    const int64 now = (int64)( ( GetTimeMSeconds() - mStartTime ) * 1000.0 * mSpeed );
+    while ((mNextCall < mCalls.size()) and (mCalls[ mNextCall ].time - mCalls.front().time <= now)) {
+        if (!SendRecorded( mCalls[ mNextCall ].packet ))
+            break;
+        SafeDelete( mCalls[ mNextCall ].packet );
+        ++mNextCall;
+    }
+
+    if ((mNextCall == mCalls.size()) and mReplayed.empty())
+        mState = STATE_DONE;
+}
+
+void ReplayBot::HandlePacket( PyPacket* packet )
+{
+    if ((packet->type != CALL_RSP) and (packet->type != ERRORRESPONSE)) {
+        LoadBot::HandlePacket( packet );
+        return;
+    }
+
+    std::map<int64, ReplayedCall>::iterator itr = mReplayed.find( packet->dest.callID );
+    if (itr == mReplayed.end())
+        return;
+
+    ReplayedCall call( itr->second );
+    mReplayed.erase( itr );
+
+    const bool error = (packet->type == ERRORRESPONSE);
+    std::string bind;
+    Buffer data;
+    GetResultData( packet, bind, data );
+    mStats.AddCall( call.name, GetTimeMSeconds() - call.sendTime, error );
+
+    std::map<int64, RecordedResult>::const_iterator res = mResults.find( call.callID );
+    if (res == mResults.end())
+        return;     // log ended before the response
+
+    const RecordedResult& recorded = res->second;
+    if (!recorded.bind.empty() and !bind.empty()) {
+        mBindMap[ recorded.bind ] = bind;
+        SetBind( mBindServices[ recorded.bind ], bind );
+    }
+
+    if ((error != recorded.error)
+    or  (data.size() != recorded.data.size())
+    or  ((data.size() > 0) and (memcmp( &data[ 0 ], &recorded.data[ 0 ], data.size() ) != 0)))
+        mStats.AddDiff( call.name );
+}
+
+bool ReplayBot::SendRecorded( PyPacket* packet )
+{
+    PyTuple* call = GetCall( packet );
+    if (call == nullptr)
+        return true;    // not a call we understand; drop it
+
+    const std::string name( GetCallName( packet ) );
+
+    PyRep* remoteObject = call->GetItem( 0 );
+    if (remoteObject->IsString()) {
+        const std::string bind( PyRep::StringContent( remoteObject ) );
+        std::map<std::string, std::string>::const_iterator itr = mBindMap.find( bind );
+        if (itr == mBindMap.end()) {
+            // the bind may still be on its way; if not, send it as recorded and let it fail
+            if (!mReplayed.empty())
+                return false;
+        } else {
+            call->SetItem( 0, new PyString( itr->second ) );
+            // the substream still holds the old data, so build a new one around the call
+            PyIncRef( call );
+            packet->payload->GetItem( 0 )->AsTuple()->SetItem( 1, new PySubStream( call ) );
+        }
+    }
+
+    ReplayedCall& replayed = mReplayed[ ++mLastCallID ];
+        replayed.callID = packet->source.callID;
+        replayed.name = name;
+        replayed.sendTime = GetTimeMSeconds();
+
+    packet->source.objectID = mClientID;
+    packet->source.callID = mLastCallID;
+    packet->userid = mUserID;
+    if ((packet->dest.type == PyAddress::Node) and (mNodeID != 0))
+        packet->dest.objectID = mNodeID;
+
+    PyRep* rep(packet->Encode());
+    // Encode() hands the payload over to rep
+    packet->payload = nullptr;
+    mNet->QueueRep( rep );    //consumed
+    return true;
+}
+
+std::string ReplayBot::GetCallName( PyPacket* packet ) const
+{
+    PyTuple* call = GetCall( packet );
+    if (call == nullptr)
+        return "";
+
+    std::string service( packet->dest.service );
+    std::string method( PyRep::StringContent( call->GetItem( 1 ) ) );
+
+    PyRep* remoteObject = call->GetItem( 0 );
+    if (remoteObject->IsString()) {
+        std::map<std::string, std::string>::const_iterator itr = mBindServices.find( PyRep::StringContent( remoteObject ) );
+        service = ( itr == mBindServices.end() ? "bound" : itr->second );
+    } else if (method == "MachoBindObject") {
+        // bind and call in one go; name it after the call, like LoadBot does
+        PyRep* args = call->GetItem( 2 );
+        if (args->IsTuple() and (args->AsTuple()->size() == 2) and args->AsTuple()->GetItem( 1 )->IsTuple()) {
+            PyTuple* inner = args->AsTuple()->GetItem( 1 )->AsTuple();
+            if (inner->size() > 0)
+                method = PyRep::StringContent( inner->GetItem( 0 ) );
+        }
+    }
+
+    return service + "." + method;
+}
+
+bool ReplayBot::GetResultData( PyPacket* packet, std::string& bind, Buffer& into )
+{
+    PyRep* result(nullptr);
+    if (packet->type == ERRORRESPONSE) {
+        result = packet->payload;
+    } else {
+        // compare the call result only; the bind has a timestamp in it
+        result = GetCallResult( packet );
+        if (result != nullptr)
+            SplitBindResult( result, bind );
+    }
+
+    if (result == nullptr)
+        return false;
+    return Marshal( result, into );
+}
+
+PyTuple* ReplayBot::GetCall( PyPacket* packet )
+{
+    // payload is ((flag, substream((remoteObject, method, args, kwargs))),)  see PyCallStream::Decode()
+    if ((packet->payload == nullptr) or (packet->payload->size() == 0) or !packet->payload->GetItem( 0 )->IsTuple())
+        return nullptr;
+
+    PyTuple* stream = packet->payload->GetItem( 0 )->AsTuple();
+    if ((stream->size() != 2) or !stream->GetItem( 1 )->IsSubStream())
+        return nullptr;
+
+    PySubStream* ss = stream->GetItem( 1 )->AsSubStream();
+    ss->DecodeData();
+    if ((ss->decoded() == nullptr) or !ss->decoded()->IsTuple() or (ss->decoded()->AsTuple()->size() < 4))
+        return nullptr;
+
+    return ss->decoded()->AsTuple();
+}
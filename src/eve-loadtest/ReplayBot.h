@@ -0,0 +1,111 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+
+#ifndef __REPLAY_BOT_H__INCL__
+#define __REPLAY_BOT_H__INCL__
+
+#include "LoadBot.h"
+
+class PyPacket;
+
+/**
+ * @brief Replays a session recorded by the server (debug.RecordPackets).
+ *
+ * Logs in like LoadBot, then resends the client's CallReq packets from
+ * the log at their recorded times (scaled by speed), with our client,
+ * user and call ids, and bound objects swapped for the ones the server
+ * gave us.  Responses are timed in LoadStats, and compared against the
+ * recorded ones; calls whose result differs count as diffs.
+ *
+ * Recording starts after login, so the log holds the whole session from
+ * character selection on.  Replay needs the account that made the log,
+ * and a database the session can run against (ie. a snapshot from when
+ * it was recorded); results that have timestamps or new ids in them
+ * will always differ.
+ */
+class ReplayBot
+: public LoadBot
+{
+public:
+    ReplayBot( uint32 number, const std::string& account, const LoadConfig& config, LoadStats& stats, const std::vector<LoadBot*>& bots, double speed );
+    ~ReplayBot();
+
+    /** Reads the calls and their results from a packet log. */
+    bool Load( const char* filename );
+
+    size_t GetCallCount() const                         { return mCalls.size(); }
+
+protected:
+    struct RecordedCall {
+        /// us since recording started
+        int64 time;
+        PyPacket* packet;
+    };
+    struct RecordedResult {
+        bool error;
+        /// bind string, if the call was a MachoBindObject
+        std::string bind;
+        /// marshaled result (error payload for errors)
+        Buffer data;
+    };
+    struct ReplayedCall {
+        int64 callID;
+        std::string name;
+        double sendTime;
+    };
+
+    void Tick();
+    void HandlePacket( PyPacket* packet );
+
+    /**
+     * @brief Rewrites a recorded call for our session and sends it.
+     *
+     * @return false if the call uses a bound object we dont have yet.
+     */
+    bool SendRecorded( PyPacket* packet );
+    /// @return "service.method" for a recorded call; empty if packet isnt one.
+    std::string GetCallName( PyPacket* packet ) const;
+    /// marshals a call result (or error payload) the way RecordedResult keeps it.
+    static bool GetResultData( PyPacket* packet, std::string& bind, Buffer& into );
+    /// @return (remoteObject, method, args, kwargs) of a CallReq, or NULL.
+    static PyTuple* GetCall( PyPacket* packet );
+
+    const double mSpeed;
+    double mStartTime;
+
+    std::vector<RecordedCall> mCalls;
+    size_t mNextCall;
+    /// results from the log, by recorded callID
+    std::map<int64, RecordedResult> mResults;
+    /// calls we are waiting on, by our callID
+    std::map<int64, ReplayedCall> mReplayed;
+    /// recorded bind string -> ours
+    std::map<std::string, std::string> mBindMap;
+    /// recorded bind string -> service
+    std::map<std::string, std::string> mBindServices;
+};
+
+#endif /* !__REPLAY_BOT_H__INCL__ */
@@ -0,0 +1,176 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+
+#include "eve-loadtest.h"
+
+#include "LoadBot.h"
+#include "LoadScenario.h"
+#include "LoadStats.h"
+#include "ReplayBot.h"
+
+const char* const LOG_FILE =          EVEMU_ROOT "/log/eve-loadtest.log";
+const char* const LOG_SETTINGS_FILE = EVEMU_ROOT "/etc/log.ini";
+
+static void Usage()
+{
+    ::printf( "usage: eve-loadtest [options] <scenario>\n"
+              "       eve-loadtest [options] -R <log> [-R <log> ...]\n"
+              "  -h <host>      server address (127.0.0.1)\n"
+              "  -p <port>      server port (26000)\n"
+              "  -n <bots>      number of bots (1)\n"
+              "  -u <prefix>    account name prefix; accounts are <prefix>0..<prefix>n-1 (bot)\n"
+              "  -w <password>  account password (password)\n"
+              "  -r <ms>        delay between bot logins (50)\n"
+              "  -t <seconds>   stop the run after this long; 0 = when all bots are done (0)\n"
+              "  -R <log>       replay a packet log (debug.RecordPackets) instead of a scenario; one bot per log.\n"
+              "                 with a single log, -u is the account name; otherwise <prefix>0..<prefix>n-1\n"
+              "  -s <speed>     replay speed (1.0)\n" );
+}
+
+int main( int argc, char* argv[] )
+{
+#if defined( HAVE_CRTDBG_H ) && !defined( NDEBUG )
+    // Under Visual Studio setup memory leak detection
+    _CrtSetDbgFlag( _CRTDBG_LEAK_CHECK_DF | _CrtSetDbgFlag( _CRTDBG_REPORT_FLAG ) );
+#endif /* defined( HAVE_CRTDBG_H ) && !defined( NDEBUG ) */
+
+    std::string host( "127.0.0.1" );
+    const char* scenarioFile(nullptr);
+    uint32 botCount(1), rampTime(50), maxTime(0);
+    std::vector<const char*> replayFiles;
+    double speed(1.0);
+
+    LoadConfig config;
+        config.port = 26000;
+        config.prefix = "bot";
+        config.password = "password";
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg( argv[ i ] );
+        if ((arg.size() == 2) and (arg[ 0 ] == '-') and (i + 1 < argc)) {
+            const char* value = argv[ ++i ];
+            switch (arg[ 1 ]) {
+                case 'h': host = value;                   continue;
+                case 'p': config.port = atoi( value );    continue;
+                case 'n': botCount = atoi( value );       continue;
+                case 'u': config.prefix = value;          continue;
+                case 'w': config.password = value;        continue;
+                case 'r': rampTime = atoi( value );       continue;
+                case 't': maxTime = atoi( value );        continue;
+                case 'R': replayFiles.push_back( value ); continue;
+                case 's': speed = atof( value );          continue;
+            }
+        } else if ((arg[ 0 ] != '-') and (scenarioFile == nullptr)) {
+            scenarioFile = argv[ i ];
+            continue;
+        }
+
+        Usage();
+        return 1;
+    }
+
+    if (!replayFiles.empty())
+        botCount = replayFiles.size();
+    if ((( scenarioFile == nullptr ) == replayFiles.empty()) or (botCount == 0) or (speed <= 0.0)) {
+        Usage();
+        return 1;
+    }
+
+    // Load server log settings ( will be removed )
+    if (!load_log_settings( LOG_SETTINGS_FILE ))
+        sLog.Warning( "init", "Unable to read %s (this file is optional)", LOG_SETTINGS_FILE );
+    if (!log_open_logfile( LOG_FILE ))
+        sLog.Warning( "init", "Unable to open log file '%s', only logging to the screen now.", LOG_FILE );
+
+    LoadScenario scenario;
+    if ((scenarioFile != nullptr) and !scenario.Load( scenarioFile ))
+        return 1;
+
+    char errbuf[ TCPCONN_ERRBUF_SIZE ];
+    config.ip = ResolveIP( host.c_str(), errbuf );
+    if (config.ip == 0) {
+        sLog.Error( "init", "Unable to resolve '%s': %s", host.c_str(), errbuf );
+        return 1;
+    }
+
+    LoadStats stats;
+    std::vector<LoadBot*> bots;
+    bots.reserve( botCount );
+    if (replayFiles.empty()) {
+        sLog.Log( "init", "Running '%s' with %u bots against %s:%u.", scenarioFile, botCount, host.c_str(), config.port );
+        for (uint32 i = 0; i < botCount; ++i)
+            bots.push_back( new LoadBot( i, config, scenario, stats, bots ) );
+    } else {
+        sLog.Log( "init", "Replaying %u logs at %.2fx against %s:%u.", botCount, speed, host.c_str(), config.port );
+        for (uint32 i = 0; i < botCount; ++i) {
+            const std::string account( botCount == 1 ? config.prefix : config.prefix + std::to_string( i ) );
+            ReplayBot* bot = new ReplayBot( i, account, config, stats, bots, speed );
+            bots.push_back( bot );
+            if (!bot->Load( replayFiles[ i ] )) {
+                for (auto cur : bots)
+                    SafeDelete( cur );
+                return 1;
+            }
+        }
+    }
+
+    // logins are ramped so the server's login path isnt what gets measured
+    stats.Start();
+    const double startTime = GetTimeMSeconds();
+    uint32 connected(0);
+    while (true) {
+        const double now = GetTimeMSeconds();
+        while ((connected < botCount) and (now - startTime >= (double)connected * rampTime))
+            bots[ connected++ ]->Connect();
+
+        bool running = (connected < botCount);
+        for (uint32 i = 0; i < connected; ++i)
+            if (bots[ i ]->Process())
+                running = true;
+
+        if (!running)
+            break;
+        if ((maxTime > 0) and (now - startTime >= maxTime * 1000.0)) {
+            sLog.Log( "shutdown", "Time limit reached." );
+            break;
+        }
+
+        Sleep( 1 );
+    }
+
+    uint32 failed(0);
+    for (auto cur : bots) {
+        if (cur->GetState() == LoadBot::STATE_FAILED)
+            ++failed;
+        SafeDelete( cur );
+    }
+
+    stats.Report();
+    ::printf( "%u of %u bots failed\n", failed, botCount );
+
+    sLog.Log( "shutdown", "Exiting." );
+    return ( failed > 0 ? 2 : 0 );
+}
@@ -35,6 +35,7 @@
 #include "ConsoleCommands.h"
 #include "EVEServerConfig.h"
 #include "LiveUpdateDB.h"
+#include "LoginPool.h"
 
 #include "StaticDataMgr.h"
 #include "chat/LSCService.h"
@@ -88,7 +89,8 @@ Client::Client(EVEServiceManager& services, EVETCPConnection** con)
   m_uncloakTimer(0),
   m_destinyEventQueue(new PyList()),
   m_destinyUpdateQueue(new PyList()),
-  m_nextNotifySequence(0)
+  m_nextNotifySequence(0),
+  m_sendQueueMetric(nullptr)
 {
     m_pod = ShipItemRef(nullptr);
     m_ship = ShipItemRef(nullptr);
@@ -135,6 +137,9 @@ Client::Client(EVEServiceManager& services, EVETCPConnection** con)
 }
 
 Client::~Client() {
+    if (m_sendQueueMetric != nullptr)
+        sMetrics.Remove("evemu_client_send_queue_bytes", {{"client", std::to_string(GetClientID())}});
+
     if (!m_loaded)
         return;
 
@@ -209,6 +214,10 @@ bool Client::ProcessNet()
     if (state != TCPConnection::STATE_CONNECTED)
         return false;
 
+    // login verification is done by LoginPool.  finish it here once ready
+    if ((m_loginJob.get() != nullptr) and m_loginJob->IsDone())
+        _CompleteLogin();
+
     PyPacket *p(nullptr);
     while ((p = PopPacket())) {
         try {
@@ -226,6 +235,14 @@ bool Client::ProcessNet()
     SafeDelete(p);
     // send queue
     _SendQueuedUpdates();
+    // keep staged packets moving as the client reads
+    mNet->FlushSendQueue();
+
+    if ((m_sendQueueMetric == nullptr) and (GetUserID() != 0))
+        m_sendQueueMetric = &sMetrics.GetGauge("evemu_client_send_queue_bytes", "Bytes waiting to be sent, staged and socket-queued, by client.",
+                                               {{"client", std::to_string(GetClientID())}});
+    if (m_sendQueueMetric != nullptr)
+        m_sendQueueMetric->Set(mNet->GetStagedBytes() + mNet->GetSendQueueBytes());
 
     return true;
 }
@@ -258,10 +275,17 @@ bool Client::SelectCharacter(int32 charID/*0*/)
         return false;
     }
 
+    // use this char's login items if LoginPool has read them already, and they arent too old to trust
+    std::map<uint32, std::shared_ptr<CharPrefetchJob>>::iterator itr = m_prefetchJobs.find(charID);
+    if ((itr != m_prefetchJobs.end()) and itr->second->IsDone() and itr->second->result
+    and (itr->second->items.time + (EvE::Time::Minute * 5) > GetFileTimeNow()))
+        sItemFactory.SetPrefetch(&itr->second->items);
+
     m_char = sItemFactory.GetCharacterRef(charID);
     if (m_char.get() == nullptr) {
         sLog.Error("Client::SelectCharacter()", "GetChar for %u = nullptr", charID);
         SendErrorMsg("Unable to locate Character.  Selection Failed.");
+        sItemFactory.UnsetPrefetch();
         sItemFactory.UnsetUsingClient();
         CloseClientConnection();
         return false;
@@ -294,6 +318,10 @@ bool Client::SelectCharacter(int32 charID/*0*/)
 
     m_ship->SetPlayer(this);
 
+    // char, skills and ship are loaded.  prefetched rows are done with
+    sItemFactory.UnsetPrefetch();
+    m_prefetchJobs.clear();
+
     GPoint pos(NULL_ORIGIN);
 
     if (sDataMgr.IsSolarSystem(m_locationID)) {
@@ -2155,7 +2183,8 @@ void Client::SendSessionChange()
         packet->Dump(CLIENT__SESSION_DUMP, dumper);
     }
 
-    QueuePacket(packet);
+    // keeps its place among sequenced notifications
+    QueuePacket(packet, EVETCPConnection::SEND_CALL, EVETCPConnection::SEND_FLAG_ORDERED);
 
     // clean up packet after being created by 'new'
     //SafeDelete(packet);
@@ -2183,7 +2212,8 @@ void Client::QueueDestinyUpdate(PyTuple **update, bool DoPackage /*false*/, bool
         act.stamp = sEntityList.GetStamp();
     if (DoPackage/* or m_packaged*/) {
         if (IsSetState) {
-            // send the setstate buffer alone
+            // send the setstate buffer alone.  it holds the full ballpark state,
+            //  so updates from earlier ticks still waiting in the send queue are stale
             act.update = *update;
         } else {
             // this will package all current updates (and those coming in before next flush) into
@@ -2204,7 +2234,8 @@ void Client::QueueDestinyUpdate(PyTuple **update, bool DoPackage /*false*/, bool
         PyTuple* t = dum.Encode();
         if (is_log_enabled(CLIENT__QUEUE_DUMP))
             t->Dump(CLIENT__QUEUE_DUMP, "");
-        SendNotification("DoDestinyUpdate", "clientID", &t, false);
+        SendNotification("DoDestinyUpdate", "clientID", &t, false, EVETCPConnection::SEND_DESTINY,
+                         (IsSetState ? EVETCPConnection::SEND_FLAG_SUPERSEDE : EVETCPConnection::SEND_FLAG_DROPPABLE));
         PyDecRef(t);
     } else {
         act.update = *update;
@@ -2222,7 +2253,8 @@ void Client::_SendQueuedUpdates() {
             PyTuple* t = dum.Encode();
             if (is_log_enabled(CLIENT__QUEUE_DUMP))
                 t->Dump(CLIENT__QUEUE_DUMP, "");
-            SendNotification("DoDestinyUpdate", "clientID", &t);
+            // sequenced, so never dropped.  only packaged updates give way to a later SetState
+            SendNotification("DoDestinyUpdate", "clientID", &t, true, EVETCPConnection::SEND_DESTINY);
         } else {
             DoDestinyUpdateMain dum;
                 dum.updates = m_destinyUpdateQueue;
@@ -2231,7 +2263,8 @@ void Client::_SendQueuedUpdates() {
             PyTuple* t = dum.Encode();
             if (is_log_enabled(CLIENT__QUEUE_DUMP))
                 t->Dump(CLIENT__QUEUE_DUMP, "");
-            SendNotification("DoDestinyUpdate", "clientID", &t);
+            // events must not be lost
+            SendNotification("DoDestinyUpdate", "clientID", &t, true, EVETCPConnection::SEND_DESTINY);
         }
     } else if (!m_destinyEventQueue->empty()) {
         Notify_OnMultiEvent nom;
@@ -2239,7 +2272,7 @@ void Client::_SendQueuedUpdates() {
         PyTuple* t = nom.Encode();
         if (is_log_enabled(CLIENT__QUEUE_DUMP))
             t->Dump(CLIENT__QUEUE_DUMP, "");
-        SendNotification("OnMultiEvent", "charid", &t);
+        SendNotification("OnMultiEvent", "charid", &t, true, EVETCPConnection::SEND_DESTINY);
     } //else nothing to be sent ...
 
     // clear the queues now, after the packets have been sent
@@ -2268,7 +2301,7 @@ void Client::SendNotification(const char *notifyType, const char *idType, PyTupl
     SendNotification(dest, notify, seq);
 }
 
-void Client::SendNotification(const char *notifyType, const char *idType, PyTuple **payload, bool seq /*true*/) {
+void Client::SendNotification(const char *notifyType, const char *idType, PyTuple **payload, bool seq /*true*/, uint8 sendClass /*EVETCPConnection::SEND_NOTIFY*/, uint8 sendFlags /*0*/) {
     if ((*payload) == nullptr)
         return;
     //build a little notification out of it.
@@ -2285,10 +2318,10 @@ void Client::SendNotification(const char *notifyType, const char *idType, PyTupl
         dest.objectID = GetClientID();
 
     //now send it to the client
-    SendNotification(dest, notify, seq);
+    SendNotification(dest, notify, seq, sendClass, sendFlags);
 }
 
-void Client::SendNotification(const PyAddress &dest, EVENotificationStream &noti, bool seq/*true*/) {
+void Client::SendNotification(const PyAddress &dest, EVENotificationStream &noti, bool seq/*true*/, uint8 sendClass/*EVETCPConnection::SEND_NOTIFY*/, uint8 sendFlags/*0*/) {
     //build the packet:
     PyPacket *packet = new PyPacket();
     packet->type_string = "macho.Notification";
@@ -2307,6 +2340,10 @@ void Client::SendNotification(const PyAddress &dest, EVENotificationStream &noti
     if (seq) {
         packet->named_payload = new PyDict();
         packet->named_payload->SetItemString("sn", new PyInt(++m_nextNotifySequence));
+        // the client expects sn in order and without gaps, so this goes out behind every
+        //  sequenced notification and session change queued before it, in any class, and is never dropped
+        sendFlags |= EVETCPConnection::SEND_FLAG_ORDERED;
+        sendFlags &= ~EVETCPConnection::SEND_FLAG_DROPPABLE;
     }
 
     if (is_log_enabled(CLIENT__NOTIFY_DUMP)) {
@@ -2315,7 +2352,7 @@ void Client::SendNotification(const PyAddress &dest, EVENotificationStream &noti
         packet->Dump(CLIENT__NOTIFY_DUMP, dumper);
     }
 
-    QueuePacket(packet);
+    QueuePacket(packet, sendClass, sendFlags);
 }
 
 /************************************************************************/
@@ -2406,42 +2443,24 @@ bool Client::_VerifyLogin(CryptoChallengePacket& ccp)
     PyRep* res = new PyInt(2);
     mNet->QueueRep(res);
 
-    std::string failMsg = "Login Authorization Invalid.";
-
-    // test account name for invalid chars (which may allow sql injection)
-    if (!ServiceDB::ValidateAccountName(ccp, failMsg))
-        return _LoginFail(failMsg);
+    // account lookup and password check are db calls, so are done by LoginPool.
+    //  ProcessNet() calls _CompleteLogin() when they are finished.  client waits for our handshake before sending anything else.
+    m_loginJob = std::make_shared<AccountJob>(ccp);
+    sLoginPool.Queue(m_loginJob);
+    return false;
+}
 
-    AccountData aData = AccountData();
-    if (!ServiceDB::GetAccountInformation(ccp, aData, failMsg))
-        return _LoginFail(failMsg);
+void Client::_CompleteLogin()
+{
+    std::shared_ptr<AccountJob> job(m_loginJob);
+    m_loginJob.reset();
 
-    if (aData.banned) {
-        failMsg = "Your account is banned. Contact Allan for further support";
-        return _LoginFail(failMsg);
+    if (!job->result) {
+        _LoginFail(job->failMsg);
+        return;
     }
 
-    if (aData.online) {
-        failMsg = "This account is currently online.";
-        return _LoginFail(failMsg);
-    }
-
-    if (!ccp.user_password.empty()) {
-        sLog.Warning("  Client::Login()", "%s(%u) - Using Plain Password", aData.name.c_str(), aData.clientID);
-        if (strcmp(aData.password.c_str(), ccp.user_password.c_str()) != 0) {
-            failMsg = "The plain Password you entered is incorrect for this account.";
-            return _LoginFail(failMsg);
-        }
-    } else {
-        //sLog.Warning("  Client::Login()", "%s(%u) - Using Hashed Password", aData.name.c_str(), aData.clientID);
-        if (strcmp(aData.hash.c_str(), ccp.user_password_hash.c_str()) != 0) {
-            failMsg = "The Password you entered is incorrect for this account.";
-            return _LoginFail(failMsg);
-        }
-
-        if (!ccp.user_password.empty())
-            ServiceDB::UpdatePassword(aData.id, ccp.user_password.c_str());
-    }
+    const AccountData& aData = job->aData;
 
     /** @todo  check this character/account for newbie status and revoke as needed before account update.  */
 
@@ -2465,12 +2484,12 @@ bool Client::_VerifyLogin(CryptoChallengePacket& ccp)
     server_shake.boot_build = EVEBuildVersion;
     server_shake.boot_codename = EVEProjectCodename;
     server_shake.boot_region = EVEProjectRegion;
-    res = server_shake.Encode();
+    PyRep* res = server_shake.Encode();
     mNet->QueueRep(res);
 
     // Setup session, but don't send the change yet.
     pSession->SetString("address", EVEClientSession::GetAddress().c_str());
-    pSession->SetString("languageID", ccp.user_languageid.c_str());
+    pSession->SetString("languageID", job->ccp.user_languageid.c_str());
 
     pSession->SetInt("userType", Acct::Type::Mammon);     //aData.type  - incomplete (db fields done)
     pSession->SetInt("userid", aData.id);
@@ -2479,8 +2498,16 @@ bool Client::_VerifyLogin(CryptoChallengePacket& ccp)
     pSession->SetLong("sessionID", 0 /*pSession->GetSessionID()*/);
 
     sLog.Green("  Client::Login()","Account %u (%s) logging in from %s", aData.id, aData.name.c_str(), EVEClientSession::GetAddress().c_str());
+    _log(CLIENT__INFO, "Account %u login verified in %.2fms (%.2fms queued)", aData.id, job->GetRunTime(), job->GetWaitTime());
 
-    return true;
+    _LoginVerified();
+
+    // read login items for this account's chars while player is on char select.  these run in parallel
+    for (auto cur : job->charIDs) {
+        std::shared_ptr<CharPrefetchJob> prefetch(std::make_shared<CharPrefetchJob>(cur));
+        m_prefetchJobs[cur] = prefetch;
+        sLoginPool.Queue(prefetch);
+    }
 }
 
 bool Client::_LoginFail(std::string fail_msg)
@@ -2512,6 +2539,19 @@ bool Client::_VerifyFuncResult(CryptoHandshakeResult& result)
         res->Dump(CLIENT__CALL_DUMP, "    ");
     mNet->QueueRep(res, false);
 
+    // record the rest of this session, for replay.  starts after the login, so account passwords arent in the log
+    if (sConfig.debug.RecordPackets) {
+        char filename[256];
+        snprintf(filename, sizeof(filename), "%s%i_%li_%li.evepkt", sConfig.files.packetLogDir.c_str(), GetUserID(), (long)time(nullptr), (long)GetClientID());
+        PacketLogWriter* log = new PacketLogWriter();
+        if (log->Open(filename)) {
+            mNet->SetPacketLog(log);
+            sLog.Log("Client", "%s: Recording session to %s", GetAddress().c_str(), filename);
+        } else {
+            SafeDelete(log);
+        }
+    }
+
     // send out the initial session status
     SendInitialSessionStatus();
 
@@ -2534,7 +2574,13 @@ void Client::_SendCallReturn(const PyAddress& source, int64 callID, PyResult &rs
     packet->userid = GetUserID();
 
     packet->payload = new PyTuple(1);
-    packet->payload->SetItem(0, new PySubStream(rsp.ssResult));
+    if ((rsp.ssResult != nullptr) and rsp.ssResult->IsSubStream()) {
+        // result was marshaled ahead of time (bulkdata chunks); send it as it is
+        PyIncRef(rsp.ssResult);
+        packet->payload->SetItem(0, rsp.ssResult);
+    } else {
+        packet->payload->SetItem(0, new PySubStream(rsp.ssResult));
+    }
     packet->named_payload = rsp.ssNamedResult;
 
     if (is_log_enabled(COLLECT__PACKET_DUMP)) {
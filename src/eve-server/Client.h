@@ -63,6 +63,8 @@ class PyPacket;
 class PyRep;
 class Scan;
 class TradeSession;
+class AccountJob;
+class CharPrefetchJob;
 
 //DO NOT INHERIT THIS OBJECT!
 class Client
@@ -431,6 +433,8 @@ protected:
     bool _VerifyVersion( VersionExchangeClient& version );
     bool _VerifyCrypto( CryptoRequestPacket& cr );
     bool _VerifyLogin( CryptoChallengePacket& ccp );
+    // finishes _VerifyLogin() once LoginPool is done with it.  called from ProcessNet()
+    void _CompleteLogin();
     bool _VerifyVIPKey( const std::string& vipKey )     { /* do nothing */ return true; }
     bool _VerifyFuncResult( CryptoHandshakeResult& result );
 
@@ -439,9 +443,9 @@ protected:
     /********************************************************************/
 public:
     void SendSessionChange();
-    void SendNotification(const PyAddress &dest, EVENotificationStream &noti, bool seq=true);
+    void SendNotification(const PyAddress &dest, EVENotificationStream &noti, bool seq=true, uint8 sendClass=EVETCPConnection::SEND_NOTIFY, uint8 sendFlags=0);
     void SendNotification(const char *notifyType, const char *idType, PyTuple *payload, bool seq=true);
-    void SendNotification(const char *notifyType, const char *idType, PyTuple **payload, bool seq=true);
+    void SendNotification(const char *notifyType, const char *idType, PyTuple **payload, bool seq=true, uint8 sendClass=EVETCPConnection::SEND_NOTIFY, uint8 sendFlags=0);
 
     // this is to check Throw status, to avoid throws/segfault when not applicable  (should use try/catch block)
     bool CanThrow()                                     { return m_canThrow; }
@@ -458,6 +462,10 @@ private:
 
     std::set<uint32> m_bindSet;
 
+    // login work being done by LoginPool
+    std::shared_ptr<AccountJob> m_loginJob;
+    std::map<uint32, std::shared_ptr<CharPrefetchJob>> m_prefetchJobs;
+
 protected:
     void SendInitialSessionStatus ();
     void UpdateSession();
@@ -479,6 +487,9 @@ private:
 
     uint32 m_nextNotifySequence;
 
+    // staged plus socket-queued send bytes; lives in sMetrics, created once logged in
+    MetricGauge* m_sendQueueMetric;
+
     std::map<uint32, uint32>    m_lpMap;    // corpID/points
 
     std::string GetStateName(int8 state);
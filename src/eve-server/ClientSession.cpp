@@ -49,9 +49,9 @@ mDirty(false),
 m_sessionID(0)
 {
     /* default session values */
-    mSession->SetItemString("role", new_tuple(PyStatic.NewNone(), new PyLong(Acct::Role::PLAYER | Acct::Role::NEWBIE), PyStatic.NewFalse()));
-    mSession->SetItemString("userid", new_tuple(PyStatic.NewNone(), PyStatic.NewZero(), PyStatic.NewFalse()));
-    mSession->SetItemString("address", new_tuple(PyStatic.NewNone(), new PyString("0.0.0.0"), PyStatic.NewFalse()));
+    mSession->SetItem(PyString::Intern("role"), new_tuple(PyStatic.NewNone(), new PyLong(Acct::Role::PLAYER | Acct::Role::NEWBIE), PyStatic.NewFalse()));
+    mSession->SetItem(PyString::Intern("userid"), new_tuple(PyStatic.NewNone(), PyStatic.NewZero(), PyStatic.NewFalse()));
+    mSession->SetItem(PyString::Intern("address"), new_tuple(PyStatic.NewNone(), new PyString("0.0.0.0"), PyStatic.NewFalse()));
 
     /*  session id is unique to each session.
      * is not saved or shared between chars
@@ -222,7 +222,7 @@ void ClientSession::_Set(const char* name, PyRep* value)
     PyTuple* tuple(_GetValueTuple(name)); // copy c'tor
     if (tuple == nullptr) {
         tuple = new_tuple(PyStatic.NewNone(), PyStatic.NewNone(), PyStatic.NewFalse());
-        mSession->SetItemString(name, tuple);
+        mSession->SetItem(PyString::Intern(name), tuple);
     }
 
     PyRep* current(tuple->GetItem(1)); // copy c'tor
@@ -37,6 +37,8 @@
 #include "market/MarketMgr.h"
 #include "missions/MissionDataMgr.h"
 #include "threading/Threading.h"
+#include "threading/WakeEvent.h"
+#include "utils/Trace.h"
 // #include "testing/test.h"
 
 
@@ -68,6 +70,7 @@ void ConsoleCommand::Initialize(CommandDispatcher* cd)
             std::lock_guard<std::mutex> lock(m_inputMutex);
             m_input.push_back(std::move(temp));
             m_inputCondition.notify_one();
+            sMainLoopWake.Notify();
         }
     });
 }
@@ -120,6 +123,8 @@ bool ConsoleCommand::HandleCommand(const char* buf)
         sLog.Warning("           (n)ote", " Broadcasts a message to all clients thru a notification window.");
         sLog.Warning("        (m)essage", " Broadcasts a message to all clients thru a message window.");
         sLog.Warning("        (p)rofile", " Prints a profile of current server runtimes.  *Incomplete*");
+        sLog.Warning("   trace [on|off]", " Turns trace spans on or off.");
+        sLog.Warning("      trace [sec]", " Writes the last sec (default 10) seconds of spans to logDir, as Chrome trace JSON.");
         sLog.Warning("          r(o)les", " Prints a list of common roles and their values.");
         sLog.Warning("       c(o)mmands", " Prints a list of currently loaded Commands and their required role. (long list)");
         sLog.Warning("           (t)est", " Prints the current test object *varies*");
@@ -317,6 +322,26 @@ bool ConsoleCommand::HandleCommand(const char* buf)
     else if (strncmp(buf, "o", 1) == 0) {
         pCommand->ListCommands();
     }
+    else if (strncmp(buf, "trace", 5) == 0) {
+        // before "t".  view dumps in chrome://tracing or ui.perfetto.dev
+        Seperator sep(buf);
+        if ((sep.argCount() > 1) and ((sep.arg(1) == "on") or (sep.arg(1) == "off"))) {
+            TraceRecorder::SetEnabled(sep.arg(1) == "on");
+            sLog.Green("  EVEmu", "Tracing is %s.", (TraceRecorder::IsEnabled() ? "on" : "off"));
+        } else if (!TraceRecorder::IsEnabled()) {
+            sLog.Error("            Trace", "Tracing is off.  'trace on' first.");
+        } else {
+            double seconds = (((sep.argCount() > 1) and sep.isNumber(1)) ? atof(sep.arg(1).c_str()) : 10.0);
+            char filename[256];
+            snprintf(filename, sizeof(filename), "%strace_%li.json", sConfig.files.logDir.c_str(), (long)time(nullptr));
+            std::ofstream file(filename);
+            if (file << sTrace.Serialize(seconds)) {
+                sLog.Green("  EVEmu", "Last %.1fs of trace spans written to %s", seconds, filename);
+            } else {
+                sLog.Error("            Trace", "Unable to write %s", filename);
+            }
+        }
+    }
     else if (strncmp(buf, "t", 1) == 0) {
         Test();
     }
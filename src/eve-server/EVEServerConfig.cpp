@@ -232,6 +232,8 @@ EVEServerConfig::EVEServerConfig()
     debug.IsTestServer = true;
     debug.UseProfiling = false;
     debug.PositionHack = false;
+    debug.RecordPackets = false;
+    debug.UseTracing = false;
     debug.UseShipTracking = false;
     debug.DeleteTrackingCans = true;
     debug.SpawnTest = false;
@@ -257,11 +259,13 @@ EVEServerConfig::EVEServerConfig()
     files.cacheDir = "../server_cache/";
     files.imageDir = "../image_cache/";
     files.marketBotSettings = "../etc/MarketBot.xml";
+    files.packetLogDir = "../packet_log/";
 
     // net
     net.port = 26000;
     net.imageServer = "localhost";
     net.imageServerPort = 26001;
+    net.imageCacheMB = 64;
 
     // threads  -not implemented
     threads.ConsoleThreads = 1;//P
@@ -644,6 +648,7 @@ bool EVEServerConfig::ProcessFiles( const TiXmlElement* ele )
     AddValueParser( "logSettings",      files.logSettings );
     AddValueParser( "cacheDir",         files.cacheDir );
     AddValueParser( "imageDir",         files.imageDir );
+    AddValueParser( "packetLogDir",     files.packetLogDir );
 
     const bool result = ParseElementChildren( ele );
 
@@ -651,6 +656,7 @@ bool EVEServerConfig::ProcessFiles( const TiXmlElement* ele )
     RemoveParser( "logSettings" );
     RemoveParser( "cacheDir" );
     RemoveParser( "imageDir" );
+    RemoveParser( "packetLogDir" );
 
     return result;
 }
@@ -660,12 +666,14 @@ bool EVEServerConfig::ProcessNet( const TiXmlElement* ele )
     AddValueParser( "port",             net.port );
     AddValueParser( "imageServerPort",  net.imageServerPort);
     AddValueParser( "imageServer",      net.imageServer);
+    AddValueParser( "imageCacheMB",     net.imageCacheMB);
 
     const bool result = ParseElementChildren( ele );
 
     RemoveParser( "port" );
     RemoveParser( "imageServerPort" );
     RemoveParser( "imageServer" );
+    RemoveParser( "imageCacheMB" );
 
     return result;
 }
@@ -825,6 +833,8 @@ bool EVEServerConfig::ProcessDebug(const TiXmlElement* ele)
     AddValueParser( "UseProfiling",         debug.UseProfiling );
     AddValueParser( "UseShipTracking",      debug.UseShipTracking );
     AddValueParser( "PositionHack",         debug.PositionHack );
+    AddValueParser( "RecordPackets",        debug.RecordPackets );
+    AddValueParser( "UseTracing",           debug.UseTracing );
     AddValueParser( "AnomalyFaction",       debug.AnomalyFaction );
     AddValueParser( "BubbleTrack",          debug.BubbleTrack );
     AddValueParser( "SpawnTest",            debug.SpawnTest );
@@ -839,6 +849,8 @@ bool EVEServerConfig::ProcessDebug(const TiXmlElement* ele)
     RemoveParser( "UseProfiling" );
     RemoveParser( "UseShipTracking" );
     RemoveParser( "PositionHack" );
+    RemoveParser( "RecordPackets" );
+    RemoveParser( "UseTracing" );
     RemoveParser( "DeleteTrackingCans" );
     RemoveParser( "AnomalyFaction" );
     RemoveParser( "SpawnTest" );
@@ -239,6 +239,8 @@ public:
         std::string imageDir;
         // used as the path for the MarketBot.xml settings file
         std::string marketBotSettings;
+        /// A directory at which session packet logs are written (see debug.RecordPackets).
+        std::string packetLogDir;
     } files;
 
     // From <net>
@@ -249,6 +251,8 @@ public:
         uint16 imageServerPort;
         /// the imageServer for char images. should be the evemu server external ip/host
         std::string imageServer;
+        /// Memory the imageServer may use to keep served images, in MB. 0 disables the cache.
+        uint32 imageCacheMB;
     } net;
 
     // From <thread>
@@ -339,6 +343,8 @@ public:
         bool UseShipTracking;
         bool DeleteTrackingCans;
         bool PositionHack;
+        bool RecordPackets;     // write each session's packets to files.packetLogDir, for eve-loadtest -R
+        bool UseTracing;        // record trace spans from startup, for the console 'trace' dump
         uint16 ProfileTraceTime;
         uint32 AnomalyFaction;
     } debug;
@@ -47,6 +47,12 @@
 #include "system/cosmicMgrs/WormholeMgr.h"
 #include "system/cosmicMgrs/ManagerDB.h"
 #include "corporation/CorporationDB.h"
+#include "utils/Trace.h"
+
+/* main loop pass budget.  passes longer than this start delaying the 4Hz tic */
+static const uint32 PASS_BUDGET_MS = 100;
+/* low-priority work is deferred at most this many 1Hz tics in a row */
+static const uint8 MAX_DEFERRED_TICS = 30;
 
 EntityList::EntityList()
 : m_services(nullptr),
@@ -58,6 +64,8 @@ m_npcs(0),
 m_stamp(1000),   /* arbitrary.  start at 1k.  in seconds.  used for destiny and client counters */
 m_minutes(0),
 m_connections(0),
+m_overrun(0),
+m_deferredTics(0),
 m_clientSeedID(0)
 {
     m_agents.clear();
@@ -186,19 +194,25 @@ void EntityList::RemovePlayer(Client* pClient)
 
 
 void EntityList::Process() {
-    Client* pClient(nullptr);
-    std::vector<Client*>::iterator citr = m_clients.begin();
-    while (citr != m_clients.end()) {
-        if ((*citr)->ProcessNet()) {
-            ++citr;
-        } else {
-            pClient = *citr;
-            citr = m_clients.erase(citr);
-            SafeDelete(pClient);
+    TRACE_SPAN("EntityList::Process");
+
+    {
+        TRACE_SPAN("EntityList::ProcessNet");
+        Client* pClient(nullptr);
+        std::vector<Client*>::iterator citr = m_clients.begin();
+        while (citr != m_clients.end()) {
+            if ((*citr)->ProcessNet()) {
+                ++citr;
+            } else {
+                pClient = *citr;
+                citr = m_clients.erase(citr);
+                SafeDelete(pClient);
+            }
         }
     }
 
     if (m_targTimer.Check()) {
+        TRACE_SPAN("EntityList::Targets");
         std::unordered_map<SystemEntity*, TargetManager*>::iterator titr = m_targMgrs.begin();
         while (titr != m_targMgrs.end()) {
             if (titr->second->Process()) {
@@ -223,9 +237,12 @@ void EntityList::Process() {
 
         ++m_stamp;
 
-        for (auto cur : m_players)
-            if (cur.second->IsValidSession())   // verify client is constructed before calling ProcessClient() on it
-                cur.second->ProcessClient();
+        {
+            TRACE_SPAN("EntityList::ProcessClient");
+            for (auto cur : m_players)
+                if (cur.second->IsValidSession())   // verify client is constructed before calling ProcessClient() on it
+                    cur.second->ProcessClient();
+        }
 
     /** @todo test for adding OpenMP here to enable MP per system. */
     // this wont work....possibility of removing systems, therefore invalidating the iterator.
@@ -246,12 +263,26 @@ void EntityList::Process() {
             ++itr;
         }
 
+        // overloaded tics leave low-priority work for a lighter one, but not forever
+        bool lowPriority(true);
+        if (IsOverloaded() and (++m_deferredTics < MAX_DEFERRED_TICS)) {
+            static MetricCounter& deferMetric = sMetrics.GetCounter("evemu_main_loop_deferred_tics_total", "1Hz tics that deferred low-priority work while the main loop was overloaded.");
+            deferMetric.Inc();
+            lowPriority = false;
+        } else {
+            m_deferredTics = 0;
+        }
+
         // these need 1Hz tics
-        sCivMgr.Process();
-        sBubbleMgr.Process();
+        {
+            TRACE_SPAN("EntityList::Managers");
+            sCivMgr.Process();
+            sBubbleMgr.Process(lowPriority);
+        }
 
-        // these minute tics do not need to be precise
-        if (m_minuteTimer.Check()) {
+        // these minute tics do not need to be precise.  an unchecked timer stays due, so deferring only delays them
+        if (lowPriority and m_minuteTimer.Check()) {
+            TRACE_SPAN("EntityList::MinuteTasks");
             ++m_minutes;
             sMissionDataMgr.Process();  // 1m
 
@@ -276,6 +307,20 @@ void EntityList::Process() {
     }
 }
 
+uint32 EntityList::GetNextTicDelay() const {
+    // timers fire once strictly past due, so add 1ms.  an overdue tic gives 1ms, which the pass has usually used up
+    return std::min(m_targTimer.GetRemainingTime(), m_stampTimer.GetRemainingTime()) + 1;
+}
+
+void EntityList::AddPassTime(uint32 busyMs, uint32 idleMs) {
+    uint32 budget = PASS_BUDGET_MS + idleMs;
+    if (busyMs > budget) {
+        m_overrun += busyMs - budget;
+    } else {
+        m_overrun -= std::min(m_overrun, budget - busyMs);
+    }
+}
+
 SystemManager* EntityList::FindOrBootSystem(uint32 systemID) {
     if (!sDataMgr.IsSolarSystem(systemID)) {
         _log(SERVER__INIT_ERR, "BootSystem() called with invalid systemID (%u)", systemID);
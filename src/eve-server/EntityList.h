@@ -27,6 +27,7 @@
 #ifndef EVE_ENTITY_LIST_H
 #define EVE_ENTITY_LIST_H
 
+#include <atomic>
 #include <vector>
 
 #include "eve-common.h"
@@ -90,6 +91,14 @@ public:
 
     // for main loop thread sleeping
     bool HasClients()                                   { return !m_players.empty(); }
+    // ms until the next 4Hz or 1Hz tic fires, as of this pass
+    uint32 GetNextTicDelay() const;
+    /* main loop reports each pass here.  time over the pass budget is kept as overrun, and rest between passes pays it back.
+     *  while there is overrun, low-priority work (minute tasks, bubble wanderer checks) waits for a lighter tic.
+     */
+    void AddPassTime(uint32 busyMs, uint32 idleMs);
+    bool IsOverloaded() const                           { return m_overrun > 0; }
+    uint32 GetOverrun() const                           { return m_overrun; }
 
     Agent* GetAgent(uint32 agentID);
 
@@ -202,7 +211,9 @@ private:
     uint32 m_stamp;
     uint32 m_minutes;
     uint32 m_connections;
-    uint16 m_clientSeedID;
+    uint32 m_overrun;       // ms over pass budget, not yet paid back
+    uint8 m_deferredTics;   // 1Hz tics low-priority work has been deferred
+    std::atomic<uint16> m_clientSeedID;        // also read by LoginPool workers (account creation)
 
     int64 m_startTime;
 };
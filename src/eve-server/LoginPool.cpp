@@ -0,0 +1,183 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include <algorithm>
+#include <thread>
+
+#include "LoginPool.h"
+#include "ServiceDB.h"
+#include "threading/Threading.h"
+#include "threading/WakeEvent.h"
+
+
+void AccountJob::Run()
+{
+    failMsg = "Login Authorization Invalid.";
+
+    // test account name for invalid chars (which may allow sql injection)
+    if (!ServiceDB::ValidateAccountName(ccp, failMsg))
+        return;
+
+    if (!ServiceDB::GetAccountInformation(ccp, aData, failMsg))
+        return;
+
+    if (aData.banned) {
+        failMsg = "Your account is banned. Contact Allan for further support";
+        return;
+    }
+
+    if (aData.online and !loadTest) {
+        failMsg = "This account is currently online.";
+        return;
+    }
+
+    if (!ccp.user_password.empty()) {
+        sLog.Warning("  Client::Login()", "%s(%u) - Using Plain Password", aData.name.c_str(), aData.clientID);
+        if (strcmp(aData.password.c_str(), ccp.user_password.c_str()) != 0) {
+            failMsg = "The plain Password you entered is incorrect for this account.";
+            return;
+        }
+    } else {
+        if (strcmp(aData.hash.c_str(), ccp.user_password_hash.c_str()) != 0) {
+            failMsg = "The Password you entered is incorrect for this account.";
+            return;
+        }
+
+        if (!ccp.user_password.empty())
+            ServiceDB::UpdatePassword(aData.id, ccp.user_password.c_str());
+    }
+
+    ServiceDB::GetAccountCharacters(aData.id, charIDs);
+    result = true;
+}
+
+void CharPrefetchJob::Run()
+{
+    result = ItemDB::GetLoginItems(charID, items);
+}
+
+
+LoginPool::LoginPool()
+: m_running(false),
+m_active(0),
+m_nextConn(0),
+m_workers(0)
+{
+}
+
+int LoginPool::Initialize()
+{
+    // one db connection per worker.  without any, jobs run inline on the main connection as before
+    m_workers = sDatabase.AddConnections((uint8)std::max(2, std::min(4, (int)std::thread::hardware_concurrency() / 2)));
+    if (m_workers == 0) {
+        sLog.Error("        LoginPool", "No worker db connections.  Login jobs will run inline.");
+        return 1;
+    }
+
+    m_running = true;
+    m_active = m_workers;
+    for (uint8 i = 0; i < m_workers; ++i)
+        sThread.CreateThread(WorkerLoop, this);
+
+    sLog.Blue("        LoginPool", "Login Worker Pool Initialized with %u threads.", m_workers);
+    return 1;
+}
+
+void LoginPool::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+        m_queue.clear();
+    }
+    m_cond.notify_all();
+
+    // workers are detached, so wait for them to leave Work() before db is closed.  a running job finishes first
+    double stopTime(GetTimeMSeconds() + 5000);
+    while ((m_active > 0) and (GetTimeMSeconds() < stopTime))
+        Sleep(10);
+
+    sLog.Warning("        LoginPool", "Login Worker Pool has been closed." );
+}
+
+void LoginPool::Queue(std::shared_ptr<LoginJob> job)
+{
+    job->m_queueTime = GetTimeMSeconds();
+    if (!m_running) {
+        RunJob(job.get());
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(job);
+    }
+    m_cond.notify_one();
+}
+
+uint32 LoginPool::GetQueueSize()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size();
+}
+
+void* LoginPool::WorkerLoop(void* arg)
+{
+    LoginPool* pPool = reinterpret_cast<LoginPool*>(arg);
+    pPool->Work();
+    return nullptr;
+}
+
+void LoginPool::Work()
+{
+    sDatabase.BindThread(m_nextConn++);
+
+    std::shared_ptr<LoginJob> job;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this] { return (!m_running or !m_queue.empty()); });
+            if (!m_running)
+                break;
+            job = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        RunJob(job.get());
+        job.reset();
+    }
+    sDatabase.UnbindThread();
+    --m_active;
+}
+
+void LoginPool::RunJob(LoginJob* pJob)
+{
+    pJob->m_runTime = GetTimeMSeconds();
+    pJob->Run();
+    pJob->m_doneTime = GetTimeMSeconds();
+    pJob->m_done.store(true, std::memory_order_release);
+    // let the main loop finish the login now, instead of on its next pass
+    sMainLoopWake.Notify();
+}
@@ -0,0 +1,145 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#ifndef __EVE_SERVER_LOGIN_POOL_H__
+#define __EVE_SERVER_LOGIN_POOL_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "eve-server.h"
+#include "POD_containers.h"
+#include "inventory/ItemDB.h"
+#include "packets/Crypto.h"
+
+/* worker threads for the db-heavy parts of client login.
+ *  each worker has its own db connection (DBcore::AddConnections()), so its queries do not wait on the main loop's.
+ *  account lookup and password check run here, as does reading a character's
+ *  login items (skills, implants, ship and its contents) while the player is on char select.
+ *  the only login work left on the main thread is building the session and attaching to EntityList.
+ *
+ * jobs are shared between the pool and the Client that queued them.  the Client polls IsDone()
+ *  from ProcessNet(), so nothing is ever called back on the main thread.  a client dropping
+ *  mid-login just drops its ref, and the job is deleted when the worker is done with it.
+ * all job data is written before m_done is set, and only read after IsDone() returns true.
+ */
+class LoginJob
+{
+public:
+    LoginJob() : m_done(false), m_queueTime(0.0), m_runTime(0.0), m_doneTime(0.0) { }
+    virtual ~LoginJob() { }
+
+    // called on a worker thread.  db only; no access to server objects
+    virtual void Run() = 0;
+
+    bool IsDone() const                                 { return m_done.load(std::memory_order_acquire); }
+    // times in ms.  valid after IsDone()
+    double GetWaitTime() const                          { return m_runTime - m_queueTime; }
+    double GetRunTime() const                           { return m_doneTime - m_runTime; }
+
+private:
+    friend class LoginPool;
+    std::atomic<bool> m_done;
+    double m_queueTime;
+    double m_runTime;
+    double m_doneTime;
+};
+
+// validates account name and password for a CryptoChallengePacket.  called from Client::_VerifyLogin()
+class AccountJob
+: public LoginJob
+{
+public:
+    AccountJob(const CryptoChallengePacket& ccp) : ccp(ccp), loadTest(false), result(false) { }
+
+    void Run();
+
+    CryptoChallengePacket ccp;
+    bool loadTest;                                      // loginLoadTest runs the full check on an account that is online
+    // results
+    bool result;
+    std::string failMsg;
+    AccountData aData;
+    std::vector<uint32> charIDs;                        // chars on this account, for prefetch
+};
+
+// reads a character's login items, for ItemFactory to use in Client::SelectCharacter()
+class CharPrefetchJob
+: public LoginJob
+{
+public:
+    CharPrefetchJob(uint32 charID) : charID(charID), result(false) { }
+
+    void Run();
+
+    uint32 charID;
+    // results
+    bool result;
+    ItemPrefetch items;
+};
+
+
+class LoginPool
+: public Singleton< LoginPool >
+{
+public:
+    LoginPool();
+    ~LoginPool()                                        { /* do nothing here */ }
+
+    int Initialize();
+    void Close();
+
+    // jobs are run inline when pool isnt running
+    void Queue(std::shared_ptr<LoginJob> job);
+
+    uint32 GetQueueSize();
+    uint8 GetWorkerCount()                              { return m_workers; }
+
+protected:
+    // thread entry point, called thru sThread
+    static void* WorkerLoop(void* arg);
+    void Work();
+
+    void RunJob(LoginJob* pJob);
+
+private:
+    std::atomic<bool> m_running;
+    std::atomic<uint8> m_active;                        // workers still in Work()
+    std::atomic<uint8> m_nextConn;                      // db connection for the next worker to start
+    uint8 m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<std::shared_ptr<LoginJob>> m_queue;
+};
+
+//Singleton
+#define sLoginPool \
+    ( LoginPool::get() )
+
+#endif  // __EVE_SERVER_LOGIN_POOL_H__
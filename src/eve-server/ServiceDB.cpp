@@ -172,6 +172,19 @@ void ServiceDB::UpdatePassword(uint32 accountID, const char* pass)
     sDatabase.RunQuery(err, "UPDATE account SET password = '%s' WHERE accountID=%u", pass, accountID);
 }
 
+void ServiceDB::GetAccountCharacters(uint32 accountID, std::vector<uint32>& into)
+{
+    DBQueryResult res;
+    if (!sDatabase.RunQuery(res, "SELECT characterID FROM chrCharacters WHERE accountID = %u", accountID)) {
+        codelog(DATABASE__ERROR, "Error in GetAccountCharacters query: %s", res.error.c_str());
+        return;
+    }
+
+    DBResultRow row;
+    while (res.GetRow(row))
+        into.push_back(row.GetUInt(0));
+}
+
 void ServiceDB::SetServerOnlineStatus(bool online) {
     DBerror err;
     sDatabase.RunQuery(err, "UPDATE srvStatus SET Online = %u, Connections = 0, startTime = %s WHERE AI = 1",
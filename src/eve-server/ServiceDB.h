@@ -45,6 +45,7 @@ public:
     static bool UpdateAccountHash( const char* username, std::string &hash );
     static bool IncrementLoginCount(uint32 accountID );
     static void UpdatePassword(uint32 accountID, const char* pass);
+    static void GetAccountCharacters(uint32 accountID, std::vector<uint32>& into);
 
     uint32 GetStationOwner(uint32 stationID);
 
@@ -1207,6 +1207,35 @@ PyResult Command_runtest(Client* pClient, CommandDB* db, EVEServiceManager &serv
     return nullptr;
 }
 
+PyResult Command_bulkloadtest(Client* pClient, CommandDB* db, EVEServiceManager &services, const Seperator& args)
+{
+    if (!pClient->IsDocked())
+        throw CustomError ("You're not docked.");
+
+    uint32 count(5000);
+    if (args.argCount() > 1) {
+        if (!args.isNumber(1))
+            throw CustomError ("Argument 1 must be a count.");
+        count = atoi(args.arg(1).c_str());
+    }
+
+    testing::bulkLoadTest(pClient, count);
+    return nullptr;
+}
+
+PyResult Command_loginloadtest(Client* pClient, CommandDB* db, EVEServiceManager &services, const Seperator& args)
+{
+    uint16 count(500);
+    if (args.argCount() > 1) {
+        if (!args.isNumber(1))
+            throw CustomError ("Argument 1 must be a count.");
+        count = atoi(args.arg(1).c_str());
+    }
+
+    testing::loginLoadTest(pClient, count);
+    return nullptr;
+}
+
 PyResult Command_bindList(Client* pClient, CommandDB* db, EVEServiceManager &services, const Seperator& args)
 {
     // TODO: properly implement this
@@ -62,6 +62,10 @@
           " - begin warp to given bubbleID in current ship.")
  COMMAND( runtest, Acct::Role::PROGRAMMER,
           " - run testing::posTest()." )
+ COMMAND( bulkloadtest, Acct::Role::PROGRAMMER,
+          " - time per-item vs bulk item loading for <count> (default 5000) synthetic items in current station." )
+ COMMAND( loginloadtest, Acct::Role::PROGRAMMER,
+          " - main loop tick overrun for <count> (default 500) simulated logins, inline vs login worker pool." )
  COMMAND( bindList, Acct::Role::PROGRAMMER,
           " - list of current bound objects (with clients)." )
  COMMAND( dropLoot, Acct::Role::PROGRAMMER,
@@ -147,7 +147,8 @@ PyResult AgentMgrService::GetMyJournalDetails(PyCallArgs &call) {
         mData->SetItem(3, new PyString(cur.name)); //missionName
         mData->SetItem(4, new PyInt(cur.agentID)); //agentID
         mData->SetItem(5, new PyLong(cur.expiryTime)); //expirationTime
-        mData->SetItem(6, cur.bookmarks->Clone()); //bookmarks -- if populated, this is PyList of PyDicts as defined below...
+        PyIncRef(cur.bookmarks);
+        mData->SetItem(6, cur.bookmarks); //bookmarks -- if populated, this is PyList of PyDicts as defined below...
         mData->SetItem(7, new PyBool(cur.remoteOfferable)); //remoteOfferable
         mData->SetItem(8, new PyBool(cur.remoteCompletable)); //remoteCompletable
         missions->AddItem(mData);
@@ -23,34 +23,101 @@
     Author:        Aknor Jaden
 */
 
-#include "eve-server.h"
+
+#include "eve-core.h"
+
+#include "utils/utils_time.h"
 
 #include "apiserver/APICacheManager.h"
 
-APICacheManager::APICacheManager()
+APICacheManager::APICacheManager(size_t maxBytes/*16MB*/)
+: m_bytes(0),
+  m_maxBytes(maxBytes)
 {
 }
 
+std::string APICacheManager::BuildDescriptor(const APICommandCall * pAPICommandCall)
+{
+    std::string descriptor;
+    APICommandCall::const_iterator itr = pAPICommandCall->find( "service" );
+    if ( itr != pAPICommandCall->end() )
+        descriptor += itr->second;
+    descriptor += "/";
+    itr = pAPICommandCall->find( "servicehandler" );
+    if ( itr != pAPICommandCall->end() )
+        descriptor += itr->second;
+    descriptor += "?";
+
+    for ( itr = pAPICommandCall->begin(); itr != pAPICommandCall->end(); ++itr )
+    {
+        if ( (itr->first == "service") or (itr->first == "servicehandler") )
+            continue;
+        descriptor += itr->first;
+        descriptor += "=";
+        descriptor += itr->second;
+        descriptor += "&";
+    }
+
+    return descriptor;
+}
+
 bool APICacheManager::CacheRetrieve(const std::string * apiDescriptor, std::string * xmlDoc)
 {
-    // TODO:
-    // 1) run apiDescriptor string through SHA1 hash, then search for a file
-    //    with the name of the hash with '.apiobj' extension
-    // 2) if no file found, then return FALSE
-    // 3) if file found, open it and grab first line, inspect this expriation time and compare to current time
-    // 4) if expiration has passed, return FALSE
-    // 5) if expiration has NOT passed, read rest of file contents and copy to xmlDoc string, then return TRUE
+    std::unique_lock<std::mutex> lock( m_mutex );
+
+    // someone is already building this one; use theirs
+    while ( m_building.find( *apiDescriptor ) != m_building.end() )
+        m_cond.wait( lock );
+
+    std::unordered_map<std::string, EntryList::iterator>::iterator itr = m_index.find( *apiDescriptor );
+    if ( itr != m_index.end() )
+    {
+        if ( itr->second->expires > Win32TimeNow() )
+        {
+            m_entries.splice( m_entries.begin(), m_entries, itr->second );
+            *xmlDoc = itr->second->xmlDoc;
+            return true;
+        }
+
+        _Remove( itr->second );
+    }
+
+    // caller builds it
+    m_building.insert( *apiDescriptor );
     return false;
 }
 
-bool APICacheManager::CacheDeposit(const std::string * apiDescriptor, const std::string * xmlDoc, uint64 win32timeExpiration)
+bool APICacheManager::CacheDeposit(const std::string * apiDescriptor, const std::string * xmlDoc, int64 win32timeExpiration)
 {
-    // TODO:
-    // 1) run apiDescriptor string through SHA1 hash, then create a file
-    //    with the name of the hash with '.apiobj' extension
-    // 2) check to see if this filename already exists, if so, return FALSE
-    // 3) place the win32timeExpiration value at the first line of the file, this indicates when this cached object expires
-    // 4) place the xmlDoc string in the rest of the file, save and close it
-    // 5) return TRUE
-    return false;
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    m_building.erase( *apiDescriptor );
+    m_cond.notify_all();
+
+    if ( (win32timeExpiration <= Win32TimeNow()) or (xmlDoc->size() > m_maxBytes / 16) )
+        return false;
+
+    std::unordered_map<std::string, EntryList::iterator>::iterator itr = m_index.find( *apiDescriptor );
+    if ( itr != m_index.end() )
+        _Remove( itr->second );
+
+    Entry entry;
+    entry.descriptor = *apiDescriptor;
+    entry.xmlDoc = *xmlDoc;
+    entry.expires = win32timeExpiration;
+    m_entries.push_front( entry );
+    m_index[ *apiDescriptor ] = m_entries.begin();
+    m_bytes += xmlDoc->size();
+
+    while ( m_bytes > m_maxBytes )
+        _Remove( --m_entries.end() );
+
+    return true;
+}
+
+void APICacheManager::_Remove(EntryList::iterator itr)
+{
+    m_bytes -= itr->xmlDoc.size();
+    m_index.erase( itr->descriptor );
+    m_entries.erase( itr );
 }
@@ -23,44 +23,91 @@
     Author:        Aknor Jaden
 */
 
+
 #ifndef __APIAPICACHEMANAGER_H_INCL__
 #define __APIAPICACHEMANAGER_H_INCL__
 
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 
+#include "apiserver/APICommandCall.h"
 
+/**
+ * \class APICacheManager
+ *
+ * @brief In-memory cache of API xml documents, until their cachedUntil time.
+ *
+ * Documents are keyed by their api descriptor; see BuildDescriptor().  The
+ * cache is bounded by size, and drops the least recently used documents
+ * first.  Identical requests made while a document is being built wait for
+ * it, so only one of them hits the database.
+ *
+ * Thread safe.
+ */
 class APICacheManager
 {
 public:
-    APICacheManager();
+    APICacheManager(size_t maxBytes = 16 * 1024 * 1024);
+
+    /**
+     * @brief Makes the cache key for a call: service, handler and its params, in order.
+     *
+     * Params are lower case and sorted (APICommandCall is a map), so the same
+     * query always makes the same key.  The key id / api key are params, so
+     * documents are never shared between keys.
+     */
+    static std::string BuildDescriptor(const APICommandCall * pAPICommandCall);
 
     /**
-     * @brief ?
+     * @brief Looks up a document.
      *
-     * ?
+     * If another thread is building this document, waits for it first.
      *
-     * @param[in] ?
-     * @param[in] ?
+     * @param[in] apiDescriptor key, from BuildDescriptor()
+     * @param[out] xmlDoc the cached document
      *
-     * @retval ?
+     * @retval true xmlDoc is set.
+     * @retval false not cached (or expired); the caller must build the document and
+     *               call CacheDeposit(), which other callers will wait for.
      */
     bool CacheRetrieve(const std::string * apiDescriptor, std::string * xmlDoc);
 
     /**
-     * @brief ?
+     * @brief Stores a document built after CacheRetrieve() returned false.
      *
-     * ?
+     * @param[in] apiDescriptor key, from BuildDescriptor()
+     * @param[in] xmlDoc the document
+     * @param[in] win32timeExpiration its cachedUntil; 0 (or a past time) doesnt cache it,
+     *            but still has to be called to release waiting callers.
      *
-     * @param[in] ?
-     * @param[in] ?
-     *
-     * @retval ?
+     * @retval true the document was cached.
      */
-    bool CacheDeposit(const std::string * apiDescriptor, const std::string * xmlDoc, uint64 win32timeExpiration);
+    bool CacheDeposit(const std::string * apiDescriptor, const std::string * xmlDoc, int64 win32timeExpiration);
 
 protected:
+    struct Entry {
+        std::string descriptor;
+        std::string xmlDoc;
+        int64 expires;
+    };
+    typedef std::list<Entry> EntryList;
 
-};
+    void _Remove(EntryList::iterator itr);
 
-#endif    //__APIAPICACHEMANAGER_H_INCL__
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
 
+    // most recently used first
+    EntryList m_entries;
+    std::unordered_map<std::string, EntryList::iterator> m_index;
+    // descriptors being built
+    std::unordered_set<std::string> m_building;
+    size_t m_bytes;
+    size_t m_maxBytes;
+};
 
+#endif    //__APIAPICACHEMANAGER_H_INCL__
@@ -76,15 +76,33 @@ std::tr1::shared_ptr<std::vector<char> > APIServer::GetXML(const APICommandCall
 
     if ( m_APIServiceManagers.find(pAPICommandCall->find( "service" )->second) != m_APIServiceManagers.end() )
     {
+        // served this recently?  then it cant have changed, as far as the client is concerned (cachedUntil)
+        std::string descriptor = APICacheManager::BuildDescriptor( pAPICommandCall );
+        std::string xmlDoc;
+        if ( m_cache.CacheRetrieve( &descriptor, &xmlDoc ) )
+            return std::tr1::shared_ptr<std::vector<char> >( new std::vector<char>( xmlDoc.begin(), xmlDoc.end() ) );
+
         // Get reference to service manager object and call ProcessCall() with the pAPICommandCall packet
         //m_xmlString = m_APIServiceManagers.find("base")->second->ProcessCall(pAPICommandCall);
-        m_xmlString = m_APIServiceManagers.find( pAPICommandCall->find( "service" )->second )->second->ProcessCall( pAPICommandCall );
+        APIServiceManager * pManager = m_APIServiceManagers.find( pAPICommandCall->find( "service" )->second )->second;
+        try {
+            m_xmlString = pManager->ProcessCall( pAPICommandCall );
+        } catch (...) {
+            // CacheRetrieve() made us the builder for this descriptor.  give the slot up so identical calls dont wait forever
+            m_cache.CacheDeposit( &descriptor, &xmlDoc, 0 );
+            throw;
+        }
+
+        // always deposit, even uncached, as identical calls are waiting on it
+        if ( m_xmlString )
+            m_cache.CacheDeposit( &descriptor, m_xmlString.get(), pManager->GetCachedUntil() );
+        else
+            m_cache.CacheDeposit( &descriptor, &xmlDoc, 0 );
 
         // Convert the std::string to the std::vector<char>:
         std::tr1::shared_ptr<std::vector<char> > ret = std::tr1::shared_ptr<std::vector<char> >(new std::vector<char>());
-        unsigned long len = m_xmlString->length();
-        for(size_t i=0; i<m_xmlString->length(); i++)
-            ret->push_back(m_xmlString->at(i));
+        if ( m_xmlString )
+            ret->assign( m_xmlString->begin(), m_xmlString->end() );
 
         return ret;
     }
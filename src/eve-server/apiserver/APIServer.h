@@ -27,6 +27,7 @@
 #define __APISERVER__H__INCL__
 
 #include "APIServerListener.h"
+#include "apiserver/APICacheManager.h"
 
 class APIServiceManager;
 
@@ -72,6 +73,9 @@ private:
 
     std::map<std::string, APIServiceManager *> m_APIServiceManagers;    // We own these
 
+    // documents served, until their cachedUntil
+    APICacheManager m_cache;
+
     class Lock
     {
     public:
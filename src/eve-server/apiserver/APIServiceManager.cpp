@@ -33,6 +33,7 @@ APIServiceManager::APIServiceManager(const PyServiceMgr &services)
     _pXmlDocOuterTag = NULL;
     _pXmlElementStack = NULL;
     _CurrentRowSetColumnString = "";
+    m_cachedUntil = 0;
 }
 
 std::tr1::shared_ptr<std::string> APIServiceManager::ProcessCall(const APICommandCall * pAPICommandCall)
@@ -191,6 +192,7 @@ void APIServiceManager::_BuildXMLHeader()
 {
     // Build header at beginning of XML document, so clear existing xml document
     _XmlDoc.Clear();
+    m_cachedUntil = 0;
     // object pointed to by '_pXmlDocOuterTag' is automatically deleted by the TinyXML system with the above call
     if ( _pXmlElementStack != NULL )
     {
@@ -217,17 +219,22 @@ void APIServiceManager::_CloseXMLHeader(uint32 cacheStyle)
     {
         case EVEAPI::CacheStyles::Long:
             // 2 hour cache timer
-            _BuildSingleXMLTag( "cachedUntil", Win32TimeToString(Win32TimeNow() + 120*Win32Time_Minute).c_str() );
+            m_cachedUntil = Win32TimeNow() + 120*Win32Time_Minute;
             break;
         case EVEAPI::CacheStyles::Short:
             // 5 minute cache timer
-            _BuildSingleXMLTag( "cachedUntil", Win32TimeToString(Win32TimeNow() + 5*Win32Time_Minute).c_str() );
+            m_cachedUntil = Win32TimeNow() + 5*Win32Time_Minute;
             break;
         case EVEAPI::CacheStyles::Modified:
             // 15 minute cache timer
-            _BuildSingleXMLTag( "cachedUntil", Win32TimeToString(Win32TimeNow() + 15*Win32Time_Minute).c_str() );
+            m_cachedUntil = Win32TimeNow() + 15*Win32Time_Minute;
             break;
+        default:
+            return;
     }
+
+    // APIServer caches the document until then
+    _BuildSingleXMLTag( "cachedUntil", Win32TimeToString(m_cachedUntil).c_str() );
 }
 
 void APIServiceManager::_BuildXMLRowSet(std::string name, std::string key, const std::vector<std::string> * columns)
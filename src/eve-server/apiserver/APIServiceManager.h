@@ -27,6 +27,7 @@
 #define __APISERVICEMANAGER__H__INCL__
 
 
+#include "apiserver/APICommandCall.h"
 #include "apiserver/APIServiceDB.h"
 
 namespace EVEAPI {
@@ -56,8 +57,6 @@ namespace EVEAPI {
     }
 }
 
-typedef std::map<std::string, std::string> APICommandCall;
-
 /**
  * \class APIServiceManager
  *
@@ -80,6 +79,9 @@ public:
     virtual std::tr1::shared_ptr<std::string> ProcessCall(const APICommandCall * pAPICommandCall);
     std::tr1::shared_ptr<std::string> BuildErrorXMLResponse(std::string errorCode, std::string errorMessage);
 
+    // cachedUntil of the last document built (Win32 time); 0 if it had none
+    int64 GetCachedUntil() const { return m_cachedUntil; }
+
 protected:
     bool _AuthenticateUserNamePassword(std::string userName, std::string password);
     bool _AuthenticateFullAPIQuery(std::string userID, std::string apiKey);
@@ -106,6 +108,7 @@ protected:
     TiXmlElement * _pXmlDocOuterTag;
     std::string _CurrentRowSetColumnString;
     std::stack<TiXmlElement *> * _pXmlElementStack;
+    int64 m_cachedUntil;
 };
 
 #endif // __APISERVICEMANAGER__H__INCL__
@@ -36,8 +36,12 @@ void BulkDB::Close()
     for (auto cur : m_bulkDataChunks)
         PyDecRef(cur.second);
 
+    for (auto cur : m_chunkResponses)
+        PyDecRef(cur.second);
+
     m_bulkData.clear();
     m_bulkDataChunks.clear();
+    m_chunkResponses.clear();
     sLog.Warning("      BulkDataMgr", "Bulk Data Manager has been closed." );
 }
 
@@ -71,31 +75,47 @@ void BulkDB::Initialize()
     m_bulkData.insert(std::pair<uint8, PyRep*>(1, GetDogmaAttribs()));
     m_bulkData.insert(std::pair<uint8, PyRep*>(2, GetDogmaEffects()));
 
-    for (int i = 1; i < m_chunks; ++i) {
-        switch (i) {
-            case 1:
-            case 2: {
-                m_bulkDataChunks.insert(std::pair<uint8, PyRep*>(i, GetExpressions(i+1)));
-            } break;
-            case 3:
-            case 4:
-            case 5:
-            case 6: {
-                uint8 chunk = i - 2;  // 1 to 4
-                m_bulkDataChunks.insert(std::pair<uint8, PyRep*>(i, GetDogmaTypeEffects(chunk)));
-            } break;
-            default: {
-                uint8 chunk = i - 6;  // 1 to 36
-                if (chunk > 36)
-                    assert(true);  // make error here for wrong chunkID
-                m_bulkDataChunks.insert(std::pair<uint8, PyRep*>(i, GetDogmaTypeAttribs(chunk)));
-            } break;
+    /* the chunked files are read in one go each, in primary key order, so every chunk always gets the same rows.
+     *  chunk numbers are fixed: 1-2 dgmExpressions, 3-6 dgmTypeEffects, 7-42 dgmTypeAttributes */
+    LoadChunks("dgmExpressions",
+        "SELECT expressionID, operandID, arg1, arg2, expressionValue, description, expressionName, expressionTypeID, expressionGroupID, expressionAttributeID"
+        " FROM dgmExpressions ORDER BY expressionID", 1, 2, 9000);
+    LoadChunks("dgmTypeEffects",
+        "SELECT typeID, effectID, isDefault FROM dgmTypeEffects ORDER BY typeID, effectID", 3, 4, 9000);
+    LoadChunks("dgmTypeAttributes",
+        "SELECT typeID, attributeID, IF(valueInt IS NULL, valueFloat, valueInt) AS value FROM dgmTypeAttributes ORDER BY typeID, attributeID", 7, 36, 10000);
+
+    /* GetFullFilesChunk() results never change, so they are marshaled here once and sent as they are */
+    size_t bytes(0);
+    for (auto cur : m_bulkDataChunks) {
+        PyTuple* response = new PyTuple(2);
+        PyDict* toBeChanged = new PyDict();
+            PyIncRef(cur.second);
+            toBeChanged->SetItem(new PyInt(GetFileIDfromChunk(0, cur.first)), cur.second);
+        response->SetItem(0, toBeChanged);
+        if (IsLastChunk(cur.first)) {
+            PyList* bulksEndingInChunk = new PyList();
+            bulksEndingInChunk->AddItem(new PyInt(GetFileIDfromChunk(0, cur.first)));
+            response->SetItem(1, bulksEndingInChunk);
+        } else {
+            response->SetItem(1, PyStatic.NewNone());
+        }
+
+        Buffer* data = new Buffer();
+        if (Marshal(response, *data)) {
+            bytes += data->size();
+            m_chunkResponses[cur.first] = new PySubStream(new PyBuffer(&data));
+        } else {
+            _log(BULKDATA__ERROR, "BulkDB::Initialize(): Failed to marshal chunk %u.", cur.first);
         }
+        SafeDelete(data);
+        PyDecRef(response);
     }
+
     if (m_bulkDataChunks.size() > 0)
         m_loaded = true;
 
-    sLog.Cyan("      BulkDataMgr", "%u BulkData Chunks loaded in %.3fms.", m_bulkDataChunks.size(), (GetTimeMSeconds() - start));
+    sLog.Cyan("      BulkDataMgr", "%u BulkData Chunks loaded (%.1fMB marshaled) in %.3fms.", m_bulkDataChunks.size(), bytes / 1048576.0, (GetTimeMSeconds() - start));
 }
 
 uint8 BulkDB::GetNumChunks(uint8 setID /*0*/)
@@ -177,27 +197,49 @@ PyRep* BulkDB::GetBulkDataChunks(uint8 setID, uint8 chunkID)
         Initialize();
 
     /** @todo  need to fix this for separate chunks vs sets */
+    // sets 1-3 are single files; their chunks are the same as the matching set 0 chunks
     switch (setID) {
         case 0: {
-            std::map<uint8, PyRep*>::const_iterator itr = m_bulkDataChunks.find(chunkID);
-            if (itr != m_bulkDataChunks.end())
-                return itr->second;
         } break;
-        case 1: {
-            return GetExpressions(chunkID);
+        case 1: {   // dgmExpressions
         } break;
-        case 2: {
-            return GetDogmaTypeEffects(chunkID);
+        case 2: {   // dgmTypeEffects
+            chunkID += 2;
         } break;
-        case 3: {
-            return GetDogmaTypeAttribs(chunkID);
+        case 3: {   // dgmTypeAttributes
+            chunkID += 6;
         } break;
+        default: {
+            // make error here.  should not reach this point.
+            return nullptr;
+        }
     }
 
-    // make error here.  should not reach this point.
+    std::map<uint8, PyRep*>::const_iterator itr = m_bulkDataChunks.find(chunkID);
+    if (itr != m_bulkDataChunks.end())
+        return itr->second;
     return nullptr;
 }
 
+PySubStream* BulkDB::GetChunkResponse(uint8 chunkID)
+{
+    if (!m_loaded)
+        Initialize();
+
+    std::map<uint8, PySubStream*>::const_iterator itr = m_chunkResponses.find(chunkID);
+    if (itr == m_chunkResponses.end())
+        return nullptr;
+
+    PyIncRef(itr->second);
+    return itr->second;
+}
+
+bool BulkDB::IsLastChunk(uint8 chunkID)
+{
+    // 2, 6, 42
+    return ((chunkID == 2) or (chunkID == 6) or (chunkID == m_chunks - 1));
+}
+
 PyRep* BulkDB::GetOperands()
 {   //74
     DBQueryResult res;
@@ -299,177 +341,18 @@ PyRep* BulkDB::GetDogmaEffects()
     */
 }
 
-PyRep* BulkDB::GetExpressions(uint8 chunkID)    // 2 chunks
-{   //17758
+bool BulkDB::LoadChunks(const char* name, const char* query, uint8 firstChunk, uint8 chunkCount, uint32 rowsPerChunk)
+{
     DBQueryResult res;
-    std::ostringstream q;
-    q << " SELECT expressionID, operandID, arg1, arg2, expressionValue, description, expressionName, expressionTypeID, expressionGroupID, expressionAttributeID";
-    q << " FROM dgmExpressions";
-    switch (chunkID) {
-        case 1: {
-            q << " LIMIT 0, 9000";
-        } break;
-        case 2: {
-            q << " LIMIT 9000, 18000";
-        } break;
-    };
-
-    if ( !sDatabase.RunQuery(res, q.str().c_str()))  // start at row 0 and get next 8k rows
-    {
-        codelog(DATABASE__ERROR, "Error in GetExpressions: %s", res.error.c_str());
-        return nullptr;
+    if (!sDatabase.RunQuery(res, query)) {
+        _log(DATABASE__ERROR, "Error in LoadChunks(%s): %s", name, res.error.c_str());
+        return false;
     }
-    return DBResultToCRowset(res);
-}
 
-PyRep* BulkDB::GetDogmaTypeEffects(uint8 chunkID)   // 4 chunks
-{   //33777
-    DBQueryResult res;
-    std::ostringstream q;
-    q << "SELECT typeID,effectID,isDefault FROM dgmTypeEffects";
-    switch (chunkID) {
-        case 1: {
-            q << " LIMIT 0, 9000";
-        } break;
-        case 2: {
-            q << " LIMIT 9000, 9000";
-        } break;
-        case 3: {
-            q << " LIMIT 18000, 9000";
-        } break;
-        case 4: {
-            q << " LIMIT 27000, 9000";
-        } break;
-    };
-
-    if (!sDatabase.RunQuery(res, q.str().c_str()))
-    {
-        _log(DATABASE__ERROR, "Error in GetDogmaTypeEffects: %s",res.error.c_str());
-        return nullptr;
-    }
-    return DBResultToCRowset(res);
-}
+    // DBResultToCRowset() carries on from where the previous chunk stopped
+    for (uint8 i = 0; i < chunkCount; ++i)
+        m_bulkDataChunks.insert(std::pair<uint8, PyRep*>(firstChunk + i, DBResultToCRowset(res, (i + 1 < chunkCount) ? rowsPerChunk : 0)));
 
-PyRep* BulkDB::GetDogmaTypeAttribs(uint8 chunkID)   // 36 chunks
-{   //353290
-    DBQueryResult res;
-    std::ostringstream q;
-    q << "SELECT typeID, attributeID, IF(valueInt IS NULL, valueFloat, valueInt) AS value FROM dgmTypeAttributes";
-    switch (chunkID) {
-        case 1: {
-            q << " LIMIT 0, 10000";
-        } break;
-        case 2: {
-            q << " LIMIT 10000, 10000";
-        } break;
-        case 3: {
-            q << " LIMIT 20000, 10000";
-        } break;
-        case 4: {
-            q << " LIMIT 30000, 10000";
-        } break;
-        case 5: {
-            q << " LIMIT 40000, 10000";
-        } break;
-        case 6: {
-            q << " LIMIT 50000, 10000";
-        } break;
-        case 7: {
-            q << " LIMIT 60000, 10000";
-        } break;
-        case 8: {
-            q << " LIMIT 70000, 10000";
-        } break;
-        case 9: {
-            q << " LIMIT 80000, 10000";
-        } break;
-        case 10: {
-            q << " LIMIT 90000, 10000";
-        } break;
-        case 11: {
-            q << " LIMIT 100000, 10000";
-        } break;
-        case 12: {
-            q << " LIMIT 110000, 10000";
-        } break;
-        case 13: {
-            q << " LIMIT 120000, 10000";
-        } break;
-        case 14: {
-            q << " LIMIT 130000, 10000";
-        } break;
-        case 15: {
-            q << " LIMIT 140000, 10000";
-        } break;
-        case 16: {
-            q << " LIMIT 150000, 10000";
-        } break;
-        case 17: {
-            q << " LIMIT 160000, 10000";
-        } break;
-        case 18: {
-            q << " LIMIT 170000, 10000";
-        } break;
-        case 19: {
-            q << " LIMIT 180000, 10000";
-        } break;
-        case 20: {
-            q << " LIMIT 190000, 10000";
-        } break;
-        case 21: {
-            q << " LIMIT 200000, 10000";
-        } break;
-        case 22: {
-            q << " LIMIT 210000, 10000";
-        } break;
-        case 23: {
-            q << " LIMIT 220000, 10000";
-        } break;
-        case 24: {
-            q << " LIMIT 230000, 10000";
-        } break;
-        case 25: {
-            q << " LIMIT 240000, 10000";
-        } break;
-        case 26: {
-            q << " LIMIT 250000, 10000";
-        } break;
-        case 27: {
-            q << " LIMIT 260000, 10000";
-        } break;
-        case 28: {
-            q << " LIMIT 270000, 10000";
-        } break;
-        case 29: {
-            q << " LIMIT 280000, 10000";
-        } break;
-        case 30: {
-            q << " LIMIT 290000, 10000";
-        } break;
-        case 31: {
-            q << " LIMIT 300000, 10000";
-        } break;
-        case 32: {
-            q << " LIMIT 310000, 10000";
-        } break;
-        case 33: {
-            q << " LIMIT 320000, 10000";
-        } break;
-        case 34: {
-            q << " LIMIT 330000, 10000";
-        } break;
-        case 35: {
-            q << " LIMIT 340000, 10000";
-        } break;
-        case 36: {
-            q << " LIMIT 350000, 10000";
-        } break;
-    };
-
-    if (!sDatabase.RunQuery(res, q.str().c_str()))
-    {
-        _log(DATABASE__ERROR, "Error in GetDogmaTypeAttribs: %s",res.error.c_str());
-        return nullptr;
-    }
-    return DBResultToCRowset(res);
+    _log(BULKDATA__INFO, "BulkDB::LoadChunks(): %s: %lu rows in %u chunks.", name, res.GetRowCount(), chunkCount);
+    return true;
 }
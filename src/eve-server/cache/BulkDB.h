@@ -34,21 +34,26 @@ public:
     PyRep* GetDogmaAttribs();
     PyRep* GetDogmaEffects();
 
-    /* these are split into ~10k-row chunks for easier handling */
-    PyRep* GetExpressions(uint8 chunkID);
-    PyRep* GetDogmaTypeEffects(uint8 chunkID);
-    PyRep* GetDogmaTypeAttribs(uint8 chunkID);
-
     /* these are used to get chunks */
     PyRep* GetBulkData(uint8 chunkID);
     PyRep* GetBulkDataChunks(uint8 setID, uint8 chunkID);
 
+    /* whole GetFullFilesChunk() result for a chunk of set 0, already marshaled.  caller gets a new ref */
+    PySubStream* GetChunkResponse(uint8 chunkID);
+    /* true if chunkID (set 0) holds the last rows of its file */
+    bool IsLastChunk(uint8 chunkID);
+
 private:
+    /* loads one of the chunked files with a single query, split into chunkCount chunks from firstChunk on.
+     *  every chunk gets rowsPerChunk rows, except the last one which gets the rest. */
+    bool LoadChunks(const char* name, const char* query, uint8 firstChunk, uint8 chunkCount, uint32 rowsPerChunk);
+
     bool m_loaded;
     uint8 m_chunks;
 
     std::map<uint8, PyRep*> m_bulkData;          // chunkID/data (preliminary data)
     std::map<uint8, PyRep*> m_bulkDataChunks;    // chunkID/data
+    std::map<uint8, PySubStream*> m_chunkResponses;  // chunkID/marshaled GetFullFilesChunk() result
 };
 
 #define sBulkDB \
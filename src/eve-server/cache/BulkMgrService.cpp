@@ -291,8 +291,6 @@ PyResult BulkMgrService::GetFullFilesChunk(PyCallArgs &call, PyInt* chunkSetID,
         toBeChanged, bulksEndingInChunk = self.bulkMgr.GetFullFilesChunk(chunkSetID, chunkNumber)
             this breaks files up into ?kb chunks for sending to client.  client requests "chunkSetID" and "chunkNumber", where chunkSetID is ???
      */
-    PyTuple* response = new PyTuple(2);
-    PyDict* toBeChanged = new PyDict();
     int32 bulkFileID = sBulkDB.GetFileIDfromChunk(chunkSetID->value(), chunkNumber->value());
     if (bulkFileID < 0) {
         _log(BULKDATA__ERROR, "BulkMgrService::Handle_GetFullFilesChunk(): chunkSetID: %u, chunkNumber: %u, bulkFileID: %i", chunkSetID->value(), chunkNumber->value(), bulkFileID);
@@ -301,19 +299,21 @@ PyResult BulkMgrService::GetFullFilesChunk(PyCallArgs &call, PyInt* chunkSetID,
     }
 
     _log(BULKDATA__INFO, "BulkMgrService::Handle_GetFullFilesChunk(): bulkFileID: %i, chunkSetID: %u, chunkNumber: %u", bulkFileID, chunkSetID->value(), chunkNumber->value());
+
+    // set 0 results are marshaled once, when the bulkdata is loaded; the client gets them as they are
+    if (chunkSetID->value() == 0) {
+        PySubStream* ss = sBulkDB.GetChunkResponse(chunkNumber->value());
+        if (ss != nullptr)
+            return ss;
+    }
+
+    PyTuple* response = new PyTuple(2);
+    PyDict* toBeChanged = new PyDict();
     toBeChanged->SetItem(new PyInt(bulkFileID), sBulkDB.GetBulkDataChunks(chunkSetID->value(), chunkNumber->value()));
 
     // 2, 4, 36
     if (chunkSetID->value() == 0) {
-        if (chunkNumber->value() == 2) {
-            PyList* bulksEndingInChunk = new PyList();
-            bulksEndingInChunk->AddItem(new PyInt(bulkFileID));
-            response->SetItem(1, bulksEndingInChunk);
-        } else if (chunkNumber->value() == 6) {
-            PyList* bulksEndingInChunk = new PyList();
-            bulksEndingInChunk->AddItem(new PyInt(bulkFileID));
-            response->SetItem(1, bulksEndingInChunk);
-        } else if (chunkNumber->value() == 42) {
+        if (sBulkDB.IsLastChunk(chunkNumber->value())) {
             PyList* bulksEndingInChunk = new PyList();
             bulksEndingInChunk->AddItem(new PyInt(bulkFileID));
             response->SetItem(1, bulksEndingInChunk);
@@ -248,7 +248,7 @@ PyResult ObjCacheService::GetCachableObject(PyCallArgs &call, PyRep* shared, PyR
     int64 timestamp = 0;
     int64 version = 0;
 
-    // nothing here is used yet, but is kept here as documentation for when it's eventually used
+    // version of the copy the client holds, if any
     if (cacheVersion->size() == 2) {
         timestamp = PyRep::IntegerValue(cacheVersion->GetItem(0));
         version = PyRep::IntegerValue(cacheVersion->GetItem(1));
@@ -274,16 +274,18 @@ PyResult ObjCacheService::GetCachableObject(PyCallArgs &call, PyRep* shared, PyR
     if (!_LoadCachableObject(objectID))
         return nullptr;   //print done already
 
-    //should we check their version? I am pretty sure they check it and only request what they want.
-    //well, we want to do something like this, but this doesn't seem to be it. taken
-    // out until we have time to figure out how to properly throw the CacheOK exception.
-    /*if (m_cache.IsCacheUpToDate(args.objectID, args.version, args.timestamp)) {
-        //they throw an exception for "its up to date", lets give it a try...
-        return new CacheOK();
+    static MetricCounter& upToDate = sMetrics.GetCounter( "evemu_objcache_requests_total", "GetCachableObject calls, by whether the object was sent.", { { "result", "cacheok" } } );
+    static MetricCounter& sent = sMetrics.GetCounter( "evemu_objcache_requests_total", "GetCachableObject calls, by whether the object was sent.", { { "result", "sent" } } );
+
+    // CacheOK tells the client the copy it holds is current, so it keeps using that one
+    if ((version != 0) and m_cache.IsCacheUpToDate(objectID, (uint32)version)) {
+        _log(CACHE__INFO, "Client copy of '%s' is current (version 0x%x, built %li).", CachedObjectMgr::OIDToString(objectID).c_str(), (uint32)version, (long)timestamp);
+        upToDate.Inc();
+        throw PyException(new CacheOK());
     }
-    */
 
     PyObject *result = m_cache.GetCachedObject(objectID);
+    sent.Inc();
 
     return result;
 }
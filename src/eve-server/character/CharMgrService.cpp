@@ -151,8 +151,7 @@ BoundDispatcher* CharMgrService::BindObject(Client *client, PyRep* bindParameter
     bindParameters->Dump(CHARACTER__BIND, "    ");
     Call_TwoIntegerArgs args;
     //crap
-    PyRep* tmp(bindParameters->Clone());
-    if (!args.Decode(&tmp)) {
+    if (!args.Decode(bindParameters)) {
         codelog(SERVICE__ERROR, "%s: Failed to decode arguments.", GetName());
         return nullptr;
     }
@@ -182,7 +182,7 @@ PyRep *ConfigDB::GetMultiOwnersEx(const std::vector<int32> &entityIDs) {
         PyTuple *response = new PyTuple(2);
         PyList *cols = new PyList(cc);
         for(uint32 r(0); r < cc; ++r)
-            cols->SetItemString(r, res.ColumnName(r));
+            cols->SetItem(r, PyString::Intern(res.ColumnName(r)));
         response->items[0] = cols;
         response->items[1] = results;
 
@@ -53,8 +53,7 @@ PyResult DogmaIMService::GetAttributeTypes(PyCallArgs& call) {
 BoundDispatcher* DogmaIMService::BindObject(Client* client, PyRep* bindParameters) {
     DogmaLM_BindArgs args;
     //crap
-    PyRep* tmp(bindParameters->Clone());
-    if (!args.Decode(&tmp)) {
+    if (!args.Decode(bindParameters)) {
         codelog(SERVICE__ERROR, "%s: Failed to decode bind args.", GetName().c_str());
         return nullptr;
     }
@@ -29,7 +29,10 @@
 #include "../eve-common/EVEVersion.h"
 
 #include "EVEServerConfig.h"
+#include "LoginPool.h"
 #include "NetService.h"
+#include "threading/WakeEvent.h"
+#include "utils/Trace.h"
 // data managers
 #include "StaticDataMgr.h"
 #include "StatisticMgr.h"
@@ -200,6 +203,12 @@ int main( int argc, char* argv[] )
 
     /* init logging */
     sLog.Initialize();
+    /* create the metrics registry before any other thread can touch it */
+    MetricRegistry::get();
+    PyRep::RegisterMetrics();
+    /* same for the trace recorder.  spans stay off until config (or console) turns them on */
+    TraceRecorder::get();
+    sTrace.SetThreadName("main");
     /* Load server log settings */
     if (load_log_settings(sConfig.files.logSettings.c_str())) {
         sLog.Green( "       ServerInit", "Log settings loaded from %s", sConfig.files.logSettings.c_str() );
@@ -216,6 +225,7 @@ int main( int argc, char* argv[] )
         std::cout << std::endl << "press any key to exit...";  std::cin.get();
         return EXIT_FAILURE;
     }
+    TraceRecorder::SetEnabled(sConfig.debug.UseTracing);
 
     std::printf("\n");     // spacer
     /* display server config data */
@@ -253,7 +263,7 @@ int main( int argc, char* argv[] )
     std::printf("\n");     // spacer
 
     sLog.Blue("     ServerConfig", "Main Loop Settings");
-    uint8 m_sleepTime = sConfig.server.ServerSleepTime; // default 10ms.  max 256ms
+    uint8 m_sleepTime = sConfig.server.ServerSleepTime; // default 10ms.  max 255ms.  longest idle sleep; network activity and tics wake the loop sooner
     if (m_sleepTime == 10) {
         sLog.Green("  Loop Sleep Time","Default at 10ms.");
     } else {
@@ -641,6 +651,9 @@ int main( int argc, char* argv[] )
     /* initialize EntityList singleton, clientID seed and start tic timer */
     sLog.Green("       ServerInit", "Starting Entity List");
     sEntityList.Initialize();
+    /* start login worker threads.  needs db and client seed */
+    sLog.Green("       ServerInit", "Starting Login Worker Pool");
+    sLoginPool.Initialize();
     /* create a service manager */
     sLog.Green("       ServerInit", "Starting Service Manager");
     EVEServiceManager newSvcMgr(888444);
@@ -868,7 +881,6 @@ int main( int argc, char* argv[] )
     #endif
     */
 
-    uint32 start(0);
     EVETCPConnection* tcpc(nullptr);
 
     if (sConfig.debug.UseProfiling) {
@@ -896,27 +908,48 @@ int main( int argc, char* argv[] )
      * THE MAIN LOOP
      * Everything except IO should happen in this loop, in this thread context.
      */
+    MetricHistogram& loopMetric = sMetrics.GetHistogram("evemu_main_loop_seconds", "Main loop pass time, sleep excluded.");
+    MetricGauge& itemMetric = sMetrics.GetGauge("evemu_items_loaded", "Items loaded in ItemFactory.");
+    MetricGauge& overrunMetric = sMetrics.GetGauge("evemu_main_loop_overrun_ms", "Main loop time over its pass budget, not yet caught up.");
+    std::chrono::steady_clock::time_point passStart, passEnd(std::chrono::steady_clock::now()), deadline;
+    uint32 busyTime(0), idleTime(0);
     while (m_run) {
         Timer::SetCurrentTime();
-        start = GetTickCount();
+        passStart = std::chrono::steady_clock::now();
+        idleTime = std::chrono::duration_cast<std::chrono::milliseconds>(passStart - passEnd).count();
 
         sAllocators.tickAllocator.Reset();
 
         /* Freeze Detector Code */
         //++m_worldLoopCounter;
 
-        if ((tcpc = tcps.PopConnection()))
+        /* take every connection accepted since last pass, so a login storm isnt paced by the loop */
+        while ((tcpc = tcps.PopConnection()))
             sEntityList.Add(new Client(newSvcMgr, &tcpc));
 
         sEntityList.Process();
 
+        /* write new item rows spawned this pass */
+        sItemFactory.Process();
+
         /*  process console commands, if any, and check for 'exit' command */
         m_run = sConsole.Process();
 
         /* do the stuff for thread sleeping */
-        start = GetTickCount() - start;
-        if (m_sleepTime > start)
-            std::this_thread::sleep_for(std::chrono::milliseconds(start));
+        passEnd = std::chrono::steady_clock::now();
+        busyTime = std::chrono::duration_cast<std::chrono::milliseconds>(passEnd - passStart).count();
+        loopMetric.Observe(std::chrono::duration<double>(passEnd - passStart).count());
+        itemMetric.Set(sItemFactory.Count());
+        sEntityList.AddPassTime(busyTime, idleTime);
+        overrunMetric.Set(sEntityList.GetOverrun());
+
+        /* sleep until the next 4Hz/1Hz tic is due, measured from pass start so the pass itself counts against it.
+         *  ServerSleepTime caps the sleep for anything that doesnt wake us.  new connections, received packets,
+         *  finished login jobs and console input wake us early.  an overdue tic skips the sleep, and the tics catch up.
+         */
+        deadline = passStart + std::chrono::milliseconds(std::min<uint32>(m_sleepTime, sEntityList.GetNextTicDelay()));
+        if (m_run and (deadline > passEnd))
+            sMainLoopWake.WaitUntil(deadline);
     }
 
     /*
@@ -938,6 +971,8 @@ int main( int argc, char* argv[] )
     /* stop Image Server */
     sImageServer.Stop();
     sLog.Warning("   ServerShutdown", "Image Server stopped." );
+    /* stop login workers */
+    sLoginPool.Close();
     /* Close the MarketMgr */
     sMktMgr.Close();
     /* Close the bulk data manager */
@@ -1044,6 +1079,8 @@ static void CleanUp() {
     /* stop Image Server */
     sImageServer.Stop();
     sLog.Warning("   ServerShutdown", "Image Server stopped." );
+    /* stop login workers */
+    sLoginPool.Close();
     /* Close the MarketMgr */
     sLog.Warning("   ServerShutdown", "Shutting down Market Manager." );
     sMktMgr.Close();
@@ -55,6 +55,7 @@
 #include "network/EVETCPServer.h"
 #include "network/EVEPktDispatch.h"
 #include "network/EVESession.h"
+#include "network/PacketLog.h"
 // marshal
 #include "marshal/EVEMarshal.h"
 #include "marshal/EVEMarshalOpcodes.h"
@@ -112,6 +113,7 @@
 //#include "threading/Mutex.h"
 // utils
 #include "utils/EVEUtils.h"
+#include "utils/Metrics.h"
 
 #include "Allocators.h"
 
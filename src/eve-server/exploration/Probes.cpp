@@ -272,7 +272,7 @@ bool ProbeSE::ProcessTic()
             _log(SCAN__INFO, "ProbeSE::Process() state timer hit for probeID %u  state: %s", \
                     m_self->itemID(), GetStateName(m_state));
             if (IsMoving())
-                m_self->SetPosition(m_destination);
+                SetPosition(m_destination);
             if (m_state == Probe::State::Warping)
                 SendWarpEnd();
             SendStateChange(Probe::State::Idle);
@@ -391,7 +391,7 @@ void ProbeSE::RemoveProbe()
     // remove from system
     m_system->RemoveEntity(this);
     // set item loc to null
-    m_self->SetPosition(NULL_ORIGIN);
+    SetPosition(NULL_ORIGIN);
     // remove from entity list
     sEntityList.RemoveProbe(m_self->itemID());
 
@@ -437,7 +437,7 @@ void ProbeSE::SendWarpStart(float travelTime/*0*/)
 
 void ProbeSE::SendWarpEnd()
 {
-    m_self->SetPosition(m_destination);
+    SetPosition(m_destination);
     sBubbleMgr.Add(this);
     if (m_client == nullptr)
         return;
@@ -22,6 +22,8 @@
  * SCAN__RSPDUMP
  */
 
+#include <unordered_set>
+
 #include "eve-server.h"
 
 #include "Client.h"
@@ -108,30 +110,23 @@ PyRep* Scan::ConeScan(Call_ConeScan args) {
      * DP = Uvr dot U (dot product of Uvr and U).  this will give cosine of angle between VR and U
      * acDP = arc cosine of DP to give angle
      * test acDP < cone angle = point is inside cone.
+     *
+     * this test is now done in SpatialIndex::QueryCone() (as DP > cos(cone angle)), which also skips whole cells outside the cone.
      */
-    bool test(false);
-    float dot(0), acDP(0), angle(args.ScanAngle/2);
+    float angle(args.ScanAngle/2);
     std::vector<SystemEntity*> seVec;
     const GPoint vertex(m_client->GetShipSE()->GetPosition());
-    const GPoint U(args.x, args.y, args.z);
-    m_client->SystemMgr()->DScan(args.range, vertex, seVec);
-    _log(SCAN__TRACE, "ConeScan() - query returned %u objects within range.  angle is %.3f", seVec.size(), angle);
+    const GVector U(args.x, args.y, args.z);
+    // the system's spatial index does the cone test, so everything returned here is in the scan
+    m_client->SystemMgr()->DScan(args.range, vertex, U, angle, seVec);
+    _log(SCAN__TRACE, "ConeScan() - query returned %u objects within range and cone.  angle is %.3f", seVec.size(), angle);
     PyList* list = new PyList();
     for (auto cur : seVec ) {
-        GVector VR(vertex, cur->GetPosition());
-        VR.normalize();
-        dot = U.dotProduct(VR);
-        acDP = acos(dot);
-        if (acDP < angle) {
-            test = true;
-            DirectionScanResult res;
-            res.id         = cur->GetID();
-            res.typeID     = cur->GetSelf()->typeID();
-            res.groupID    = cur->GetSelf()->groupID();
-            list->AddItem(res.Encode());
-        }
-        _log(SCAN__TRACE, "ConeScan() - tested %s(%u).  dot %.5f, acDP %.5f, result %s", cur->GetName(), cur->GetID(), dot, acDP, test?"true":"false");
-        test = false;
+        DirectionScanResult res;
+        res.id         = cur->GetID();
+        res.typeID     = cur->GetSelf()->typeID();
+        res.groupID    = cur->GetSelf()->groupID();
+        list->AddItem(res.Encode());
     }
 
     return list;
@@ -345,8 +340,24 @@ void Scan::ProbeScanResult()
         resultList->AddItem(ssr.Encode());
     }
 
+    /* entities with a sig (ships, drones, structures, etc) are also in the system's spatial index.
+     *  only those within range of an active probe can be hit, so get them from the index up front
+     *  instead of testing every sig in system against every probe.
+     */
+    SpatialIndex* pIndex(m_system->GetSpatialIndex());
+    std::unordered_set<uint32> inRange;
+    std::vector<SystemEntity*> seVec;
+    for (auto cur : m_activeProbeMap) {
+        seVec.clear();
+        pIndex->QuerySphere(cur.second->GetPosition(), cur.second->GetScanRange(), seVec);
+        for (auto se : seVec)
+            inRange.insert(se->GetID());
+    }
+
     m_system->GetAnomMgr()->GetSignatureList(sig);
     for (auto sigs : sig) {
+        if (pIndex->Contains(sigs.sigItemID) and (inRange.find(sigs.sigItemID) == inRange.end()))
+            continue;
         SignalData data = SignalData();
             data.sig = sigs;
             data.probes = nullptr;
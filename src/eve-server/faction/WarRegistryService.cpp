@@ -47,7 +47,7 @@ WarRegistryService::WarRegistryService(EVEServiceManager& mgr) :
 BoundDispatcher* WarRegistryService::BindObject(Client* client, PyRep* bindParameters) {
     Call_TwoIntegerArgs args;
 
-    if (args.Decode(bindParameters->Clone()) == false) {
+    if (args.Decode(bindParameters) == false) {
         codelog(SERVICE__ERROR, "%s: Failed to decode bind args.", GetName().c_str());
         return nullptr;
     }
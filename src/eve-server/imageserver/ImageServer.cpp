@@ -40,6 +40,8 @@ const char *const ImageServer::Categories[] = {
 const uint32 ImageServer::CategoryCount = 5;
 
 ImageServer::ImageServer()
+: _cacheBytes(0),
+_cacheLimit((size_t)sConfig.net.imageCacheMB * 1024 * 1024)
 {
     std::stringstream urlBuilder;
     urlBuilder << "http://" << sConfig.net.imageServer << ":" << sConfig.net.imageServerPort << "/";
@@ -109,43 +111,117 @@ void ImageServer::ReportNewCharacter(uint32 creatorAccountID, uint32 characterID
     // and delete it from our limbo map
     _limboImages.erase(creatorAccountID);
 
+    // drop anything we served for this id before, so the new portrait goes out (with a new ETag)
+    InvalidateImages(dirName, characterID);
+
     sLog.Green("      ImageServer", "Received image from %u and saved as %s", creatorAccountID, path.c_str());
 }
 
-std::shared_ptr<std::vector<char> > ImageServer::GetImage(std::string& category, uint32 id, uint32 size)
+std::shared_ptr<const ImageServer::Image> ImageServer::GetImage(std::string& category, uint32 id, uint32 size)
 {
     sLog.Cyan("      ImageServer"," GetImage() called. Cat: %s, id: %u, size:%u", category.c_str(), id, size);
+    static MetricCounter& hits = sMetrics.GetCounter("evemu_imageserver_cache_total", "Image requests, by whether the image was cached.", {{"result", "hit"}});
+    static MetricCounter& misses = sMetrics.GetCounter("evemu_imageserver_cache_total", "Image requests, by whether the image was cached.", {{"result", "miss"}});
 
     if (!ValidateCategory(category) || !ValidateSize(category, size))
-        return std::shared_ptr<std::vector<char> >();
+        return std::shared_ptr<const Image>();
 
-    //std::ifstream stream;
     std::string path(GetFilePath(category, id, size));
+    {
+        Lock lock(_cacheLock);
+        std::unordered_map<std::string, ImageList::iterator>::iterator itr = _cacheIndex.find(path);
+        if (itr != _cacheIndex.end()) {
+            _cache.splice(_cache.begin(), _cache, itr->second);
+            hits.Inc();
+            return itr->second->second;
+        }
+    }
+
+    misses.Inc();
+    std::shared_ptr<const Image> image = LoadImage(category, path);
+    if (image and image->data)
+        CacheImage(path, image);
+    return image;
+}
+
+std::shared_ptr<const ImageServer::Image> ImageServer::LoadImage(std::string& category, std::string& path)
+{
+    struct stat st;
+    if ((stat(path.c_str(), &st) != 0) or ((st.st_mode & S_IFMT) != S_IFREG))
+        return std::shared_ptr<const Image>();
+
+    std::shared_ptr<Image> image(new Image());
+    image->length = st.st_size;
+
+    char etag[32];
+    snprintf(etag, sizeof(etag), "\"%lx-%lx\"", (unsigned long)st.st_size, (unsigned long)st.st_mtime);
+    image->etag = etag;
+
+    std::stringstream header;
+    header << "HTTP/1.0 200 OK\r\n";
+    header << "Content-Type: " << (category == "Character" ? "image/jpeg" : "image/png") << "\r\n";
+    header << "Content-Length: " << image->length << "\r\n";
+    header << "ETag: " << image->etag << "\r\n\r\n";
+    image->header = header.str();
+
+#ifdef HAVE_SYS_SENDFILE_H
+    // large renders arent worth the memory; the kernel sends them straight from its page cache
+    if (image->length > _cacheLimit / 16) {
+        image->path = path;
+        return image;
+    }
+#endif /* HAVE_SYS_SENDFILE_H */
+
     FILE * fp = fopen(path.c_str(), "rb");
     if (fp == NULL)
-        return std::shared_ptr<std::vector<char> >();
-    fseek(fp, 0, SEEK_END);
-    size_t length = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
+        return std::shared_ptr<const Image>();
 
-    //stream.open(path, std::ios::binary | std::ios::in);
-    // not found or other error
-    //if (stream.fail())
-    //    return std::shared_ptr<std::vector<char> >();
+    std::shared_ptr<std::vector<char> > data(new std::vector<char>(image->length));
+    size_t read = (image->length > 0 ? fread(&((*data)[0]), 1, image->length, fp) : 0);
+    fclose(fp);
 
-    // get length
-    //stream.seekg(0, std::ios::end);
-    //int length = stream.tellg();
-    //stream.seekg(0, std::ios::beg);
+    // changed under us; let the next request have another go
+    if (read != image->length)
+        return std::shared_ptr<const Image>();
 
-    std::shared_ptr<std::vector<char> > ret = std::shared_ptr<std::vector<char> >(new std::vector<char>());
-    ret->resize(length);
+    image->data = data;
+    return image;
+}
 
-    // HACK
-    //stream.read(&((*ret)[0]), length);
-    fread(&((*ret)[0]), 1, length, fp);
+void ImageServer::CacheImage(const std::string& path, std::shared_ptr<const Image> image)
+{
+    if (image->length > _cacheLimit / 16)
+        return;
+
+    Lock lock(_cacheLock);
+    // another request may have beaten us to it
+    if (_cacheIndex.find(path) != _cacheIndex.end())
+        return;
+
+    _cache.push_front(std::make_pair(path, image));
+    _cacheIndex[path] = _cache.begin();
+    _cacheBytes += image->length;
 
-    return ret;
+    while (_cacheBytes > _cacheLimit) {
+        _cacheBytes -= _cache.back().second->length;
+        _cacheIndex.erase(_cache.back().first);
+        _cache.pop_back();
+    }
+}
+
+void ImageServer::InvalidateImages(std::string& category, uint32 id)
+{
+    static const uint32 sizes[] = { 1024, 512, 256, 128, 64, 40, 32 };
+
+    Lock lock(_cacheLock);
+    for (uint8 i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        std::unordered_map<std::string, ImageList::iterator>::iterator itr = _cacheIndex.find(GetFilePath(category, id, sizes[i]));
+        if (itr == _cacheIndex.end())
+            continue;
+        _cacheBytes -= itr->second->second->length;
+        _cache.erase(itr->second);
+        _cacheIndex.erase(itr);
+    }
 }
 
 std::string ImageServer::GetFilePath(std::string& category, uint32 id, uint32 size)
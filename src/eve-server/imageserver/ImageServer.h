@@ -57,8 +57,32 @@ public:
     void ReportNewImage(uint32 accountID, std::shared_ptr<std::vector<char> > imageData);
     void ReportNewCharacter(uint32 creatorAccountID, uint32 characterID);
 
+    /**
+     * @brief An image ready to be sent; never changed once GetImage() returns it.
+     *
+     * Either data holds the file contents, or (for images too large to cache,
+     * when sendfile is available) path names the file to send.
+     */
+    struct Image
+    {
+        std::shared_ptr<const std::vector<char> > data;
+        std::string path;
+        size_t length;
+        /// quoted, as sent; from file size and mtime
+        std::string etag;
+        /// "200 OK" response header, with Content-Type, Content-Length and ETag
+        std::string header;
+    };
+
     std::string GetFilePath(std::string& category, uint32 id, uint32 size);
-    std::shared_ptr<std::vector<char> > GetImage(std::string& category, uint32 id, uint32 size);
+    /**
+     * @brief Gets an image, from the cache or from disk.
+     *
+     * Called on the image server thread.
+     *
+     * @return the image; empty if the request is invalid or there is no such file.
+     */
+    std::shared_ptr<const Image> GetImage(std::string& category, uint32 id, uint32 size);
 
     static const char *const Categories[];
     static const uint32 CategoryCount;
@@ -72,6 +96,10 @@ private:
     bool ValidateCategory(std::string& category);
     bool ValidateSize(std::string& category, uint32 size);
 
+    std::shared_ptr<const Image> LoadImage(std::string& category, std::string& path);
+    void CacheImage(const std::string& path, std::shared_ptr<const Image> image);
+    void InvalidateImages(std::string& category, uint32 id);
+
     std::unordered_map<uint32 /*accountID*/, std::shared_ptr<std::vector<char> > /*imageData*/> _limboImages;
     std::shared_ptr<boost::asio::detail::thread> _ioThread;
     std::shared_ptr<boost::asio::io_context> _io;
@@ -80,6 +108,15 @@ private:
     std::string _basePath;
     boost::asio::detail::mutex _limboLock;
 
+    // LRU of served images, keyed by file path (so by category, id and size), most recent first.
+    // bounded to net.imageCacheMB; anything larger than a sixteenth of that isnt cached.
+    typedef std::list<std::pair<std::string, std::shared_ptr<const Image> > > ImageList;
+    ImageList _cache;
+    std::unordered_map<std::string, ImageList::iterator> _cacheIndex;
+    size_t _cacheBytes;
+    size_t _cacheLimit;
+    boost::asio::detail::mutex _cacheLock;
+
     class Lock
     {
     public:
@@ -25,7 +25,12 @@
 
 #include "imageserver/ImageServerConnection.h"
 
-boost::asio::const_buffers_1 ImageServerConnection::_responseOK = boost::asio::buffer("HTTP/1.0 200 OK\r\nContent-Type: image/jpeg\r\n\r\n", 45);
+#ifdef HAVE_SYS_SENDFILE_H
+#   include <sys/sendfile.h>
+#   include <unistd.h>
+#endif /* HAVE_SYS_SENDFILE_H */
+
+boost::asio::const_buffers_1 ImageServerConnection::_responseMetrics = boost::asio::buffer("HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n\r\n", 60);
 boost::asio::const_buffers_1 ImageServerConnection::_responseNotFound = boost::asio::buffer("HTTP/1.0 404 Not Found\r\n\r\n", 26);
 boost::asio::const_buffers_1 ImageServerConnection::_responseRedirectBegin = boost::asio::buffer("HTTP/1.0 301 Moved Permanently\r\nLocation: ", 42);
 boost::asio::const_buffers_1 ImageServerConnection::_responseRedirectEnd = boost::asio::buffer("\r\n\r\n", 4);
@@ -33,10 +38,20 @@ boost::asio::const_buffers_1 ImageServerConnection::_responseRedirectEnd = boost
 ImageServerConnection::ImageServerConnection(boost::asio::io_context& io)
 : _socket(io),
 _id(0),
-_size(0)
+_size(0),
+_fileFd(-1),
+_fileOffset(0)
 {
 }
 
+ImageServerConnection::~ImageServerConnection()
+{
+#ifdef HAVE_SYS_SENDFILE_H
+    if (_fileFd != -1)
+        ::close(_fileFd);
+#endif /* HAVE_SYS_SENDFILE_H */
+}
+
 boost::asio::ip::tcp::socket& ImageServerConnection::socket()
 {
     return _socket;
@@ -55,6 +70,7 @@ void ImageServerConnection::ProcessHeaders()
 
     // every request line ends with \r\n
     std::getline(stream, request, '\r');
+    ReadRequestHeaders(stream);
 
     if (!starts_with(request, "GET /"))
     {
@@ -63,6 +79,12 @@ void ImageServerConnection::ProcessHeaders()
     }
     request = request.substr(5);
 
+    if (starts_with(request, "metrics ") or starts_with(request, "metrics?"))
+    {
+        SendMetrics();
+        return;
+    }
+
     bool found = false;
     for (uint32 i = 0; i < ImageServer::CategoryCount; i++)
     {
@@ -100,8 +122,8 @@ void ImageServerConnection::ProcessHeaders()
     _id = atoi(idStr.c_str());
     _size = atoi(sizeStr.c_str());
 
-    _imageData = sImageServer.GetImage(_category, _id, _size);
-    if (!_imageData) {
+    _image = sImageServer.GetImage(_category, _id, _size);
+    if (!_image) {
         if (IsPlayerItem(_id)) {
             sLog.Error("     Image Server","Image for itemID %u not found.", _id);
             NotFound();
@@ -115,13 +137,98 @@ void ImageServerConnection::ProcessHeaders()
         return;
     }
 
-    // first we have to send the responseOK, then our actual result
-    boost::asio::async_write(_socket, _responseOK, boost::asio::transfer_all(), std::bind(&ImageServerConnection::SendImage, shared_from_this()));
+    if (!_ifNoneMatch.empty() and ((_ifNoneMatch == "*") or (_ifNoneMatch.find(_image->etag) != std::string::npos))) {
+        NotModified();
+        return;
+    }
+
+    SendImage();
+}
+
+void ImageServerConnection::ReadRequestHeaders(std::istream& stream)
+{
+    // we only care for If-None-Match; header names are case insensitive
+    std::string line;
+    while (std::getline(stream, line, '\n')) {
+        if (!line.empty() and (line[line.size() - 1] == '\r'))
+            line.erase(line.size() - 1);
+        size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+        if ((colon != 13) or (strncasecmp(line.c_str(), "If-None-Match", 13) != 0))
+            continue;
+        size_t value = line.find_first_not_of(" \t", colon + 1);
+        if (value != std::string::npos)
+            _ifNoneMatch = line.substr(value);
+    }
 }
 
 void ImageServerConnection::SendImage()
 {
-    boost::asio::async_write(_socket, boost::asio::buffer(*_imageData, _imageData->size()), boost::asio::transfer_all(), std::bind(&ImageServerConnection::Close, shared_from_this()));
+    if (!_image->data) {
+        // too large to cache; header first, then the file itself
+        boost::asio::async_write(_socket, boost::asio::buffer(_image->header), boost::asio::transfer_all(), std::bind(&ImageServerConnection::SendFile, shared_from_this()));
+        return;
+    }
+
+    // header and image in one write, both straight from the cached image
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.push_back(boost::asio::buffer(_image->header));
+    buffers.push_back(boost::asio::buffer(*_image->data));
+    boost::asio::async_write(_socket, buffers, boost::asio::transfer_all(), std::bind(&ImageServerConnection::Close, shared_from_this()));
+}
+
+void ImageServerConnection::SendFile()
+{
+#ifdef HAVE_SYS_SENDFILE_H
+    if (_fileFd == -1) {
+        _fileFd = ::open(_image->path.c_str(), O_RDONLY);
+        if (_fileFd == -1) {
+            sLog.Error("     Image Server","Unable to open %s: %s", _image->path.c_str(), strerror(errno));
+            Close();
+            return;
+        }
+        // sendfile() must not block the image server thread; we wait for the socket instead
+        _socket.native_non_blocking(true);
+    }
+
+    while ((size_t)_fileOffset < _image->length) {
+        ssize_t sent = ::sendfile(_socket.native_handle(), _fileFd, &_fileOffset, _image->length - _fileOffset);
+        if (sent > 0)
+            continue;
+        if ((sent == -1) and (errno == EINTR))
+            continue;
+        if ((sent == -1) and ((errno == EAGAIN) or (errno == EWOULDBLOCK))) {
+            _socket.async_wait(boost::asio::ip::tcp::socket::wait_write, std::bind(&ImageServerConnection::SendFile, shared_from_this()));
+            return;
+        }
+        // error, or the file got shorter; either way the client has all it gets
+        break;
+    }
+#endif /* HAVE_SYS_SENDFILE_H */
+
+    Close();
+}
+
+void ImageServerConnection::NotModified()
+{
+    static MetricCounter& notModified = sMetrics.GetCounter("evemu_imageserver_not_modified_total", "Image requests answered with 304 Not Modified.");
+    notModified.Inc();
+
+    _response = "HTTP/1.0 304 Not Modified\r\nETag: " + _image->etag + "\r\n\r\n";
+    boost::asio::async_write(_socket, boost::asio::buffer(_response), boost::asio::transfer_all(), std::bind(&ImageServerConnection::Close, shared_from_this()));
+}
+
+void ImageServerConnection::SendMetrics()
+{
+    // only reads atomics, on this (the image server's) thread; the main loop is never waited on
+    _metricsData = sMetrics.Serialize();
+    boost::asio::async_write(_socket, _responseMetrics, boost::asio::transfer_all(), std::bind(&ImageServerConnection::SendMetricsData, shared_from_this()));
+}
+
+void ImageServerConnection::SendMetricsData()
+{
+    boost::asio::async_write(_socket, boost::asio::buffer(_metricsData), boost::asio::transfer_all(), std::bind(&ImageServerConnection::Close, shared_from_this()));
 }
 
 void ImageServerConnection::NotFound()
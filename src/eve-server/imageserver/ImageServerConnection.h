@@ -34,6 +34,8 @@
  * @brief Handles a client connection to the image server
  *
  * Handles exactly one client; does all the protocol related stuff. Very limited HTTP handling.
+ * Also serves GET /metrics (sMetrics, Prometheus text format) for monitoring.
+ * Answers If-None-Match with 304 when the client has the image already.
  *
  * @author caytchen
  * @date April 2011
@@ -41,6 +43,7 @@
 class ImageServerConnection : public std::enable_shared_from_this<ImageServerConnection>
 {
 public:
+    ~ImageServerConnection();
     static std::shared_ptr<ImageServerConnection> create(boost::asio::io_context& io);
     void Process();
     boost::asio::ip::tcp::socket& socket();
@@ -48,7 +51,12 @@ public:
 private:
     ImageServerConnection(boost::asio::io_context& io);
     void ProcessHeaders();
+    void ReadRequestHeaders(std::istream& stream);
     void SendImage();
+    void SendFile();
+    void NotModified();
+    void SendMetrics();
+    void SendMetricsData();
     void NotFound();
     void Close();
     void Redirect();
@@ -62,12 +70,19 @@ private:
     uint32 _id;
     uint32 _size;
     std::string _redirectUrl;
+    std::string _ifNoneMatch;
 
     boost::asio::streambuf _buffer;
     boost::asio::ip::tcp::socket _socket;
-    std::shared_ptr<std::vector<char> > _imageData;
+    std::shared_ptr<const ImageServer::Image> _image;
+    std::string _response;
+    std::string _metricsData;
 
-    static boost::asio::const_buffers_1 _responseOK;
+    // SendFile() state
+    int _fileFd;
+    off_t _fileOffset;
+
+    static boost::asio::const_buffers_1 _responseMetrics;
     static boost::asio::const_buffers_1 _responseNotFound;
     static boost::asio::const_buffers_1 _responseRedirectBegin;
     static boost::asio::const_buffers_1 _responseRedirectEnd;
@@ -32,6 +32,7 @@
 #include "StaticDataMgr.h"
 #include "inventory/AttributeMap.h"
 #include "inventory/InventoryItem.h"
+#include "inventory/ItemFactory.h"
 
 
 /*
@@ -68,6 +69,23 @@ bool AttributeMap::Load(bool reset/*false*/) {
 
     // check for temp items.  they arent saved to db
     if (!IsTempItem(mItem.itemID()) and !IsNPC(mItem.itemID())) {
+        /* items being bulk loaded by ItemFactory already have their saved attribs pulled from db */
+        const std::vector<Inv::AttrData>* pSaved(sItemFactory.GetPreloadedAttributes(mItem.itemID()));
+        if (pSaved != nullptr) {
+            EvilNumber value(EvilZero);
+            for (auto cur : *pSaved) {
+                if (cur.type) {
+                    value = cur.valueFloat;
+                } else {
+                    value = cur.valueInt;
+                }
+                SetAttribute(cur.attrID, value, false);
+            }
+            if (is_log_enabled(ATTRIBUTE__INFO))
+                _log(ATTRIBUTE__INFO, "AttributeMap::Load()  Loaded %lu attribs for %s.", mAttributes.size(), mItem.name());
+            return true;
+        }
+
         /* load saved attribs from the db, if any, to update the defaults with items current (saved) values*/
         DBQueryResult res;
         if (IsCharacterID(mItem.itemID())) {
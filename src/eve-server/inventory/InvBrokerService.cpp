@@ -52,8 +52,7 @@ PyResult InvBrokerService::GetItemDescriptor(PyCallArgs &call) {
 BoundDispatcher* InvBrokerService::BindObject(Client* client, PyRep* bindParameters) {
     InvBroker_BindArgs args;
     //crap
-    PyRep* tmp(bindParameters->Clone());
-    if (!args.Decode(&tmp)) {
+    if (!args.Decode(bindParameters)) {
         codelog(SERVICE__ERROR, "%s: Failed to decode bind args.", GetName().c_str());
         return nullptr;
     }
@@ -179,19 +179,24 @@ bool Inventory::LoadContents() {
         return false;
     }
 
+    std::vector<uint32> toLoad;
+    toLoad.reserve(items.size());
     for (auto cur : items) {
         if ((cur == od.ownerID) or (cur == od.locID) or (cur == m_myID))
             continue;
-        InventoryItemRef iRef = sItemFactory.GetItemRef(cur);
-        if (iRef.get() == nullptr) {
-            _log(INV__WARNING, "Inventory::LoadContents() - Failed to load item %u contained in %u. Skipping.", cur, m_myID);
-            continue;
-        } else {
-            AddItem(iRef);
-            Client* pClient(sItemFactory.GetUsingClient());
-        }
+        toLoad.push_back(cur);
     }
 
+    // load all items at once.  this is 2 db hits per 1k items instead of 2 per item
+    std::vector<InventoryItemRef> loaded;
+    sItemFactory.GetItemRefs(toLoad, loaded);
+    if (loaded.size() < toLoad.size())
+        _log(INV__WARNING, "Inventory::LoadContents() - Failed to load %lu of %lu items contained in %u. Skipping.", \
+                    toLoad.size() - loaded.size(), toLoad.size(), m_myID);
+
+    for (auto cur : loaded)
+        AddItem(cur);
+
     if (sConfig.debug.UseProfiling)
         sProfiler.AddTime(Profile::itemload, GetTimeUSeconds() - profileStartTime);
 
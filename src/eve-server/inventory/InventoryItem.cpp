@@ -144,6 +144,23 @@ InventoryItemRef InventoryItem::Load(uint32 itemID)
     return InventoryItem::Load<InventoryItem>(itemID);
 }
 
+InventoryItemRef InventoryItem::Load(uint32 itemID, const ItemData &data)
+{
+    const ItemType *type = sItemFactory.GetType(data.typeID);
+    if (type == nullptr)
+        return InventoryItemRef(nullptr);
+
+    InventoryItemRef iRef = InventoryItem::_LoadItem<InventoryItem>(itemID, *type, data);
+    if (iRef.get() == nullptr)
+        return InventoryItemRef(nullptr);
+
+    // virtual load (load attributes)
+    if (!iRef->_Load())
+        return InventoryItemRef(nullptr);
+
+    return iRef;
+}
+
 InventoryItemRef InventoryItem::SpawnItem(uint32 itemID, const ItemData &data)
 {
     if (data.quantity == 0)
@@ -175,8 +192,19 @@ uint32 InventoryItem::CreateItemID(ItemData &data) {
             EvE::traceStack();
         }
 
-    // insert new entry into DB
-    return ItemDB::NewItem(data);
+    // srvItemIDSeq missing (checked once, on startup).  insert now, using entity auto-increment
+    if (!sItemFactory.HasItemIDSeq())
+        return ItemDB::NewItem(data);
+
+    // id comes from ItemFactory's reserved block, and the row is written with the next batch insert.
+    //  no auto-increment fallback here, as that could hand out ids from a reserved block
+    uint32 itemID(sItemFactory.GetNextItemID());
+    if (itemID == 0)
+        return 0;
+    if (!ItemDB::QueueNewItem(itemID, data))
+        return 0;
+
+    return itemID;
 }
 
 /* This Spawn function is meant for in-memory only items created from the following categories...
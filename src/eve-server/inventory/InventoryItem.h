@@ -209,6 +209,8 @@ public:
     /*  Item Creating and Loading methods */
     /* calls _Ty::Load<_Ty>.  */
     static InventoryItemRef Load( uint32 itemID);
+    /* same as above, using item data already pulled from db.  used by ItemFactory bulk loading */
+    static InventoryItemRef Load( uint32 itemID, const ItemData &data);
     /* creates new Item and calls item::_Load() */
     /* does not save to db.  does not add item to ItemFactory */
     static InventoryItemRef SpawnItem( uint32 itemID, const ItemData &data);
@@ -241,9 +243,9 @@ protected:
     template<class _Ty>
     static RefPtr<_Ty> _Load( uint32 itemID)
     {
-        // pull the specific item info from db
+        // pull the specific item info from db (unless it was prefetched)
         ItemData data;
-        if (!ItemDB::GetItemData(itemID, data))
+        if (!sItemFactory.GetPrefetchedData(itemID, data) and !ItemDB::GetItemData(itemID, data))
             return RefPtr<_Ty>(nullptr);
 
         // obtain type
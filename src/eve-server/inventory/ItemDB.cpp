@@ -24,6 +24,9 @@
 */
 
 
+#include <atomic>
+#include <mutex>
+
 #include "eve-server.h"
 #include "StaticDataMgr.h"
 
@@ -181,6 +184,111 @@ bool ItemDB::GetItemData(uint32 itemID, ItemData &into) {
     return true;
 }
 
+/* bulk loaders.
+ *  ids are sent in chunks to keep query (and result) size sane.
+ *  a 5k-item hangar is 5 queries per table instead of 5k
+ */
+static const uint16 BulkChunkSize = 1000;
+
+bool ItemDB::GetItemData(const std::vector<uint32>& itemIDs, std::map<uint32, ItemData>& into)
+{
+    std::string ids;
+    std::vector<int32> chunk;
+    chunk.reserve(BulkChunkSize);
+    for (size_t i = 0; i < itemIDs.size(); i += BulkChunkSize) {
+        chunk.assign(itemIDs.begin() + i, itemIDs.begin() + std::min(i + BulkChunkSize, itemIDs.size()));
+        ids.clear();
+        ListToINString(chunk, ids);
+
+        DBQueryResult res;
+        if (!sDatabase.RunQuery(res,
+            "SELECT"
+            "  itemID, itemName, typeID, ownerID, locationID, flag, contraband,"
+            "  singleton, quantity, x, y, z, customInfo"
+            " FROM entity WHERE itemID IN (%s)", ids.c_str()))
+        {
+            codelog(DATABASE__ERROR, "Error in bulk item query: %s", res.error.c_str());
+            return false;
+        }
+
+        DBResultRow row;
+        while (res.GetRow(row)) {
+            ItemData& data = into[row.GetUInt(0)];
+            data.name = row.GetText(1);
+            data.typeID = row.GetUInt(2);
+            data.ownerID = (row.IsNull(3) ? 1 : row.GetUInt(3));
+            data.locationID = (row.IsNull(4) ? 0 : row.GetUInt(4));
+            data.flag = (EVEItemFlags)row.GetUInt(5);
+            data.contraband = row.GetInt(6) ? true : false;
+            data.singleton = row.GetInt(7) ? true : false;
+            data.quantity = row.GetUInt(8);
+            data.position.x = row.GetDouble(9);
+            data.position.y = row.GetDouble(10);
+            data.position.z = row.GetDouble(11);
+            data.customInfo = (row.IsNull(12) ? "" : row.GetText(12));
+        }
+    }
+
+    return true;
+}
+
+bool ItemDB::GetItemAttributes(const std::vector<uint32>& itemIDs, std::map<uint32, std::vector<Inv::AttrData>>& into)
+{
+    std::string ids;
+    std::vector<int32> chunk;
+    chunk.reserve(BulkChunkSize);
+    for (size_t i = 0; i < itemIDs.size(); i += BulkChunkSize) {
+        chunk.assign(itemIDs.begin() + i, itemIDs.begin() + std::min(i + BulkChunkSize, itemIDs.size()));
+        ids.clear();
+        ListToINString(chunk, ids);
+
+        DBQueryResult res;
+        if (!sDatabase.RunQuery(res, "SELECT itemID, attributeID, valueInt, valueFloat FROM entity_attributes WHERE itemID IN (%s)", ids.c_str())) {
+            codelog(DATABASE__ERROR, "Error in bulk attribute query: %s", res.error.c_str());
+            return false;
+        }
+
+        DBResultRow row;
+        while (res.GetRow(row)) {
+            Inv::AttrData data = Inv::AttrData();
+                data.itemID = row.GetUInt(0);
+                data.attrID = row.GetUInt(1);
+                data.type = (row.IsNull(2) and !row.IsNull(3));
+                data.valueInt = (row.IsNull(2) ? 0 : row.GetInt64(2));
+                data.valueFloat = (row.IsNull(3) ? 0.0 : row.GetDouble(3));
+            into[data.itemID].push_back(data);
+        }
+    }
+
+    return true;
+}
+
+bool ItemDB::GetLoginItems(uint32 charID, ItemPrefetch& into)
+{
+    DBQueryResult res;
+    if (!sDatabase.RunQuery(res,
+        "SELECT e.itemID FROM entity AS e, chrCharacters AS c"
+        " WHERE c.characterID = %u"
+        "  AND (e.itemID = c.shipID OR e.locationID = c.shipID OR e.locationID = c.characterID)", charID))
+    {
+        codelog(DATABASE__ERROR, "Error in login item query: %s", res.error.c_str());
+        return false;
+    }
+
+    std::vector<uint32> itemIDs;
+    itemIDs.reserve(res.GetRowCount());
+    DBResultRow row;
+    while (res.GetRow(row))
+        itemIDs.push_back(row.GetUInt(0));
+
+    into.time = GetFileTimeNow();
+    // every item gets an entry, so items without saved attribs dont go back to db
+    for (auto cur : itemIDs)
+        into.attribs[cur];
+
+    return (GetItemData(itemIDs, into.items) and GetItemAttributes(itemIDs, into.attribs));
+}
+
 uint32 ItemDB::NewItem(const ItemData &data) {
     // check for common errors ('common' is relative.)
     if (data.position.isNaN() or data.position.isInf())
@@ -210,6 +318,120 @@ uint32 ItemDB::NewItem(const ItemData &data) {
     return uid;
 }
 
+/* new item rows waiting for the next batch insert.
+ *  s_newItemMutex is held thru the insert, so a query that flushes first never runs ahead of a
+ *  flush already in progress on another thread.  it is recursive, as the insert itself goes thru the query hook.
+ */
+static std::recursive_mutex s_newItemMutex;
+static std::vector<std::pair<uint32, ItemData>> s_newItems;
+// lets the query hook skip the lock when nothing is queued
+static std::atomic<bool> s_newItemsPending(false);
+// rows per insert statement
+static const uint16 NewItemBatchSize = 500;
+
+bool ItemDB::QueueNewItem(uint32 itemID, const ItemData &data)
+{
+    // check for common errors ('common' is relative.)
+    if (data.position.isNaN() or data.position.isInf())
+        return false;
+
+    std::lock_guard<std::recursive_mutex> lock(s_newItemMutex);
+    s_newItems.emplace_back(itemID, data);
+    s_newItemsPending.store(true, std::memory_order_release);
+    return true;
+}
+
+void ItemDB::FlushBeforeQuery(const char* query)
+{
+    // any statement naming entity may read or update a queued row.  a few false hits only flush early
+    if (!s_newItemsPending.load(std::memory_order_acquire))
+        return;
+    if (strstr(query, "entity") == nullptr)
+        return;
+    FlushNewItems();
+}
+
+void ItemDB::FlushNewItems()
+{
+    std::lock_guard<std::recursive_mutex> lock(s_newItemMutex);
+    if (s_newItems.empty())
+        return;
+
+    // take the queue first, so the hook sees nothing pending while our own inserts run
+    std::vector<std::pair<uint32, ItemData>> items;
+    items.swap(s_newItems);
+    s_newItemsPending.store(false, std::memory_order_release);
+
+    std::string nameEsc, customInfoEsc;
+    for (size_t i = 0; i < items.size(); i += NewItemBatchSize) {
+        std::ostringstream Inserts;
+        Inserts << "INSERT INTO entity";
+        Inserts << " (itemID, itemName, typeID, ownerID, locationID, flag, contraband, singleton, quantity, x, y, z, customInfo)";
+        Inserts << " VALUES ";
+        size_t end(std::min(i + NewItemBatchSize, items.size()));
+        for (size_t j = i; j < end; ++j) {
+            const ItemData& data = items[j].second;
+            sDatabase.DoEscapeString(nameEsc, data.name);
+            sDatabase.DoEscapeString(customInfoEsc, data.customInfo);
+            if (j > i)
+                Inserts << ", ";
+            Inserts << "(" << items[j].first << ", '" << nameEsc << "', " << data.typeID << ", " << data.ownerID << ", ";
+            Inserts << data.locationID << ", " << (uint16)data.flag << ", " << (data.contraband ? 1 : 0) << ", " << (data.singleton ? 1 : 0) << ", ";
+            Inserts << data.quantity << ", " << std::to_string(data.position.x) << ", " << std::to_string(data.position.y) << ", " << std::to_string(data.position.z);
+            Inserts << ", '" << customInfoEsc << "')";
+        }
+
+        DBerror err;
+        if (!sDatabase.RunQuery(err, "%s", Inserts.str().c_str()))
+            codelog(DATABASE__ERROR, "Failed to insert %lu new entities: %s", end - i, err.c_str());
+    }
+}
+
+bool ItemDB::ReserveItemIDs(uint32 count, uint32& first)
+{
+    DBerror err;
+    uint32 next(0);
+    if (!sDatabase.RunQueryLID(err, next, "UPDATE srvItemIDSeq SET nextItemID = LAST_INSERT_ID(nextItemID + %u) WHERE AI = 1", count)
+    or (next == 0))
+    {
+        codelog(DATABASE__ERROR, "Failed to reserve item ids: %s", err.c_str());
+        return false;
+    }
+    first = next - count;
+    return true;
+}
+
+void ItemDB::ReleaseItemIDs(uint32 from, uint32 to)
+{
+    if (from >= to)
+        return;
+    DBerror err;
+    sDatabase.RunQuery(err, "UPDATE srvItemIDSeq SET nextItemID = %u WHERE AI = 1 AND nextItemID = %u", from, to);
+}
+
+bool ItemDB::SyncItemIDs()
+{
+    /* ids reserved by a server that didnt shut down cleanly are never handed out again;
+     *  seq only moves forward, so the unused part of that block is skipped.
+     *  this also moves seq past any rows written without it (restored backups, old auto-increment inserts)
+     */
+    DBerror err;
+    if (!sDatabase.RunQuery(err,
+        "UPDATE srvItemIDSeq SET nextItemID = GREATEST(nextItemID,"
+        " (SELECT COALESCE(MAX(itemID) + 1, 0) FROM entity WHERE itemID > %u AND itemID < %u)) WHERE AI = 1",
+        minPlayerItem, maxPlayerItem))
+    {
+        _log(DATABASE__MESSAGE, "SyncItemIDs - unable to sync item id seq: %s", err.c_str());
+        return false;
+    }
+
+    // table may be there without its row
+    DBQueryResult res;
+    if (!sDatabase.RunQuery(res, "SELECT nextItemID FROM srvItemIDSeq WHERE AI = 1"))
+        return false;
+    return (res.GetRowCount() > 0);
+}
+
 void ItemDB::UpdateLocation(uint32 itemID, uint32 locationID, EVEItemFlags flag)
 {
     DBerror err;
@@ -32,17 +32,47 @@
 
 class ItemData;
 
+/* entity rows pulled ahead of time, off the main thread.  see LoginPool
+ *  ItemFactory checks these before going to db, while they are set as its current prefetch.
+ */
+struct ItemPrefetch {
+    int64 time;                                                 // filetime rows were read
+    std::map<uint32, ItemData> items;
+    std::map<uint32, std::vector<Inv::AttrData>> attribs;
+};
+
 class ItemDB
 {
 public:
     // get item data based on itemID
     static bool GetItemData(uint32 itemID, ItemData &into);   // called by RefPtr<_Ty> _Load() at InventoryItem.h:245
+    // bulk versions for ItemFactory::LoadItems().  these only query entity tables, and skip ids not found
+    static bool GetItemData(const std::vector<uint32>& itemIDs, std::map<uint32, ItemData>& into);
+    static bool GetItemAttributes(const std::vector<uint32>& itemIDs, std::map<uint32, std::vector<Inv::AttrData>>& into);
+    // rows for items loaded with a character on login (skills, implants, active ship and its contents)
+    static bool GetLoginItems(uint32 charID, ItemPrefetch& into);
     static bool DeleteItem(uint32 itemID);
 
     static void UpdateLocation(uint32 itemID, uint32 locationID, EVEItemFlags flag);
 
+    // single insert, id from entity auto-increment.  only used when srvItemIDSeq is missing
     static uint32 NewItem(const ItemData &data);
 
+    /* new item rows.  ids come from blocks reserved in srvItemIDSeq (see ItemFactory::GetNextItemID())
+     *  and rows are held here, then written with one multi-row insert per batch.
+     *  FlushBeforeQuery() is DBcore's query hook, so any statement on entity, from any DB class or thread,
+     *  writes pending rows first.  ItemFactory::Process() also flushes every main loop pass.
+     */
+    static bool QueueNewItem(uint32 itemID, const ItemData &data);
+    static void FlushNewItems();
+    static void FlushBeforeQuery(const char* query);
+    // moves seq to 'count' past current, and sets first to start of reserved range
+    static bool ReserveItemIDs(uint32 count, uint32& first);
+    // gives back unused ids [from, to) if no block was reserved after them.  called on clean shutdown
+    static void ReleaseItemIDs(uint32 from, uint32 to);
+    // moves seq past any existing item.  called on startup.  false if srvItemIDSeq is missing
+    static bool SyncItemIDs();
+
     static bool SaveItem(uint32 itemID, const ItemData &data);
     static void SaveItems(std::vector< Inv::SaveData > &data);
     static void SaveAttributes(bool isChar, std::vector< Inv::AttrData > &data);
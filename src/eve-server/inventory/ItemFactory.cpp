@@ -31,6 +31,7 @@
 #include "character/Character.h"
 #include "exploration/Probes.h"
 #include "inventory/InventoryDB.h"
+#include "inventory/ItemDB.h"
 #include "inventory/ItemFactory.h"
 #include "inventory/ItemType.h"
 #include "manufacturing/Blueprint.h"
@@ -47,10 +48,15 @@
 
 ItemFactory::ItemFactory()
 :m_pClient(nullptr),
+m_pPreloadAttribs(nullptr),
+m_pPrefetch(nullptr),
 m_nextTempID(0),
 m_nextNPCID(0),
 m_nextDroneID(0),
-m_nextMissileID(0)
+m_nextMissileID(0),
+m_nextItemID(0),
+m_lastItemID(0),
+m_itemIDSeq(false)
 {
 }
 
@@ -68,6 +74,12 @@ int ItemFactory::Initialize()
     m_nextNPCID = NPC_ID;
     m_nextMissileID = MISSILE_ID;
     m_nextDroneID = DRONE_ID;
+    // player item ids are reserved in blocks as needed.  make sure seq is past anything already in db
+    m_itemIDSeq = ItemDB::SyncItemIDs();
+    if (!m_itemIDSeq)
+        sLog.Warning("      ItemFactory", "srvItemIDSeq not found.  New items will be inserted one at a time.  Run the db migrations to fix this.");
+    // queued entity rows are written before any query that could need them
+    sDatabase.SetQueryHook(ItemDB::FlushBeforeQuery);
 
     sLog.Blue("      ItemFactory", "Item Factory Initialized.");
     return 1;
@@ -87,6 +99,16 @@ void ItemFactory::Close()
     m_items.clear();
     // Set Client pointer to NULL
     m_pClient = nullptr;
+    // write anything still queued, and give back rest of our id block
+    ItemDB::FlushNewItems();
+    if (m_itemIDSeq)
+        ItemDB::ReleaseItemIDs(m_nextItemID, m_lastItemID);
+    m_nextItemID = m_lastItemID = 0;
+}
+
+void ItemFactory::Process()
+{
+    ItemDB::FlushNewItems();
 }
 
 void ItemFactory::SaveItems() {
@@ -160,6 +182,23 @@ uint32 ItemFactory::GetNextMissileID()
     return ++m_nextMissileID;
 }
 
+/* ids for new player items.  these are reserved from db in blocks, so spawning an item
+ *  doesnt need an insert round trip to get its id.  the row itself is queued in ItemDB.
+ */
+static const uint32 ItemIDBlockSize = 1000;
+
+uint32 ItemFactory::GetNextItemID()
+{
+    if (m_nextItemID >= m_lastItemID) {
+        uint32 first(0);
+        if (!ItemDB::ReserveItemIDs(ItemIDBlockSize, first))
+            return 0;
+        m_nextItemID = first;
+        m_lastItemID = first + ItemIDBlockSize;
+    }
+    return m_nextItemID++;
+}
+
 Inventory* ItemFactory::GetInventoryFromId(uint32 itemID, bool load /*true*/) {
     // do we need to check trade containers here?
     if (!IsValidLocationID(itemID))
@@ -305,6 +344,88 @@ InventoryItemRef ItemFactory::GetItemRef(uint32 itemID)
     return _GetItem<InventoryItem>(itemID);
 }
 
+void ItemFactory::GetItemRefs(const std::vector<uint32>& itemIDs, std::vector<InventoryItemRef>& into)
+{
+    // only player items live in the entity table.  everything else (chars, offices, statics) uses the single-item path
+    std::vector<uint32> toLoad;
+    toLoad.reserve(itemIDs.size());
+    for (auto cur : itemIDs)
+        if (IsPlayerItem(cur) and (m_items.find(cur) == m_items.end()))
+            toLoad.push_back(cur);
+
+    if (!toLoad.empty()) {
+        std::map<uint32, ItemData> data;
+        std::map<uint32, std::vector<Inv::AttrData>> attribs;
+        // items already in the current prefetch dont need querying.  their attribs are found by GetPreloadedAttributes()
+        if (m_pPrefetch != nullptr) {
+            std::vector<uint32> remaining;
+            remaining.reserve(toLoad.size());
+            for (auto cur : toLoad) {
+                std::map<uint32, ItemData>::const_iterator itr = m_pPrefetch->items.find(cur);
+                if (itr == m_pPrefetch->items.end()) {
+                    remaining.push_back(cur);
+                } else {
+                    data.emplace(cur, itr->second);
+                }
+            }
+            toLoad.swap(remaining);
+        }
+        // every item gets an entry, so items without saved attribs dont go back to db
+        for (auto cur : toLoad)
+            attribs[cur];
+
+        if (toLoad.empty() or (ItemDB::GetItemData(toLoad, data) and ItemDB::GetItemAttributes(toLoad, attribs))) {
+            // item loading may recurse into here (containers loading contents), so save previous set
+            std::map<uint32, std::vector<Inv::AttrData>>* pPrev(m_pPreloadAttribs);
+            m_pPreloadAttribs = &attribs;
+            for (auto& cur : data) {
+                // may have been loaded by a container earlier in this loop
+                if (m_items.find(cur.first) != m_items.end())
+                    continue;
+                InventoryItemRef iRef = InventoryItem::Load(cur.first, cur.second);
+                if (iRef.get() != nullptr)
+                    m_items.emplace(cur.first, iRef);
+            }
+            m_pPreloadAttribs = pPrev;
+        }
+    }
+
+    // everything is cached now (or failed to load), so this is just lookups and the odd non-entity item
+    into.reserve(into.size() + itemIDs.size());
+    for (auto cur : itemIDs) {
+        InventoryItemRef iRef = GetItemRef(cur);
+        if (iRef.get() != nullptr)
+            into.push_back(iRef);
+    }
+}
+
+const std::vector<Inv::AttrData>* ItemFactory::GetPreloadedAttributes(uint32 itemID)
+{
+    std::map<uint32, std::vector<Inv::AttrData>>::const_iterator itr;
+    if (m_pPreloadAttribs != nullptr) {
+        itr = m_pPreloadAttribs->find(itemID);
+        if (itr != m_pPreloadAttribs->end())
+            return &itr->second;
+    }
+    if (m_pPrefetch != nullptr) {
+        itr = m_pPrefetch->attribs.find(itemID);
+        if (itr != m_pPrefetch->attribs.end())
+            return &itr->second;
+    }
+    return nullptr;
+}
+
+bool ItemFactory::GetPrefetchedData(uint32 itemID, ItemData& into)
+{
+    if (m_pPrefetch == nullptr)
+        return false;
+    std::map<uint32, ItemData>::const_iterator itr = m_pPrefetch->items.find(itemID);
+    if (itr == m_pPrefetch->items.end())
+        return false;
+    into = itr->second;
+    return true;
+}
+
 BlueprintRef ItemFactory::GetBlueprintRef(uint32 blueprintID)
 {
     return _GetItem<Blueprint>(blueprintID);
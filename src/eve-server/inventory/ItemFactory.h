@@ -35,6 +35,7 @@ struct CharacterData;
 struct CorpData;
 struct OfficeData;
 struct AsteroidData;
+struct ItemPrefetch;
 
 class ItemData;
 class ItemType;
@@ -57,12 +58,17 @@ public:
 
     void Close();
     int Initialize();
+    // called from main loop.  writes new item rows queued this pass
+    void Process();
     uint32 Count()                                      { return m_items.size(); }
 
     void SaveItems();
     void RemoveItem(uint32 itemID);
     void SetUsingClient(Client *pClient)                { m_pClient = pClient; }
     void UnsetUsingClient()                             { m_pClient = nullptr; }
+    // rows read ahead of time (by LoginPool) for items about to be loaded.  we do not own this
+    void SetPrefetch(ItemPrefetch* pData)               { m_pPrefetch = pData; }
+    void UnsetPrefetch()                                { m_pPrefetch = nullptr; }
     void AddItem(InventoryItemRef iRef);
 
     Client* GetUsingClient()                            { return m_pClient; }
@@ -98,6 +104,15 @@ public:
     CelestialObjectRef      GetCelestialRef(uint32 celestialID);
     ProbeItemRef            GetProbeRef(uint32 probeID);
 
+    /* bulk version of GetItemRef().  player items not yet loaded are pulled from db with 2 queries total,
+     * instead of 2 per item.  into gets loaded refs in same order as itemIDs.  ids that fail to load are skipped
+     */
+    void                    GetItemRefs(const std::vector<uint32>& itemIDs, std::vector<InventoryItemRef>& into);
+    // saved attribs for an item in the current bulk load.  null if item isnt part of one.  called by AttributeMap::Load()
+    const std::vector<Inv::AttrData>* GetPreloadedAttributes(uint32 itemID);
+    // entity row for an item in the current prefetch.  false if item isnt part of one.  called by InventoryItem::_Load()
+    bool                    GetPrefetchedData(uint32 itemID, ItemData& into);
+
 
     /**
      * creates new InventoryItem, saves to db, caches it and returns a RefPtr.
@@ -127,6 +142,10 @@ public:
     /** @todo  add Sleeper item spawners here */
 
     /* ID Authority Functions  */
+    // player item id from current reserved block (reserving a new block as needed).  0 if none could be reserved
+    uint32                  GetNextItemID();
+    // false if srvItemIDSeq is missing, and new items use entity auto-increment instead
+    bool                    HasItemIDSeq()              { return m_itemIDSeq; }
     uint32                  GetNextNPCID();
     uint32                  GetNextTempID();
     uint32                  GetNextDroneID();
@@ -140,6 +159,9 @@ protected:
     std::map<uint32, InventoryItemRef> m_items;
     std::map<uint32, InventoryItemRef> m_staticItems;
     std::map<uint32, InventoryItemRef> m_dynamicItems;
+    // attribs for current GetItemRefs() call.  we do not own this
+    std::map<uint32, std::vector<Inv::AttrData>>* m_pPreloadAttribs;
+    ItemPrefetch* m_pPrefetch;
 
     template<class _Ty>
     const _Ty *_GetType(uint16 typeID);
@@ -154,6 +176,10 @@ private:
     uint32 m_nextTempID;
     uint32 m_nextDroneID;
     uint32 m_nextMissileID;
+    // current block of player item ids, reserved from srvItemIDSeq.  [next, last)
+    uint32 m_nextItemID;
+    uint32 m_lastItemID;
+    bool m_itemIDSeq;
 };
 
 //Singleton
@@ -7,6 +7,8 @@
  * @Author:         Allan
  * @date:   13 November 2018
  */
+#include <algorithm>
+
 #include "../StaticDataMgr.h"
 #include "agents/Agent.h"
 #include "map/MapData.h"
@@ -45,6 +47,13 @@ void MapData::Clear()
     m_regionJumps.clear();
     m_constJumps.clear();
     m_systemJumps.clear();
+
+    m_graphIndex.clear();
+    m_graphSystems.clear();
+    m_graphSecurity.clear();
+    m_graphOffsets.clear();
+    m_graphEdges.clear();
+    m_jumpRows.clear();
 }
 
 void MapData::GetInfo()
@@ -69,8 +78,10 @@ void MapData::Populate()
     DBQueryResult* res = new DBQueryResult();
     MapDB::GetSystemJumps(*res);
     DBResultRow row;
+    std::vector<std::pair<uint32, uint32>> jumps;
     while (res->GetRow(row)) {
         //SELECT ctype, fromsol, tosol FROM mapConnections
+        jumps.push_back(std::make_pair(row.GetUInt(1), row.GetUInt(2)));
         if (row.GetInt(0) == Map::Jumptype::Region) {
             m_regionJumps.emplace(row.GetInt(1), row.GetInt(2));
         } else if (row.GetInt(0) == Map::Jumptype::Constellation) {
@@ -83,10 +94,155 @@ void MapData::Populate()
     sLog.Cyan("          MapData", "%lu Region jumps, %lu Constellation jumps and %lu System jumps loaded in %.3fms.", //
               m_regionJumps.size(), m_constJumps.size(), m_systemJumps.size(), (GetTimeMSeconds() - start));
 
+    start = GetTimeMSeconds();
+    BuildJumpGraph(jumps);
+    sLog.Cyan("          MapData", "Jump graph of %lu systems and %lu connections built in %.3fms.", //
+              m_graphSystems.size(), m_graphEdges.size(), (GetTimeMSeconds() - start));
+
     // cleanup
     SafeDelete(res);
 }
 
+void MapData::BuildJumpGraph(const std::vector<std::pair<uint32, uint32>>& jumps)
+{
+    // number each system that has a gate
+    for (auto cur : jumps) {
+        for (uint32 sysID : {cur.first, cur.second}) {
+            if (m_graphIndex.find(sysID) != m_graphIndex.end())
+                continue;
+            m_graphIndex[sysID] = m_graphSystems.size();
+            m_graphSystems.push_back(sysID);
+        }
+    }
+
+    uint16 count(m_graphSystems.size());
+    m_graphSecurity.resize(count, 0.0f);
+    for (uint16 i = 0; i < count; ++i) {
+        SystemData data = SystemData();
+        if (sDataMgr.GetSystemData(m_graphSystems[i], data))
+            m_graphSecurity[i] = data.securityRating;
+    }
+
+    // gates are two-way.  mapConnections may or may not list both directions, so add both and remove dupes
+    std::vector<std::vector<uint16>> adjacency(count);
+    for (auto cur : jumps) {
+        uint16 from(m_graphIndex[cur.first]), to(m_graphIndex[cur.second]);
+        adjacency[from].push_back(to);
+        adjacency[to].push_back(from);
+    }
+
+    m_graphOffsets.resize(count + 1, 0);
+    for (uint16 i = 0; i < count; ++i) {
+        std::sort(adjacency[i].begin(), adjacency[i].end());
+        adjacency[i].erase(std::unique(adjacency[i].begin(), adjacency[i].end()), adjacency[i].end());
+        m_graphOffsets[i] = m_graphEdges.size();
+        m_graphEdges.insert(m_graphEdges.end(), adjacency[i].begin(), adjacency[i].end());
+    }
+    m_graphOffsets[count] = m_graphEdges.size();
+
+    m_jumpRows.clear();
+    m_jumpRows.resize(count);
+}
+
+void MapData::SearchJumps(uint16 origin, std::vector<uint8>& dist, std::vector<uint16>* parent, float minSec, float maxSec)
+{
+    // breadth-first search from origin.  every edge costs one jump, so first visit is shortest.
+    bool filter(IsSecFiltered(minSec, maxSec));
+    dist.assign(m_graphSystems.size(), Map::Jumps::Unreachable);
+    if (parent != nullptr)
+        parent->assign(m_graphSystems.size(), origin);
+
+    std::vector<uint16> queue;
+    queue.reserve(m_graphSystems.size());
+    queue.push_back(origin);
+    dist[origin] = 0;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint16 cur(queue[head]);
+        if (dist[cur] >= Map::Jumps::Max)
+            continue;
+        for (uint32 i = m_graphOffsets[cur]; i < m_graphOffsets[cur + 1]; ++i) {
+            uint16 next(m_graphEdges[i]);
+            if (dist[next] != Map::Jumps::Unreachable)
+                continue;
+            if (filter and ((m_graphSecurity[next] < minSec) or (m_graphSecurity[next] > maxSec)))
+                continue;
+            dist[next] = dist[cur] + 1;
+            if (parent != nullptr)
+                (*parent)[next] = cur;
+            queue.push_back(next);
+        }
+    }
+}
+
+const std::vector<uint8>& MapData::GetJumpRow(uint16 origin)
+{
+    // rows are ~5k bytes each and only built for systems actually queried
+    if (m_jumpRows[origin].empty())
+        SearchJumps(origin, m_jumpRows[origin], nullptr, -1.0f, 1.0f);
+    return m_jumpRows[origin];
+}
+
+uint8 MapData::GetJumpCount(uint32 fromSystemID, uint32 toSystemID, float minSec/*-1.0f*/, float maxSec/*1.0f*/)
+{
+    if (fromSystemID == toSystemID)
+        return 0;
+    std::unordered_map<uint32, uint16>::const_iterator from = m_graphIndex.find(fromSystemID), to = m_graphIndex.find(toSystemID);
+    if ((from == m_graphIndex.end()) or (to == m_graphIndex.end()))
+        return Map::Jumps::Unreachable;
+
+    if (!IsSecFiltered(minSec, maxSec))
+        return GetJumpRow(from->second)[to->second];
+
+    std::vector<uint8> dist;
+    SearchJumps(from->second, dist, nullptr, minSec, maxSec);
+    return dist[to->second];
+}
+
+void MapData::GetSystemsInRange(uint32 systemID, uint8 minJumps, uint8 maxJumps, std::vector<uint32>& into, float minSec/*-1.0f*/, float maxSec/*1.0f*/)
+{
+    std::unordered_map<uint32, uint16>::const_iterator itr = m_graphIndex.find(systemID);
+    if (itr == m_graphIndex.end()) {
+        // system without gates.  only itself is in range
+        if (minJumps == 0)
+            into.push_back(systemID);
+        return;
+    }
+
+    std::vector<uint8> filtered;
+    if (IsSecFiltered(minSec, maxSec))
+        SearchJumps(itr->second, filtered, nullptr, minSec, maxSec);
+    const std::vector<uint8>& dist = (filtered.empty() ? GetJumpRow(itr->second) : filtered);
+
+    for (uint16 i = 0; i < dist.size(); ++i)
+        if ((dist[i] >= minJumps) and (dist[i] <= maxJumps))
+            into.push_back(m_graphSystems[i]);
+}
+
+bool MapData::GetRoute(uint32 fromSystemID, uint32 toSystemID, std::vector<uint32>& into, float minSec/*-1.0f*/, float maxSec/*1.0f*/)
+{
+    if (fromSystemID == toSystemID) {
+        into.push_back(fromSystemID);
+        return true;
+    }
+    std::unordered_map<uint32, uint16>::const_iterator from = m_graphIndex.find(fromSystemID), to = m_graphIndex.find(toSystemID);
+    if ((from == m_graphIndex.end()) or (to == m_graphIndex.end()))
+        return false;
+
+    std::vector<uint8> dist;
+    std::vector<uint16> parent;
+    SearchJumps(from->second, dist, &parent, minSec, maxSec);
+    if (dist[to->second] == Map::Jumps::Unreachable)
+        return false;
+
+    // walk back from destination, then reverse
+    size_t start(into.size());
+    for (uint16 cur = to->second; cur != from->second; cur = parent[cur])
+        into.push_back(m_graphSystems[cur]);
+    into.push_back(fromSystemID);
+    std::reverse(into.begin() + start, into.end());
+    return true;
+}
+
 
 
 void MapData::GetMissionDestination(Agent* pAgent, uint8 misionType, MissionOffer& offer)
@@ -136,13 +292,21 @@ void MapData::GetMissionDestination(Agent* pAgent, uint8 misionType, MissionOffe
                     ++destRange;
 
             if ((destRange > 1) or (IsEven(MakeRandomInt(0, 100)))) {
-                // neighboring system
-                bool run = true;
-                uint8 count = 0;
-                std::vector<uint32> sysList;
-                auto itr = m_systemJumps.equal_range(systemID);
-                for (auto it = itr.first; it != itr.second; ++it)
-                    sysList.push_back(it->second);
+                // neighboring system in same constellation (with a station, if needed)
+                SystemData sysData = SystemData();
+                sDataMgr.GetSystemData(systemID, sysData);
+                std::vector<uint32> sysList, candidates;
+                GetSystemsInRange(systemID, 1, 1, sysList);
+                for (auto cur : sysList) {
+                    SystemData toData = SystemData();
+                    if (!sDataMgr.GetSystemData(cur, toData))
+                        continue;
+                    if (toData.constellationID != sysData.constellationID)
+                        continue;
+                    if (station and (sDataMgr.GetStationCount(cur) < 1))
+                        continue;
+                    candidates.push_back(cur);
+                }
                 /** @todo not sure why this is empty, but have segfaults from empty vector. */
                 if (sysList.empty()) {
                     StationData data = StationData();
@@ -152,23 +316,13 @@ void MapData::GetMissionDestination(Agent* pAgent, uint8 misionType, MissionOffe
                     offer.destinationTypeID     = data.typeID;
                     return;
                 }
-
-                while (run) {
-                    run = false;
-                    uint32 randomIndex = MakeRandomInt(0, (sysList.size() -1));
-                    systemID = sysList.at(randomIndex);
-                    if (station and (sDataMgr.GetStationCount(systemID) < 1)) {
-                        run = true;
-                        ++count;
-                    }
-                    if (run and (count > sysList.size())) {
-                        // problem....no station found within one jump
-                        offer.destinationID = 0;
-                        _log(AGENT__ERROR, "Agent::GetMissionDestination() - no station found within 1 jump." );
-                        return;
-                    }
-                    sysList.erase(sysList.begin() + randomIndex); // If we have searched a system already then do not try it again
+                if (candidates.empty()) {
+                    // problem....no station found within one jump
+                    offer.destinationID = 0;
+                    _log(AGENT__ERROR, "Agent::GetMissionDestination() - no station found within 1 jump." );
+                    return;
                 }
+                systemID = candidates.at(MakeRandomInt(0, (candidates.size() -1)));
             }
             if (station) {
                 std::vector<uint32> list;
@@ -194,14 +348,21 @@ void MapData::GetMissionDestination(Agent* pAgent, uint8 misionType, MissionOffe
         /** @todo  make function to find route from origin to constellation/region jump point.  */
         case SameOrNeighboringSystem:  //3
         case NeighboringSystem: {  //5
+            // any system within one jump, regardless of constellation
             uint32 systemID = pAgent->GetSystemID();
-            if (IsEven(MakeRandomInt(0, 100))) {
-                // same constellation
-            } else {
-                // neighboring constellation
-                systemID = 0;
-            }
-            if (ship) {
+            std::vector<uint32> sysList;
+            GetSystemsInRange(systemID, ((destRange == SameOrNeighboringSystem) ? 0 : 1), 1, sysList);
+            if (station) {
+                std::vector<uint32> list, stations;
+                for (auto cur : sysList) {
+                    stations.clear();
+                    if (sDataMgr.GetStationList(cur, stations))
+                        list.insert(list.end(), stations.begin(), stations.end());
+                }
+                list.erase(std::remove(list.begin(), list.end(), pAgent->GetStationID()), list.end());
+                if (!list.empty())
+                    offer.destinationID = list.at(MakeRandomInt(0, (list.size() -1)));
+            } else if (ship) {
                 ;  // code here for agent in ship
             }
         } break;
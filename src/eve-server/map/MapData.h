@@ -38,6 +38,16 @@ public:
 
     void                GetMissionDestination(Agent* pAgent, uint8 misionType, MissionOffer& offer);
 
+    /* jump graph queries.  sec limits apply to every system on the route except the origin.
+     *  unfiltered queries use cached per-system distance rows.  filtered queries run a fresh search.
+     */
+    // returns number of gate jumps between systems, or Map::Jumps::Unreachable
+    uint8               GetJumpCount(uint32 fromSystemID, uint32 toSystemID, float minSec=-1.0f, float maxSec=1.0f);
+    // fills 'into' with all systems between minJumps and maxJumps from systemID
+    void                GetSystemsInRange(uint32 systemID, uint8 minJumps, uint8 maxJumps, std::vector<uint32>& into, float minSec=-1.0f, float maxSec=1.0f);
+    // fills 'into' with shortest route, including both ends.  returns false if no route
+    bool                GetRoute(uint32 fromSystemID, uint32 toSystemID, std::vector<uint32>& into, float minSec=-1.0f, float maxSec=1.0f);
+
 
     void                GetMoons(uint32 systemID);   // incomplete
     void                GetPlanets(uint32 systemID); // incomplete
@@ -54,6 +64,12 @@ public:
 protected:
     void                Populate();
 
+    // jump graph
+    void                BuildJumpGraph(const std::vector<std::pair<uint32, uint32>>& jumps);
+    void                SearchJumps(uint16 origin, std::vector<uint8>& dist, std::vector<uint16>* parent, float minSec, float maxSec);
+    const std::vector<uint8>& GetJumpRow(uint16 origin);
+    bool                IsSecFiltered(float minSec, float maxSec)   { return ((minSec > -1.0f) or (maxSec < 1.0f)); }
+
 private:
     PyTuple*            m_stationExtraInfo;
     PyObject*           m_pseudoSecurities;
@@ -61,6 +77,16 @@ private:
     std::multimap<uint32, uint32>        m_regionJumps;  //fromSys/toSys
     std::multimap<uint32, uint32>        m_constJumps;   //fromSys/toSys
     std::multimap<uint32, uint32>        m_systemJumps;  //fromSys/toSys
+
+    /* all gate connections (any jump type) in compressed sparse row form.
+     *  systems are numbered 0..n-1 in m_graphSystems.  neighbors of n are m_graphEdges[m_graphOffsets[n]..m_graphOffsets[n+1]]
+     */
+    std::unordered_map<uint32, uint16>   m_graphIndex;       // systemID/node
+    std::vector<uint32>                  m_graphSystems;     // node/systemID
+    std::vector<float>                   m_graphSecurity;    // node/security
+    std::vector<uint32>                  m_graphOffsets;
+    std::vector<uint16>                  m_graphEdges;
+    std::vector<std::vector<uint8>>      m_jumpRows;         // cached unfiltered distance rows.  empty until first used
 };
 
 
@@ -47,6 +47,7 @@
 #include "system/DestinyManager.h"
 #include "system/Damage.h"
 #include "system/SystemBubble.h"
+#include "system/SystemManager.h"
 
 NPCAIMgr::NPCAIMgr(NPC* who)
 : m_state(NPCAI::State::Idle),
@@ -288,32 +289,30 @@ void NPCAIMgr::Process() {
     switch(m_state) {
         case NPCAI::State::Idle: {
             if (m_beginFindTarget.Check()) {
-                std::vector<Client*> clientVec;
-                clientVec.clear();
-                DestinyManager* pDestiny(nullptr);
-                m_npc->SysBubble()->GetPlayers(clientVec); // what about player drones?  yes...later
-                for (auto cur : clientVec) {
-                    if (cur->IsInvul())
-                        continue;
-                    if (cur->GetShipSE() == nullptr)
-                        continue;
-                    if (cur->InPod()) {
-                        if (sConfig.npc.TargetPod) {
-                            if (m_npc->SystemMgr()->GetSystemSecurityRating() > sConfig.npc.TargetPodSec)
-                                continue;
-                        } else {
-                            continue;
-                        }
-                    }
-                    pDestiny = cur->GetShipSE()->DestinyMgr();
-                    if (pDestiny == nullptr)   // this shouldnt be needed, but whatever...
-                        continue;
-                    if (pDestiny->IsCloaked() or pDestiny->IsWarping())
-                        continue;
-                    if (m_npc->GetPosition().distance(cur->GetShipSE()->GetPosition()) > m_sightRange)
-                        continue;
-
-                    Target(cur->GetShipSE());
+                // closest valid player ship in our bubble and within sight range.  what about player drones?  yes...later
+                SystemBubble* pBubble(m_npc->SysBubble());
+                bool targetPod(sConfig.npc.TargetPod and (m_npc->SystemMgr()->GetSystemSecurityRating() <= sConfig.npc.TargetPodSec));
+                std::vector<SystemEntity*> seVec;
+                m_npc->SystemMgr()->GetSpatialIndex()->QueryNearest(m_npc->GetPosition(), 1, m_sightRange, seVec,
+                    [pBubble, targetPod](SystemEntity* pSE) {
+                        if (!pSE->IsShipSE() or !pSE->HasPilot())
+                            return false;
+                        if (pSE->SysBubble() != pBubble)
+                            return false;
+                        Client* pClient(pSE->GetPilot());
+                        if (pClient->IsInvul())
+                            return false;
+                        if (pClient->InPod() and !targetPod)
+                            return false;
+                        DestinyManager* pDestiny(pSE->DestinyMgr());
+                        if (pDestiny == nullptr)   // this shouldnt be needed, but whatever...
+                            return false;
+                        if (pDestiny->IsCloaked() or pDestiny->IsWarping())
+                            return false;
+                        return true;
+                    });
+                if (!seVec.empty()) {
+                    Target(seVec.front());
                     return;
                 }
                 if (sConfig.npc.IdleWander)
@@ -109,8 +109,7 @@ P4          1,200,000 ISK
 Colony::Colony(EVEServiceManager& mgr, Client* pClient, SystemEntity* pSE)
 :m_svcMgr(mgr),
 m_client(pClient),
-m_pSE(pSE->GetPlanetSE()),
-m_colonyTimer(0)
+m_pSE(pSE->GetPlanetSE())
 {
     ccPin = new PI_CCPin();
 
@@ -124,6 +123,7 @@ m_colonyTimer(0)
     m_pLevel = 5;
     m_colonyID = 0;
     m_procTime = 0; // process check.  init to zero and stores last proc time, which is lastRunTime in command center
+    m_nextEvent = 0;
     tempPinIDs.clear();
     _log(COLONY__DEBUG, "Colony::Colony() c'tor called for %s(%u) by %s(%u)", pSE->GetName(), pSE->GetID(), pClient->GetName(), pClient->GetCharacterID());
 }
@@ -200,11 +200,13 @@ void Colony::Save()
 
 // called by PlanetSE::Process() for loaded colony.
 //  NOTE: colony is only loaded AFTER client calls for it.
+//  Update() catches up all elapsed cycles in one pass, so there is no need to run it on a timer.
+//  colony is updated when the owner views it, and here only when a scheduled event (program end) is due.
 void Colony::Process()
 {
-    if (m_colonyTimer.Check()) { //  this will process colony data every 30 mins. (typical cycle time)
+    if ((m_nextEvent > 0) and (m_nextEvent <= GetFileTimeNow())) {
         if (ccPin->pins.empty()) {
-            m_colonyTimer.Disable();
+            m_nextEvent = 0;
             return;
         }
 
@@ -291,10 +293,6 @@ void Colony::LoadPlants()
         }
     }
 
-    // set process timer to 30m
-    if (!m_colonyTimer.Enabled())
-        m_colonyTimer.Start(30*60*1000);
-
     if (update)
         UpdatePlantPins();
 }
@@ -354,7 +352,7 @@ void Colony::AbandonColony()
     SafeDelete(ccPin);
     ccPin = new PI_CCPin();
     m_colonyID = 0;
-    m_colonyTimer.Disable();
+    m_nextEvent = 0;
 }
 
 void Colony::CreateCommandPin(uint32 itemID, uint32 typeID, double latitude, double longitude) {
@@ -778,9 +776,6 @@ void Colony::SetSchematic(uint32 pinID, uint8 schematicID/*0*/)
 
         m_pLevel = (uint8)EvE::min(m_pLevel, itr->second.pLevel);
 
-        // set process timer to 30m
-        if (!m_colonyTimer.Enabled())
-            m_colonyTimer.Start(30*60*1000);
         _log(COLONY__INFO, "Colony::SetSchematic() - Set Schematic %u in plantID %u", schematicID, pinID);
     } else {
         itr->second = PI_Plant();
@@ -823,11 +818,18 @@ void Colony::InstallProgram(uint32 ecuID, uint16 typeID, float headRadius, Plane
     itr->second.installTime = GetFileTimeNow();
     itr->second.lastRunTime = GetFileTimeNow();
 
+    // same format client sends (headID, latitude, longitude)
     PyList* list = new PyList();
-    for (auto cur : itr->second.heads)
-        list->AddItem(new PyInt(cur.second.ecuPinID));
+    for (auto cur : itr->second.heads) {
+        PyTuple* tuple = new PyTuple(3);
+            tuple->SetItem(0, new PyInt(cur.first));
+            tuple->SetItem(1, new PyFloat(cur.second.latitude));
+            tuple->SetItem(2, new PyFloat(cur.second.longitude));
+        list->AddItem(tuple);
+    }
     // set up extractor program data
-    sPIDataMgr.GetProgramResultInfo(this, ecuID, typeID, list, headRadius);
+    PyRep* res = sPIDataMgr.GetProgramResultInfo(this, ecuID, typeID, list, headRadius);
+    PySafeDecRef(res);
 }
 
 void Colony::SetProgramResults(uint32 ecuID, uint16 typeID, uint16 numCycles, float headRadius, float cycleTime, uint32 qtyPerCycle)
@@ -850,9 +852,8 @@ void Colony::SetProgramResults(uint32 ecuID, uint16 typeID, uint16 numCycles, fl
     // save extraction quantity in ecu attrib    this doesnt check for invalid item
     sItemFactory.GetItemRef(ecuID)->SetAttribute(AttrPinExtractionQuantity, qtyPerCycle, false);
 
-    // set process timer to 30m
-    if (!m_colonyTimer.Enabled())
-        m_colonyTimer.Start(30*60*1000);
+    // make sure final cycles of this program are delivered even if owner doesnt look at colony again
+    ScheduleEvent(itr->second.expiryTime);
 }
 /*{'FullPath': u'UI/Messages', 'messageID': 256790, 'label': u'PlanetBlackListedBody'}(u'{planet} is not available for the general public.', None, {u'{planet}': {'conditionalValues': [], 'variableType': 10, 'propertyName': None, 'args': 0, 'kwargs': {}, 'variableName': 'planet'}})
  * {'FullPath': u'UI/Messages', 'messageID': 256791, 'label': u'CannotInstallWithoutScanResultsBody'}(u'Your mining foreman reports that an intern seems to have misplaced the necessary mineral survey results. You will need to order a fresh deposit scan before this {typeName} can begin operating.', None, {u'{typeName}': {'conditionalValues': [], 'variableType': 10, 'propertyName': None, 'args': 0, 'kwargs': {}, 'variableName': 'typeName'}})
@@ -1364,14 +1365,17 @@ void Colony::Update(bool updateTimes/*false*/)
     if (is_log_enabled(COLONY__DEBUG))
         _log(COLONY__DEBUG, "Colony::Update() - Starting Update for colony %u on %s.", m_colonyID, m_pSE->GetName());
 
+    // update colony time to current time first, so this update catches up everything since the last one
+    m_procTime = GetFileTimeNow();
+
     // first, process ecus for raw matls.
     ProcessECUs(updateTimes);
     // second, process plants for production.
     ProcessPlants(updateTimes);
     // third, update plants for matl's received
 
-    // update colony time to current time (based on this update, prior to sending out current colony status)
-    m_procTime = GetFileTimeNow();
+    // find when we next need to look at this colony without the owner asking
+    m_nextEvent = GetNextEventTime();
 
     // update CommandCenter pin times
     if (updateTimes) {
@@ -1390,79 +1394,79 @@ void Colony::Update(bool updateTimes/*false*/)
 
 void Colony::ProcessECUs(bool& updateTimes)
 {
-    /** @todo  this needs complete review/overhaul...many errors here */
-    double delta = 0;
-    uint16 cycles = 0, quantity = 0, amount = 0, count = 0;
+    /** @note  ecu output is computed in closed form, so a colony left alone for days costs the same to update as one
+     * checked every cycle.  cycles are indexed from program install, so the diminishing returns curve is the same
+     * regardless of how often (or how rarely) this is called.
+     */
+    int64 endTime = 0, cycles = 0, runCycles = 0;
+    uint32 amount = 0;
+    double factor = 0;
     std::map<uint16, uint32>::iterator itemItr;
     std::map<uint32, PI_Pin>::iterator destPin;
     std::map<uint32, PI_Plant>::iterator plant;
-    for (auto ecu : ccPin->pins) {
+    for (auto& ecu : ccPin->pins) {
         if (!ecu.second.isECU)
             continue;
 
-        if ((ecu.second.expiryTime < EvE::Time::Second ) or (ecu.second.expiryTime > m_procTime)) {
+        if (ecu.second.expiryTime < EvE::Time::Second) {
             if (is_log_enabled(COLONY__DEBUG))
-                _log(COLONY__DEBUG, "Colony::ProcessECUs() - expiryTime (%lli) > m_procTime (%lli).", \
-                        ecu.second.expiryTime, m_procTime);
+                _log(COLONY__DEBUG, "Colony::ProcessECUs() - ECU pin %u has no program installed.", ecu.first);
             continue;
         }
-        if (ecu.second.cycleTime < 0.0f) {
+        if (ecu.second.cycleTime < EvE::Time::Second) {
             if (is_log_enabled(COLONY__DEBUG))
-                _log(COLONY__DEBUG, "Colony::ProcessECUs() - cycleTime < 0.");
+                _log(COLONY__DEBUG, "Colony::ProcessECUs() - cycleTime < 1s.");
             continue;
         }
 
-        if (ecu.second.lastRunTime < EvE::Time::Hour)
-            ecu.second.lastRunTime = ecu.second.expiryTime - ecu.second.cycleTime;
+        if (ecu.second.installTime < EvE::Time::Hour)
+            ecu.second.installTime = ecu.second.expiryTime - ecu.second.cycleTime;
+        if (ecu.second.lastRunTime < ecu.second.installTime)
+            ecu.second.lastRunTime = ecu.second.installTime;
+
+        // program stops at expiryTime.  anything after that is not extracted.
+        endTime = std::min(m_procTime, ecu.second.expiryTime);
+        if (endTime <= ecu.second.lastRunTime)
+            continue;
+
+        // completed cycles since last run, and cycles already run before that (for diminishing returns)
+        cycles = (endTime - ecu.second.lastRunTime) / ecu.second.cycleTime;
+        if (cycles < 1)
+            continue;
+        runCycles = (ecu.second.lastRunTime - ecu.second.installTime) / ecu.second.cycleTime;
 
         /** @todo  as i dont have data on planet resources, and am not tracking depletion, extraction qtys used here are
          * sent from the client during 'survey program' installation, and do not simulate the diminishing returns as shown in
          * the survey program. (testing diminishing returns @ 95%)
          * because of this, the values used here (and all subsequent processes) will be more than shown in client.
          */
+        //  sum of 0.95^k for k = runCycles+1 .. runCycles+cycles
+        factor = std::pow(0.95, runCycles + 1) * (1.0 - std::pow(0.95, cycles)) / 0.05;
+
+        if (is_log_enabled(COLONY__DEBUG))
+            _log(COLONY__DEBUG, "Colony::ProcessECUs() - ECU pin %u - begin processing with %lli cycles (%lli run) at %.3f", \
+                    ecu.first, cycles, runCycles, factor);
+
         /** @note this is a simple process, as it only provides raw mats, simulating extraction from planet and
          *  shipped to storage or directly to plant for processing.
-         * however, in the case of shipping directly to plant, we will have to store the mats in the plant queue
-         * and wait for the ProcessPlants() call to use them, as this will avoid overcomplicating things,
-         * but it could get messy later....
+         * in the case of shipping directly to plant, we store the mats in the plant queue
+         * and wait for the ProcessPlants() call to use them.
          */
-
-        // dont loop...get #cycles to 'run' and set amounts accordingly
-        delta = (m_procTime - ecu.second.expiryTime) / EvE::Time::Hour;
-        cycles = delta / (ecu.second.cycleTime / EvE::Time::Hour);
-
-        /** @todo  verify cycles isnt over program cycle count */
-
-        // first - see if this ecu has a route and move contents per route.  this will simulate aquisition of raw matls from heads to storage
-        if (is_log_enabled(COLONY__DEBUG))
-            _log(COLONY__DEBUG, "Colony::ProcessECUs() - ECU pin %u - begin processing with %u cycles (%0.2f / %0.2f)", \
-                    ecu.first, cycles, delta, (ecu.second.cycleTime / EvE::Time::Hour));
-        auto destRouteItr = m_destRoutes.equal_range(plant->first);  // sum ting wong
-        for (auto it = destRouteItr.first; it != destRouteItr.second; ++it) {
-            // verify this route begins at this pin.
-            //if (it->second.srcPinID != ecu.first)
-            //    continue;
-
-            // second - update current contents per route movement as noted above (there are no stored contents to update in the ECU)
-            // get route destination pin and update qty
-            destPin = ccPin->pins.find(it->first);
+        auto srcRouteItr = m_srcRoutes.equal_range(ecu.first);
+        for (auto it = srcRouteItr.first; it != srcRouteItr.second; ++it) {
+            // get route destination pin and update qty (there are no stored contents to update in the ECU)
+            destPin = ccPin->pins.find(it->second.destPinID);
             if (destPin == ccPin->pins.end()) {
-                _log(COLONY__ERROR, "Colony::ProcessECUs() - Dest pinID %u not found in ccPin.pins map", it->first);
+                _log(COLONY__ERROR, "Colony::ProcessECUs() - Dest pinID %u not found in ccPin.pins map", it->second.destPinID);
                 continue;
             }
-            //  loop thru cycles to apply diminishing returns
-            count = cycles;
-            quantity = it->second.commodityQuantity;
-            while (count) {
-                quantity *= 0.95;
-                amount += quantity;
-                --count;
-            }
+            amount = (uint32)(it->second.commodityQuantity * factor);
+            if (amount < 1)
+                continue;
             // contents are stored in each pin.  PI_Pin.contents(std::map<uint16, uint32>(typeID, qty))
-            itemItr = destPin->second.contents.find(it->second.commodityTypeID);
             /** @todo  set/implement storage capy for pin - PI_Pin.capacity, PI_Pin.quantity */
             //  if dest cant hold entire xfer qty, drop remainder in current pin contents (as opposed to loss)
-            //      will need a way to set/test for this 'extra' material and xfer on next run
+            itemItr = destPin->second.contents.find(it->second.commodityTypeID);
             if (itemItr != destPin->second.contents.end()) {
                 itemItr->second += amount;
             } else {
@@ -1475,35 +1479,54 @@ void Colony::ProcessECUs(bool& updateTimes)
             // 'update' is part of clever code to avoid db hits.
             //  this will delete existing contents and insert current contents upon completion of processing
             destPin->second.update = true;
-            // if destination pin is plant, put materials in its' storage
+            // if destination pin is plant, flag it for subsequent processing.
             // client verifies mat'l is required before routing
             if (destPin->second.isProcess) {
-                // find dest's plant data
                 plant = ccPin->plants.find(destPin->first);
                 if (plant == ccPin->plants.end()) {
                     _log(COLONY__ERROR, "Colony::ProcessECUs() - Plant pinID %u not found in ccPin.plants map", destPin->first);
                     continue;
                 }
-                //and set hasReceivedInputs to true for subsequent processing
                 plant->second.hasReceivedInputs = true;
-                if (is_log_enabled(COLONY__DEBUG))
-                    _log(COLONY__DEBUG, "Colony::ProcessECUs() - Dest pinID %u isPlant.", it->second.destPinID);
             }
         }
 
-        // third - reset cycle times.
-        // set expiryTime to previous runtime plus cycleTime to simulate end of cycle
-        ecu.second.expiryTime = ecu.second.lastRunTime + ecu.second.cycleTime * cycles;
-        // set lastRunTime to last-processed cycle's expire time.
-        ecu.second.lastRunTime = ecu.second.expiryTime;
+        // advance to end of last completed cycle.  partial cycle is picked up on next update
+        ecu.second.lastRunTime += ecu.second.cycleTime * cycles;
         updateTimes = true;
 
         if (is_log_enabled(COLONY__DEBUG))
-            _log(COLONY__DEBUG, "Colony::ProcessECUs() - Processing complete.  timeNow %lli, expiryTime %lli, lastRunTime %lli", \
-                    GetFileTimeNow(), ecu.second.expiryTime, ecu.second.lastRunTime);
+            _log(COLONY__DEBUG, "Colony::ProcessECUs() - Processing complete.  m_procTime %lli, expiryTime %lli, lastRunTime %lli", \
+                    m_procTime, ecu.second.expiryTime, ecu.second.lastRunTime);
     }
 }
 
+int64 Colony::GetNextEventTime()
+{
+    /* the only things that need server-side attention between views are ecu programs finishing.
+     * plant runs and routed transfers are caught up in batch by Update() when the owner next looks.
+     * @todo  add earliest storage-full time here once pin capacity (PI_Pin.capacity/quantity) is implemented
+     */
+    int64 next = 0;
+    for (auto cur : ccPin->pins) {
+        if (!cur.second.isECU)
+            continue;
+        if (cur.second.expiryTime <= m_procTime)
+            continue;
+        if ((next == 0) or (cur.second.expiryTime < next))
+            next = cur.second.expiryTime;
+    }
+    return next;
+}
+
+void Colony::ScheduleEvent(int64 time)
+{
+    if (time <= m_procTime)
+        return;
+    if ((m_nextEvent == 0) or (time < m_nextEvent))
+        m_nextEvent = time;
+}
+
 void Colony::ProcessPlants(bool& updateTimes)
 {
     if (ccPin->plants.empty() or (m_pLevel < 1))
@@ -54,6 +54,10 @@ public:
     void ProcessECUs(bool& save);
     void ProcessPlants(bool& save);
 
+    // earliest filetime something in this colony needs server-side attention (0 = nothing pending)
+    int64 GetNextEventTime();
+    void ScheduleEvent(int64 time);
+
     void RemovePin(uint32 pinID);
     void RemoveLink(uint32 src, uint32 dest);
     void RemoveRoute(uint16 routeID);
@@ -91,6 +95,7 @@ public:
 
     int8 GetLevel()                                     { return ccPin->level; }
     int64 GetSimTime()                                  { return m_procTime; }
+    PlanetSE* GetPlanetSE()                             { return m_pSE; }
 
 private:
     EVEServiceManager& m_svcMgr;
@@ -98,8 +103,6 @@ private:
     PI_CCPin* ccPin;
     Client* m_client;
 
-    Timer m_colonyTimer;
-
     PlanetDB m_db;
 
     bool m_active;
@@ -113,6 +116,7 @@ private:
     uint32 m_colonyID;
 
     int64 m_procTime;
+    int64 m_nextEvent;      // filetime of next forced update.  colony is otherwise only updated when owner views it
 
     std::vector<uint32> tempECUs;
     std::map<uint8, uint32> tempPinIDs;
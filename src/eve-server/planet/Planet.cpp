@@ -24,12 +24,15 @@
   */
 
 
+#include <random>
+
 #include "Client.h"
 #include "EVEServerConfig.h"
 #include "math/Trig.h"
 #include "planet/Colony.h"
 #include "planet/Planet.h"
 #include "planet/PlanetMgr.h"
+#include "planet/ResourceField.h"
 #include "planet/CustomsOffice.h"
 #include "packets/Planet.h"
 #include "pos/Structure.h"
@@ -76,50 +79,20 @@ bool PlanetSE::LoadExtras() {
     /** @todo save planet data after creation.  change data every x hours?days? */
 
     /*  quality: (min=1.0, max=154.275)  */
-    // these are relative indicators of material quantity.  makes no difference to ecu or extraction amount
+    // these are relative indicators of material quantity.  they also set the mean of each resource field.
+    // seeded from planetID so a planet shows the same resources across server restarts
     // as system matures, we will begin adjusting these (from extractor data) and saving per planet
+    std::mt19937 rng(m_self->itemID());
     float sysSec = (1.1 - m_system->GetSystemSecurityRating());    // 0.1 - 2.0
-    int min = round(sysSec *10);
-    m_data.dist_1 = MakeRandomInt(min, 75) * sysSec + MakeRandomFloat(0, 4);
-    m_data.dist_2 = MakeRandomInt(min, 75) * sysSec + MakeRandomFloat(0, 4);
-    m_data.dist_3 = MakeRandomInt(min, 75) * sysSec + MakeRandomFloat(0, 4);
-    m_data.dist_4 = MakeRandomInt(min, 75) * sysSec + MakeRandomFloat(0, 4);
-    m_data.dist_5 = MakeRandomInt(min, 75) * sysSec + MakeRandomFloat(0, 4);
-
-    //if (sysSec > 1) {
-        for (uint16 i=0; i<3600; ++i)  //this cannot use numList
-            m_data.buffer_1 += hexList[MakeRandomInt(0,15)];   // random fill buffer to capacity, 1k8 bytes.
-        for (uint16 i=0; i<3600; ++i)
-            m_data.buffer_2 += hexList[MakeRandomInt(0,15)];   // random fill buffer to capacity, 1k8 bytes.
-        for (uint16 i=0; i<3600; ++i)
-            m_data.buffer_3 += hexList[MakeRandomInt(0,15)];   // random fill buffer to capacity, 1k8 bytes.
-        for (uint16 i=0; i<3600; ++i)
-            m_data.buffer_4 += hexList[MakeRandomInt(0,15)];   // random fill buffer to capacity, 1k8 bytes.
-        for (uint16 i=0; i<3600; ++i)
-            m_data.buffer_5 += hexList[MakeRandomInt(0,15)];   // random fill buffer to capacity, 1k8 bytes.
-    /* } else {
-        for (uint16 i=0; i<1000; ++i) {
-            m_data.buffer_1 += asciiList[MakeRandomInt(0,57)];   // random fill buffer to capacity, 1k8 bytes.
-            m_data.buffer_2 += alphaList[MakeRandomInt(0,26)];   // random fill buffer to capacity, 1k8 bytes.
-            m_data.buffer_3 += numList[MakeRandomInt(0,10)];   // random fill buffer to capacity, 1k8 bytes.
-            m_data.buffer_4 += numList[MakeRandomInt(0,10)];   // random fill buffer to capacity, 1k8 bytes.
-            m_data.buffer_5 += numList[MakeRandomInt(0,10)];   // random fill buffer to capacity, 1k8 bytes.
-        }
-    } */
-/*
-    for (uint16 i=0; i<800; ++i) {
-        m_data.buffer_1 += std::to_string(0);
-        m_data.buffer_2 += std::to_string(0);
-        m_data.buffer_3 += std::to_string(0);
-        m_data.buffer_4 += std::to_string(0);
-        m_data.buffer_5 += std::to_string(0);
-    }
-*/
-    m_typeBuffers[m_data.type_1] = m_data.buffer_1;
-    m_typeBuffers[m_data.type_2] = m_data.buffer_2;
-    m_typeBuffers[m_data.type_3] = m_data.buffer_3;
-    m_typeBuffers[m_data.type_4] = m_data.buffer_4;
-    m_typeBuffers[m_data.type_5] = m_data.buffer_5;
+    std::uniform_int_distribution<int> qty(round(sysSec *10), 75);
+    std::uniform_real_distribution<float> var(0, 4);
+    m_data.dist_1 = qty(rng) * sysSec + var(rng);
+    m_data.dist_2 = qty(rng) * sysSec + var(rng);
+    m_data.dist_3 = qty(rng) * sysSec + var(rng);
+    m_data.dist_4 = qty(rng) * sysSec + var(rng);
+    m_data.dist_5 = qty(rng) * sysSec + var(rng);
+
+    // resource fields are generated on first request.  most planets are never scanned.
 
     // should we check for a CO here?
     //  no, it hasnt been loaded at this point
@@ -174,11 +147,12 @@ PyRep* PlanetSE::GetResourceData(Call_ResourceDataDict& dict)
     dict.remoteSensing;
     dict.updateTime;
     */
-    std::map<uint16, std::string>::iterator itr = m_typeBuffers.find(dict.resourceTypeID);
-    if (itr == m_typeBuffers.end())
+    const ResourceField* pField = GetResourceField(dict.resourceTypeID);
+    if (pField == nullptr)
         return nullptr;
-    uint16 size = (uint16)pow(dict.newBand, 2) *4;
-    std::string data = itr->second.substr(0, size);
+    // client asks for bands based on skills and proximity.  send only coeffs for those bands
+    std::string data = pField->GetData(dict.newBand);
+    uint16 size = data.size();
     // adjust data for system security.  not sure how to make it 'less' yet
     _log(PLANET__DEBUG, "PlanetSE::GetResourceData() for %s (%u) using remoteSense: %u, planetology: %u, advPlanetology: %u - updateTime: %u, proximity: %u, newBand: %u, oldBand: %u, bufferSize: %u", \
                 sPIDataMgr.GetProductName(dict.resourceTypeID), dict.resourceTypeID, dict.remoteSensing, dict.planetology, dict.advancedPlanetology, \
@@ -194,6 +168,29 @@ PyRep* PlanetSE::GetResourceData(Call_ResourceDataDict& dict)
     return rtn;
 }
 
+const ResourceField* PlanetSE::GetResourceField(uint16 typeID)
+{
+    float quality(0.0f);
+    if (typeID == m_data.type_1) {
+        quality = m_data.dist_1;
+    } else if (typeID == m_data.type_2) {
+        quality = m_data.dist_2;
+    } else if (typeID == m_data.type_3) {
+        quality = m_data.dist_3;
+    } else if (typeID == m_data.type_4) {
+        quality = m_data.dist_4;
+    } else if (typeID == m_data.type_5) {
+        quality = m_data.dist_5;
+    } else {
+        return nullptr;
+    }
+
+    ResourceField& field = m_fields[typeID];
+    if (!field.IsGenerated())
+        field.Generate((m_self->itemID() * 2654435761U) ^ typeID, quality);
+    return &field;
+}
+
 PyRep* PlanetSE::GetPlanetResourceInfo()
 {
     PyDict* res = new PyDict();
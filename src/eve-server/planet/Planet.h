@@ -14,6 +14,7 @@
 
 #include "EntityList.h"
 #include "StaticDataMgr.h"
+#include "planet/ResourceField.h"
 #include "system/SystemEntity.h"
 
 /** @todo update this to create a planet item instead of the default celestial item */
@@ -57,6 +58,8 @@ public:
     PyRep*                      GetPlanetInfo(Colony* pColony);
     PyRep*                      GetResourceData(Call_ResourceDataDict& dict);
     PyRep*                      GetPlanetResourceInfo();
+    // null if this planet doesnt have typeID.  field is generated on first call
+    const ResourceField*        GetResourceField(uint16 typeID);
     PyRep*                      GetExtractorsForPlanet(int32 planetID);
 
     void                        AbandonColony(Colony* pColony);
@@ -74,7 +77,7 @@ protected:
     PlanetResourceData          m_data;
 
 private:
-    std::map<uint16, std::string> m_typeBuffers;
+    std::map<uint16, ResourceField> m_fields;
 
     /* map of charID, Colony* for this planet.
      *   this is a hack, as the client will not reuse planet bound objects, instead calling for a new object on every call.
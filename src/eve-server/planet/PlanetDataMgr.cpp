@@ -26,8 +26,11 @@
 
 #include "inventory/ItemFactory.h"
 #include "inventory/InventoryItem.h"
+#include "math/Trig.h"
 #include "planet/PlanetDataMgr.h"
 #include "planet/Colony.h"
+#include "planet/Planet.h"
+#include "planet/ResourceField.h"
 
 PlanetDataMgr::PlanetDataMgr()
 {
@@ -223,10 +226,33 @@ PyRep* PIDataMgr::GetProgramResultInfo(Colony* pColony, uint32 pinID, uint16 typ
     int64 iCycleTime = cycleTime * EvE::Time::Hour;
 
     uint32 qtyPerCycle = GetProgramOutput(iRef, iCycleTime);
-    //qtyPerCycle *= heads->size();
 
-    _log(PLANET__TRACE, "PlanetMgr::GetProgramResultInfo() - cycleTime:%.2f, iCycleTime:%lli, length:%.2f, numCycles:%u, qtyPerCycle:%u, heads: %u, headRadius:%.4f", \
-                cycleTime, iCycleTime, length, numCycles, qtyPerCycle, heads->size(), headRadius);
+    // scale output by resource field value under each head.  this is the same field the client draws as the heat map
+    //  heads are (headID, latitude, longitude).  client uses theta = 2pi - longitude and clamps negative values to 0
+    float total(0.0f);
+    const ResourceField* pField = pColony->GetPlanetSE()->GetResourceField(typeID);
+    if ((pField != nullptr) and !heads->empty()) {
+        std::vector<float> theta, phi, value;
+        theta.reserve(heads->size());
+        phi.reserve(heads->size());
+        for (PyList::const_iterator itr = heads->begin(); itr != heads->end(); ++itr) {
+            if (!(*itr)->IsTuple())
+                continue;
+            PyTuple* head = (*itr)->AsTuple();
+            if (head->size() < 3)
+                continue;
+            phi.push_back(PyRep::FloatValue(head->GetItem(1)));
+            theta.push_back(EvE::Trig::Pi2 - PyRep::FloatValue(head->GetItem(2)));
+        }
+        value.resize(theta.size());
+        pField->GetValuesAt(theta.data(), phi.data(), value.data(), value.size());
+        for (auto cur : value)
+            total += EvE::max(cur);
+        qtyPerCycle *= total;
+    }
+
+    _log(PLANET__TRACE, "PlanetMgr::GetProgramResultInfo() - cycleTime:%.2f, iCycleTime:%lli, length:%.2f, numCycles:%u, qtyPerCycle:%u, heads: %u, headRadius:%.4f, fieldTotal:%.3f", \
+                cycleTime, iCycleTime, length, numCycles, qtyPerCycle, heads->size(), headRadius, total);
 
     PyTuple* res = new PyTuple(3);
         res->SetItem(0, new PyInt(qtyPerCycle));    //qtyToDistribute  (2843)
@@ -0,0 +1,180 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+
+#include "eve-server.h"
+
+#include <random>
+
+#include "math/Trig.h"
+#include "planet/ResourceField.h"
+
+/* evaluation uses the standard associated legendre recurrences, across a block of points at once:
+ *    P(m,m)   = -(2m-1) * sin(phi) * P(m-1,m-1)
+ *    P(m+1,m) = (2m+1) * cos(phi) * P(m,m)
+ *    P(l,m)   = ((2l-1) * cos(phi) * P(l-1,m) - (l+m-1) * P(l-2,m)) / (l-m)
+ *  and cos(m*theta)/sin(m*theta) by angle addition, so each point costs one sin/cos pair per angle
+ *  no matter how many bands are used.  normalization is folded into m_scaled when the field is generated.
+ */
+
+ResourceField::ResourceField()
+{
+    m_coeff.clear();
+    m_scaled.clear();
+}
+
+void ResourceField::Generate(uint32 seed, float quality)
+{
+    uint16 size = MaxBands * MaxBands;
+    m_coeff.resize(size);
+    m_scaled.resize(size);
+
+    /*  quality: (min=1.0, max=154.275)
+     *  client shows quality relative to planetResourceMaxValue (1.21).  set mean of field to about half of that
+     *  at max quality, and let higher bands add detail with decreasing amplitude.
+     */
+    std::mt19937 rng(seed);
+    double mean = EvE::max(quality, 1.0f) / 154.275 * 0.6;
+    double c00 = mean * 2.0 * sqrt(EvE::Trig::Pi);     // Y(0,0) = 1 / (2 * sqrt(pi))
+    m_coeff[0] = (float)c00;
+    for (uint8 l = 1; l < MaxBands; ++l) {
+        std::normal_distribution<double> dist(0.0, c00 * 0.5 / (l + 1));
+        for (int8 m = -l; m <= l; ++m)
+            m_coeff[l * (l + 1) + m] = (float)dist(rng);
+    }
+
+    // K(l,m) = sqrt((2l+1)/(4pi) * (l-m)!/(l+m)!), times sqrt(2) for m != 0
+    for (uint8 l = 0; l < MaxBands; ++l) {
+        for (uint8 m = 0; m <= l; ++m) {
+            double k = sqrt((2 * l + 1) / (4.0 * EvE::Trig::Pi) * exp(lgamma(l - m + 1) - lgamma(l + m + 1)));
+            if (m == 0) {
+                m_scaled[l * (l + 1)] = m_coeff[l * (l + 1)] * k;
+            } else {
+                k *= sqrt(2.0);
+                m_scaled[l * (l + 1) + m] = m_coeff[l * (l + 1) + m] * k;
+                m_scaled[l * (l + 1) - m] = m_coeff[l * (l + 1) - m] * k;
+            }
+        }
+    }
+}
+
+std::string ResourceField::GetData(uint8 numBands) const
+{
+    if (numBands > MaxBands)
+        numBands = MaxBands;
+    if (m_coeff.empty() or (numBands < 1))
+        return "";
+    // coeffs are sent as a raw float array.  client and server are both little-endian.
+    return std::string((const char*)m_coeff.data(), numBands * numBands * sizeof(float));
+}
+
+float ResourceField::GetValueAt(float theta, float phi, uint8 numBands/*MaxBands*/) const
+{
+    float out(0.0f);
+    GetValuesAt(&theta, &phi, &out, 1, numBands);
+    return out;
+}
+
+void ResourceField::GetValuesAt(const float* theta, const float* phi, float* out, uint32 count, uint8 numBands/*MaxBands*/) const
+{
+    if (numBands > MaxBands)
+        numBands = MaxBands;
+    if (m_scaled.empty() or (numBands < 1)) {
+        for (uint32 i = 0; i < count; ++i)
+            out[i] = 0.0f;
+        return;
+    }
+
+    for (uint32 i = 0; i < count; i += BlockSize)
+        EvaluateBlock(theta + i, phi + i, out + i, (uint8)std::min(count - i, (uint32)BlockSize), numBands);
+}
+
+void ResourceField::EvaluateBlock(const float* theta, const float* phi, float* out, uint8 count, uint8 numBands) const
+{
+    // unused lanes are zeroed and computed anyway.  keeps loops fixed-length so they vectorize
+    double x[BlockSize], s[BlockSize], ct[BlockSize], st[BlockSize], cm[BlockSize], sm[BlockSize], tmp[BlockSize];
+    double pmm[BlockSize], p0[BlockSize], p1[BlockSize], p2[BlockSize], acc[BlockSize];
+    for (uint8 k = 0; k < BlockSize; ++k) {
+        double t = (k < count ? theta[k] : 0.0), p = (k < count ? phi[k] : 0.0);
+        x[k] = cos(p);
+        s[k] = sin(p);
+        ct[k] = cos(t);
+        st[k] = sin(t);
+        cm[k] = 1.0;
+        sm[k] = 0.0;
+        pmm[k] = 1.0;
+        acc[k] = 0.0;
+    }
+
+    uint16 idx(0);
+    double a(0), b(0);
+    for (uint8 m = 0; m < numBands; ++m) {
+        if (m > 0) {
+            a = -(2.0 * m - 1.0);
+            for (uint8 k = 0; k < BlockSize; ++k) {
+                pmm[k] *= a * s[k];
+                tmp[k] = cm[k] * ct[k] - sm[k] * st[k];
+                sm[k] = sm[k] * ct[k] + cm[k] * st[k];
+                cm[k] = tmp[k];
+            }
+        }
+
+        for (uint8 l = m; l < numBands; ++l) {
+            if (l == m) {
+                for (uint8 k = 0; k < BlockSize; ++k)
+                    p2[k] = pmm[k];
+            } else if (l == m + 1) {
+                a = 2.0 * m + 1.0;
+                for (uint8 k = 0; k < BlockSize; ++k)
+                    p2[k] = a * x[k] * pmm[k];
+            } else {
+                a = (2.0 * l - 1.0) / (l - m);
+                b = (l + m - 1.0) / (l - m);
+                for (uint8 k = 0; k < BlockSize; ++k)
+                    p2[k] = a * x[k] * p1[k] - b * p0[k];
+            }
+
+            idx = l * (l + 1);
+            if (m == 0) {
+                a = m_scaled[idx];
+                for (uint8 k = 0; k < BlockSize; ++k)
+                    acc[k] += a * p2[k];
+            } else {
+                a = m_scaled[idx + m];
+                b = m_scaled[idx - m];
+                for (uint8 k = 0; k < BlockSize; ++k)
+                    acc[k] += (a * cm[k] + b * sm[k]) * p2[k];
+            }
+
+            for (uint8 k = 0; k < BlockSize; ++k) {
+                p0[k] = p1[k];
+                p1[k] = p2[k];
+            }
+        }
+    }
+
+    for (uint8 k = 0; k < count; ++k)
+        out[k] = (float)acc[k];
+}
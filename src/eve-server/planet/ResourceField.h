@@ -0,0 +1,76 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+
+#ifndef EVEMU_PLANET_RESOURCEFIELD_H_
+#define EVEMU_PLANET_RESOURCEFIELD_H_
+
+#include <string>
+#include <vector>
+
+#include "eve-core.h"
+
+/* spherical-harmonic resource distribution for one resource type on one planet.
+ *  this is the same data the client gets from GetResourceData() and draws as the resource heat map,
+ *  so anything we evaluate here (extractor heads, mostly) matches what the player sees.
+ *
+ *  coefficients are real, orthonormal SH with Condon-Shortley phase, stored l-major as index l*(l+1)+m.
+ *  they are generated from a seed (planetID/typeID), so a planet always has the same field
+ *  without having to save anything.
+ *
+ *  client calls are band-limited by skills.  band truncation here is just "use the first numBands^2 coefficients"
+ */
+class ResourceField
+{
+public:
+    ResourceField();
+    ~ResourceField()                                    { /* do nothing here */ }
+
+    // max bands client will ask for (planetResourceProximityLimits)
+    static const uint8 MaxBands = 30;
+
+    void Generate(uint32 seed, float quality);
+
+    bool IsGenerated() const                            { return !m_coeff.empty(); }
+
+    // raw little-endian float32 coefficients for first numBands bands, as sent to client
+    std::string GetData(uint8 numBands) const;
+
+    // evaluate field at a single point.  theta is longitude (0..2pi), phi is colatitude (0..pi)
+    float GetValueAt(float theta, float phi, uint8 numBands = MaxBands) const;
+    // evaluate field at 'count' points.  this is the fast path, and should be used for more than one point
+    void GetValuesAt(const float* theta, const float* phi, float* out, uint32 count, uint8 numBands = MaxBands) const;
+
+private:
+    // points evaluated together.  inner loops run across the block so the compiler can vectorize them
+    static const uint8 BlockSize = 8;
+
+    void EvaluateBlock(const float* theta, const float* phi, float* out, uint8 count, uint8 numBands) const;
+
+    std::vector<float> m_coeff;     // as sent to client
+    std::vector<double> m_scaled;   // coeff * normalization constant, used for evaluation
+};
+
+#endif  // EVEMU_PLANET_RESOURCEFIELD_H_
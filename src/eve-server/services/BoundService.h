@@ -202,7 +202,7 @@ protected:
      */
     template <class H, class... Args>
     void Add(const std::string& name, PyResult(H::*callHandler)(PyCallArgs&, Args...)) {
-        this->mHandlers.push_back(std::make_pair(std::string(name), new CallHandler <H> (callHandler)));
+        this->mHandlers.push_back(std::make_pair(PyString::Intern(name), new CallHandler <H> (callHandler)));
     }
 
 public:
@@ -213,8 +213,16 @@ public:
         if (this->CanClientCall(args.client) == false)
             throw CustomError("This client is not allowed to call this bound service");
 
-        for (auto handler : this->mHandlers) {
-            if (handler.first != name)
+        // handler names are interned; a name that isn't can't match any of them
+        const PyString* method = PyString::Lookup(name.data(), name.size());
+        if (method == nullptr)
+            throw method_not_found ();
+
+        // bound objects come and go, so no name for the detail
+        TRACE_SPAN(method->content().c_str(), "bound object");
+
+        for (auto& handler : this->mHandlers) {
+            if (handler.first != method)
                 continue;
 
             try
@@ -236,8 +244,8 @@ public:
     std::string DebugDispatch (const std::string& name) override {
         std::string result = name + " candidates: \n";
 
-        for (auto handler : this->mHandlers) {
-            if (handler.first != name)
+        for (auto& handler : this->mHandlers) {
+            if (handler.first->content() != name)
                 continue;
 
             result += "\t(" + handler.second->getSignature () + ")";
@@ -313,8 +321,8 @@ private:
     BoundServiceParent<Bound>& mParent;
     /** @var The numeric ID of the bound service */
     BoundID mBoundId;
-    /** @var The map of handlers for this service */
-    std::vector <std::pair <std::string, CallHandlerBase*>> mHandlers;
+    /** @var The map of handlers for this service, by interned method name */
+    std::vector <std::pair <PyString*, CallHandlerBase*>> mHandlers;
     /** @var The clients that have access to this bound service */
     std::map <Client*, bool> mClients;
 };
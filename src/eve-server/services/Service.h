@@ -33,6 +33,7 @@
 
 #include "eve-server.h"
 #include "services/Callable.h"
+#include "utils/Trace.h"
 
 template<class T>
 class Service;
@@ -79,7 +80,7 @@ protected:
      */
     template <class H, class... Args>
     void Add(const std::string& name, PyResult(H::*callHandler)(PyCallArgs&, Args...)) {
-        this->mHandlers.push_back(std::make_pair(std::string(name), new CallHandler <H> (callHandler)));
+        this->mHandlers.push_back(std::make_pair(PyString::Intern(name), new CallHandler <H> (callHandler)));
     }
 
 public:
@@ -92,8 +93,16 @@ public:
      * @brief Handles dispatching a call to this service
      */
     PyResult Dispatch(const std::string& name, PyCallArgs& args) override {
-        for (auto handler : this->mHandlers) {
-            if (handler.first != name)
+        // handler names are interned; a name that isn't can't match any of them
+        const PyString* method = PyString::Lookup(name.data(), name.size());
+        if (method == nullptr)
+            throw method_not_found ();
+
+        // interned names and services both live for the process, as spans need
+        TRACE_SPAN(method->content().c_str(), this->mName.c_str());
+
+        for (auto& handler : this->mHandlers) {
+            if (handler.first != method)
                 continue;
 
             try
@@ -115,8 +124,8 @@ public:
     std::string DebugDispatch (const std::string& name) override {
         std::string result = GetName () + "::" + name + " candidates: \n";
 
-        for (auto handler : this->mHandlers) {
-            if (handler.first != name)
+        for (auto& handler : this->mHandlers) {
+            if (handler.first->content() != name)
                 continue;
 
             result += "\t(" + handler.second->getSignature () + ")";
@@ -131,8 +140,8 @@ private:
     std::string mName;
     /** @var The access level required to access this service */
     AccessLevel mAccessLevel;
-    /** @var The map of handlers for this service */
-    std::vector <std::pair <std::string, CallHandlerBase*>> mHandlers;
+    /** @var The map of handlers for this service, by interned method name */
+    std::vector <std::pair <PyString*, CallHandlerBase*>> mHandlers;
 };
 
 #endif /* !__SERVICE_H__ */
\ No newline at end of file
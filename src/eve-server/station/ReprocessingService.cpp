@@ -104,7 +104,7 @@ PyResult ReprocessingServiceBound::GetOptionsForItemTypes(PyCallArgs &call, PyDi
         }
 
         const PyInt* k = dict_2_cur->first->AsInt();
-        typeIDMap[k->value()] = dict_2_cur->second->Clone();
+        typeIDMap[k->value()] = dict_2_cur->second;
     }
 
     Rsp_GetOptionsForItemTypes      rsp;
@@ -511,8 +511,7 @@ BoundDispatcher* TradeService::BindObject(Client* client, PyRep* bindParameters)
     //   create code for multiple sessions per client, using TradeBound and TradeSession.
     Trade_BindArgs args;
     //crap
-    PyRep* tmp(bindParameters->Clone());
-    if (!args.Decode(&tmp)) {
+    if (!args.Decode(bindParameters)) {
         codelog(SERVICE__ERROR, "%s: Failed to decode bind args.", GetName());
         return nullptr;
     }
@@ -613,7 +612,9 @@ PyResult TradeService::InitiateTrade(PyCallArgs &call, PyInt* characterID) {
     PyTuple* tuple = new PyTuple(3);
     tuple->SetItem(0, new PyString("Initiate"));
     tuple->SetItem(1, new PyInt(call.client->GetCharacterID()));
-    tuple->SetItem(2, resp->Clone());
+    // resp is also our return value
+    PyIncRef(resp);
+    tuple->SetItem(2, resp);
     // now send it, bypassing the extra shit and wrong dest name added in Client::SendNotification
     call.client->SendNotification("OnTrade", "charid", &tuple);
     return resp;
@@ -70,7 +70,7 @@ void BubbleManager::clear() {
     sLog.Warning("        BubbleMgr", "Bubble Manager has been closed." );
 }
 
-void BubbleManager::Process() {
+void BubbleManager::Process(bool checkWanderers/*true*/) {
     double profileStartTime(GetTimeUSeconds());
 
     for (auto cur : m_bubbles) {
@@ -82,7 +82,7 @@ void BubbleManager::Process() {
             cur->Process();
     }
 
-    if (m_wanderTimer.Check()) {    //60s
+    if (checkWanderers and m_wanderTimer.Check()) {    //60s
         m_wanderers.clear();
         std::list<SystemBubble*>::iterator itr = m_bubbles.begin();
         while (itr != m_bubbles.end()) {
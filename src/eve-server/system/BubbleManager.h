@@ -51,7 +51,8 @@ public:
     ~BubbleManager();
 
     int Initialize();
-    void Process();
+    // checkWanderers=false leaves the 60s wanderer check due for a later, lighter tic
+    void Process(bool checkWanderers=true);
 
     // call to check for and remove empty bubbles from bubble vector
     void RemoveEmpty();
@@ -603,24 +603,23 @@ void DestinyManager::CheckBump()
 
     // NOTE:  object's "massive = true" means it can bump/collide  (massive = solid)
 
-    // initial implementation will ONLY check player ships for bumping.
-    std::vector<Client*> vPlayers;
-    mySE->SysBubble()->GetPlayers(vPlayers);
-    Client* pClient = mySE->GetPilot();
+    // candidates come from bubble's broadphase, which is built once per tic and includes ships, npcs and structures
+    std::vector<SystemEntity*> vCandidates;
+    mySE->SysBubble()->GetBumpCandidates(mySE, vCandidates);
     GPoint pos(GetPosition());
-    float distance = 0.0f;
-    for (auto cur : vPlayers) {
-        if (cur == pClient)
-            continue;
-        distance = pos.distance(cur->GetShipSE()->GetPosition());
-        distance -= (mySE->GetRadius() - cur->GetShipSE()->GetRadius());
+    double distance(0.0);
+    bool bump(false);
+    for (auto cur : vCandidates) {
+        // distance between hulls, not centers
+        distance = pos.distance(cur->GetPosition());
+        distance -= (mySE->GetRadius() + cur->GetRadius());
         if (distance < BUMP_DISTANCE) {
-            Bump(cur->GetShipSE());
-            m_bump = true;
-        } else {
-            m_bump = false;
+            Bump(cur);
+            bump = true;
         }
     }
+    // m_bump is set after checking all candidates, so each new contact this tic gets a msg
+    m_bump = bump;
     /** @todo  add data and checks for each ship bumped
      * to give single bump msg for each ship combo
      * without spamming their overview
@@ -654,10 +653,9 @@ void DestinyManager::Bump(SystemEntity* pSE)
      *   bump drones??  prolly not, for simplicity
      */
     std::string msg1 = "You have bumped ";
-    msg1 += pSE->GetPilot()->GetName();
+    msg1 += (pSE->HasPilot() ? pSE->GetPilot()->GetName() : pSE->GetName());
     mySE->GetPilot()->SendNotifyMsg(msg1.c_str());
-    // this test isnt needed right now, as it's ONLY checking against players and will always return true.
-    //  will keep it in here for later expansion.
+    // npcs and structures dont get msgs
     if (pSE->HasPilot()) {
         std::string msg2 = "You have been bumped by ";
         msg2 += mySE->GetPilot()->GetName();
@@ -899,7 +897,7 @@ void DestinyManager::MoveObject() {
     }
 
     if (sConfig.cosmic.BumpEnabled)
-        if (mySE->HasPilot() and mySE->SysBubble()->HasPlayers()) // no players in bubble = nothing to check against (for now)
+        if (mySE->HasPilot() and (mySE->SysBubble() != nullptr)) // only piloted ships check for bumps
             CheckBump();
 }
 
@@ -0,0 +1,392 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+#include "eve-server.h"
+
+#include "system/SpatialIndex.h"
+#include "system/SystemEntity.h"
+
+/* root cell is 2^48m (~1900AU) on a side, which covers every k-space and w-space system.
+ * anything outside that is kept in the root node and always tested.
+ * cells stop splitting at 2^17m (~130km) which is about a grid, so a cell rarely holds more than a single bubble.
+ */
+static const double ROOT_HALF_SIZE = 140737488355328.0;     // 2^47
+static const double MIN_HALF_SIZE = 65536.0;                // 2^16
+static const double LOOSE_FACTOR = 1.5;
+static const uint16 SPLIT_COUNT = 16;
+static const uint16 MERGE_COUNT = 8;
+static const double SQRT_3 = 1.7320508075688772;
+
+
+SpatialIndex::SpatialIndex()
+: m_root(nullptr)
+{
+    m_lookup.clear();
+    m_root = NewNode(nullptr, NULL_ORIGIN, ROOT_HALF_SIZE);
+}
+
+SpatialIndex::~SpatialIndex()
+{
+    DeleteNode(m_root);
+}
+
+void SpatialIndex::Clear()
+{
+    DeleteNode(m_root);
+    m_lookup.clear();
+    m_root = NewNode(nullptr, NULL_ORIGIN, ROOT_HALF_SIZE);
+}
+
+SpatialIndex::Node* SpatialIndex::NewNode(Node* parent, const GPoint& center, double halfSize)
+{
+    Node* pNode = new Node();
+        pNode->center = center;
+        pNode->halfSize = halfSize;
+        pNode->count = 0;
+        pNode->parent = parent;
+    for (uint8 i = 0; i < 8; ++i)
+        pNode->child[i] = nullptr;
+    return pNode;
+}
+
+void SpatialIndex::DeleteNode(Node* pNode)
+{
+    if (pNode == nullptr)
+        return;
+    for (uint8 i = 0; i < 8; ++i)
+        DeleteNode(pNode->child[i]);
+    SafeDelete(pNode);
+}
+
+uint8 SpatialIndex::Octant(const Node* pNode, const GPoint& pos) const
+{
+    uint8 idx(0);
+    if (pos.x >= pNode->center.x)
+        idx |= 1;
+    if (pos.y >= pNode->center.y)
+        idx |= 2;
+    if (pos.z >= pNode->center.z)
+        idx |= 4;
+    return idx;
+}
+
+bool SpatialIndex::InLooseBounds(const Node* pNode, const GPoint& pos) const
+{
+    if (pNode == m_root)
+        return true;
+    double loose(pNode->halfSize * LOOSE_FACTOR);
+    if (std::fabs(pos.x - pNode->center.x) > loose)
+        return false;
+    if (std::fabs(pos.y - pNode->center.y) > loose)
+        return false;
+    if (std::fabs(pos.z - pNode->center.z) > loose)
+        return false;
+    return true;
+}
+
+double SpatialIndex::LooseDistance2(const Node* pNode, const GPoint& pos) const
+{
+    // squared distance from pos to node's loose bounds.  0 if inside
+    if (pNode == m_root)
+        return 0.0;
+    double loose(pNode->halfSize * LOOSE_FACTOR), dist2(0.0), d(0.0);
+    d = std::fabs(pos.x - pNode->center.x) - loose;
+    if (d > 0)
+        dist2 += d * d;
+    d = std::fabs(pos.y - pNode->center.y) - loose;
+    if (d > 0)
+        dist2 += d * d;
+    d = std::fabs(pos.z - pNode->center.z) - loose;
+    if (d > 0)
+        dist2 += d * d;
+    return dist2;
+}
+
+void SpatialIndex::Insert(SystemEntity* pSE)
+{
+    if (pSE == nullptr)
+        return;
+    if (Contains(pSE->GetID())) {
+        Update(pSE);
+        return;
+    }
+    InsertInto(m_root, pSE, pSE->GetPosition());
+}
+
+void SpatialIndex::InsertInto(Node* pNode, SystemEntity* pSE, const GPoint& pos)
+{
+    // descend to leaf containing pos.  positions outside root are kept in root.
+    if ((pNode == m_root)
+    and ((std::fabs(pos.x) > pNode->halfSize) or (std::fabs(pos.y) > pNode->halfSize) or (std::fabs(pos.z) > pNode->halfSize))) {
+        ++pNode->count;
+        pNode->items.push_back(pSE);
+        m_lookup[pSE->GetID()] = Entry{pNode, pSE};
+        return;
+    }
+    while (!pNode->IsLeaf()) {
+        ++pNode->count;
+        pNode = pNode->child[Octant(pNode, pos)];
+    }
+    ++pNode->count;
+    pNode->items.push_back(pSE);
+    m_lookup[pSE->GetID()] = Entry{pNode, pSE};
+
+    if ((pNode->items.size() > SPLIT_COUNT) and (pNode->halfSize > MIN_HALF_SIZE))
+        Split(pNode);
+}
+
+void SpatialIndex::Split(Node* pNode)
+{
+    double half(pNode->halfSize / 2);
+    for (uint8 i = 0; i < 8; ++i) {
+        GPoint center(pNode->center.x + ((i & 1) ? half : -half),
+                      pNode->center.y + ((i & 2) ? half : -half),
+                      pNode->center.z + ((i & 4) ? half : -half));
+        pNode->child[i] = NewNode(pNode, center, half);
+    }
+
+    /* push items down into children.  root keeps anything outside its bounds.
+     * items in a leaf may have drifted into its loose margin, which can be outside the loose bounds of the child
+     *  they would go in.  those are pulled out and re-inserted from root.
+     */
+    std::vector<SystemEntity*> items, drifted;
+    items.swap(pNode->items);
+    double h(pNode->halfSize);
+    for (auto cur : items) {
+        const GPoint& pos(cur->GetPosition());
+        bool outside((std::fabs(pos.x - pNode->center.x) > h) or (std::fabs(pos.y - pNode->center.y) > h) or (std::fabs(pos.z - pNode->center.z) > h));
+        if (outside) {
+            if (pNode == m_root) {
+                pNode->items.push_back(cur);
+            } else {
+                drifted.push_back(cur);
+            }
+            continue;
+        }
+        Node* pChild = pNode->child[Octant(pNode, pos)];
+        ++pChild->count;
+        pChild->items.push_back(cur);
+        m_lookup[cur->GetID()].node = pChild;
+    }
+
+    // a single child may still be overfull if everything is stacked together
+    for (uint8 i = 0; i < 8; ++i)
+        if ((pNode->child[i]->items.size() > SPLIT_COUNT) and (pNode->child[i]->halfSize > MIN_HALF_SIZE))
+            Split(pNode->child[i]);
+
+    for (auto cur : drifted) {
+        for (Node* pParent = pNode; pParent != nullptr; pParent = pParent->parent)
+            --pParent->count;
+        m_lookup.erase(cur->GetID());
+        InsertInto(m_root, cur, cur->GetPosition());
+    }
+}
+
+void SpatialIndex::Merge(Node* pNode)
+{
+    // pull all items from children back into this node, then delete children
+    for (uint8 i = 0; i < 8; ++i) {
+        Node* pChild = pNode->child[i];
+        if (!pChild->IsLeaf())
+            Merge(pChild);
+        for (auto cur : pChild->items) {
+            pNode->items.push_back(cur);
+            m_lookup[cur->GetID()].node = pNode;
+        }
+        pChild->items.clear();
+        DeleteNode(pChild);
+        pNode->child[i] = nullptr;
+    }
+}
+
+void SpatialIndex::Remove(uint32 entityID)
+{
+    std::unordered_map<uint32, Entry>::iterator itr = m_lookup.find(entityID);
+    if (itr == m_lookup.end())
+        return;
+
+    Node* pNode = itr->second.node;
+    std::vector<SystemEntity*>::iterator iItr = std::find(pNode->items.begin(), pNode->items.end(), itr->second.pSE);
+    if (iItr != pNode->items.end()) {
+        *iItr = pNode->items.back();
+        pNode->items.pop_back();
+    }
+    m_lookup.erase(itr);
+
+    // update counts up the tree, and collapse the highest node which has gotten sparse
+    Node* pMerge(nullptr);
+    while (pNode != nullptr) {
+        --pNode->count;
+        if (!pNode->IsLeaf() and (pNode->count <= MERGE_COUNT))
+            pMerge = pNode;
+        pNode = pNode->parent;
+    }
+    if (pMerge != nullptr)
+        Merge(pMerge);
+}
+
+void SpatialIndex::Update(SystemEntity* pSE)
+{
+    std::unordered_map<uint32, Entry>::iterator itr = m_lookup.find(pSE->GetID());
+    if (itr == m_lookup.end())
+        return;
+
+    const GPoint& pos(pSE->GetPosition());
+    Node* pNode = itr->second.node;
+    // still in loose bounds of a leaf = nothing to do.  this is the common case for ships moving in a grid
+    if (pNode->IsLeaf() and InLooseBounds(pNode, pos))
+        return;
+
+    Remove(pSE->GetID());
+    InsertInto(m_root, pSE, pos);
+}
+
+void SpatialIndex::QuerySphere(const GPoint& center, double range, std::vector<SystemEntity*>& into, const SpatialFilter& filter/*nullptr*/) const
+{
+    QuerySphere(m_root, center, range, into, filter);
+}
+
+void SpatialIndex::QuerySphere(const Node* pNode, const GPoint& center, double range, std::vector<SystemEntity*>& into, const SpatialFilter& filter) const
+{
+    if ((pNode->count == 0) or (LooseDistance2(pNode, center) > range * range))
+        return;
+
+    for (auto cur : pNode->items) {
+        if (center.distance(cur->GetPosition()) >= range)
+            continue;
+        if (filter and !filter(cur))
+            continue;
+        into.push_back(cur);
+    }
+
+    if (pNode->IsLeaf())
+        return;
+    for (uint8 i = 0; i < 8; ++i)
+        QuerySphere(pNode->child[i], center, range, into, filter);
+}
+
+void SpatialIndex::QueryCone(const GPoint& vertex, const GVector& axis, double halfAngle, double range, std::vector<SystemEntity*>& into, const SpatialFilter& filter/*nullptr*/) const
+{
+    GVector U(axis);
+    U.normalize();
+    QueryCone(m_root, vertex, U, std::cos(halfAngle), halfAngle, range, into, filter);
+}
+
+void SpatialIndex::QueryCone(const Node* pNode, const GPoint& vertex, const GVector& axis, double cosAngle, double halfAngle, double range, std::vector<SystemEntity*>& into, const SpatialFilter& filter) const
+{
+    if ((pNode->count == 0) or (LooseDistance2(pNode, vertex) > range * range))
+        return;
+
+    /* reject node if its bounding sphere is entirely outside the cone.
+     *  angle from axis to node center, less the angle subtended by the bounding sphere, must be inside halfAngle
+     */
+    if (pNode != m_root) {
+        GVector toNode(vertex, pNode->center);
+        double dist(toNode.length()), radius(pNode->halfSize * LOOSE_FACTOR * SQRT_3);
+        if (dist > radius) {
+            double angle(std::acos(EvE::max(-1.0, EvE::min(1.0, toNode.dotProduct(axis) / dist))));
+            if (angle - std::asin(radius / dist) > halfAngle)
+                return;
+        }
+    }
+
+    for (auto cur : pNode->items) {
+        GVector VR(vertex, cur->GetPosition());
+        double dist(VR.length());
+        if (dist >= range)
+            continue;
+        // entity at vertex is ourself.  client doesnt list that
+        if (dist == 0.0)
+            continue;
+        if (VR.dotProduct(axis) / dist < cosAngle)
+            continue;
+        if (filter and !filter(cur))
+            continue;
+        into.push_back(cur);
+    }
+
+    if (pNode->IsLeaf())
+        return;
+    for (uint8 i = 0; i < 8; ++i)
+        QueryCone(pNode->child[i], vertex, axis, cosAngle, halfAngle, range, into, filter);
+}
+
+void SpatialIndex::QueryNearest(const GPoint& pos, uint16 count, double range, std::vector<SystemEntity*>& into, const SpatialFilter& filter/*nullptr*/) const
+{
+    if (count == 0)
+        return;
+
+    /* best-first search.  nodes are visited closest first, and search stops when
+     * the closest remaining node is further than the furthest of our current results.
+     */
+    typedef std::pair<double, const Node*> NodeDist;
+    typedef std::pair<double, SystemEntity*> ItemDist;
+    std::priority_queue<NodeDist, std::vector<NodeDist>, std::greater<NodeDist>> nodeQueue;
+    std::priority_queue<ItemDist> results;    // max-heap, so furthest result is on top
+    double range2(range * range);
+
+    nodeQueue.push(NodeDist(0.0, m_root));
+    while (!nodeQueue.empty()) {
+        NodeDist top = nodeQueue.top();
+        nodeQueue.pop();
+        if (top.first > range2)
+            break;
+        if ((results.size() >= count) and (top.first > results.top().first))
+            break;
+
+        const Node* pNode = top.second;
+        for (auto cur : pNode->items) {
+            GVector VR(pos, cur->GetPosition());
+            double dist2(VR.lengthSquared());
+            if (dist2 >= range2)
+                continue;
+            if ((results.size() >= count) and (dist2 >= results.top().first))
+                continue;
+            if (filter and !filter(cur))
+                continue;
+            results.push(ItemDist(dist2, cur));
+            if (results.size() > count)
+                results.pop();
+        }
+
+        if (pNode->IsLeaf())
+            continue;
+        for (uint8 i = 0; i < 8; ++i)
+            if (pNode->child[i]->count > 0)
+                nodeQueue.push(NodeDist(LooseDistance2(pNode->child[i], pos), pNode->child[i]));
+    }
+
+    // results come off the heap furthest first
+    size_t start(into.size());
+    while (!results.empty()) {
+        into.push_back(results.top().second);
+        results.pop();
+    }
+    std::reverse(into.begin() + start, into.end());
+}
@@ -0,0 +1,105 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#ifndef __SPATIALINDEX_H_INCL__
+#define __SPATIALINDEX_H_INCL__
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "eve-core.h"
+
+class SystemEntity;
+
+/* loose octree of all entities in a solar system.
+ *  SystemManager owns one of these, and keeps it current from AddEntity/RemoveEntity
+ *  and from SystemEntity::SetPosition() (which all destiny movement goes thru).
+ *  nodes are "loose" (bounds expanded by LOOSE_FACTOR) so ships moving back and forth
+ *  across a cell boundary dont cause constant remove/insert churn.
+ *
+ * queries only return entities that pass the (optional) filter.
+ *  sphere and cone queries return results in no specific order.
+ *  nearest query returns results sorted by distance, closest first.
+ */
+typedef std::function<bool(SystemEntity*)> SpatialFilter;
+
+class SpatialIndex
+{
+public:
+    SpatialIndex();
+    ~SpatialIndex();
+
+    void Clear();
+    void Insert(SystemEntity* pSE);
+    void Remove(uint32 entityID);
+    // call when entity has moved.  does nothing if entity isnt indexed
+    void Update(SystemEntity* pSE);
+
+    bool Contains(uint32 entityID) const                { return (m_lookup.find(entityID) != m_lookup.end()); }
+    uint32 Count() const                                { return m_lookup.size(); }
+
+    // all entities where distance(center) < range
+    void QuerySphere(const GPoint& center, double range, std::vector<SystemEntity*>& into, const SpatialFilter& filter = nullptr) const;
+    // all entities within range of vertex, and within halfAngle (radians) of axis
+    void QueryCone(const GPoint& vertex, const GVector& axis, double halfAngle, double range, std::vector<SystemEntity*>& into, const SpatialFilter& filter = nullptr) const;
+    // closest 'count' entities within range of pos, sorted by distance
+    void QueryNearest(const GPoint& pos, uint16 count, double range, std::vector<SystemEntity*>& into, const SpatialFilter& filter = nullptr) const;
+
+protected:
+    struct Node {
+        GPoint center;
+        double halfSize;
+        uint32 count;                       // entities in this node and all children
+        Node* parent;
+        Node* child[8];                     // all null for leaf
+        std::vector<SystemEntity*> items;   // we do not own these
+
+        bool IsLeaf() const                             { return (child[0] == nullptr); }
+    };
+
+    struct Entry {
+        Node* node;
+        SystemEntity* pSE;                  // we do not own this
+    };
+
+    Node* NewNode(Node* parent, const GPoint& center, double halfSize);
+    void DeleteNode(Node* pNode);
+    void Split(Node* pNode);
+    void Merge(Node* pNode);
+    void InsertInto(Node* pNode, SystemEntity* pSE, const GPoint& pos);
+    uint8 Octant(const Node* pNode, const GPoint& pos) const;
+    bool InLooseBounds(const Node* pNode, const GPoint& pos) const;
+    double LooseDistance2(const Node* pNode, const GPoint& pos) const;
+
+    void QuerySphere(const Node* pNode, const GPoint& center, double range, std::vector<SystemEntity*>& into, const SpatialFilter& filter) const;
+    void QueryCone(const Node* pNode, const GPoint& vertex, const GVector& axis, double cosAngle, double halfAngle, double range, std::vector<SystemEntity*>& into, const SpatialFilter& filter) const;
+
+private:
+    Node* m_root;
+    std::unordered_map<uint32, Entry> m_lookup;
+};
+
+#endif  // __SPATIALINDEX_H_INCL__
@@ -51,6 +51,7 @@ m_sbuSE(nullptr),
 m_ihubSE(nullptr),
 m_towerSE(nullptr),
 m_centerSE(nullptr),
+m_broadphaseStamp(0),
 m_spawnTimer(0)
 {
     m_ice = false;
@@ -105,6 +106,8 @@ void SystemBubble::clear() {
     m_players.clear();
     m_entities.clear();
     m_dynamicEntities.clear();
+    m_bumpCandidates.clear();
+    m_broadphaseStamp = 0;
 }
 
 void SystemBubble::Process()
@@ -353,6 +356,7 @@ void SystemBubble::Add(SystemEntity* pSE) {
     );
 
     m_dynamicEntities[pSE->GetID()] = pSE;
+    ResetBroadphase();
 }
 
 /**
@@ -392,6 +396,7 @@ void SystemBubble::Untrack(SystemEntity *pSE) {
     );
 
     m_dynamicEntities.erase(pseId);
+    ResetBroadphase();
 
     if (pSE->HasPilot()) {
         _log(
@@ -569,6 +574,86 @@ void SystemBubble::GetPlayers(std::vector<Client*> &into) const {
         into.push_back(cur.second);
 }
 
+void SystemBubble::GetBumpCandidates(SystemEntity* pSE, std::vector<SystemEntity*> &into)
+{
+    /* called from DestinyManager::CheckBump() for each moving ship.
+     * the broadphase is built on first call each tic, then all balls in bubble query the same pair list.
+     * this will only return candidates.  actual distance checks are done by caller.
+     */
+    into.clear();
+    if (m_broadphaseStamp != sEntityList.GetStamp())
+        BuildBroadphase();
+
+    std::unordered_map<uint32, std::vector<SystemEntity*>>::const_iterator itr = m_bumpCandidates.find(pSE->GetID());
+    if (itr != m_bumpCandidates.end())
+        into = itr->second;
+}
+
+void SystemBubble::BuildBroadphase()
+{
+    m_bumpCandidates.clear();
+    m_broadphaseStamp = sEntityList.GetStamp();
+
+    /* sort-and-sweep on x axis
+     *  each entity gets a box of (radius + bump distance + distance it may travel this tic) around its position.
+     *  boxes are sorted by min x, then each box is only tested against boxes starting before its max x.
+     *  overlapping boxes on all three axes are candidate pairs.
+     *  this is O(n log n) for sorting + O(n + k) for the sweep, where k is number of overlapping pairs.
+     */
+    struct BoundBox {
+        SystemEntity* pSE;
+        GPoint min;
+        GPoint max;
+        bool pilot;
+    };
+
+    std::vector<BoundBox> boxes;
+    boxes.reserve(m_dynamicEntities.size());
+    for (auto cur : m_dynamicEntities) {
+        // only ships, npcs and structures are solid for bumping.  drones, missiles, wrecks and cans pass thru
+        if (!cur.second->IsShipSE() and !cur.second->IsNPCSE() and !cur.second->IsPOSSE())
+            continue;
+        double extent(cur.second->GetRadius() + BUMP_DISTANCE);
+        if (cur.second->DestinyMgr() != nullptr) {
+            if (cur.second->DestinyMgr()->IsWarping())
+                continue;
+            extent += cur.second->DestinyMgr()->GetVelocity().length();
+        }
+        const GPoint& pos(cur.second->GetPosition());
+        BoundBox box;
+            box.pSE = cur.second;
+            box.min = GPoint(pos.x - extent, pos.y - extent, pos.z - extent);
+            box.max = GPoint(pos.x + extent, pos.y + extent, pos.z + extent);
+            box.pilot = cur.second->HasPilot();
+        boxes.push_back(box);
+    }
+
+    std::sort(boxes.begin(), boxes.end(), [](const BoundBox& a, const BoundBox& b) { return a.min.x < b.min.x; });
+
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        const BoundBox& a = boxes[i];
+        for (size_t j = i + 1; j < boxes.size(); ++j) {
+            const BoundBox& b = boxes[j];
+            if (b.min.x > a.max.x)
+                break;
+            // only piloted ships check for bumps, so pairs without a pilot are useless
+            if (!a.pilot and !b.pilot)
+                continue;
+            if ((a.max.y < b.min.y) or (b.max.y < a.min.y))
+                continue;
+            if ((a.max.z < b.min.z) or (b.max.z < a.min.z))
+                continue;
+            if (a.pilot)
+                m_bumpCandidates[a.pSE->GetID()].push_back(b.pSE);
+            if (b.pilot)
+                m_bumpCandidates[b.pSE->GetID()].push_back(a.pSE);
+        }
+    }
+
+    _log(DESTINY__BUBBLE_DEBUG, "SystemBubble::BuildBroadphase() - %lu solid entities, %lu with candidates in bubble %u", \
+            boxes.size(), m_bumpCandidates.size(), m_bubbleID);
+}
+
 SystemEntity* SystemBubble::GetRandomEntity()
 {
     // this is used for idle npc's as a orbit target while waiting for something to pewpew
@@ -27,6 +27,7 @@
 #define __SYSTEMBUBBLE_H_INCL__
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 #include "eve-core.h"
@@ -144,6 +145,8 @@ public:
     /* for scanning */
     void GetEntityVec(std::vector<SystemEntity*> &into) const;
     SystemEntity* GetRandomEntity();
+    /* for collision checks.  returns entities whose swept bounds overlap pSE this tic */
+    void GetBumpCandidates(SystemEntity* pSE, std::vector<SystemEntity*> &into);
 
     /* for towers/ship abandoning */
     bool HasTower()                                     { return (m_towerSE != nullptr); }
@@ -183,6 +186,10 @@ protected:
 
     void MarkBubble(const GPoint& position, std::string& name, std::string& desc, bool center=false);
 
+    // collision broadphase.  sort-and-sweep on x, built once per tic and shared by all balls in bubble
+    void BuildBroadphase();
+    void ResetBroadphase()                              { m_broadphaseStamp = 0; }
+
 private:
     TCUSE* m_tcuSE;
     SBUSE* m_sbuSE;
@@ -196,6 +203,9 @@ private:
 
     uint16 m_bubbleID;
     uint32 m_systemID;
+    uint32 m_broadphaseStamp;                           // tic stamp broadphase was built on.  0 = stale
+
+    std::unordered_map<uint32, std::vector<SystemEntity*>> m_bumpCandidates;  // entityID -> overlapping entities.  we do not own these.
 
     std::map<uint32, Client*> m_players;                // testing with bubble player list (in std::map)
     std::map<uint32, SystemEntity*> m_markers;          // bubble marker cans.  we do own these.
@@ -165,6 +165,13 @@ void SystemEntity::Delete()
         m_self->Delete();
 }
 
+void SystemEntity::SetPosition(const GPoint &pos)
+{
+    m_self->SetPosition(pos);
+    // keep system's spatial index current.  this is a noop for entities not yet added to system
+    m_system->GetSpatialIndex()->Update(this);
+}
+
 double SystemEntity::DistanceTo2(const SystemEntity* other) {
     if (other->m_bubble == nullptr)
         return 1000000.0;
@@ -386,8 +393,10 @@ PyDict* StargateSE::MakeSlimItem() {
         slim->SetItemString("itemID",       new PyLong(m_self->itemID()));
         slim->SetItemString("name",         new PyString(m_self->itemName()));
         slim->SetItemString("nameID",       PyStatic.NewNone());
-    if (m_jumps != nullptr)
-        slim->SetItemString("jumps", m_jumps->Clone());
+    if (m_jumps != nullptr) {
+        PyIncRef(m_jumps);
+        slim->SetItemString("jumps", m_jumps);
+    }
     return slim;
 }
 
@@ -234,7 +234,7 @@ public:
     uint32                      GetLocationID()         { return m_self->locationID(); }
     const char*                 GetName() const         { return m_self->name(); }
     const GPoint&               GetPosition() const     { return m_self->position(); }
-    void                  SetPosition(const GPoint &pos){ m_self->SetPosition(pos); }
+    void                        SetPosition(const GPoint &pos);
     void                        SetRadius(double radius){ m_self->SetRadius(radius); }
     void                        Rename(const char *name){ m_self->Rename(name); }
     inline double               x()                     { return m_self->position().x; }
@@ -65,6 +65,7 @@
 #include "system/cosmicMgrs/SpawnMgr.h"
 #include "station/Outpost.h"
 #include "services/ServiceManager.h"
+#include "utils/Trace.h"
 
 SystemManager::SystemManager(uint32 systemID, EVEServiceManager &svc)
 :m_services(svc),
@@ -109,6 +110,9 @@ m_secValue(1.1f)
     sDataMgr.GetSystemData(systemID, m_data);   // system data is now an internal memory (cached) object.  db is hit once at system boot.
     m_secValue -= m_data.securityRating;  // range is 0.1 for 1.0 system to 2.0 for -0.9 system
 
+    m_tickMetric = &sMetrics.GetHistogram("evemu_system_tick_seconds", "SystemManager::ProcessTic() time, by system.", {{"system", m_data.name}});
+    m_traceName = sTrace.Intern(m_data.name);
+
     _log(COMMON__MESSAGE, "Created SystemManager %p for System %s(%u)", this, m_data.name.c_str(), m_data.systemID);
 
     this->m_lsc = svc.Lookup <LSCService>("LSC");
@@ -222,6 +226,7 @@ bool SystemManager::LoadCosmicMgrs()
 
 //called once per second from EntityList. (1Hz Tic)
 bool SystemManager::ProcessTic() {
+    TRACE_SPAN("SystemManager::ProcessTic", m_traceName);
     double profileStartTime(GetTimeUSeconds());
 
     /* the idea here is entities map NEVER has invalid items in it, but our iterator may become invalid
@@ -271,6 +276,7 @@ bool SystemManager::ProcessTic() {
             cur.second->Process();
     }
 
+    m_tickMetric->Observe((GetTimeUSeconds() - profileStartTime) / 1e6);
     if (sConfig.debug.UseProfiling)
         sProfiler.AddTime(Profile::system, GetTimeUSeconds() - profileStartTime);
 
@@ -310,6 +316,7 @@ void SystemManager::UnloadSystem() {
     SystemEntity* pSE(nullptr);
     while (itr != m_entities.end()) {
         if ((itr->first == 0) or (itr->second == nullptr)) {
+            m_spatialIndex.Remove(itr->first);
             itr = m_entities.erase(itr);
             continue;
         }
@@ -338,6 +345,7 @@ void SystemManager::UnloadSystem() {
         }
 
         sItemFactory.RemoveItem(itr->first);
+        m_spatialIndex.Remove(itr->first);
         itr = m_entities.erase(itr);
         sBubbleMgr.Remove(pSE);
         SafeDelete(pSE);
@@ -352,6 +360,7 @@ void SystemManager::UnloadSystem() {
     m_npcs.clear();
     // at this point, system entity list should be clear...but just in case, hit it again
     m_entities.clear();
+    m_spatialIndex.Clear();
     // this is dupe container. contents unloaded in another call
     m_ticEntities.clear();
     // at this point, system static entity list should be clear...but just in case, hit it again
@@ -382,6 +391,7 @@ bool SystemManager::LoadSystemStatics() {
     entities.clear();
     m_entities.clear();
     m_staticEntities.clear();
+    m_spatialIndex.Clear();
     if (!SystemDB::LoadSystemStaticEntities(m_data.systemID, entities)) {
         sLog.Error( "SystemManager::LoadSystemStatics()", "Unable to load celestial entities during boot of %s(%u).", m_data.name.c_str(), m_data.systemID);
         return false;
@@ -454,6 +464,7 @@ bool SystemManager::LoadSystemStatics() {
 
         m_entities[cur.itemID] = pSE;
         m_staticEntities[cur.itemID] = pSE;
+        m_spatialIndex.Insert(pSE);
         AddItemToInventory(pSE->GetSelf());
     }
 
@@ -1056,6 +1067,7 @@ void SystemManager::AddEntity(SystemEntity* pSE, bool addSignal/*true*/) {
     } else {
         _log(ITEM__TRACE, "%s(%u): Added to system manager for %s(%u)", pSE->GetName(), itemID, m_data.name.c_str(), m_data.systemID);
         m_entities[itemID] = pSE;
+        m_spatialIndex.Insert(pSE);
 
         if ((pSE->IsCOSE())
         or  (pSE->isGlobal())) {
@@ -1108,6 +1120,7 @@ void SystemManager::AddMarker(SystemEntity* pSE, bool sendBall/*false*/, bool ad
         return;
 
     m_entities[pSE->GetID()] = pSE;
+    m_spatialIndex.Insert(pSE);
     // Add Entity's Item Ref to Solar System Dynamic Inventory:
     //m_solarSystemRef->AddItemToInventory(pSE->GetSelf());
 
@@ -1464,6 +1477,7 @@ void SystemManager::RemoveItemFromInventory(InventoryItemRef iRef)
     if (itr != m_entities.end()) {
         _log(ITEM__TRACE, "%s(%u): Removed from system manager for %s(%u)", iRef->name(), iRef->itemID(), m_data.name.c_str(), m_data.systemID);
         m_entities.erase(itr);
+        m_spatialIndex.Remove(iRef->itemID());
     } else {
         _log(ITEM__WARNING, "%s(%u): Called RemoveEntity(), but they weren\'t found in system manager for %s(%u)", \
                 iRef->name(), iRef->itemID(), m_data.name.c_str(), m_data.systemID);
@@ -1577,30 +1591,37 @@ void SystemManager::DScan(int64 range, const GPoint& pos, std::vector<SystemEnti
      * may not be in this version, but check for "scan inhibitor" POS module; ships in it are invis to dscan
      * AttrDScanImmune is from rhea expansion.  may be able to implement here.
      */
-    for (auto cur : m_entities) {
-        // these dont show on dscan
-        if (IsTempItem(cur.first))
-            continue;
-        if (IsAsteroidID(cur.first))
-            if (!sConfig.server.AsteroidsOnDScan)
-                continue;
-        if (IsNPC(cur.first))
-            continue;
-        if (cur.second->IsDeployableSE())       // not sure if this is right or not
-            continue;
-        if (cur.second->IsShipSE()) {
-            if (cur.second->GetGroupID() == EVEDB::invGroups::CovertOps)
-                continue;
-            if (cur.second->GetGroupID() == EVEDB::invGroups::CombatRecon)
-                continue;
-        }
-        if (cur.second->DestinyMgr() != nullptr)
-            if (cur.second->DestinyMgr()->IsCloaked())
-                continue;
-        // made it this far.  add item to scan list
-        if (pos.distance(cur.second->GetPosition()) < range)
-            vector.push_back(cur.second);
+    m_spatialIndex.QuerySphere(pos, range, vector, &SystemManager::OnDScan);
+}
+
+void SystemManager::DScan(int64 range, const GPoint& pos, const GVector& direction, double angle, std::vector<SystemEntity*>& vector)
+{
+    // same as above, but limited to cone of half-angle 'angle' (radians) along 'direction'
+    m_spatialIndex.QueryCone(pos, direction, angle, range, vector, &SystemManager::OnDScan);
+}
+
+bool SystemManager::OnDScan(SystemEntity* pSE)
+{
+    // these dont show on dscan
+    if (IsTempItem(pSE->GetID()))
+        return false;
+    if (IsAsteroidID(pSE->GetID()))
+        if (!sConfig.server.AsteroidsOnDScan)
+            return false;
+    if (IsNPC(pSE->GetID()))
+        return false;
+    if (pSE->IsDeployableSE())       // not sure if this is right or not
+        return false;
+    if (pSE->IsShipSE()) {
+        if (pSE->GetGroupID() == EVEDB::invGroups::CovertOps)
+            return false;
+        if (pSE->GetGroupID() == EVEDB::invGroups::CombatRecon)
+            return false;
     }
+    if (pSE->DestinyMgr() != nullptr)
+        if (pSE->DestinyMgr()->IsCloaked())
+            return false;
+    return true;
 }
 
 PyRep* SystemManager::GetCurrentEntities()
@@ -29,6 +29,7 @@
 
 #include "system/BubbleManager.h"
 #include "system/SolarSystem.h"
+#include "system/SpatialIndex.h"
 #include "system/SystemDB.h"
 #include "chat/LSCService.h"
 
@@ -111,6 +112,9 @@ public:
     AnomalyMgr* GetAnomMgr()                            { return m_anomMgr; }
     DungeonMgr* GetDungMgr()                            { return m_dungMgr; }
 
+    // spatial index of all entities in system, for range/cone/nearest queries
+    SpatialIndex* GetSpatialIndex()                     { return &m_spatialIndex; }
+
     // range is 0.1 for 1.0 system to 2.0 for -0.9 system
     float GetSecValue()                                 { return m_secValue; }
 
@@ -146,6 +150,8 @@ public:
 
     // this returns entities in range for display on dscan.
     void DScan(int64 range, const GPoint& pos, std::vector< SystemEntity* >& vector);
+    // this returns entities in range and inside given cone for display on dscan.
+    void DScan(int64 range, const GPoint& pos, const GVector& direction, double angle, std::vector< SystemEntity* >& vector);
     // this returns entities in system for display on Groove's Entity Map in client
     PyRep* GetCurrentEntities();
     // this returns entities in system for display on ship scanner when enabled.
@@ -176,6 +182,9 @@ protected:
     bool LoadSystemDynamics();
     bool LoadPlayerDynamics();
 
+    // filter for dscan queries
+    static bool OnDScan(SystemEntity* pSE);
+
 private:
     AnomalyMgr* m_anomMgr;      //we own this, never NULL.
     BeltMgr* m_beltMgr;         //we own this, never NULL.
@@ -188,6 +197,10 @@ private:
 
     // static system data
     SystemData m_data;
+    // tic time; lives in sMetrics
+    MetricHistogram* m_tickMetric;
+    // system name for trace spans; interned, as spans outlive an unloaded system
+    const char* m_traceName;
 
     float m_secValue;  // range is 0.1 for 1.0 system to 2.0 for -0.9 system
 
@@ -225,6 +238,7 @@ private:
     std::map<uint32, NPC*> m_npcs;
     std::map<uint32, Client*> m_clients;
     std::map<uint32, SystemEntity*> m_entities;         // this list is all entities in this system.  we own these.
+    SpatialIndex m_spatialIndex;                        // mirrors m_entities, indexed by position.  we do not own these.
     std::map<uint32, SystemEntity*> m_ticEntities;      // this list is for entities that need process tics (objects, npc, client ships)
     std::map<uint32, SystemEntity*> m_staticEntities;   // this list is for static entities to send in setstate
     std::map<uint32, SystemEntity*> m_opStaticEntities; // this list is for static entities which are operational and need to be initialized and operated upon even when system is empty
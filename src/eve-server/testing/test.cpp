@@ -11,6 +11,9 @@
 #include "eve-server.h"
 
 #include "Client.h"
+#include "LoginPool.h"
+#include "inventory/InventoryItem.h"
+#include "inventory/ItemFactory.h"
 #include "system/SystemEntity.h"
 #include "testing/test.h"
 
@@ -19,3 +22,167 @@ void testing::posTest(Client* pClient) {
 
     sLog.Warning("\ttesting","Test competed");
 }
+
+/* loads a synthetic hangar twice, once with the old one-item-at-a-time path and once with ItemFactory::GetItemRefs()
+ *  items are created with customInfo 'bulkLoadTest' and deleted when done (or on next run, if we crashed)
+ */
+void testing::bulkLoadTest(Client* pClient, uint32 count/*5000*/) {
+    uint32 stationID(pClient->GetStationID()), ownerID(pClient->GetCharacterID());
+    DBerror err;
+    sDatabase.RunQuery(err, "DELETE FROM entity WHERE customInfo = 'bulkLoadTest'");
+
+    // ids come from the item id seq like any spawned item, so they never land in a block ItemFactory holds
+    uint32 firstID(0);
+    if (sItemFactory.HasItemIDSeq() and !ItemDB::ReserveItemIDs(count, firstID)) {
+        sLog.Error("\ttesting", "bulkLoadTest - unable to reserve %u item ids", count);
+        return;
+    }
+
+    // create items.  1k per insert
+    double startTime(GetTimeMSeconds());
+    for (uint32 i = 0; i < count; i += 1000) {
+        std::ostringstream Inserts;
+        Inserts << "INSERT INTO entity (" << (firstID ? "itemID, " : "");
+        Inserts << "itemName, typeID, ownerID, locationID, flag, contraband, singleton, quantity, x, y, z, customInfo) VALUES ";
+        for (uint32 j = i; j < std::min(i + 1000, count); ++j) {
+            if (j > i)
+                Inserts << ", ";
+            Inserts << "(";
+            if (firstID)
+                Inserts << (firstID + j) << ", ";
+            Inserts << "'', 34, " << ownerID << ", " << stationID << ", " << flagHangar << ", 0, 0, " << (j + 1) << ", 0, 0, 0, 'bulkLoadTest')";
+        }
+        if (!sDatabase.RunQuery(err, Inserts.str().c_str())) {
+            sLog.Error("\ttesting", "bulkLoadTest - insert failed: %s", err.c_str());
+            return;
+        }
+    }
+    double createTime(GetTimeMSeconds() - startTime);
+
+    std::vector<uint32> itemIDs;
+    DBQueryResult res;
+    sDatabase.RunQuery(res, "SELECT itemID FROM entity WHERE customInfo = 'bulkLoadTest'");
+    DBResultRow row;
+    while (res.GetRow(row))
+        itemIDs.push_back(row.GetUInt(0));
+
+    // old path.  these arent cached, so nothing to clean up
+    startTime = GetTimeMSeconds();
+    uint32 single(0);
+    for (auto cur : itemIDs)
+        if (InventoryItem::Load(cur).get() != nullptr)
+            ++single;
+    double singleTime(GetTimeMSeconds() - startTime);
+
+    // bulk path.  these are cached by ItemFactory, so remove them after
+    startTime = GetTimeMSeconds();
+    std::vector<InventoryItemRef> loaded;
+    sItemFactory.GetItemRefs(itemIDs, loaded);
+    double bulkTime(GetTimeMSeconds() - startTime);
+    for (auto cur : itemIDs)
+        sItemFactory.RemoveItem(cur);
+
+    sDatabase.RunQuery(err, "DELETE FROM entity WHERE customInfo = 'bulkLoadTest'");
+
+    sLog.Warning("\ttesting", "bulkLoadTest - %lu items created in %.0fms.  per-item load: %u in %.0fms.  bulk load: %lu in %.0fms.", \
+                itemIDs.size(), createTime, single, singleTime, loaded.size(), bulkTime);
+    pClient->SendInfoModalMsg("Bulk Load Test<br><br>%lu items in station %u<br>per-item load: %u in %.0fms<br>bulk load: %lu in %.0fms", \
+                itemIDs.size(), stationID, single, singleTime, loaded.size(), bulkTime);
+}
+
+/* simulates 'count' logins arriving 25 per 50ms tick, first done inline (the old path) and then thru LoginPool.
+ *  each login is the full account check on pClient's own account (lookup, hash compare and char list, all reads)
+ *  plus a login item read for pClient's char.  each tick also runs one query on the main connection, as the main loop would.
+ *  reports how far ticks ran over their 50ms budget, and any login that failed.
+ */
+void testing::loginLoadTest(Client* pClient, uint16 count/*500*/) {
+    static const double tickTime = 50;
+    static const uint8 perTick = 25;
+
+    DBQueryResult res;
+    sDatabase.RunQuery(res, "SELECT accountName, hash FROM account WHERE accountID = %u", pClient->GetUserID());
+    DBResultRow row;
+    if (!res.GetRow(row)) {
+        sLog.Error("\ttesting", "loginLoadTest - account %u not found", pClient->GetUserID());
+        return;
+    }
+
+    CryptoChallengePacket ccp;
+    ccp.user_name = row.GetText(0);
+    ccp.user_password_hash = (row.IsNull(1) ? "" : row.GetText(1));
+
+    std::ostringstream str;
+    str << "Login Load Test<br><br>" << count << " logins, " << (uint16)perTick << " per " << tickTime << "ms tick, ";
+    str << (uint16)sLoginPool.GetWorkerCount() << " workers<br>";
+    for (uint8 pooled = 0; pooled < 2; ++pooled) {
+        std::vector<double> overrun;
+        std::vector<std::shared_ptr<LoginJob>> pending;
+        std::vector<std::shared_ptr<AccountJob>> accounts;
+        std::vector<std::shared_ptr<CharPrefetchJob>> chars;
+        uint16 queued(0);
+        double startTime(GetTimeMSeconds());
+        while ((queued < count) or !pending.empty()) {
+            double tickStart(GetTimeMSeconds());
+            // this tick's new logins
+            for (uint8 i = 0; (i < perTick) and (queued < count); ++i, ++queued) {
+                std::shared_ptr<AccountJob> aJob(std::make_shared<AccountJob>(ccp));
+                std::shared_ptr<CharPrefetchJob> cJob(std::make_shared<CharPrefetchJob>(pClient->GetCharacterID()));
+                aJob->loadTest = true;
+                accounts.push_back(aJob);
+                chars.push_back(cJob);
+                if (pooled) {
+                    sLoginPool.Queue(aJob);
+                    sLoginPool.Queue(cJob);
+                    pending.push_back(aJob);
+                    pending.push_back(cJob);
+                } else {
+                    aJob->Run();
+                    cJob->Run();
+                }
+            }
+            // the main loop's own db work for this tick
+            DBQueryResult tick;
+            sDatabase.RunQuery(tick, "SELECT online FROM account WHERE accountID = %u", pClient->GetUserID());
+
+            // poll for finished jobs, as Client::ProcessNet() does
+            std::vector<std::shared_ptr<LoginJob>>::iterator itr = pending.begin();
+            while (itr != pending.end()) {
+                if ((*itr)->IsDone()) {
+                    itr = pending.erase(itr);
+                } else {
+                    ++itr;
+                }
+            }
+
+            double elapsed(GetTimeMSeconds() - tickStart);
+            overrun.push_back(std::max(0.0, elapsed - tickTime));
+            if (elapsed < tickTime)
+                Sleep((uint32)(tickTime - elapsed));
+        }
+        double totalTime(GetTimeMSeconds() - startTime);
+
+        std::sort(overrun.begin(), overrun.end());
+        double sum(0);
+        for (auto cur : overrun)
+            sum += cur;
+        double p99(overrun[(overrun.size() - 1) * 99 / 100]);
+
+        uint16 failed(0);
+        for (auto cur : accounts)
+            if (!cur->result)
+                ++failed;
+        for (auto cur : chars)
+            if (!cur->result)
+                ++failed;
+        if (failed > 0)
+            sLog.Error("\ttesting", "loginLoadTest - %s: %u of %u jobs failed", (pooled ? "LoginPool" : "inline"), failed, count * 2);
+
+        sLog.Warning("\ttesting", "loginLoadTest - %s: %lu ticks in %.0fms.  tick overrun mean %.2fms, p99 %.2fms, max %.2fms", \
+                (pooled ? "LoginPool" : "inline"), overrun.size(), totalTime, sum / overrun.size(), p99, overrun.back());
+        str << "<br>" << (pooled ? "LoginPool" : "inline") << ": " << overrun.size() << " ticks in " << (uint32)totalTime << "ms";
+        str << "<br>  tick overrun mean " << sum / overrun.size() << "ms, p99 " << p99 << "ms, max " << overrun.back() << "ms";
+        str << "<br>  failed jobs " << failed << "<br>";
+    }
+
+    pClient->SendInfoModalMsg("%s", str.str().c_str());
+}
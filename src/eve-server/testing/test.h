@@ -20,6 +20,10 @@ public:
     ~testing()                                          { /* do nothing here */ }
 
     static void posTest(Client* pClient);
+    // time per-item vs bulk loading of 'count' synthetic items in pClient's station hangar
+    static void bulkLoadTest(Client* pClient, uint32 count=5000);
+    // main loop tick overrun for 'count' simulated logins, done inline vs thru LoginPool
+    static void loginLoadTest(Client* pClient, uint16 count=500);
 
 };
 
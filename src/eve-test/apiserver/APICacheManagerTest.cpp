@@ -0,0 +1,230 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+#include <atomic>
+
+#include "apiserver/APICacheManager.h"
+
+/* APICacheManager:
+ *  1) descriptors: the same call always makes the same key, different params never share one.
+ *  2) a deposited document is a hit until its cachedUntil, and a miss after.
+ *  3) documents past maxBytes / 16 or already expired are not cached.
+ *  4) past maxBytes, the least recently used documents are dropped first.
+ *  5) identical calls wait for the one building the document and get it; when the build
+ *     fails (APIServer deposits an expired, empty document), they are let go to build it.
+ *  every miss is followed by a deposit, as the cache expects of its callers.
+ */
+
+namespace {
+
+const int64 HOUR = Win32Time_Hour;
+
+struct Waiter {
+    APICacheManager* cache;
+    std::string descriptor;
+    std::string doc;
+    std::atomic<bool> done;
+    std::atomic<bool> hit;
+};
+
+void Retrieve( Waiter* waiter )
+{
+    waiter->hit = waiter->cache->CacheRetrieve( &waiter->descriptor, &waiter->doc );
+    waiter->done = true;
+}
+
+bool Hit( APICacheManager& cache, const std::string& descriptor, const std::string& expected )
+{
+    std::string doc;
+    if( !cache.CacheRetrieve( &descriptor, &doc ) ) {
+        // the miss made us the builder; give the slot back
+        cache.CacheDeposit( &descriptor, &doc, 0 );
+        return false;
+    }
+    return doc == expected;
+}
+
+bool Miss( APICacheManager& cache, const std::string& descriptor )
+{
+    std::string doc;
+    if( cache.CacheRetrieve( &descriptor, &doc ) )
+        return false;
+    cache.CacheDeposit( &descriptor, &doc, 0 );
+    return true;
+}
+
+void Store( APICacheManager& cache, const std::string& descriptor, const std::string& doc, int64 expires )
+{
+    std::string old;
+    if( !cache.CacheRetrieve( &descriptor, &old ) )
+        cache.CacheDeposit( &descriptor, &doc, expires );
+}
+
+void CheckDescriptors()
+{
+    APICommandCall call;
+    call[ "service" ] = "char";
+    call[ "servicehandler" ] = "CharacterSheet.xml.aspx";
+    call[ "userid" ] = "1";
+    call[ "characterid" ] = "90000001";
+
+    const std::string descriptor = APICacheManager::BuildDescriptor( &call );
+    Check( descriptor == "char/CharacterSheet.xml.aspx?characterid=90000001&userid=1&", "descriptor" );
+
+    APICommandCall same;
+    same[ "characterid" ] = "90000001";
+    same[ "userid" ] = "1";
+    same[ "servicehandler" ] = "CharacterSheet.xml.aspx";
+    same[ "service" ] = "char";
+    Check( APICacheManager::BuildDescriptor( &same ) == descriptor, "descriptor does not depend on param order" );
+
+    call[ "userid" ] = "2";
+    Check( APICacheManager::BuildDescriptor( &call ) != descriptor, "descriptor holds the key id" );
+}
+
+void CheckExpiry()
+{
+    APICacheManager cache( 16 * 1024 );
+    const std::string descriptor = "char/SkillQueue.xml.aspx?userid=1&";
+    const std::string doc( 100, 'x' );
+
+    Check( Miss( cache, descriptor ), "empty cache misses" );
+
+    // a quarter second, in win32 time
+    Store( cache, descriptor, doc, Win32TimeNow() + Win32Time_Second / 4 );
+    Check( Hit( cache, descriptor, doc ), "document is a hit before it expires" );
+    Check( Hit( cache, descriptor, doc ), "document is still a hit" );
+
+    Sleep( 400 );
+    Check( Miss( cache, descriptor ), "document is a miss once expired" );
+
+    std::string expired;
+    Check( !cache.CacheRetrieve( &descriptor, &expired ), "miss before an expired deposit" );
+    Check( !cache.CacheDeposit( &descriptor, &doc, Win32TimeNow() - HOUR ), "expired document is not cached" );
+    Check( Miss( cache, descriptor ), "expired document is a miss" );
+
+    const std::string big( 16 * 1024 / 16 + 1, 'b' );
+    Check( !cache.CacheRetrieve( &descriptor, &expired ), "miss before an oversized deposit" );
+    Check( !cache.CacheDeposit( &descriptor, &big, Win32TimeNow() + HOUR ), "oversized document is not cached" );
+    Check( Miss( cache, descriptor ), "oversized document is a miss" );
+}
+
+void CheckEviction()
+{
+    // room for 16 documents of 1KB
+    APICacheManager cache( 16 * 1024 );
+    const std::string doc( 1024, 'd' );
+    const int64 expires = Win32TimeNow() + HOUR;
+
+    char descriptor[ 32 ];
+    for( uint32 i = 0; i < 16; ++i ) {
+        ::snprintf( descriptor, sizeof( descriptor ), "doc%u", i );
+        Store( cache, descriptor, doc, expires );
+    }
+    for( uint32 i = 0; i < 16; ++i ) {
+        ::snprintf( descriptor, sizeof( descriptor ), "doc%u", i );
+        Check( Hit( cache, descriptor, doc ), "all documents fit" );
+    }
+
+    // doc0 is now the least recently used; touch it so doc1 is
+    Check( Hit( cache, "doc0", doc ), "doc0 is a hit" );
+    Store( cache, "doc16", doc, expires );
+    Check( Hit( cache, "doc16", doc ), "new document is a hit" );
+    Check( Hit( cache, "doc0", doc ), "recently used document is kept" );
+    Check( Miss( cache, "doc1" ), "least recently used document is dropped" );
+    Check( Hit( cache, "doc2", doc ), "next document is kept" );
+
+    // the cache is full, so even a small document drops the least recently used one
+    Store( cache, "small", std::string( 16, 's' ), expires );
+    Check( Miss( cache, "doc3" ), "small document drops the least recently used one" );
+    // that left 1KB - 16 bytes free; 1KB more drops one more document, and no more
+    Check( Hit( cache, "doc5", doc ), "doc5 is a hit" );
+    Store( cache, "doc17", doc, expires );
+    Check( Miss( cache, "doc4" ), "1KB more drops the least recently used document" );
+    Check( Hit( cache, "doc6", doc ), "and no more" );
+    Check( Hit( cache, "small", std::string( 16, 's' ) ), "small document is kept" );
+}
+
+void CheckCoalescing()
+{
+    APICacheManager cache( 16 * 1024 );
+    const std::string doc( 200, 'm' );
+
+    for( uint8 pass = 0; pass < 2; ++pass ) {
+        const bool fail = (pass == 0);
+        const std::string descriptor = (fail ? "corp/MemberTracking.xml.aspx?userid=1&" : "corp/MemberTracking.xml.aspx?userid=2&");
+
+        std::string built;
+        Check( !cache.CacheRetrieve( &descriptor, &built ), "first call builds" );
+
+        Waiter waiter;
+        waiter.cache = &cache;
+        waiter.descriptor = descriptor;
+        waiter.done = false;
+        waiter.hit = false;
+        std::thread thread( Retrieve, &waiter );
+
+        Sleep( 100 );
+        Check( !waiter.done.load(), "identical call waits for the builder" );
+
+        if( fail ) {
+            // what APIServer::GetXML() does when ProcessCall() throws
+            Check( !cache.CacheDeposit( &descriptor, &built, 0 ), "failed build is not cached" );
+        } else {
+            Check( cache.CacheDeposit( &descriptor, &doc, Win32TimeNow() + HOUR ), "built document is cached" );
+        }
+        thread.join();
+
+        if( fail ) {
+            Check( !waiter.hit.load(), "waiter is let go to build after a failed build" );
+            // and it is the builder now
+            Check( cache.CacheDeposit( &descriptor, &doc, Win32TimeNow() + HOUR ), "waiter's build is cached" );
+            Check( Hit( cache, descriptor, doc ), "waiter's build is a hit" );
+        } else {
+            Check( waiter.hit.load() and (waiter.doc == doc), "waiter gets the built document" );
+        }
+    }
+}
+
+}
+
+int apiserver_APICacheManagerTest( int argc, char* argv[] )
+{
+    ::puts( "Descriptors..." );
+    CheckDescriptors();
+
+    ::puts( "Expiry..." );
+    CheckExpiry();
+
+    ::puts( "Eviction..." );
+    CheckEviction();
+
+    ::puts( "Coalescing..." );
+    CheckCoalescing();
+
+    return CheckResult();
+}
@@ -0,0 +1,132 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+
+#ifndef __BENCHMARK_H__INCL__
+#define __BENCHMARK_H__INCL__
+
+#include <chrono>
+#include <functional>
+
+/**
+ * @brief Minimal benchmark runner for the eve-test benchmarks.
+ *
+ * Each case is run in batches; the batch size doubles until a batch takes
+ * the minimum time, then a few batches of that size are timed and the
+ * fastest is reported.  Results go to stdout either as a table or, with
+ * -j, as one JSON object per line so runs can be diffed/compared by
+ * scripts.
+ *
+ * usage: eve-test benchmark/<Name> [-j] [-t minTimeMs] [filter]
+ */
+class BenchRunner
+{
+public:
+    BenchRunner( const char* suite, int argc, char* argv[] )
+    : mSuite( suite ),
+      mJson( false ),
+      mMinTime( 0.2 ),
+      mRuns( 0 )
+    {
+        // argv[0] is the test name
+        for( int i = 1; i < argc; ++i ) {
+            const std::string arg( argv[ i ] );
+            if( arg == "-j" )
+                mJson = true;
+            else if( (arg == "-t") and (i + 1 < argc) )
+                mMinTime = atoi( argv[ ++i ] ) / 1000.0;
+            else
+                mFilter = arg;
+        }
+
+        if( !mJson )
+            ::printf( "%-44s %10s %14s %12s\n", "benchmark", "iterations", "ns/op", "MB/s" );
+    }
+
+    /**
+     * @brief Times fn.
+     *
+     * @param[in] name   Case name, shown as <suite>/<name>.
+     * @param[in] fn     Runs one iteration.
+     * @param[in] bytes  Payload bytes handled per iteration, for MB/s; 0 if n/a.
+     */
+    void Run( const char* name, const std::function<void()>& fn, size_t bytes = 0 )
+    {
+        const std::string fullName( mSuite + "/" + name );
+        if( !mFilter.empty() and (fullName.find( mFilter ) == std::string::npos) )
+            return;
+
+        // warm up, then find a batch size which takes at least mMinTime
+        fn();
+        int64 iterations = 1;
+        double elapsed = Time( fn, iterations );
+        while( (elapsed < mMinTime) and (iterations < ( (int64)1 << 30 )) ) {
+            iterations = (int64)( iterations * ( elapsed > 0.0 ? std::min( 10.0, std::max( 2.0, 1.2 * mMinTime / elapsed ) ) : 10.0 ) );
+            elapsed = Time( fn, iterations );
+        }
+
+        double best = elapsed;
+        for( uint8 i = 0; i < 2; ++i )
+            best = std::min( best, Time( fn, iterations ) );
+
+        const double ns = best * 1e9 / iterations;
+        const double mbs = ( bytes > 0 ? bytes * iterations / best / ( 1024.0 * 1024.0 ) : 0.0 );
+        if( mJson )
+            ::printf( "{\"benchmark\":\"%s\",\"iterations\":%li,\"ns_per_op\":%.1f,\"bytes_per_op\":%lu,\"mb_per_s\":%.2f}\n",
+                      fullName.c_str(), (long)iterations, ns, (unsigned long)bytes, mbs );
+        else
+            ::printf( "%-44s %10li %14.1f %12.2f\n", fullName.c_str(), (long)iterations, ns, mbs );
+        ::fflush( stdout );
+        ++mRuns;
+    }
+
+    /// Notes a case that could not run.
+    void Skip( const char* name, const char* reason )
+    {
+        if( mJson )
+            ::printf( "{\"benchmark\":\"%s/%s\",\"skipped\":\"%s\"}\n", mSuite.c_str(), name, reason );
+        else
+            ::printf( "%s/%s skipped: %s\n", mSuite.c_str(), name, reason );
+    }
+
+    uint32 GetRunCount() const { return mRuns; }
+
+protected:
+    static double Time( const std::function<void()>& fn, int64 iterations )
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for( int64 i = 0; i < iterations; ++i )
+            fn();
+        return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    }
+
+    const std::string mSuite;
+    std::string mFilter;
+    bool mJson;
+    double mMinTime;
+    uint32 mRuns;
+};
+
+#endif /* !__BENCHMARK_H__INCL__ */
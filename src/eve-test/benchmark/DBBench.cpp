@@ -0,0 +1,134 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+#include "benchmark/Benchmark.h"
+
+/* database conversion benchmarks.
+ *  fills a temporary table with 'rows' market orders (default 10000) and times
+ *  the SELECT alone, then SELECT + DBResultToRowset/DBResultToCRowset/
+ *  DBResultToCIndexedRowset.  results can only be read once, so the conversion
+ *  cost is the difference between those and Query.
+ *  needs a database; without -db the cases are reported as skipped.
+ *
+ * usage: eve-test benchmark/DBBench -db <host> <user> <password> <database> [port] [-rows n] [-j] [-t minTimeMs] [filter]
+ */
+
+int benchmark_DBBench( int argc, char* argv[] )
+{
+    // pull our options out; the rest go to the runner
+    std::vector<char*> args;
+    std::string host, user, password, database;
+    int16 port = 3306;
+    uint32 rows = 10000;
+    for( int i = 0; i < argc; ++i ) {
+        const std::string arg( argv[ i ] );
+        if( (arg == "-db") and (i + 4 < argc) ) {
+            host = argv[ ++i ];
+            user = argv[ ++i ];
+            password = argv[ ++i ];
+            database = argv[ ++i ];
+            if( (i + 1 < argc) and (atoi( argv[ i + 1 ] ) > 0) )
+                port = atoi( argv[ ++i ] );
+        } else if( (arg == "-rows") and (i + 1 < argc) ) {
+            rows = atoi( argv[ ++i ] );
+        } else {
+            args.push_back( argv[ i ] );
+        }
+    }
+
+    BenchRunner bench( "db", (int)args.size(), args.data() );
+
+    if( host.empty() ) {
+        bench.Skip( "*", "no database given (-db)" );
+        return EXIT_SUCCESS;
+    }
+
+    sDatabase.Initialize( host, user, password, database, false, false, port );
+    if( sDatabase.GetStatus() != DBcore::Connected ) {
+        bench.Skip( "*", "unable to connect to the database" );
+        return EXIT_FAILURE;
+    }
+
+    DBerror err;
+    if( !sDatabase.RunQuery( err,
+        "CREATE TEMPORARY TABLE benchOrders ("
+        " orderID BIGINT UNSIGNED NOT NULL PRIMARY KEY, typeID INT UNSIGNED NOT NULL, price DOUBLE NOT NULL,"
+        " volRemaining DOUBLE NOT NULL, volEntered INT UNSIGNED NOT NULL, minVolume INT UNSIGNED NOT NULL,"
+        " bid TINYINT(1) NOT NULL, issueDate BIGINT UNSIGNED NOT NULL, duration SMALLINT NOT NULL,"
+        " orderRange SMALLINT NOT NULL, stationID INT UNSIGNED NOT NULL, regionID INT UNSIGNED NOT NULL,"
+        " solarSystemID INT UNSIGNED NOT NULL, jumps SMALLINT NOT NULL, memo VARCHAR(32) NULL )" ) )
+    {
+        ::printf( "Failed to create table: %s\n", err.c_str() );
+        return EXIT_FAILURE;
+    }
+
+    // batched inserts; a row at a time takes longer than the benchmark
+    for( uint32 i = 0; i < rows; ) {
+        std::string query( "INSERT INTO benchOrders VALUES " );
+        for( uint32 n = 0; (n < 500) and (i < rows); ++n, ++i ) {
+            char row[ 256 ];
+            snprintf( row, sizeof( row ), "%s(%u,%u,%f,%f,1000,1,%u,%lld,90,%d,%u,10000002,30000142,0,%s)",
+                      ( n > 0 ? "," : "" ), 100000000 + i, 34 + i % 8, 5.0 + ( i % 997 ) * 0.1, 1000.0 + i % 50,
+                      i % 2, 130000000000000000LL + (long long)i * 10000000, ( i % 3 == 0 ? -1 : 0 ),
+                      60000004 + i % 20, ( i % 5 == 0 ? "'bench'" : "NULL" ) );
+            query += row;
+        }
+        if( !sDatabase.RunQuery( err, "%s", query.c_str() ) ) {
+            ::printf( "Failed to fill table: %s\n", err.c_str() );
+            return EXIT_FAILURE;
+        }
+    }
+
+    const char* const SELECT = "SELECT orderID, typeID, price, volRemaining, volEntered, minVolume, bid, issueDate,"
+                               " duration, orderRange, stationID, regionID, solarSystemID, jumps, memo FROM benchOrders";
+
+    bench.Run( "Query", [SELECT]() {
+        DBQueryResult res;
+        sDatabase.RunQuery( res, "%s", SELECT );
+    } );
+    bench.Run( "DBResultToRowset", [SELECT]() {
+        DBQueryResult res;
+        sDatabase.RunQuery( res, "%s", SELECT );
+        PyRep* rep = DBResultToRowset( res );
+        PyDecRef( rep );
+    } );
+    bench.Run( "DBResultToCRowset", [SELECT]() {
+        DBQueryResult res;
+        sDatabase.RunQuery( res, "%s", SELECT );
+        PyRep* rep = DBResultToCRowset( res );
+        PyDecRef( rep );
+    } );
+    bench.Run( "DBResultToCIndexedRowset", [SELECT]() {
+        DBQueryResult res;
+        sDatabase.RunQuery( res, "%s", SELECT );
+        PyRep* rep = DBResultToCIndexedRowset( res, "orderID" );
+        PyDecRef( rep );
+    } );
+
+    sDatabase.RunQuery( err, "DROP TEMPORARY TABLE benchOrders" );
+    return EXIT_SUCCESS;
+}
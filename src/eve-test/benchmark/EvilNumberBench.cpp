@@ -0,0 +1,81 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+#include "benchmark/Benchmark.h"
+
+/* EvilNumber benchmarks.
+ *  1000 operations per iteration, on int, float and mixed operands; the mixed case
+ *  is the usual attribute modifier shape, base * (1 + bonus / 100).
+ *
+ * usage: eve-test benchmark/EvilNumberBench [-j] [-t minTimeMs] [filter]
+ */
+
+int benchmark_EvilNumberBench( int argc, char* argv[] )
+{
+    BenchRunner bench( "evilnumber", argc, argv );
+
+    std::vector<EvilNumber> ints, floats;
+    for( uint16 i = 0; i < 1000; ++i ) {
+        ints.push_back( EvilNumber( (int32)( i + 1 ) ) );
+        floats.push_back( EvilNumber( 1.0 + i * 0.25 ) );
+    }
+
+    volatile double sink = 0.0;
+    bench.Run( "Add/int", [&ints, &sink]() {
+        EvilNumber sum( 0 );
+        for( auto& cur : ints )
+            sum += cur;
+        sink = sum.get_double();
+    } );
+    bench.Run( "Multiply/float", [&floats, &sink]() {
+        EvilNumber product( 1.0 );
+        for( auto& cur : floats )
+            product = product * cur / floats[ 0 ];
+        sink = product.get_double();
+    } );
+    bench.Run( "Modifier/mixed", [&ints, &floats, &sink]() {
+        EvilNumber value( 0.0 );
+        for( size_t i = 0; i < ints.size(); ++i )
+            value = floats[ i ] * ( EvilNumber( 1 ) + ints[ i ] / EvilNumber( 100.0 ) );
+        sink = value.get_double();
+    } );
+    bench.Run( "Compare/mixed", [&ints, &floats, &sink]() {
+        uint32 count = 0;
+        for( size_t i = 0; i < ints.size(); ++i )
+            if( ints[ i ] > floats[ i ] )
+                ++count;
+        sink = count;
+    } );
+    bench.Run( "GetPyObject/float", [&floats]() {
+        for( auto& cur : floats ) {
+            PyRep* rep = cur.GetPyObject();
+            PyDecRef( rep );
+        }
+    } );
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+#include "benchmark/Benchmark.h"
+#include "benchmark/Payloads.h"
+
+/* marshal benchmarks.
+ *  Marshal/Unmarshal and MarshalDeflate/InflateUnmarshal of a 10k row market rowset,
+ *  a 1000 ship AddBalls, a 300 attribute item, and a 10k row mostly-zero rowset
+ *  (packed row zero compression).  MB/s is of the marshaled (or deflated) size.
+ *
+ * usage: eve-test benchmark/MarshalBench [-j] [-t minTimeMs] [filter]
+ */
+
+namespace {
+
+void RunPayload( BenchRunner& bench, const char* name, PyRep* rep )
+{
+    Buffer marshaled;
+    Buffer deflated;
+    if( !Marshal( rep, marshaled ) or !MarshalDeflate( rep, deflated, 0 ) ) {
+        bench.Skip( name, "failed to marshal payload" );
+        return;
+    }
+
+    bench.Run( ( std::string( "Marshal/" ) + name ).c_str(), [rep]() {
+        Buffer into;
+        Marshal( rep, into );
+    }, marshaled.size() );
+
+    bench.Run( ( std::string( "Unmarshal/" ) + name ).c_str(), [&marshaled]() {
+        PyRep* res = Unmarshal( marshaled );
+        PyDecRef( res );
+    }, marshaled.size() );
+
+    // deflationLimit 0 so every payload is deflated
+    bench.Run( ( std::string( "MarshalDeflate/" ) + name ).c_str(), [rep]() {
+        Buffer into;
+        MarshalDeflate( rep, into, 0 );
+    }, marshaled.size() );
+
+    bench.Run( ( std::string( "InflateUnmarshal/" ) + name ).c_str(), [&deflated]() {
+        PyRep* res = InflateUnmarshal( deflated );
+        PyDecRef( res );
+    }, marshaled.size() );
+}
+
+}
+
+int benchmark_MarshalBench( int argc, char* argv[] )
+{
+    BenchRunner bench( "marshal", argc, argv );
+
+    PyRep* market = MakeMarketRowset( 10000 );
+    RunPayload( bench, "market10k", market );
+    PyDecRef( market );
+
+    PyRep* sparse = MakeSparseRowset( 10000 );
+    RunPayload( bench, "sparse10k", sparse );
+    PyDecRef( sparse );
+
+    PyRep* addBalls = MakeAddBalls( 1000 );
+    RunPayload( bench, "addballs1000", addBalls );
+    PyDecRef( addBalls );
+
+    PyRep* item = MakeItemAttributes( 300 );
+    RunPayload( bench, "item300", item );
+    PyDecRef( item );
+
+    return EXIT_SUCCESS;
+}
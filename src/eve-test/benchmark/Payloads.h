@@ -0,0 +1,182 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+
+#ifndef __BENCHMARK_PAYLOADS_H__INCL__
+#define __BENCHMARK_PAYLOADS_H__INCL__
+
+/* generated payloads for the benchmarks, shaped like what the server sends.
+ *  values are deterministic so runs are comparable.
+ */
+
+/// market order CRowset, as sent for GetOrders
+inline CRowSet* MakeMarketRowset( uint32 rows )
+{
+    DBRowDescriptor* header = new DBRowDescriptor();
+        header->AddColumn( "price",         DBTYPE_CY );
+        header->AddColumn( "volRemaining",  DBTYPE_R8 );
+        header->AddColumn( "typeID",        DBTYPE_I4 );
+        header->AddColumn( "range",         DBTYPE_I2 );
+        header->AddColumn( "orderID",       DBTYPE_I8 );
+        header->AddColumn( "volEntered",    DBTYPE_I4 );
+        header->AddColumn( "minVolume",     DBTYPE_I4 );
+        header->AddColumn( "bid",           DBTYPE_BOOL );
+        header->AddColumn( "issueDate",     DBTYPE_FILETIME );
+        header->AddColumn( "duration",      DBTYPE_I2 );
+        header->AddColumn( "stationID",     DBTYPE_I4 );
+        header->AddColumn( "regionID",      DBTYPE_I4 );
+        header->AddColumn( "solarSystemID", DBTYPE_I4 );
+        header->AddColumn( "jumps",         DBTYPE_I2 );
+
+    CRowSet* rowset = new CRowSet( &header );
+    for( uint32 i = 0; i < rows; ++i ) {
+        PyPackedRow* row = rowset->NewRow();
+            row->SetField( (uint32)0,  new PyLong( 50000 + (int64)( i % 997 ) * 1000 ) );
+            row->SetField( 1,  new PyFloat( 1000.0 + i % 50 ) );
+            row->SetField( 2,  new PyInt( 34 + i % 8 ) );
+            row->SetField( 3,  new PyInt( ( i % 3 == 0 ) ? -1 : 0 ) );
+            row->SetField( 4,  new PyLong( 100000000 + i ) );
+            row->SetField( 5,  new PyInt( 1000 ) );
+            row->SetField( 6,  new PyInt( 1 ) );
+            row->SetField( 7,  new PyBool( i % 2 == 0 ) );
+            row->SetField( 8,  new PyLong( 130000000000000000LL + (int64)i * 10000000 ) );
+            row->SetField( 9,  new PyInt( 90 ) );
+            row->SetField( 10, new PyInt( 60000004 + i % 20 ) );
+            row->SetField( 11, new PyInt( 10000002 ) );
+            row->SetField( 12, new PyInt( 30000142 ) );
+            row->SetField( 13, new PyInt( 0 ) );
+    }
+    return rowset;
+}
+
+/// mostly-empty rows, where the packed row zero compression does most of the work
+inline CRowSet* MakeSparseRowset( uint32 rows )
+{
+    DBRowDescriptor* header = new DBRowDescriptor();
+    for( uint8 i = 0; i < 16; ++i )
+        header->AddColumn( ( "col" + std::to_string( i ) ).c_str(), ( i % 2 == 0 ? DBTYPE_I8 : DBTYPE_I4 ) );
+
+    CRowSet* rowset = new CRowSet( &header );
+    for( uint32 i = 0; i < rows; ++i ) {
+        PyPackedRow* row = rowset->NewRow();
+        for( uint8 c = 0; c < 16; ++c ) {
+            const int32 value = ( c == 0 ? (int32)i : ( ( i + c ) % 7 == 0 ? (int32)c : 0 ) );
+            if( c % 2 == 0 )
+                row->SetField( c, new PyLong( value ) );
+            else
+                row->SetField( c, new PyInt( value ) );
+        }
+    }
+    return rowset;
+}
+
+/// destiny AddBalls for 'count' ships: state buffer, slim items and damage states
+inline PyTuple* MakeAddBalls( uint32 count )
+{
+    using namespace Destiny;
+
+    Buffer* state = new Buffer();
+    AddBall_header head = AddBall_header();
+        head.packet_type = 1;
+        head.stamp = 12345;
+    state->Append( head );
+
+    PyList* slims = new PyList();
+    PyDict* damageDict = new PyDict();
+    for( uint32 i = 0; i < count; ++i ) {
+        const int64 shipID = 140000000 + i;
+
+        BallHeader ball = BallHeader();
+            ball.entityID = shipID;
+            ball.mode = Ball::Mode::STOP;
+            ball.radius = 50.0f;
+            ball.posX = i * 1000.0;
+            ball.posY = 0.0;
+            ball.posZ = -( i * 500.0 );
+            ball.flags = Ball::Flag::IsFree | Ball::Flag::IsMassive;
+        state->Append( ball );
+        MassSector mass = MassSector();
+            mass.mass = 1000000.0;
+            mass.corporationID = 1000044;
+        state->Append( mass );
+        DataSector data = DataSector();
+            data.maxSpeed = 300.0f;
+            data.inertia = 0.5f;
+            data.speedfraction = 1.0f;
+        state->Append( data );
+
+        PyDict* slim = new PyDict();
+            slim->SetItemString( "itemID",          new PyLong( shipID ) );
+            slim->SetItemString( "typeID",          new PyInt( 587 ) );
+            slim->SetItemString( "name",            new PyString( "Rifter" ) );
+            slim->SetItemString( "ownerID",         new PyInt( 90000000 + i ) );
+            slim->SetItemString( "charID",          new PyInt( 90000000 + i ) );
+            slim->SetItemString( "corpID",          new PyInt( 1000044 ) );
+            slim->SetItemString( "allianceID",      PyStatic.NewNone() );
+            slim->SetItemString( "warFactionID",    PyStatic.NewNone() );
+            slim->SetItemString( "bounty",          new PyFloat( 0.0 ) );
+            slim->SetItemString( "securityStatus",  new PyFloat( 0.0 ) );
+            slim->SetItemString( "categoryID",      new PyInt( 6 ) );
+            slim->SetItemString( "groupID",         new PyInt( 25 ) );
+        PyList* modules = new PyList();
+        for( uint8 m = 0; m < 3; ++m )
+            modules->AddItem( new_tuple( new PyLong( shipID * 10 + m ), new PyInt( 3001 ) ) );
+        slim->SetItemString( "modules", modules );
+        slims->AddItem( new PyObject( "foo.SlimItem", slim ) );
+
+        // ((shield, recharge, timestamp), armor, structure)
+        PyTuple* shield = new_tuple( new PyFloat( 1.0 ), new PyFloat( 110000.0 ), new PyLong( 130000000000000000LL ) );
+        PyTuple* damage = new_tuple( shield, new PyFloat( 1.0 ), new PyFloat( 1.0 ) );
+        damageDict->SetItem( new PyLong( shipID ), damage );
+    }
+
+    PyTuple* chunk = new_tuple( new PyBuffer( &state ), slims, damageDict );
+    return new_tuple( new PyString( "AddBalls" ), new_tuple( chunk ) );
+}
+
+/// item info with 'count' dogma attributes, as sent by GetAllInfo
+inline PyDict* MakeItemAttributes( uint32 count )
+{
+    PyDict* attributes = new PyDict();
+    for( uint32 i = 0; i < count; ++i ) {
+        const uint16 attributeID = 2 + i * 3;
+        if( i % 3 == 0 )
+            attributes->SetItem( new PyInt( attributeID ), new PyInt( i * 10 ) );
+        else
+            attributes->SetItem( new PyInt( attributeID ), new PyFloat( i * 1.5 ) );
+    }
+
+    PyDict* item = new PyDict();
+        item->SetItemString( "itemID",      new PyLong( 140000001 ) );
+        item->SetItemString( "typeID",      new PyInt( 587 ) );
+        item->SetItemString( "ownerID",     new PyInt( 90000000 ) );
+        item->SetItemString( "locationID",  new PyInt( 60000004 ) );
+        item->SetItemString( "flagID",      new PyInt( 4 ) );
+        item->SetItemString( "attributes",  attributes );
+        item->SetItemString( "time",        new PyLong( 130000000000000000LL ) );
+    return item;
+}
+
+#endif /* !__BENCHMARK_PAYLOADS_H__INCL__ */
@@ -0,0 +1,129 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+#include "benchmark/Benchmark.h"
+#include "benchmark/Payloads.h"
+
+/* PyRep benchmarks.
+ *  Clone() of the benchmark payloads, and PyDict lookup/insert/iteration on a 300
+ *  attribute dict (int keys), a slim item (string keys) and keyword args sized dicts.
+ *
+ * usage: eve-test benchmark/PyRepBench [-j] [-t minTimeMs] [filter]
+ */
+
+int benchmark_PyRepBench( int argc, char* argv[] )
+{
+    BenchRunner bench( "pyrep", argc, argv );
+
+    PyRep* market = MakeMarketRowset( 10000 );
+    bench.Run( "Clone/market10k", [market]() {
+        PyRep* res = market->Clone();
+        PyDecRef( res );
+    } );
+    PyDecRef( market );
+
+    PyRep* addBalls = MakeAddBalls( 1000 );
+    bench.Run( "Clone/addballs1000", [addBalls]() {
+        PyRep* res = addBalls->Clone();
+        PyDecRef( res );
+    } );
+    PyDecRef( addBalls );
+
+    PyDict* item = MakeItemAttributes( 300 );
+    bench.Run( "Clone/item300", [item]() {
+        PyRep* res = item->Clone();
+        PyDecRef( res );
+    } );
+
+    // keys are made up front, as callers mostly look up with a key they already have
+    PyDict* attributes = item->GetItemString( "attributes" )->AsDict();
+    std::vector<PyInt*> keys;
+    for( PyDict::const_iterator cur = attributes->begin(); cur != attributes->end(); ++cur )
+        keys.push_back( new PyInt( cur->first->AsInt()->value() ) );
+    std::vector<PyInt*> missing;
+    for( size_t i = 0; i < keys.size(); ++i )
+        missing.push_back( new PyInt( 100000 + i ) );
+
+    volatile size_t found = 0;
+    bench.Run( "PyDict/GetItem/int300", [attributes, &keys, &found]() {
+        for( auto cur : keys )
+            if( attributes->GetItem( cur ) != nullptr )
+                ++found;
+    } );
+    bench.Run( "PyDict/GetItem/int300miss", [attributes, &missing, &found]() {
+        for( auto cur : missing )
+            if( attributes->GetItem( cur ) != nullptr )
+                ++found;
+    } );
+    bench.Run( "PyDict/SetItem/int300", [&keys]() {
+        PyDict* dict = new PyDict();
+        for( auto cur : keys )
+            dict->SetItem( new PyInt( cur->value() ), new PyFloat( 1.0 ) );
+        PyDecRef( dict );
+    } );
+    volatile int64 sum = 0;
+    bench.Run( "PyDict/iterate/int300", [attributes, &sum]() {
+        for( PyDict::const_iterator cur = attributes->begin(); cur != attributes->end(); ++cur )
+            sum += cur->first->AsInt()->value();
+    } );
+
+    // keyword args, KeyVal and session change sized
+    static const char* const KWARGS_KEYS[] = { "machoVersion", "locationID", "flag", "qty" };
+    bench.Run( "PyDict/SetItem/kwargs4", []() {
+        PyDict* dict = new PyDict();
+        for( auto cur : KWARGS_KEYS )
+            dict->SetItemString( cur, new PyInt( 1 ) );
+        PyDecRef( dict );
+    } );
+    PyDict* kwargs = new PyDict();
+    for( auto cur : KWARGS_KEYS )
+        kwargs->SetItemString( cur, new PyInt( 1 ) );
+    bench.Run( "PyDict/GetItemString/kwargs4", [kwargs, &found]() {
+        for( auto cur : KWARGS_KEYS )
+            if( kwargs->GetItemString( cur ) != nullptr )
+                ++found;
+    } );
+    PyDecRef( kwargs );
+
+    PyTuple* addBallsSlim = MakeAddBalls( 1 );
+    PyDict* slim = addBallsSlim->GetItem( 1 )->AsTuple()->GetItem( 0 )->AsTuple()->GetItem( 1 )->AsList()->GetItem( 0 )->AsObject()->arguments()->AsDict();
+    static const char* const SLIM_KEYS[] = { "itemID", "typeID", "ownerID", "corpID", "allianceID", "charID", "groupID", "modules" };
+    bench.Run( "PyDict/GetItemString/slim", [slim, &found]() {
+        for( auto cur : SLIM_KEYS )
+            if( slim->GetItemString( cur ) != nullptr )
+                ++found;
+    } );
+    PyDecRef( addBallsSlim );
+
+    for( auto cur : keys )
+        PyDecRef( cur );
+    for( auto cur : missing )
+        PyDecRef( cur );
+    PyDecRef( item );
+
+    return EXIT_SUCCESS;
+}
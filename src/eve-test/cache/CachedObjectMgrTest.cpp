@@ -0,0 +1,151 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+#include "benchmark/Payloads.h"
+
+/*
+ * Plays the cache part of a login twice against one CachedObjectMgr, the way
+ * ObjCacheService::GetCachableObject answers it: the client sends the version
+ * of its copy, and gets CacheOK back if that copy is current.
+ */
+
+namespace {
+
+const char* const LOGIN_OBJECTS[] = {
+    "config.BulkData.types",
+    "config.BulkData.groups",
+    "config.BulkData.categories",
+    "config.BulkData.dgmtypeattribs",
+    "config.BulkData.dgmtypeeffects",
+    "config.BulkData.owners",
+    "config.BulkData.locations",
+    "config.StaticOwners",
+};
+const size_t LOGIN_OBJECT_COUNT = sizeof( LOGIN_OBJECTS ) / sizeof( LOGIN_OBJECTS[ 0 ] );
+
+/// the client's cache: object name -> version
+typedef std::map<std::string, int64> ClientCache;
+
+void BuildCache( CachedObjectMgr& mgr, uint32 rows )
+{
+    for (size_t i = 0; i < LOGIN_OBJECT_COUNT; ++i) {
+        PyRep* rs = MakeMarketRowset( rows + i * 100 );
+        mgr.UpdateCache( LOGIN_OBJECTS[ i ], &rs );
+    }
+}
+
+/** @return bytes sent to the client for the cachable objects of one login. */
+size_t Login( CachedObjectMgr& mgr, ClientCache& client, uint32& sent )
+{
+    size_t bytes(0);
+    sent = 0;
+    for (size_t i = 0; i < LOGIN_OBJECT_COUNT; ++i) {
+        PyString* objectID = new PyString( LOGIN_OBJECTS[ i ] );
+
+        PyRep* rsp(nullptr);
+        ClientCache::iterator itr = client.find( LOGIN_OBJECTS[ i ] );
+        if (( itr != client.end() ) and mgr.IsCacheUpToDate( objectID, (uint32)itr->second )) {
+            rsp = new CacheOK();
+        } else {
+            PyObject* obj = mgr.GetCachedObject( objectID );
+            if (obj == nullptr) {
+                PyDecRef( objectID );
+                return 0;
+            }
+            // the version is the second half of the (timestamp, version) tuple in the args
+            client[ LOGIN_OBJECTS[ i ] ] = PyRep::IntegerValue( obj->arguments()->AsTuple()->GetItem( 0 )->AsTuple()->GetItem( 1 ) );
+            rsp = obj;
+            ++sent;
+        }
+
+        Buffer data;
+        Marshal( rsp, data );
+        bytes += data.size();
+
+        PyDecRef( rsp );
+        PyDecRef( objectID );
+    }
+
+    return bytes;
+}
+
+}
+
+int cache_CachedObjectMgrTest( int argc, char* argv[] )
+{
+    CachedObjectMgr mgr;
+    BuildCache( mgr, 500 );
+
+    ClientCache client;
+    uint32 sent(0);
+
+    const size_t first = Login( mgr, client, sent );
+    ::printf( "first login:  %lu bytes, %u objects sent\n", first, sent );
+    if (sent != LOGIN_OBJECT_COUNT) {
+        ::puts( "First login should get every object." );
+        return EXIT_FAILURE;
+    }
+
+    // cached data goes out shared, not copied
+    PyObject* obj1 = mgr.GetCachedObject( LOGIN_OBJECTS[ 0 ] );
+    PyObject* obj2 = mgr.GetCachedObject( LOGIN_OBJECTS[ 0 ] );
+    const bool shared = ( obj1->arguments()->AsTuple()->GetItem( 4 ) == obj2->arguments()->AsTuple()->GetItem( 4 ) );
+    PyDecRef( obj1 );
+    PyDecRef( obj2 );
+    if (!shared) {
+        ::puts( "GetCachedObject should share the cached data." );
+        return EXIT_FAILURE;
+    }
+
+    const size_t second = Login( mgr, client, sent );
+    ::printf( "second login: %lu bytes, %u objects sent\n", second, sent );
+    if (( sent != 0 ) or ( second * 100 > first )) {
+        ::puts( "Second login should only get CacheOK." );
+        return EXIT_FAILURE;
+    }
+
+    // same contents built again (server restart); new timestamps, same versions
+    BuildCache( mgr, 500 );
+    Login( mgr, client, sent );
+    ::printf( "after rebuild: %u objects sent\n", sent );
+    if (sent != 0) {
+        ::puts( "Rebuilding unchanged objects should keep client copies current." );
+        return EXIT_FAILURE;
+    }
+
+    // changed contents
+    PyRep* rs = MakeMarketRowset( 42 );
+    mgr.UpdateCache( LOGIN_OBJECTS[ 0 ], &rs );
+    Login( mgr, client, sent );
+    ::printf( "after change: %u objects sent\n", sent );
+    if (sent != 1) {
+        ::puts( "Only the changed object should be sent." );
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -38,12 +38,76 @@
 
 // auth
 #include "auth/PasswordModule.h"
+// cache
+#include "cache/CachedObjectMgr.h"
+// database
+#include "database/EVEDBUtils.h"
+// destiny
+#include "destiny/DestinyStructs.h"
 // marshal
 #include "marshal/EVEMarshal.h"
 #include "marshal/EVEUnmarshal.h"
+// network
+#include "network/EVETCPConnection.h"
+// python
+#include "python/PyPacket.h"
 // python/classes
 #include "python/classes/PyDatabase.h"
 // utils
 #include "utils/EvilNumber.h"
 
+/*************************************************************************/
+/* check helpers                                                         */
+/*************************************************************************/
+/* each test runs in a process of its own, so one failure count will do.
+ *  Check() reports and counts a failed condition, and the test returns CheckResult().
+ */
+inline uint32& CheckFailures()
+{
+    static uint32 failures = 0;
+    return failures;
+}
+
+inline void Check( bool ok, const char* what )
+{
+    if (ok)
+        return;
+    ::printf( "FAILED: %s\n", what );
+    ++CheckFailures();
+}
+
+inline int CheckResult()
+{
+    if (CheckFailures() > 0) {
+        ::printf( "%u checks failed.\n", CheckFailures() );
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/*************************************************************************/
+/* network helpers                                                       */
+/*************************************************************************/
+/* binds listener to a loopback port the system picks and starts listening, so tests
+ *  running side by side never fight over a port.  set socket options before calling.
+ *  returns the port, or 0 on failure.
+ */
+inline uint16 ListenLoopback( Socket& listener )
+{
+    sockaddr_in addr;
+    ::memset( &addr, 0, sizeof( addr ) );
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr( "127.0.0.1" );
+    addr.sin_port = 0;
+    if( listener.bind( (sockaddr*)&addr, sizeof( addr ) ) == SOCKET_ERROR )
+        return 0;
+    if( listener.listen() == SOCKET_ERROR )
+        return 0;
+
+    SOCKLEN_T len = sizeof( addr );
+    if( listener.getsockname( (sockaddr*)&addr, &len ) == SOCKET_ERROR )
+        return 0;
+    return ntohs( addr.sin_port );
+}
+
 #endif /* !__EVE_TEST_H__INCL__ */
@@ -0,0 +1,362 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+#include <algorithm>
+
+/* packed row marshaling, checked by an unmarshal round trip.
+ *  1) a row of every packed column type, with bool, null and None-in-bool fields and strings.
+ *  2) descriptors of 1-24 int64 columns, 0-9 bools and an optional int16 and uint8,
+ *     so the packed data ends on every length mod 16 and mod 64.  their rows are all zero,
+ *     all set, random with varied zero density, and set but for one zero run crossing the
+ *     64 byte boundary of the zero mask.  besides the round trip, their RLE bytes must match
+ *     the byte by byte encoder the zero mask one replaced, as validated against blue.dll.
+ *  every row is marshaled inside a tuple with a string column and a trailing sentinel,
+ *  so an RLE stream of the wrong length shows up as a broken sentinel.
+ */
+
+namespace {
+
+const int32 SENTINEL = 0x5A5A5A5A;
+
+uint32 sSeed = 12345;
+
+uint32 Random()
+{
+    sSeed = sSeed * 1103515245 + 12345;
+    return sSeed >> 8;
+}
+
+bool SameField( const PyRep* a, const PyRep* b )
+{
+    if( a->GetType() != b->GetType() )
+        return false;
+
+    switch( a->GetType() ) {
+        case PyRep::PyTypeNone:     return true;
+        case PyRep::PyTypeBool:     return a->AsBool()->value() == b->AsBool()->value();
+        case PyRep::PyTypeInt:      return a->AsInt()->value() == b->AsInt()->value();
+        case PyRep::PyTypeLong:     return a->AsLong()->value() == b->AsLong()->value();
+        case PyRep::PyTypeFloat:    return a->AsFloat()->value() == b->AsFloat()->value();
+        case PyRep::PyTypeString:   return a->AsString()->content() == b->AsString()->content();
+        case PyRep::PyTypeWString:  return a->AsWString()->content() == b->AsWString()->content();
+        default:                    return false;
+    }
+}
+
+/* marshals row with a sentinel after it into marshaled, unmarshals it and compares every field */
+bool RoundTrip( const PyPackedRow* row, Buffer& marshaled )
+{
+    PyTuple* tuple = new PyTuple( 2 );
+    PyIncRef( row );
+    tuple->SetItem( 0, const_cast<PyPackedRow*>( row ) );
+    tuple->SetItem( 1, new PyInt( SENTINEL ) );
+
+    bool res = Marshal( tuple, marshaled );
+    PyDecRef( tuple );
+    if( !res )
+        return false;
+
+    PyRep* rep = Unmarshal( marshaled );
+    if( rep == nullptr )
+        return false;
+
+    res = false;
+    PyTuple* out = rep->AsTuple();
+    if( (out->size() == 2) and out->GetItem( 0 )->IsPackedRow() and out->GetItem( 1 )->IsInt()
+        and (out->GetItem( 1 )->AsInt()->value() == SENTINEL) )
+    {
+        const PyPackedRow* outRow = out->GetItem( 0 )->AsPackedRow();
+        const uint32 columns = row->header()->ColumnCount();
+        res = (outRow->header()->ColumnCount() == columns);
+        for( uint32 i = 0; res and (i < columns); ++i )
+            res = SameField( row->GetField( i ), outRow->GetField( i ) );
+    }
+
+    PyDecRef( rep );
+    return res;
+}
+
+void CheckMixedRow()
+{
+    DBRowDescriptor* header = new DBRowDescriptor();
+    header->AddColumn( "flag1", DBTYPE_BOOL );
+    header->AddColumn( "itemID", DBTYPE_I8 );
+    header->AddColumn( "name", DBTYPE_STR );
+    header->AddColumn( "flag2", DBTYPE_BOOL );
+    header->AddColumn( "quantity", DBTYPE_I4 );
+    header->AddColumn( "price", DBTYPE_CY );
+    header->AddColumn( "flag3", DBTYPE_BOOL );
+    header->AddColumn( "volume", DBTYPE_R8 );
+    header->AddColumn( "radius", DBTYPE_R4 );
+    header->AddColumn( "flagID", DBTYPE_UI2 );
+    header->AddColumn( "delta", DBTYPE_I2 );
+    header->AddColumn( "singleton", DBTYPE_UI1 );
+    header->AddColumn( "bias", DBTYPE_I1 );
+    header->AddColumn( "typeID", DBTYPE_UI4 );
+    header->AddColumn( "description", DBTYPE_WSTR );
+    header->AddColumn( "flag4", DBTYPE_BOOL );
+
+    // every value, then every column None, then None in the bools only
+    for( uint8 pass = 0; pass < 3; ++pass ) {
+        const bool none = (pass == 1);
+        const bool noneBools = (pass != 0);
+
+        PyIncRef( header );
+        PyPackedRow* row = new PyPackedRow( header );
+        row->SetField( "flag1", noneBools ? (PyRep*)new PyNone() : new PyBool( true ) );
+        row->SetField( "itemID", none ? (PyRep*)new PyNone() : new PyLong( 0x0000010000000001LL ) );
+        row->SetField( "name", none ? (PyRep*)new PyNone() : new PyString( "Tritanium" ) );
+        row->SetField( "flag2", noneBools ? (PyRep*)new PyNone() : new PyBool( false ) );
+        row->SetField( "quantity", none ? (PyRep*)new PyNone() : new PyInt( -42 ) );
+        row->SetField( "price", none ? (PyRep*)new PyNone() : new PyLong( 0 ) );
+        row->SetField( "flag3", noneBools ? (PyRep*)new PyNone() : new PyBool( true ) );
+        row->SetField( "volume", none ? (PyRep*)new PyNone() : new PyFloat( 0.01 ) );
+        row->SetField( "radius", none ? (PyRep*)new PyNone() : new PyFloat( 2.5 ) );
+        row->SetField( "flagID", none ? (PyRep*)new PyNone() : new PyInt( 0xFF00 ) );
+        row->SetField( "delta", none ? (PyRep*)new PyNone() : new PyInt( -1 ) );
+        row->SetField( "singleton", none ? (PyRep*)new PyNone() : new PyInt( 0 ) );
+        row->SetField( "bias", none ? (PyRep*)new PyNone() : new PyInt( -128 ) );
+        row->SetField( "typeID", none ? (PyRep*)new PyNone() : new PyInt( 34 ) );
+        row->SetField( "description", none ? (PyRep*)new PyNone() : new PyWString( "mineral", 7 ) );
+        row->SetField( "flag4", noneBools ? (PyRep*)new PyNone() : new PyBool( false ) );
+
+        Buffer marshaled;
+        Check( RoundTrip( row, marshaled ), (pass == 0 ? "mixed row" : (pass == 1 ? "mixed row of None" : "mixed row with None bools")) );
+        PyDecRef( row );
+    }
+
+    PyDecRef( header );
+}
+
+/* 'bytes' is the fixed-size part of the row as it is packed: the int64 columns, then the int16, then the uint8 */
+PyPackedRow* NewRow( DBRowDescriptor* header, uint32 int64s, bool hasInt16, bool hasUInt8, uint32 bools, const std::vector<uint8>& bytes )
+{
+    PyIncRef( header );
+    PyPackedRow* row = new PyPackedRow( header );
+
+    uint32 index = 0, offset = 0;
+    for( uint32 i = 0; i < int64s; ++i, offset += 8 ) {
+        int64 value;
+        ::memcpy( &value, &bytes[ offset ], sizeof( value ) );
+        row->SetField( index++, new PyLong( value ) );
+    }
+    if( hasInt16 ) {
+        int16 value;
+        ::memcpy( &value, &bytes[ offset ], sizeof( value ) );
+        row->SetField( index++, new PyInt( value ) );
+        offset += 2;
+    }
+    if( hasUInt8 )
+        row->SetField( index++, new PyInt( bytes[ offset++ ] ) );
+
+    for( uint32 i = 0; i < bools; ++i ) {
+        const uint32 r = Random() % 3;
+        row->SetField( index++, r == 0 ? (PyRep*)new PyNone() : new PyBool( r == 1 ) );
+    }
+
+    row->SetField( index++, new PyString( std::string( Random() % 5, 'x' ) ) );
+    return row;
+}
+
+/* the zero compression as it was before the zero mask, byte by byte; size prefix included */
+void ReferenceRLE( const std::vector<uint8>& in, std::vector<uint8>& rle )
+{
+    std::vector<uint8> out( in.size() * 2, 0 );
+    size_t nibble_ix = 0, in_ix = 0, out_ix = 0;
+    int count = 0, zerochains = 0;
+    bool nibble = false;
+
+    while( in_ix < in.size() ) {
+        if( !nibble ) {
+            nibble_ix = out_ix++;
+            out[ nibble_ix ] = 0;
+        }
+
+        const size_t start = in_ix;
+        const size_t end = std::min( in_ix + 8, in.size() );
+        if( in[ in_ix ] ) {
+            zerochains = 0;
+            do {
+                out[ out_ix++ ] = in[ in_ix++ ];
+            } while( (in_ix < end) and in[ in_ix ] );
+            count = int( start - in_ix ) + 8;
+        } else {
+            ++zerochains;
+            while( (in_ix < end) and !in[ in_ix ] )
+                ++in_ix;
+            count = int( in_ix - start ) + 7;
+        }
+
+        if( nibble )
+            out[ nibble_ix ] |= (count << 4);
+        else
+            out[ nibble_ix ] = count;
+        nibble = !nibble;
+    }
+
+    if( nibble and zerochains )
+        ++zerochains;
+    while( zerochains > 1 ) {
+        zerochains -= 2;
+        out_ix -= 1;
+    }
+
+    // every row here is small enough for a one byte size
+    rle.assign( 1, (uint8)out_ix );
+    rle.insert( rle.end(), out.begin(), out.begin() + out_ix );
+}
+
+/* the packed data of a row made by NewRow(): the fixed-size bytes, then the bool bits, then the null bits */
+void PackedData( const PyPackedRow* row, const std::vector<uint8>& bytes, uint32 bools, std::vector<uint8>& data )
+{
+    const uint32 columns = row->header()->ColumnCount();
+    const uint32 firstBool = columns - bools - 1;
+    data = bytes;
+    data.resize( bytes.size() + ((bools + columns) >> 3) + 1, 0 );
+
+    uint8* bits = &data[ bytes.size() ];
+    for( uint32 i = 0; i < bools; ++i ) {
+        const PyRep* value = row->GetField( firstBool + i );
+        uint32 bit = i;
+        if( value->IsNone() )
+            bit = bools + firstBool + i;
+        else if( !value->AsBool()->value() )
+            continue;
+        bits[ bit >> 3 ] |= (1 << (bit & 0x7));
+    }
+}
+
+/* what follows the RLE bytes in RoundTrip()'s stream: the string column and the sentinel */
+void StreamTail( const PyPackedRow* row, std::vector<uint8>& tail )
+{
+    PyRep* str = row->GetField( row->header()->ColumnCount() - 1 );
+    PyIncRef( str );
+    PyTuple* tuple = new PyTuple( 2 );
+    tuple->SetItem( 0, str );
+    tuple->SetItem( 1, new PyInt( SENTINEL ) );
+
+    // skip the stream header and the two-tuple opcode
+    Buffer marshaled;
+    Marshal( tuple, marshaled );
+    PyDecRef( tuple );
+    tail.assign( &marshaled[ 0 ] + 6, &marshaled[ 0 ] + marshaled.size() );
+}
+
+bool EndsWith( const Buffer& marshaled, const std::vector<uint8>& suffix )
+{
+    if( marshaled.size() < suffix.size() )
+        return false;
+    return std::equal( suffix.begin(), suffix.end(), &marshaled[ 0 ] + marshaled.size() - suffix.size() );
+}
+
+void CheckRLE()
+{
+    uint32 rows = 0, failed = 0, mismatched = 0;
+    for( uint32 int64s = 1; int64s <= 24; ++int64s )
+    for( uint32 bools = 0; bools <= 9; ++bools )
+    for( uint8 extra = 0; extra < 4; ++extra ) {
+        const bool hasInt16 = (extra & 1), hasUInt8 = (extra & 2);
+
+        DBRowDescriptor* header = new DBRowDescriptor();
+        char name[ 16 ];
+        for( uint32 i = 0; i < int64s; ++i ) {
+            ::snprintf( name, sizeof( name ), "l%u", i );
+            header->AddColumn( name, DBTYPE_I8 );
+        }
+        if( hasInt16 )
+            header->AddColumn( "s", DBTYPE_I2 );
+        if( hasUInt8 )
+            header->AddColumn( "b", DBTYPE_UI1 );
+        for( uint32 i = 0; i < bools; ++i ) {
+            ::snprintf( name, sizeof( name ), "f%u", i );
+            header->AddColumn( name, DBTYPE_BOOL );
+        }
+        header->AddColumn( "str", DBTYPE_STR );
+
+        const size_t size = 8 * int64s + (hasInt16 ? 2 : 0) + (hasUInt8 ? 1 : 0);
+        std::vector<std::vector<uint8>> images;
+        images.push_back( std::vector<uint8>( size, 0 ) );
+        images.push_back( std::vector<uint8>( size, 0xA5 ) );
+        for( uint32 density = 0; density <= 4; ++density ) {
+            std::vector<uint8> bytes( size );
+            for( auto& cur : bytes )
+                cur = ((Random() % 4) < density ? 0 : (uint8)(1 + Random() % 255));
+            images.push_back( bytes );
+        }
+        // one zero run from just before to just after the first mask word boundary
+        const size_t starts[] = { 57, 60, 63, 64, 65 };
+        const size_t lengths[] = { 1, 3, 8, 9, 15 };
+        for( auto start : starts )
+        for( auto length : lengths ) {
+            if( start + length > size )
+                continue;
+            std::vector<uint8> bytes( size, 0x11 );
+            ::memset( &bytes[ start ], 0, length );
+            images.push_back( bytes );
+        }
+
+        for( auto& cur : images ) {
+            PyPackedRow* row = NewRow( header, int64s, hasInt16, hasUInt8, bools, cur );
+            ++rows;
+            Buffer marshaled;
+            if( !RoundTrip( row, marshaled ) ) {
+                if( failed++ < 10 )
+                    ::printf( "RLE round trip failed: %u int64, int16 %d, uint8 %d, %u bools.\n", int64s, hasInt16, hasUInt8, bools );
+            }
+
+            std::vector<uint8> data, expected, tail;
+            PackedData( row, cur, bools, data );
+            ReferenceRLE( data, expected );
+            StreamTail( row, tail );
+            expected.insert( expected.end(), tail.begin(), tail.end() );
+            if( !EndsWith( marshaled, expected ) ) {
+                if( mismatched++ < 10 )
+                    ::printf( "RLE bytes differ: %u int64, int16 %d, uint8 %d, %u bools.\n", int64s, hasInt16, hasUInt8, bools );
+            }
+            PyDecRef( row );
+        }
+
+        PyDecRef( header );
+    }
+
+    ::printf( "%u of %u rows failed the round trip, %u differ from the reference RLE.\n", failed, rows, mismatched );
+    Check( failed == 0, "RLE round trips" );
+    Check( mismatched == 0, "RLE matches the reference" );
+}
+
+}
+
+int marshal_PackedRowTest( int argc, char* argv[] )
+{
+    ::puts( "Mixed columns..." );
+    CheckMixedRow();
+
+    ::puts( "Zero runs and tails..." );
+    CheckRLE();
+
+    return CheckResult();
+}
@@ -0,0 +1,274 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+#include <atomic>
+
+/* inbound decode on the connection thread.
+ *  raw loopback sockets feed ~20k call packets/s for one second, split over several
+ *  EVETCPConnections with packet decoding enabled, while this thread pops them like the
+ *  main loop does.  the calls carry None and bools, which unmarshal to the PyStatic
+ *  singletons, and this thread keeps taking and dropping those same singletons meanwhile.
+ *  this thread's cpu time per packet (less the churn) must come in under what unmarshal +
+ *  decode of the same packets costs when done here, every packet must arrive decoded with
+ *  its None and bools intact, and the singletons' refcounts must not move.
+ */
+
+namespace {
+
+const uint32 CONNECTIONS = 4;
+// over all connections
+const uint32 PACKETS_PER_MS = 20;
+const uint32 PACKET_COUNT = 20000;
+// PyStatic take/drop rounds per idle poll
+const uint32 CHURN = 1000;
+
+double ThreadCPUTime()
+{
+#ifdef HAVE_WINSOCK2_H
+    FILETIME create, exit, kernel, user;
+    ::GetThreadTimes( ::GetCurrentThread(), &create, &exit, &kernel, &user );
+    return ( ( (double)user.dwHighDateTime + kernel.dwHighDateTime ) * 4294967296.0
+             + user.dwLowDateTime + kernel.dwLowDateTime ) / 1e7;
+#else
+    timespec ts;
+    ::clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts );
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif /* HAVE_WINSOCK2_H */
+}
+
+// a client call with a moderately sized argument list
+Buffer* BuildCall( uint32 callID )
+{
+    PyPacket packet;
+    packet.type_string = "carbon.common.script.net.machoNetPacket.CallReq";
+    packet.type = CALL_REQ;
+    packet.source.type = PyAddress::Client;
+    packet.source.objectID = 1;
+    packet.source.callID = callID;
+    packet.dest.type = PyAddress::Node;
+    packet.dest.objectID = 888444;
+    packet.dest.service = "invbroker";
+    packet.userid = 1;
+
+    PyList* list = new PyList();
+    for( uint32 i = 0; i < 32; ++i )
+        list->AddItemInt( 140000000 + i );
+    PyTuple* args = new PyTuple( 6 );
+        args->SetItem( 0, new PyString( "GetItemsByID" ) );
+        args->SetItem( 1, list );
+        args->SetItem( 2, new PyFloat( 1.5 ) );
+        args->SetItem( 3, new PyNone() );
+        args->SetItem( 4, new PyBool( true ) );
+        args->SetItem( 5, new PyBool( false ) );
+    packet.payload = new PyTuple( 1 );
+    packet.payload->SetItem( 0, args );
+
+    PyRep* rep = packet.Encode();
+    Buffer* buf = new Buffer();
+    Marshal( rep, *buf );
+    // Encode() hands its payload over to rep
+    packet.payload = nullptr;
+    PyDecRef( rep );
+    return buf;
+}
+
+// true if the call's None and bools came through
+bool CheckArgs( const PyPacket* packet )
+{
+    if( ( packet->payload == nullptr ) or ( packet->payload->size() != 1 ) or !packet->payload->GetItem( 0 )->IsTuple() )
+        return false;
+    const PyTuple* args = packet->payload->GetItem( 0 )->AsTuple();
+    return ( ( args->size() == 6 ) and args->GetItem( 3 )->IsNone()
+             and args->GetItem( 4 )->IsBool() and args->GetItem( 4 )->AsBool()->value()
+             and args->GetItem( 5 )->IsBool() and !args->GetItem( 5 )->AsBool()->value() );
+}
+
+// paces framed packets out at this connection's share of PACKETS_PER_MS
+void Feeder( Socket* source, const std::vector<Buffer*>* packets, std::atomic<bool>* running )
+{
+    for( uint32 i = 0; ( i < packets->size() ) and running->load(); ) {
+        Buffer frame;
+        for( uint32 k = 0; ( k < PACKETS_PER_MS / CONNECTIONS ) and ( i < packets->size() ); ++k, ++i ) {
+            const Buffer* cur = ( *packets )[ i ];
+            frame.Append<uint32>( (uint32)cur->size() );
+            frame.AppendSeq( cur->begin<uint8>(), cur->end<uint8>() );
+        }
+        source->send( &frame[ 0 ], (uint)frame.size(), 0 );
+        Sleep( 1 );
+    }
+}
+
+}
+
+int network_EVETCPConnectionDecodeTest( int argc, char* argv[] )
+{
+    const uint32 loopback = inet_addr( "127.0.0.1" );
+    Socket listener( AF_INET, SOCK_STREAM, 0 );
+
+    const uint16 port = ListenLoopback( listener );
+    if( port == 0 ) {
+        ::puts( "Failed to open loopback listener." );
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Buffer*> packets;
+    packets.reserve( PACKET_COUNT );
+    for( uint32 i = 0; i < PACKET_COUNT; ++i )
+        packets.push_back( BuildCall( i + 1 ) );
+
+    int result = EXIT_SUCCESS;
+
+    // what the main loop used to pay per packet
+    double startTime = ThreadCPUTime();
+    uint32 decoded = 0;
+    for( auto cur : packets ) {
+        PyRep* rep = InflateUnmarshal( *cur );
+        PyPacket* packet = new PyPacket();
+        if( packet->Decode( &rep ) )
+            ++decoded;
+        SafeDelete( packet );
+    }
+    const double inlineCost = ( ThreadCPUTime() - startTime ) / PACKET_COUNT;
+    if( decoded != PACKET_COUNT ) {
+        ::printf( "Only %u of %u test packets decoded.\n", decoded, PACKET_COUNT );
+        result = EXIT_FAILURE;
+    }
+
+    // PyStatic counts before any connection thread runs
+    PyRep* statics[ 3 ] = { PyStatic.NewNone(), PyStatic.NewTrue(), PyStatic.NewFalse() };
+    uint16 staticCounts[ 3 ];
+    for( uint8 k = 0; k < 3; ++k )
+        staticCounts[ k ] = statics[ k ]->GetCount();
+
+    char errbuf[ TCPCONN_ERRBUF_SIZE ];
+    std::vector<EVETCPConnection*> conns;
+    std::vector<Socket*> sources;
+    std::vector< std::vector<Buffer*> > shares( CONNECTIONS );
+    for( uint32 i = 0; i < PACKET_COUNT; ++i )
+        shares[ i % CONNECTIONS ].push_back( packets[ i ] );
+    for( uint32 c = 0; c < CONNECTIONS; ++c ) {
+        EVETCPConnection* conn = new EVETCPConnection();
+        if( !conn->Connect( loopback, port, errbuf ) ) {
+            ::printf( "Connect %u failed: %s\n", c, errbuf );
+            SafeDelete( conn );
+            result = EXIT_FAILURE;
+            break;
+        }
+        Socket* source = listener.accept( nullptr, nullptr );
+        if( source == nullptr ) {
+            ::printf( "Accept %u failed.\n", c );
+            SafeDelete( conn );
+            result = EXIT_FAILURE;
+            break;
+        }
+        conn->SetDecodePackets( true );
+        conns.push_back( conn );
+        sources.push_back( source );
+    }
+
+    std::atomic<bool> running( true );
+    std::vector<std::thread> feeders;
+    for( uint32 c = 0; c < conns.size(); ++c )
+        feeders.emplace_back( Feeder, sources[ c ], &shares[ c ], &running );
+
+    // pop like EVEClientSession::PopPacket() does, polling once per ms when idle
+    uint32 received = 0, undecoded = 0, badArgs = 0;
+    const uint32 expected = (uint32)conns.size() * ( PACKET_COUNT / CONNECTIONS );
+    double churnTime = 0;
+    const double stopTime = GetTimeMSeconds() + 10000;
+    startTime = ThreadCPUTime();
+    while( ( received + undecoded < expected ) and ( GetTimeMSeconds() < stopTime ) ) {
+        bool idle = true;
+        for( auto conn : conns ) {
+            PyRep* rep(nullptr);
+            PyPacket* packet = conn->PopPacket( rep );
+            if( packet != nullptr ) {
+                idle = false;
+                ++received;
+                if( !CheckArgs( packet ) )
+                    ++badArgs;
+                SafeDelete( packet );
+            } else if( rep != nullptr ) {
+                idle = false;
+                ++undecoded;
+                PyDecRef( rep );
+            }
+        }
+        if( !idle )
+            continue;
+
+        // the main loop hands out PyStatic all the time
+        const double churnStart = ThreadCPUTime();
+        for( uint32 k = 0; k < CHURN; ++k ) {
+            PyRep* none = PyStatic.NewNone();
+            PyRep* yes = PyStatic.NewTrue();
+            PyRep* no = PyStatic.NewFalse();
+            PyDecRef( none );
+            PyDecRef( yes );
+            PyDecRef( no );
+        }
+        churnTime += ThreadCPUTime() - churnStart;
+        Sleep( 1 );
+    }
+    const double threadedCost = ( ThreadCPUTime() - startTime - churnTime ) / PACKET_COUNT;
+
+    ::printf( "Main thread cpu per packet: %.2fus inline, %.2fus with connection thread decode over %lu connections.\n", \
+              inlineCost * 1e6, threadedCost * 1e6, conns.size() );
+    if( received != PACKET_COUNT ) {
+        ::printf( "Received %u decoded and %u undecoded packets of %u.\n", received, undecoded, PACKET_COUNT );
+        result = EXIT_FAILURE;
+    }
+    if( badArgs > 0 ) {
+        ::printf( "%u packets lost their None or bools.\n", badArgs );
+        result = EXIT_FAILURE;
+    }
+    if( threadedCost >= inlineCost ) {
+        ::puts( "Main thread cost per packet did not drop." );
+        result = EXIT_FAILURE;
+    }
+
+    running = false;
+    for( auto& cur : feeders )
+        cur.join();
+    for( auto cur : conns )
+        SafeDelete( cur );
+    for( auto cur : sources )
+        SafeDelete( cur );
+    for( auto cur : packets )
+        SafeDelete( cur );
+
+    // every packet is gone, so the singletons must be back where they started
+    for( uint8 k = 0; k < 3; ++k ) {
+        if( statics[ k ]->IsDeleted() or ( statics[ k ]->GetCount() != staticCounts[ k ] ) ) {
+            ::printf( "PyStatic %s refcount went from %u to %u.\n", statics[ k ]->TypeString(), staticCounts[ k ], statics[ k ]->GetCount() );
+            result = EXIT_FAILURE;
+        }
+        PyDecRef( statics[ k ] );
+    }
+
+    return result;
+}
@@ -0,0 +1,248 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+/* send class backpressure against a slow reader.
+ *  the far end of a loopback connection reads ~1.6MB/s through a small receive buffer.
+ *  1) droppable destiny traffic at ~32MB/s, with a SetState every 100ms, must stay
+ *     under window + the destiny budget, and the connection must stay up.
+ *     the non-droppable destiny traffic mixed in must all reach the reader.
+ *  2) ordered packets spread over every class, under the same backpressure and next to
+ *     SetStates and over-budget classes, must all arrive, in the order they were queued.
+ *  3) non-droppable notify traffic must get the connection dropped at the hard limit,
+ *     without the backlog going past it.
+ */
+
+namespace {
+
+// ordered packets carry "<sn:########>"; nothing else sent here has a '<' in it
+const char SN_MARKER[] = "<sn:";
+const size_t SN_SIZE = 13;
+
+std::string OrderedPacket( uint32 sn, uint32 size )
+{
+    char marker[ SN_SIZE + 1 ];
+    ::snprintf( marker, sizeof( marker ), "<sn:%08u>", sn );
+    return std::string( marker ) + std::string( size, 'o' );
+}
+
+struct ReaderStats {
+    std::atomic<int64> events;
+    std::atomic<uint32> lastSn;
+    std::atomic<uint32> snErrors;
+};
+
+// reads at most 16KB every 10ms (or as fast as it can while draining), counting 'e' bytes
+//  and checking the sequence numbers of ordered packets
+void SlowReader( Socket* sink, std::atomic<bool>* running, std::atomic<bool>* draining, ReaderStats* stats )
+{
+    Buffer buf( 0x4000 );
+    std::string pending;
+    while( running->load() ) {
+        int len = sink->recv( &buf[ 0 ], (uint)buf.size(), MSG_DONTWAIT );
+        if( len > 0 ) {
+            stats->events += std::count( &buf[ 0 ], &buf[ 0 ] + len, 'e' );
+
+            // a marker may straddle two reads, so the tail of this one is kept
+            pending.append( (const char*)&buf[ 0 ], len );
+            size_t pos = 0, end = 0;
+            while( ((pos = pending.find( SN_MARKER, end )) != std::string::npos) and (pending.size() >= pos + SN_SIZE) ) {
+                uint32 sn = (uint32)::strtoul( pending.c_str() + pos + 4, nullptr, 10 );
+                if( sn != stats->lastSn.load() + 1 )
+                    ++stats->snErrors;
+                stats->lastSn = sn;
+                end = pos + SN_SIZE;
+            }
+            // anything shorter than a marker past the last one may be the start of the next
+            if( pending.size() > end + SN_SIZE - 1 )
+                end = pending.size() - (SN_SIZE - 1);
+            pending.erase( 0, end );
+        }
+        if( !draining->load() or (len <= 0) )
+            Sleep( draining->load() ? 1 : 10 );
+    }
+}
+
+int64 Backlog( const EVETCPConnection* conn )
+{
+    return conn->GetStagedBytes() + conn->GetSendQueueBytes();
+}
+
+}
+
+int network_EVETCPConnectionTest( int argc, char* argv[] )
+{
+    const uint32 loopback = inet_addr( "127.0.0.1" );
+    Socket listener( AF_INET, SOCK_STREAM, 0 );
+    int rcvbuf = 4096;
+    listener.setopt( SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof( rcvbuf ) );
+
+    const uint16 port = ListenLoopback( listener );
+    if( port == 0 ) {
+        ::puts( "Failed to open loopback listener." );
+        return EXIT_FAILURE;
+    }
+
+    char errbuf[ TCPCONN_ERRBUF_SIZE ];
+    EVETCPConnection* conn = new EVETCPConnection();
+    if( !conn->Connect( loopback, port, errbuf ) ) {
+        ::printf( "Connect failed: %s\n", errbuf );
+        SafeDelete( conn );
+        return EXIT_FAILURE;
+    }
+    Socket* sink = listener.accept( nullptr, nullptr );
+    if( sink == nullptr ) {
+        ::puts( "Accept failed." );
+        SafeDelete( conn );
+        return EXIT_FAILURE;
+    }
+    sink->setblocking( false );
+
+    std::atomic<bool> running( true );
+    std::atomic<bool> draining( false );
+    ReaderStats stats;
+    stats.events = 0;
+    stats.lastSn = 0;
+    stats.snErrors = 0;
+    std::thread reader( SlowReader, sink, &running, &draining, &stats );
+
+    int result = EXIT_SUCCESS;
+    const uint32 packetSize = 4096;
+    const uint32 eventSize = 512;
+    const uint32 ticks = 2000;
+    const uint32 setStateTicks = 100;
+
+    ::puts( "Flooding droppable destiny updates..." );
+    int64 maxBacklog = 0;
+    for( uint32 tick = 0; tick < ticks; ++tick ) {
+        for( uint8 i = 0; i < 8; ++i )
+            conn->QueueRep( new PyString( std::string( packetSize, 'd' ) ), false, EVETCPConnection::SEND_DESTINY, EVETCPConnection::SEND_FLAG_DROPPABLE );
+        // stands in for AddBalls and events, which must never be dropped
+        conn->QueueRep( new PyString( std::string( eventSize, 'e' ) ), false, EVETCPConnection::SEND_DESTINY );
+        if( tick % setStateTicks == 0 )
+            conn->QueueRep( new PyString( std::string( packetSize, 's' ) ), false, EVETCPConnection::SEND_DESTINY, EVETCPConnection::SEND_FLAG_SUPERSEDE );
+        conn->FlushSendQueue();
+        maxBacklog = std::max( maxBacklog, Backlog( conn ) );
+        Sleep( 1 );
+    }
+
+    // window can be overshot by one packet, and the budget by the events it cannot drop
+    const int64 destinyLimit = EVETCPConnection::SEND_WINDOW + EVETCPConnection::SEND_BUDGET[ EVETCPConnection::SEND_DESTINY ] + 2 * packetSize;
+    ::printf( "Max backlog %li bytes (limit %li), dropped %li bytes.\n", maxBacklog, destinyLimit, conn->GetDroppedBytes() );
+    if( maxBacklog > destinyLimit ) {
+        ::puts( "Destiny backlog was not bounded." );
+        result = EXIT_FAILURE;
+    }
+    if( conn->GetDroppedBytes() == 0 ) {
+        ::puts( "No stale destiny updates were dropped." );
+        result = EXIT_FAILURE;
+    }
+    if( conn->GetState() != TCPConnection::STATE_CONNECTED ) {
+        ::puts( "Connection was dropped for droppable traffic." );
+        result = EXIT_FAILURE;
+    }
+
+    // let the reader catch up, socket buffers included, then check no event bytes went missing
+    const int64 eventBytes = int64( ticks ) * eventSize;
+    draining = true;
+    for( uint32 i = 0; (i < 3000) and (stats.events.load() < eventBytes); ++i ) {
+        conn->FlushSendQueue();
+        Sleep( 10 );
+    }
+    if( stats.events.load() < eventBytes ) {
+        ::printf( "Only %li of %li event bytes arrived.\n", stats.events.load(), eventBytes );
+        result = EXIT_FAILURE;
+    }
+    draining = false;
+
+    ::puts( "Queueing ordered packets in every class..." );
+    const uint8 orderedClasses[] = { EVETCPConnection::SEND_NOTIFY, EVETCPConnection::SEND_DESTINY, EVETCPConnection::SEND_CALL };
+    const uint32 orderedTicks = 500;
+    uint32 sn = 0;
+    for( uint32 tick = 0; tick < orderedTicks; ++tick ) {
+        for( uint8 i = 0; i < 4; ++i )
+            conn->QueueRep( new PyString( std::string( packetSize, 'd' ) ), false, EVETCPConnection::SEND_DESTINY, EVETCPConnection::SEND_FLAG_DROPPABLE );
+        // keeps the notify class over its budget
+        conn->QueueRep( new PyString( std::string( 4 * packetSize, 'n' ) ), false, EVETCPConnection::SEND_NOTIFY, EVETCPConnection::SEND_FLAG_DROPPABLE );
+        for( uint8 i = 0; i < 3; ++i ) {
+            ++sn;
+            // droppable too, which ordered must override
+            conn->QueueRep( new PyString( OrderedPacket( sn, (sn % 7) * 256 ) ), false, orderedClasses[ sn % 3 ],
+                            EVETCPConnection::SEND_FLAG_ORDERED | EVETCPConnection::SEND_FLAG_DROPPABLE );
+        }
+        if( tick % 50 == 0 )
+            conn->QueueRep( new PyString( std::string( packetSize, 's' ) ), false, EVETCPConnection::SEND_DESTINY, EVETCPConnection::SEND_FLAG_SUPERSEDE );
+        conn->FlushSendQueue();
+        Sleep( 1 );
+    }
+
+    draining = true;
+    for( uint32 i = 0; (i < 3000) and (stats.lastSn.load() < sn); ++i ) {
+        conn->FlushSendQueue();
+        Sleep( 10 );
+    }
+    draining = false;
+    ::printf( "Last ordered packet %u of %u, %u out of order.\n", stats.lastSn.load(), sn, stats.snErrors.load() );
+    if( (stats.lastSn.load() != sn) or (stats.snErrors.load() != 0) ) {
+        ::puts( "Ordered packets were lost or reordered." );
+        result = EXIT_FAILURE;
+    }
+    if( conn->GetState() != TCPConnection::STATE_CONNECTED ) {
+        ::puts( "Connection was dropped for ordered traffic." );
+        result = EXIT_FAILURE;
+    }
+
+    ::puts( "Flooding notifications..." );
+    maxBacklog = 0;
+    const uint32 bigSize = 64 * 1024;
+    uint32 sent = 0;
+    while( (conn->GetState() == TCPConnection::STATE_CONNECTED) and (sent < 1024) ) {
+        conn->QueueRep( new PyString( std::string( bigSize, 'n' ) ), false, EVETCPConnection::SEND_NOTIFY );
+        maxBacklog = std::max( maxBacklog, Backlog( conn ) );
+        ++sent;
+    }
+
+    ::printf( "Disconnected after %u packets, max backlog %li bytes (limit %u).\n", sent, maxBacklog, EVETCPConnection::SEND_HARD_LIMIT );
+    if( conn->GetState() == TCPConnection::STATE_CONNECTED ) {
+        ::puts( "Connection was not dropped at the hard limit." );
+        result = EXIT_FAILURE;
+    }
+    if( maxBacklog > EVETCPConnection::SEND_HARD_LIMIT + bigSize ) {
+        ::puts( "Backlog went past the hard limit." );
+        result = EXIT_FAILURE;
+    }
+
+    SafeDelete( conn );
+    running = false;
+    reader.join();
+    SafeDelete( sink );
+
+    return result;
+}
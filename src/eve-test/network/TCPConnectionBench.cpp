@@ -0,0 +1,172 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+#include <atomic>
+#include <chrono>
+
+#ifndef HAVE_WINSOCK2_H
+#   include <sys/resource.h>
+#endif /* !HAVE_WINSOCK2_H */
+
+/* send path benchmark.
+ *  opens 'count' loopback TCPConnections (default 1000), queues 'perTick' buffers on each
+ *  per simulated tick from this thread, and reports send calls per second, buffers per
+ *  send call, and Send() (enqueue) latency.  the old path made one send() per buffer.
+ *
+ * usage: eve-test network/TCPConnectionBench [count] [ticks] [perTick]
+ */
+
+namespace {
+
+class BenchConnection
+: public TCPConnection
+{
+public:
+    BenchConnection() : TCPConnection() { }
+    // stop the loop while our ProcessReceivedData() is still around
+    ~BenchConnection() { Disconnect(); WaitLoop(); }
+
+protected:
+    bool ProcessReceivedData( char* errbuf = 0 ) { return true; }
+};
+
+// reads and discards everything sent to the accepted sockets
+void SinkLoop( std::vector<Socket*>* sinks, std::atomic<bool>* running )
+{
+    Buffer buf( 0x10000 );
+    while( running->load() ) {
+        bool idle = true;
+        for( auto cur : *sinks ) {
+            int status = cur->recv( &buf[ 0 ], (uint)buf.size(), MSG_DONTWAIT );
+            if( (status != SOCKET_ERROR) and (status > 0) )
+                idle = false;
+        }
+        if( idle )
+            Sleep( 1 );
+    }
+}
+
+}
+
+int network_TCPConnectionBench( int argc, char* argv[] )
+{
+    const uint32 count = ( argc > 1 ? atoi( argv[ 1 ] ) : 1000 );
+    const uint32 ticks = ( argc > 2 ? atoi( argv[ 2 ] ) : 200 );
+    const uint32 perTick = ( argc > 3 ? atoi( argv[ 3 ] ) : 8 );
+    const uint32 bufSize = 256;
+
+#ifndef HAVE_WINSOCK2_H
+    // two sockets per connection plus the listener
+    rlimit lim;
+    if( ::getrlimit( RLIMIT_NOFILE, &lim ) == 0 ) {
+        lim.rlim_cur = std::max< rlim_t >( lim.rlim_cur, std::min< rlim_t >( lim.rlim_max, count * 2 + 64 ) );
+        ::setrlimit( RLIMIT_NOFILE, &lim );
+    }
+#endif /* !HAVE_WINSOCK2_H */
+
+    const uint32 loopback = inet_addr( "127.0.0.1" );
+    Socket listener( AF_INET, SOCK_STREAM, 0 );
+    const uint16 port = ListenLoopback( listener );
+    if( port == 0 ) {
+        ::puts( "Failed to open loopback listener." );
+        return EXIT_FAILURE;
+    }
+
+    char errbuf[ TCPCONN_ERRBUF_SIZE ];
+    std::vector<BenchConnection*> conns;
+    std::vector<Socket*> sinks;
+    conns.reserve( count );
+    sinks.reserve( count );
+    for( uint32 i = 0; i < count; ++i ) {
+        BenchConnection* conn = new BenchConnection();
+        if( !conn->Connect( loopback, port, errbuf ) ) {
+            ::printf( "Connect %u failed: %s\n", i, errbuf );
+            SafeDelete( conn );
+            break;
+        }
+        Socket* sink = listener.accept( nullptr, nullptr );
+        if( sink == nullptr ) {
+            ::printf( "Accept %u failed.\n", i );
+            SafeDelete( conn );
+            break;
+        }
+        sink->setblocking( false );
+        conns.push_back( conn );
+        sinks.push_back( sink );
+    }
+    ::printf( "Opened %lu of %u loopback connections.\n", conns.size(), count );
+
+    std::atomic<bool> running( true );
+    std::thread sinkThread( SinkLoop, &sinks, &running );
+
+    std::vector<double> latency;
+    latency.reserve( conns.size() * ticks * perTick );
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    for( uint32 t = 0; t < ticks; ++t ) {
+        for( auto cur : conns ) {
+            for( uint32 k = 0; k < perTick; ++k ) {
+                Buffer* buf = new Buffer( bufSize, (uint8)k );
+                std::chrono::steady_clock::time_point sendTime = std::chrono::steady_clock::now();
+                cur->Send( &buf );
+                latency.push_back( std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - sendTime ).count() );
+            }
+        }
+        Sleep( 1 );
+    }
+
+    // wait for everything to hit the wire
+    const int64 total = (int64)latency.size();
+    int64 sent = 0, calls = 0;
+    const std::chrono::steady_clock::time_point stopTime = std::chrono::steady_clock::now() + std::chrono::seconds( 30 );
+    while( true ) {
+        sent = calls = 0;
+        for( auto cur : conns ) {
+            sent += cur->GetSentBuffers();
+            calls += cur->GetSendCalls();
+        }
+        if( (sent >= total) or (std::chrono::steady_clock::now() > stopTime) )
+            break;
+        Sleep( 1 );
+    }
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - startTime ).count();
+
+    std::sort( latency.begin(), latency.end() );
+    const size_t n = latency.size();
+    ::printf( "Buffers: %li queued, %li sent in %.2fs\n", total, sent, seconds );
+    ::printf( "Send calls: %li (%.0f/s), %.2f buffers per call\n", calls, calls / seconds, ( calls > 0 ? (double)sent / calls : 0.0 ) );
+    if( n > 0 )
+        ::printf( "Enqueue latency (us): p50 %.3f  p99 %.3f  max %.3f\n", latency[ n / 2 ], latency[ n * 99 / 100 ], latency[ n - 1 ] );
+
+    for( auto cur : conns )
+        SafeDelete( cur );
+    running = false;
+    sinkThread.join();
+    for( auto cur : sinks )
+        SafeDelete( cur );
+
+    return ( sent >= total ? EXIT_SUCCESS : EXIT_FAILURE );
+}
@@ -0,0 +1,145 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+/* copy-on-write containers.
+ *  Clone() copies a container shallowly, sharing its items by refcount, and
+ *  MakeMutable() copies only when somebody else holds a reference; either way
+ *  a change through the copy must not show in the original.
+ */
+
+namespace {
+
+void TestTuple()
+{
+    PyTuple* tuple = new_tuple( new PyInt( 1 ), new PyString( "two" ) );
+    Check( tuple->MakeMutable() == tuple, "MakeMutable of an unshared tuple is itself" );
+
+    PyRep* item = tuple->GetItem( 1 );
+    const uint16 count = item->GetCount();
+    PyTuple* copy = tuple->Clone()->AsTuple();
+    Check( copy->GetItem( 1 ) == item, "Clone shares items" );
+    Check( item->GetCount() == count + 1, "Clone holds its own reference to items" );
+
+    copy->SetItem( 1, new PyString( "three" ) );
+    Check( !item->IsDeleted() and ( tuple->GetItem( 1 ) == item ), "SetItem on a clone leaves the original alone" );
+    PyDecRef( copy );
+
+    // shared: MakeMutable copies and drops our reference
+    PyIncRef( tuple );
+    PyTuple* mine = tuple->MakeMutable();
+    Check( mine != tuple, "MakeMutable of a shared tuple copies" );
+    Check( tuple->GetCount() == 1, "MakeMutable drops the shared reference" );
+    mine->SetItem( 0, new PyInt( 5 ) );
+    Check( PyRep::IntegerValue( tuple->GetItem( 0 ) ) == 1, "change to the copy doesn't show in the original" );
+    PyDecRef( mine );
+    PyDecRef( tuple );
+}
+
+void TestDict()
+{
+    PyDict* dict = new PyDict();
+    dict->SetItemString( "a", new PyInt( 1 ) );
+    Check( dict->MakeMutable() == dict, "MakeMutable of an unshared dict is itself" );
+
+    PyIncRef( dict );
+    PyDict* mine = dict->MakeMutable();
+    Check( mine != dict, "MakeMutable of a shared dict copies" );
+    mine->SetItemString( "a", new PyInt( 2 ) );
+    mine->SetItemString( "b", new PyInt( 3 ) );
+    Check( ( dict->size() == 1 ) and ( PyRep::IntegerValue( dict->GetItemString( "a" ) ) == 1 ), "change to the copy doesn't show in the original" );
+    Check( ( mine->size() == 2 ) and ( PyRep::IntegerValue( mine->GetItemString( "a" ) ) == 2 ), "copy has the change" );
+    PyDecRef( mine );
+    PyDecRef( dict );
+}
+
+void TestList()
+{
+    PyList* list = new PyList();
+    list->AddItemInt( 1 );
+    PyIncRef( list );
+    PyList* mine = list->MakeMutable();
+    Check( mine != list, "MakeMutable of a shared list copies" );
+    mine->AddItemInt( 2 );
+    Check( ( list->size() == 1 ) and ( mine->size() == 2 ), "change to the copy doesn't show in the original" );
+    PyDecRef( mine );
+    PyDecRef( list );
+}
+
+void TestObject()
+{
+    PyDict* args = new PyDict();
+    args->SetItemString( "a", new PyInt( 1 ) );
+    PyObject* obj = new PyObject( "util.KeyVal", args );
+    Check( obj->MakeMutable() == obj, "MakeMutable of an unshared object is itself" );
+
+    // a copy shares the arguments, so neither may change them in place
+    PyObject* copy = obj->Clone()->AsObject();
+    Check( copy->arguments() == args, "Clone shares arguments" );
+    PyObject* mine = copy->MakeMutable();
+    Check( ( mine != copy ) and ( mine->arguments() != args ), "MakeMutable copies shared arguments" );
+    mine->arguments()->AsDict()->SetItemString( "a", new PyInt( 2 ) );
+    Check( PyRep::IntegerValue( args->GetItemString( "a" ) ) == 1, "change to the copy doesn't show in the original" );
+    Check( mine->type() == obj->type(), "type is shared" );
+    PyDecRef( mine );
+    PyDecRef( obj );
+}
+
+void TestPackedRow()
+{
+    DBRowDescriptor* header = new DBRowDescriptor();
+    header->AddColumn( "itemID", DBTYPE_I4 );
+    PyPackedRow* row = new PyPackedRow( header );
+    row->SetField( (uint32)0, new PyInt( 1 ) );
+
+    const uint16 count = header->GetCount();
+    PyPackedRow* copy = row->Clone()->AsPackedRow();
+    Check( copy->header() == header, "Clone shares the header" );
+    Check( header->GetCount() == count + 1, "Clone holds its own reference to the header" );
+    copy->SetField( (uint32)0, new PyInt( 2 ) );
+    Check( PyRep::IntegerValue( row->GetField( 0 ) ) == 1, "SetField on a clone leaves the original alone" );
+    PyDecRef( copy );
+    Check( !header->IsDeleted() and ( header->GetCount() == count ), "header survives the clone" );
+
+    PyIncRef( row );
+    PyPackedRow* mine = row->MakeMutable();
+    Check( mine != row, "MakeMutable of a shared row copies" );
+    PyDecRef( mine );
+    PyDecRef( row );
+}
+
+}
+
+int python_PyCopyOnWriteTest( int argc, char* argv[] )
+{
+    TestTuple();
+    TestDict();
+    TestList();
+    TestObject();
+    TestPackedRow();
+
+    return CheckResult();
+}
@@ -0,0 +1,147 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+
+#include "eve-test.h"
+
+#include "benchmark/Payloads.h"
+
+/* PyDict keys and wire format.
+ *  keys are equal by value, not by hash: -1 and -2 hash alike (as in Python) but are
+ *  different keys, while 5, 5L and 5.0 or 'a' and u'a' are one key.  dicts iterate in
+ *  insertion order, inline and past the inline size, so marshaling a dict, unmarshaling
+ *  it and marshaling it again gives the same bytes.
+ */
+
+namespace {
+
+int64 IntItem( PyDict* dict, PyRep* key )
+{
+    PyRep* res = dict->GetItem( key );
+    PyDecRef( key );
+    return ( res == nullptr ? -1000 : PyRep::IntegerValue( res ) );
+}
+
+void TestKeys()
+{
+    PyDict* dict = new PyDict();
+    dict->SetItem( new PyInt( -1 ), new PyInt( 1 ) );
+    dict->SetItem( new PyInt( -2 ), new PyInt( 2 ) );
+    Check( dict->begin()[ 0 ].hash == dict->begin()[ 1 ].hash, "-1 and -2 hash alike" );
+    Check( dict->size() == 2, "-1 and -2 are different keys" );
+    Check( IntItem( dict, new PyInt( -1 ) ) == 1, "GetItem(-1)" );
+    Check( IntItem( dict, new PyInt( -2 ) ) == 2, "GetItem(-2)" );
+
+    dict->SetItem( new PyInt( 5 ), new PyInt( 5 ) );
+    dict->SetItem( new PyLong( 5 ), new PyInt( 6 ) );
+    dict->SetItem( new PyFloat( 5.0 ), new PyInt( 7 ) );
+    Check( dict->size() == 3, "5, 5L and 5.0 are one key" );
+    Check( IntItem( dict, new PyInt( 5 ) ) == 7, "GetItem(5) after SetItem(5.0)" );
+    Check( IntItem( dict, new PyLong( 5 ) ) == 7, "GetItem(5L)" );
+
+    dict->SetItem( new PyString( "a" ), new PyInt( 8 ) );
+    dict->SetItem( new PyWString( "a", 1 ), new PyInt( 9 ) );
+    Check( dict->size() == 4, "'a' and u'a' are one key" );
+    Check( PyRep::IntegerValue( dict->GetItemString( "a" ) ) == 9, "GetItemString(a)" );
+    Check( dict->GetItemString( "b" ) == nullptr, "GetItemString(b) is missing" );
+
+    dict->SetItem( new_tuple( 1, 2 ), new PyInt( 10 ) );
+    dict->SetItem( new_tuple( 2, 1 ), new PyInt( 11 ) );
+    Check( dict->size() == 6, "tuple keys" );
+    Check( IntItem( dict, new_tuple( 1, 2 ) ) == 10, "GetItem((1, 2))" );
+    Check( IntItem( dict, new_tuple( 1, 3 ) ) == -1000, "GetItem((1, 3)) is missing" );
+
+    PyDecRef( dict );
+}
+
+void TestGrowth()
+{
+    // past the inline entries, the index takes over; order must hold across it
+    PyDict* dict = new PyDict();
+    for (int32 i = 0; i < 1000; ++i)
+        dict->SetItem( new PyInt( ( i * 7919 ) % 1000 ), new PyInt( i ) );
+    for (int32 i = 0; i < 1000; i += 3)
+        dict->SetItem( new PyInt( ( i * 7919 ) % 1000 ), new PyInt( -i ) );
+    Check( dict->size() == 1000, "1000 keys" );
+
+    bool ordered(true), found(true);
+    int32 i(0);
+    for (PyDict::const_iterator cur = dict->begin(); cur != dict->end(); ++cur, ++i) {
+        ordered &= ( cur->first->AsInt()->value() == ( i * 7919 ) % 1000 );
+        ordered &= ( cur->second->AsInt()->value() == ( i % 3 == 0 ? -i : i ) );
+        found &= ( dict->GetItem( cur->first ) == cur->second );
+    }
+    Check( ordered, "iterates in insertion order; SetItem on a key keeps its place" );
+    Check( found, "GetItem finds every key" );
+
+    PyDict* copy = (PyDict*)dict->Clone();
+    found = ( copy->size() == dict->size() );
+    for (PyDict::const_iterator cur = dict->begin(); cur != dict->end(); ++cur)
+        found &= ( copy->GetItem( cur->first ) != nullptr );
+    Check( found, "Clone finds every key" );
+    PyDecRef( copy );
+
+    dict->clear();
+    Check( dict->empty(), "clear" );
+    dict->SetItem( new PyInt( 1 ), new PyInt( 1 ) );
+    Check( IntItem( dict, new PyInt( 1 ) ) == 1, "SetItem after clear" );
+    PyDecRef( dict );
+}
+
+void TestRoundTrip( const char* name, PyRep* rep )
+{
+    Buffer first, second;
+    bool ok = Marshal( rep, first );
+    PyDecRef( rep );
+
+    PyRep* res = ( ok ? Unmarshal( first ) : nullptr );
+    ok = ( res != nullptr ) and Marshal( res, second );
+    PySafeDecRef( res );
+
+    ok = ok and ( first.size() == second.size() ) and std::equal( first.begin<uint8>(), first.end<uint8>(), second.begin<uint8>() );
+    ::printf( "%-16s %8lu bytes %s\n", name, first.size(), ( ok ? "same" : "DIFFERENT" ) );
+    Check( ok, name );
+}
+
+}
+
+int python_PyDictTest( int argc, char* argv[] )
+{
+    TestKeys();
+    TestGrowth();
+
+    // a keyword args sized dict, inline
+    PyDict* kwargs = new PyDict();
+    kwargs->SetItemString( "machoVersion", new PyInt( 1 ) );
+    kwargs->SetItemString( "locationID", new PyInt( 60003760 ) );
+    kwargs->SetItemString( "flag", new PyInt( 4 ) );
+    kwargs->SetItemString( "qty", new PyNone() );
+    TestRoundTrip( "kwargs", kwargs );
+
+    TestRoundTrip( "item300", MakeItemAttributes( 300 ) );
+    TestRoundTrip( "addballs100", MakeAddBalls( 100 ) );
+
+    return CheckResult();
+}
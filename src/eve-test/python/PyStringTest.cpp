@@ -0,0 +1,130 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+#include "marshal/EVEMarshalOpcodes.h"
+#include "marshal/EVEMarshalStringTable.h"
+
+/* interned PyStrings.
+ *  one pinned PyString per content, shared by every thread; table strings keep their
+ *  MarshalStringTable index and marshal as Op_PyStringTableItem, and unmarshal gives
+ *  back the interned string for table items and for strings already interned.
+ */
+
+namespace {
+
+void TestIntern()
+{
+    PyString* str = PyString::Intern( "PyStringTest.method" );
+    Check( str->IsInterned(), "Intern gives an interned string" );
+    Check( str == PyString::Intern( std::string( "PyStringTest.method" ) ), "Intern is unique by content" );
+    Check( str == PyString::Lookup( "PyStringTest.method", 19 ), "Lookup finds interned strings" );
+    Check( PyString::Lookup( "PyStringTest.missing", 20 ) == nullptr, "Lookup of a new string" );
+    Check( PyString::Lookup( "PyStringTest.missing", 20 ) == nullptr, "Lookup doesn't add" );
+    Check( str->GetTableIndex() == 0, "no table index outside the string table" );
+
+    // pinned: ref counting is a no-op, Clone shares
+    PyIncRef( str );
+    PyDecRef( str );
+    PyDecRef( str );
+    Check( !str->IsDeleted() and ( str->content() == "PyStringTest.method" ), "interned strings are never deleted" );
+    Check( str->Clone() == str, "Clone of an interned string is itself" );
+
+    PyString* table = PyString::Intern( "util.Rowset" );
+    Check( table->GetTableIndex() == sMarshalStringTable.LookupIndex( "util.Rowset" ), "table strings keep their index" );
+    Check( table == PyString::FromStringTable( table->GetTableIndex() ), "FromStringTable" );
+    Check( PyString::FromStringTable( 0 ) == nullptr, "FromStringTable(0)" );
+    Check( PyString::FromStringTable( 255 ) == nullptr, "FromStringTable(255)" );
+
+    // a plain copy compares by value against an interned key
+    PyDict* dict = new PyDict();
+    dict->SetItem( PyString::Intern( "userid" ), new PyInt( 1 ) );
+    dict->SetItem( new PyString( "userid" ), new PyInt( 2 ) );
+    Check( dict->size() == 1, "interned and plain strings are one key" );
+    Check( dict->GetItem( PyString::Intern( "userid" ) ) != nullptr, "GetItem by interned key" );
+    PyDecRef( dict );
+}
+
+void TestWire()
+{
+    PyTuple* tuple = new_tuple( PyString::Intern( "util.Row" ), PyString::Intern( "PyStringTest.column" ), new PyString( "PyStringTest.value" ) );
+    Buffer data;
+    Check( Marshal( tuple, data ), "Marshal" );
+    PyDecRef( tuple );
+
+    // header, tuple opcode and count, then the first string
+    Check( ( data[ 7 ] & PyRepOpcodeMask ) == Op_PyStringTableItem, "interned table strings marshal as table items" );
+    Check( data[ 8 ] == sMarshalStringTable.LookupIndex( "util.Row" ), "table item index" );
+
+    PyRep* res = Unmarshal( data );
+    Check( ( res != nullptr ) and res->IsTuple() and ( res->AsTuple()->size() == 3 ), "Unmarshal" );
+    if (res == nullptr)
+        return;
+    PyTuple* items = res->AsTuple();
+    Check( items->GetItem( 0 ) == PyString::Intern( "util.Row" ), "table items unmarshal interned" );
+    Check( items->GetItem( 1 ) == PyString::Intern( "PyStringTest.column" ), "known strings unmarshal interned" );
+    Check( !items->GetItem( 2 )->AsString()->IsInterned(), "unknown strings aren't interned" );
+    Check( PyString::Lookup( "PyStringTest.value", 18 ) == nullptr, "unmarshal doesn't add to the pool" );
+    PyDecRef( res );
+}
+
+void TestThreads()
+{
+    // every thread must get the same string for the same content
+    const uint32 threadCount = 8, stringCount = 500;
+    std::vector<std::vector<PyString*>> results( threadCount );
+    std::vector<std::thread> threads;
+    for (uint32 t = 0; t < threadCount; ++t)
+        threads.emplace_back( [t, &results]() {
+            char name[ 32 ];
+            for (uint32 i = 0; i < stringCount; ++i) {
+                snprintf( name, sizeof( name ), "PyStringTest.thread%u", ( i * 7 + t ) % stringCount );
+                results[ t ].push_back( PyString::Intern( name ) );
+            }
+        } );
+    for (std::thread& cur : threads)
+        cur.join();
+
+    bool same(true);
+    char name[ 32 ];
+    for (uint32 t = 0; t < threadCount; ++t)
+        for (uint32 i = 0; i < stringCount; ++i) {
+            snprintf( name, sizeof( name ), "PyStringTest.thread%u", ( i * 7 + t ) % stringCount );
+            same &= ( results[ t ][ i ] == PyString::Lookup( name, strlen( name ) ) );
+        }
+    Check( same, "concurrent Intern gives one string per content" );
+}
+
+}
+
+int python_PyStringTest( int argc, char* argv[] )
+{
+    TestIntern();
+    TestWire();
+    TestThreads();
+
+    return CheckResult();
+}
@@ -0,0 +1,243 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+
+#include "eve-test.h"
+
+#include <atomic>
+
+#include "utils/Metrics.h"
+
+/* scraping under load.
+ *  worker threads do what the server does between scrapes: marshal and unmarshal packets
+ *  (marshal byte counters, live PyRep gauges), observe tick times, and add and remove
+ *  per-client series as clients come and go.  meanwhile another thread scrapes as fast as
+ *  it can.  every scrape must be well formed, counters must never go backwards, histogram
+ *  buckets must be cumulative with _count matching +Inf, no scrape may stall, and the last
+ *  scrape must hold the exact totals.
+ */
+
+namespace {
+
+const uint32 WORKER_COUNT = 4;
+const uint32 PASSES = 50000;
+// generous; a scrape is a few hundred series, but CI boxes get descheduled
+const double MAX_SCRAPE_MS = 200.0;
+
+struct Scrape {
+    std::map<std::string, double> samples;
+    bool ok;
+};
+
+Scrape Parse( const std::string& text )
+{
+    Scrape scrape;
+    scrape.ok = true;
+
+    size_t pos(0);
+    while (pos < text.size()) {
+        size_t eol = text.find( '\n', pos );
+        if (eol == std::string::npos) {
+            // every line ends in \n
+            scrape.ok = false;
+            break;
+        }
+        std::string line( text, pos, eol - pos );
+        pos = eol + 1;
+
+        if (line.compare( 0, 7, "# HELP " ) == 0 or line.compare( 0, 7, "# TYPE " ) == 0)
+            continue;
+
+        size_t space = line.rfind( ' ' );
+        if ((space == std::string::npos) or (space == 0) or (line[ 0 ] == '#')) {
+            scrape.ok = false;
+            continue;
+        }
+        char* end(nullptr);
+        const std::string value( line.substr( space + 1 ) );
+        double number = strtod( value.c_str(), &end );
+        if (end != value.c_str() + value.size()) {
+            scrape.ok = false;
+            continue;
+        }
+        scrape.samples[ line.substr( 0, space ) ] = number;
+    }
+
+    return scrape;
+}
+
+void Worker( uint32 number, std::atomic<bool>* start )
+{
+    MetricCounter& calls = sMetrics.GetCounter( "test_calls_total", "Calls handled." );
+    MetricHistogram& tick = sMetrics.GetHistogram( "test_tick_seconds", "Tick time, by worker.", {{"worker", std::to_string( number )}} );
+
+    while (!start->load())
+        std::this_thread::yield();
+
+    for (uint32 i = 0; i < PASSES; ++i) {
+        // a client connects, sends, and leaves
+        const MetricLabels client = {{"client", std::to_string( number * PASSES + i )}};
+        MetricGauge& queue = sMetrics.GetGauge( "test_send_queue_bytes", "Send queue, by client.", client );
+
+        PyTuple* rep = new PyTuple( 2 );
+            rep->SetItem( 0, new PyInt( i ) );
+            rep->SetItem( 1, new PyString( "Process" ) );
+        Buffer data;
+        Marshal( rep, data );
+        PyDecRef( rep );
+        PyRep* back = Unmarshal( data );
+        PySafeDecRef( back );
+
+        queue.Set( data.size() );
+        calls.Inc();
+        tick.Observe( ( i % 100 ) / 10000.0 );
+
+        sMetrics.Remove( "test_send_queue_bytes", client );
+    }
+}
+
+}
+
+int utils_MetricsTest( int argc, char* argv[] )
+{
+    // first access isnt thread safe; the server does this in main() too
+    MetricRegistry::get();
+    PyRep::RegisterMetrics();
+
+    int result = EXIT_SUCCESS;
+
+    std::atomic<bool> start( false );
+    std::vector<std::thread> workers;
+    for (uint32 i = 0; i < WORKER_COUNT; ++i)
+        workers.emplace_back( Worker, i, &start );
+
+    uint32 scrapes(0), malformed(0), backwards(0), stalls(0), badHistograms(0);
+    double worstMs(0.0);
+    std::map<std::string, double> last;
+
+    start = true;
+    bool running = true;
+    while (running) {
+        // checked before scraping, so the last scrape sees every worker done
+        running = false;
+        for (auto& cur : workers)
+            if (cur.joinable())
+                running = true;
+
+        const double startTime = GetTimeMSeconds();
+        Scrape scrape = Parse( sMetrics.Serialize() );
+        const double ms = GetTimeMSeconds() - startTime;
+        worstMs = std::max( worstMs, ms );
+        if (ms > MAX_SCRAPE_MS)
+            ++stalls;
+        ++scrapes;
+
+        if (!scrape.ok)
+            ++malformed;
+
+        for (auto& cur : scrape.samples) {
+            const std::string& name = cur.first;
+            if ((name.find( "_total" ) != std::string::npos) or (name.find( "_bucket" ) != std::string::npos)) {
+                std::map<std::string, double>::const_iterator prev = last.find( name );
+                if ((prev != last.end()) and (cur.second < prev->second))
+                    ++backwards;
+            }
+        }
+
+        // buckets are cumulative, so none may exceed +Inf, and +Inf must match _count
+        for (uint32 i = 0; i < WORKER_COUNT; ++i) {
+            const std::string prefix = "test_tick_seconds_bucket{worker=\"" + std::to_string( i ) + "\"";
+            std::map<std::string, double>::const_iterator inf = scrape.samples.find( prefix + ",le=\"+Inf\"}" );
+            std::map<std::string, double>::const_iterator count = scrape.samples.find( "test_tick_seconds_count{worker=\"" + std::to_string( i ) + "\"}" );
+            if ((inf == scrape.samples.end()) or (count == scrape.samples.end()))
+                continue;   // not registered yet
+            if (inf->second != count->second)
+                ++badHistograms;
+            for (auto& cur : scrape.samples)
+                if ((cur.first.compare( 0, prefix.size(), prefix ) == 0) and (cur.second > inf->second))
+                    ++badHistograms;
+        }
+
+        last.swap( scrape.samples );
+
+        // reap finished workers without blocking on the rest
+        for (auto& cur : workers) {
+            if (!cur.joinable())
+                continue;
+            const std::map<std::string, double>::const_iterator calls = last.find( "test_calls_total" );
+            if ((calls != last.end()) and (calls->second >= WORKER_COUNT * PASSES))
+                cur.join();
+        }
+    }
+
+    ::printf( "%u scrapes while %u workers ran %u passes each; slowest scrape %.2fms.\n", scrapes, WORKER_COUNT, PASSES, worstMs );
+
+    if (malformed > 0) {
+        ::printf( "%u scrapes were malformed.\n", malformed );
+        result = EXIT_FAILURE;
+    }
+    if (backwards > 0) {
+        ::printf( "%u counter or bucket samples went backwards.\n", backwards );
+        result = EXIT_FAILURE;
+    }
+    if (badHistograms > 0) {
+        ::printf( "%u histogram samples were inconsistent.\n", badHistograms );
+        result = EXIT_FAILURE;
+    }
+    if (stalls > 0) {
+        ::printf( "%u scrapes took over %.0fms.\n", stalls, MAX_SCRAPE_MS );
+        result = EXIT_FAILURE;
+    }
+    if (scrapes < 10) {
+        ::printf( "Only %u scrapes ran during the load.\n", scrapes );
+        result = EXIT_FAILURE;
+    }
+
+    // exact totals once the load stops
+    if (last[ "test_calls_total" ] != WORKER_COUNT * PASSES) {
+        ::printf( "test_calls_total is %.0f, expected %u.\n", last[ "test_calls_total" ], WORKER_COUNT * PASSES );
+        result = EXIT_FAILURE;
+    }
+    for (uint32 i = 0; i < WORKER_COUNT; ++i) {
+        const std::string name = "test_tick_seconds_count{worker=\"" + std::to_string( i ) + "\"}";
+        if (last[ name ] != PASSES) {
+            ::printf( "%s is %.0f, expected %u.\n", name.c_str(), last[ name ], PASSES );
+            result = EXIT_FAILURE;
+        }
+    }
+    for (auto& cur : last) {
+        if (cur.first.compare( 0, 21, "test_send_queue_bytes" ) == 0) {
+            ::printf( "Removed series %s is still served.\n", cur.first.c_str() );
+            result = EXIT_FAILURE;
+            break;
+        }
+    }
+    if ((last[ "evemu_marshal_bytes_total" ] <= 0) or (last.find( "evemu_pyrep_live{type=\"Tuple\"}" ) == last.end())) {
+        ::puts( "Marshal and PyRep metrics are missing." );
+        result = EXIT_FAILURE;
+    }
+
+    return result;
+}
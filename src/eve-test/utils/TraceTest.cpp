@@ -0,0 +1,422 @@
+/*
+    ------------------------------------------------------------------------------------
+    LICENSE:
+    ------------------------------------------------------------------------------------
+    This file is part of EVEmu: EVE Online Server Emulator
+    Copyright 2006 - 2021 The EVEmu Team
+    For the latest information visit https://evemu.dev
+    ------------------------------------------------------------------------------------
+    This program is free software; you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License as published by the Free Software
+    Foundation; either version 2 of the License, or (at your option) any later
+    version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License along with
+    this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+    Place - Suite 330, Boston, MA 02111-1307, USA, or go to
+    http://www.gnu.org/copyleft/lesser.txt.
+    ------------------------------------------------------------------------------------
+    Author:        EVEmu Team
+*/
+
+#include "eve-test.h"
+
+#include <atomic>
+
+#include "utils/Trace.h"
+
+/* trace dumps while spans are recorded.
+ *  worker threads record spans (some with details that need escaping) while the main thread
+ *  dumps as fast as it can.  every dump must be valid JSON in the Chrome trace event format,
+ *  and once the workers are done the last dump must hold each worker's spans: all of them, or
+ *  the last RING_SIZE for the worker that overran its ring.  disabled spans and spans outside
+ *  the dump window must not show up, and a thread reusing an exited thread's ring must not
+ *  serve that thread's spans.  a thread asking for a small ring keeps SMALL_RING_SIZE spans,
+ *  and its ring is not handed to a thread that wants a full one.
+ */
+
+namespace {
+
+const uint32 WORKER_COUNT = 4;
+const uint32 SPANS = 3000;
+// seconds; the whole run, even under a sanitizer
+const double WINDOW = 3600.0;
+
+/* just enough JSON to check a dump */
+struct Json {
+    enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+    Type type;
+    double number;
+    std::string str;
+    std::vector<Json> items;
+    std::map<std::string, Json> members;
+
+    const Json* Get( const char* name ) const
+    {
+        std::map<std::string, Json>::const_iterator itr = members.find( name );
+        return ( itr == members.end() ? nullptr : &itr->second );
+    }
+};
+
+class JsonParser
+{
+public:
+    JsonParser( const std::string& text ) : mText( text ), mPos( 0 ) { }
+
+    /// @return false if text isnt exactly one JSON value.
+    bool Parse( Json& into )
+    {
+        if (!ParseValue( into ))
+            return false;
+        SkipSpace();
+        return mPos == mText.size();
+    }
+
+protected:
+    void SkipSpace()
+    {
+        while ((mPos < mText.size()) and isspace( (uint8)mText[ mPos ] ))
+            ++mPos;
+    }
+    bool Expect( const char* word )
+    {
+        size_t len = strlen( word );
+        if (mText.compare( mPos, len, word ) != 0)
+            return false;
+        mPos += len;
+        return true;
+    }
+
+    bool ParseValue( Json& into )
+    {
+        SkipSpace();
+        if (mPos >= mText.size())
+            return false;
+
+        switch (mText[ mPos ]) {
+            case '{':   return ParseObject( into );
+            case '[':   return ParseArray( into );
+            case '"':   into.type = Json::STRING; return ParseString( into.str );
+            case 't':   into.type = Json::BOOL; return Expect( "true" );
+            case 'f':   into.type = Json::BOOL; return Expect( "false" );
+            case 'n':   into.type = Json::NUL; return Expect( "null" );
+            default:    into.type = Json::NUMBER; return ParseNumber( into.number );
+        }
+    }
+    bool ParseObject( Json& into )
+    {
+        into.type = Json::OBJECT;
+        ++mPos;
+        SkipSpace();
+        if ((mPos < mText.size()) and (mText[ mPos ] == '}')) {
+            ++mPos;
+            return true;
+        }
+        while (true) {
+            std::string name;
+            SkipSpace();
+            if ((mPos >= mText.size()) or (mText[ mPos ] != '"') or !ParseString( name ))
+                return false;
+            SkipSpace();
+            if (!Expect( ":" ))
+                return false;
+            if (!ParseValue( into.members[ name ] ))
+                return false;
+            SkipSpace();
+            if (Expect( "}" ))
+                return true;
+            if (!Expect( "," ))
+                return false;
+        }
+    }
+    bool ParseArray( Json& into )
+    {
+        into.type = Json::ARRAY;
+        ++mPos;
+        SkipSpace();
+        if ((mPos < mText.size()) and (mText[ mPos ] == ']')) {
+            ++mPos;
+            return true;
+        }
+        while (true) {
+            into.items.emplace_back();
+            if (!ParseValue( into.items.back() ))
+                return false;
+            SkipSpace();
+            if (Expect( "]" ))
+                return true;
+            if (!Expect( "," ))
+                return false;
+        }
+    }
+    bool ParseString( std::string& into )
+    {
+        ++mPos;     // opening quote
+        while (mPos < mText.size()) {
+            char c = mText[ mPos++ ];
+            if (c == '"')
+                return true;
+            if ((uint8)c < 0x20)
+                return false;   // control characters must be escaped
+            if (c != '\\') {
+                into += c;
+                continue;
+            }
+            if (mPos >= mText.size())
+                return false;
+            c = mText[ mPos++ ];
+            switch (c) {
+                case '"': case '\\': case '/':  into += c; break;
+                case 'b':   into += '\b'; break;
+                case 'f':   into += '\f'; break;
+                case 'n':   into += '\n'; break;
+                case 'r':   into += '\r'; break;
+                case 't':   into += '\t'; break;
+                case 'u': {
+                    if ((mPos + 4 > mText.size()) or !isxdigit( (uint8)mText[ mPos ] ) or !isxdigit( (uint8)mText[ mPos + 1 ] )
+                    or !isxdigit( (uint8)mText[ mPos + 2 ] ) or !isxdigit( (uint8)mText[ mPos + 3 ] ))
+                        return false;
+                    into += (char)strtol( mText.substr( mPos, 4 ).c_str(), nullptr, 16 );
+                    mPos += 4;
+                } break;
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+    bool ParseNumber( double& into )
+    {
+        const char* start = mText.c_str() + mPos;
+        char* end(nullptr);
+        into = strtod( start, &end );
+        if ((end == start) or !(isdigit( (uint8)*start ) or (*start == '-')))
+            return false;
+        mPos += end - start;
+        return true;
+    }
+
+    const std::string& mText;
+    size_t mPos;
+};
+
+struct Dump {
+    bool ok;
+    std::string error;
+    /// complete events, by thread name
+    std::map<std::string, std::vector<const Json*>> spans;
+    Json root;
+};
+
+/* parses a dump and checks it against the trace event format */
+void Check( const std::string& text, Dump& dump )
+{
+    dump.ok = false;
+    dump.spans.clear();
+    dump.root = Json();
+
+    if (!JsonParser( text ).Parse( dump.root ) or (dump.root.type != Json::OBJECT)) {
+        dump.error = "not a JSON object";
+        return;
+    }
+    const Json* events = dump.root.Get( "traceEvents" );
+    if ((events == nullptr) or (events->type != Json::ARRAY)) {
+        dump.error = "no traceEvents array";
+        return;
+    }
+
+    std::map<double, std::string> names;
+    for (auto& cur : events->items) {
+        const Json* ph = cur.Get( "ph" );
+        const Json* tid = cur.Get( "tid" );
+        if ((ph == nullptr) or (ph->type != Json::STRING) or (tid == nullptr) or (tid->type != Json::NUMBER)
+        or (cur.Get( "pid" ) == nullptr) or (cur.Get( "name" ) == nullptr)) {
+            dump.error = "event without ph, pid, tid or name";
+            return;
+        }
+        if (ph->str == "M") {
+            const Json* args = cur.Get( "args" );
+            if ((args == nullptr) or (args->Get( "name" ) == nullptr)) {
+                dump.error = "thread_name without args.name";
+                return;
+            }
+            names[ tid->number ] = args->Get( "name" )->str;
+        }
+    }
+    for (auto& cur : events->items) {
+        if (cur.Get( "ph" )->str != "X")
+            continue;
+        const Json* ts = cur.Get( "ts" );
+        const Json* dur = cur.Get( "dur" );
+        if ((ts == nullptr) or (ts->type != Json::NUMBER) or (dur == nullptr) or (dur->type != Json::NUMBER) or (dur->number < 0)) {
+            dump.error = "complete event without ts or dur";
+            return;
+        }
+        std::map<double, std::string>::const_iterator name = names.find( cur.Get( "tid" )->number );
+        if (name == names.end()) {
+            dump.error = "complete event on an unnamed thread";
+            return;
+        }
+        dump.spans[ name->second ].push_back( &cur );
+    }
+
+    dump.ok = true;
+}
+
+void Worker( uint32 number, std::atomic<uint32>* ready, std::atomic<bool>* start )
+{
+    const std::string name = "worker " + std::to_string( number );
+    // every worker holds its ring before any finishes, so none reuses another's
+    sTrace.SetThreadName( name.c_str() );
+    ++*ready;
+    // built at runtime, so interned; quotes, backslash and a control character to escape
+    const char* detail = sTrace.Intern( "\"w" + std::to_string( number ) + "\"\\\n\x01" );
+
+    while (!*start)
+        std::this_thread::yield();
+
+    // the last worker overruns its ring
+    const uint32 spans = ( number + 1 == WORKER_COUNT ? TraceRecorder::RING_SIZE + SPANS : SPANS );
+    for (uint32 i = 0; i < spans; ++i) {
+        TRACE_SPAN( "Worker", ( i % 2 == 0 ? detail : nullptr ) );
+        {
+            TRACE_SPAN( "Worker::Inner" );
+        }
+    }
+}
+
+}
+
+int utils_TraceTest( int argc, char* argv[] )
+{
+    // first access isnt thread safe; the server does this in main() too
+    TraceRecorder::get();
+    sTrace.SetThreadName( "main" );
+
+    int result = EXIT_SUCCESS;
+    Dump dump;
+
+    // disabled spans record nothing
+    TraceRecorder::SetEnabled( false );
+    for (uint32 i = 0; i < 100; ++i)
+        TRACE_SPAN( "Disabled" );
+    Check( sTrace.Serialize( WINDOW ), dump );
+    if (!dump.ok or !dump.spans.empty()) {
+        ::printf( "Disabled spans were recorded (or the dump was bad: %s).\n", dump.error.c_str() );
+        result = EXIT_FAILURE;
+    }
+
+    TraceRecorder::SetEnabled( true );
+
+    std::atomic<uint32> ready( 0 );
+    std::atomic<bool> start( false );
+    std::vector<std::thread> workers;
+    for (uint32 i = 0; i < WORKER_COUNT; ++i)
+        workers.emplace_back( Worker, i, &ready, &start );
+    while (ready < WORKER_COUNT)
+        std::this_thread::yield();
+
+    // dump while the workers record
+    uint32 dumps(0), malformed(0);
+    start = true;
+    for (; dumps < 50; ++dumps) {
+        TRACE_SPAN( "Serialize" );
+        Check( sTrace.Serialize( WINDOW ), dump );
+        if (!dump.ok) {
+            if (malformed == 0)
+                ::printf( "Malformed dump: %s.\n", dump.error.c_str() );
+            ++malformed;
+        }
+    }
+    for (auto& cur : workers)
+        cur.join();
+
+    if (malformed > 0) {
+        ::printf( "%u of %u dumps during the load were malformed.\n", malformed, dumps );
+        result = EXIT_FAILURE;
+    }
+
+    Check( sTrace.Serialize( WINDOW ), dump );
+    if (!dump.ok) {
+        ::printf( "Final dump is malformed: %s.\n", dump.error.c_str() );
+        return EXIT_FAILURE;
+    }
+    if (dump.spans[ "main" ].size() != dumps) {
+        ::printf( "main has %lu spans, expected %u.\n", dump.spans[ "main" ].size(), dumps );
+        result = EXIT_FAILURE;
+    }
+    for (uint32 i = 0; i < WORKER_COUNT; ++i) {
+        const std::string name = "worker " + std::to_string( i );
+        const std::vector<const Json*>& spans = dump.spans[ name ];
+        const size_t expected = ( i + 1 == WORKER_COUNT ? TraceRecorder::RING_SIZE : SPANS * 2 );
+        if (spans.size() != expected) {
+            ::printf( "%s has %lu spans, expected %lu.\n", name.c_str(), spans.size(), expected );
+            result = EXIT_FAILURE;
+            continue;
+        }
+        uint32 details(0);
+        for (auto cur : spans) {
+            const Json* args = cur->Get( "args" );
+            if ((args == nullptr) or (args->Get( "detail" ) == nullptr))
+                continue;
+            if (args->Get( "detail" )->str != "\"w" + std::to_string( i ) + "\"\\\n\x01") {
+                ::printf( "%s detail did not survive escaping.\n", name.c_str() );
+                result = EXIT_FAILURE;
+                break;
+            }
+            ++details;
+        }
+        if (details != expected / 4) {
+            ::printf( "%s has %u spans with details, expected %lu.\n", name.c_str(), details, expected / 4 );
+            result = EXIT_FAILURE;
+        }
+    }
+
+    // nothing started in the last 0 seconds
+    Check( sTrace.Serialize( 0.0 ), dump );
+    if (!dump.ok or !dump.spans.empty()) {
+        ::puts( "An empty window still served spans." );
+        result = EXIT_FAILURE;
+    }
+
+    // a new thread takes over an exited worker's ring, without its spans
+    std::thread( [] { sTrace.SetThreadName( "reuse" ); TRACE_SPAN( "Reuse" ); } ).join();
+    Check( sTrace.Serialize( WINDOW ), dump );
+    uint32 workerRings(0);
+    for (uint32 i = 0; i < WORKER_COUNT; ++i)
+        if (dump.spans.count( "worker " + std::to_string( i ) ) > 0)
+            ++workerRings;
+    if (!dump.ok or (dump.spans[ "reuse" ].size() != 1) or (workerRings != WORKER_COUNT - 1)) {
+        ::puts( "A reused ring served the wrong spans." );
+        result = EXIT_FAILURE;
+    }
+
+    // both overrun a small ring; only the thread that asked for one is cut short
+    const uint32 overrun = TraceRecorder::SMALL_RING_SIZE + 100;
+    std::thread( [overrun] {
+        TraceRecorder::SetRingSize( TraceRecorder::SMALL_RING_SIZE );
+        sTrace.SetThreadName( "small" );
+        for (uint32 i = 0; i < overrun; ++i)
+            TRACE_SPAN( "Small" );
+    } ).join();
+    std::thread( [overrun] {
+        sTrace.SetThreadName( "full" );
+        for (uint32 i = 0; i < overrun; ++i)
+            TRACE_SPAN( "Full" );
+    } ).join();
+    Check( sTrace.Serialize( WINDOW ), dump );
+    if (!dump.ok or (dump.spans[ "small" ].size() != TraceRecorder::SMALL_RING_SIZE)
+        or (dump.spans[ "full" ].size() != overrun)) {
+        ::printf( "Small ring kept %lu spans (expected %u), full ring %lu (expected %u).\n", \
+                dump.spans[ "small" ].size(), TraceRecorder::SMALL_RING_SIZE, dump.spans[ "full" ].size(), overrun );
+        result = EXIT_FAILURE;
+    }
+
+    TraceRecorder::SetEnabled( false );
+    return result;
+}